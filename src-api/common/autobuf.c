@@ -259,6 +259,23 @@ abuf_memcpy_prepend(struct autobuf *autobuf, const void *p, const size_t len) {
   return 0;
 }
 
+/**
+ * Make sure an autobuffer has enough free memory behind its content
+ * to write a block of data directly into it. The written data becomes
+ * part of the buffer by calling abuf_setlen() afterwards.
+ * @param autobuf pointer to autobuf object
+ * @param len number of bytes that should be writable
+ * @return pointer to the first free byte of the buffer,
+ *   NULL if an out-of-memory error happened
+ */
+char *
+abuf_reserve(struct autobuf *autobuf, size_t len) {
+  if (_autobuf_enlarge(autobuf, autobuf->_len + len) < 0) {
+    return NULL;
+  }
+  return autobuf->_buf + autobuf->_len;
+}
+
 /**
  * Remove a prefix from an autobuffer. This function can be used
  * to create an autobuffer based fifo.
@@ -79,6 +79,7 @@ EXPORT int abuf_strftime(struct autobuf *autobuf, const char *format, const stru
 EXPORT int abuf_memcpy(struct autobuf *autobuf, const void *p, const size_t len);
 EXPORT int abuf_memcpy_prepend(struct autobuf *autobuf, const void *p, const size_t len);
 EXPORT void abuf_pull(struct autobuf *autobuf, size_t len);
+EXPORT char *abuf_reserve(struct autobuf *autobuf, size_t len);
 EXPORT void abuf_hexdump(struct autobuf *out, const char *prefix, const void *buffer, size_t length);
 
 /**
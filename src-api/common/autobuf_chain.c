@@ -0,0 +1,383 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/autobuf.h"
+#include "common/autobuf_chain.h"
+#include "common/common_types.h"
+#include "common/list.h"
+
+static struct abuf_chain_chunk *_get_tail(struct abuf_chain *chain, size_t len);
+static struct abuf_chain_chunk *_add_chunk(struct abuf_chain *chain, size_t size);
+static void _free_chunk(struct abuf_chain_chunk *chunk);
+
+/**
+ * Initialize an empty chained autobuffer
+ * @param chain pointer to chained autobuffer
+ */
+void
+abuf_chain_init(struct abuf_chain *chain) {
+  list_init_head(&chain->_chunks);
+  chain->_len = 0;
+  chain->_error = false;
+}
+
+/**
+ * Free all memory of a chained autobuffer.
+ * The buffer can still be used afterwards.
+ * @param chain pointer to chained autobuffer
+ */
+void
+abuf_chain_free(struct abuf_chain *chain) {
+  struct abuf_chain_chunk *chunk, *chunk_it;
+
+  list_for_each_element_safe(&chain->_chunks, chunk, _node, chunk_it) {
+    list_remove(&chunk->_node);
+    _free_chunk(chunk);
+  }
+  chain->_len = 0;
+  chain->_error = false;
+}
+
+/**
+ * Append a memory block to a chained autobuffer
+ * @param chain pointer to chained autobuffer
+ * @param p pointer to memory block to be copied
+ * @param len length of memory block
+ * @return -1 if an out-of-memory error happened, 0 otherwise
+ */
+int
+abuf_chain_memcpy(struct abuf_chain *chain, const void *p, size_t len) {
+  struct abuf_chain_chunk *chunk;
+  const char *src = p;
+  size_t part;
+
+  while (len > 0) {
+    chunk = _get_tail(chain, 1);
+    if (!chunk) {
+      return -1;
+    }
+
+    part = chunk->_total - chunk->_len;
+    if (part > len) {
+      part = len;
+    }
+
+    memcpy(chunk->_buf + chunk->_len, src, part);
+    chunk->_len += part;
+    chain->_len += part;
+
+    src += part;
+    len -= part;
+  }
+  return 0;
+}
+
+/**
+ * Append a string to a chained autobuffer
+ * @param chain pointer to chained autobuffer
+ * @param s zero terminated string
+ * @return -1 if an out-of-memory error happened, 0 otherwise
+ */
+int
+abuf_chain_puts(struct abuf_chain *chain, const char *s) {
+  return abuf_chain_memcpy(chain, s, strlen(s));
+}
+
+/**
+ * vprintf()-style function that appends the output to a chained autobuffer
+ * @param chain pointer to chained autobuffer
+ * @param fmt printf format string
+ * @param ap variable argument list pointer
+ * @return -1 if an out-of-memory error happened,
+ *   otherwise it returns the number of written characters
+ *   (excluding the \0)
+ */
+int
+abuf_chain_vappendf(struct abuf_chain *chain, const char *fmt, va_list ap) {
+  struct abuf_chain_chunk *chunk;
+  va_list ap2;
+  int len;
+
+  chunk = _get_tail(chain, 1);
+  if (!chunk) {
+    return -1;
+  }
+
+  va_copy(ap2, ap);
+  len = vsnprintf(chunk->_buf + chunk->_len, chunk->_total - chunk->_len, fmt, ap);
+  if (len >= 0 && (size_t)len >= chunk->_total - chunk->_len) {
+    /* output did not fit into the free space of the last chunk */
+    chunk = _add_chunk(chain, (size_t)len + 1);
+    if (chunk) {
+      vsnprintf(chunk->_buf, chunk->_total, fmt, ap2);
+    }
+  }
+  va_end(ap2);
+
+  if (len < 0 || !chunk) {
+    chain->_error = true;
+    return -1;
+  }
+
+  chunk->_len += len;
+  chain->_len += len;
+  return len;
+}
+
+/**
+ * printf()-style function that appends the output to a chained autobuffer
+ * @param chain pointer to chained autobuffer
+ * @param fmt printf format string
+ * @return -1 if an out-of-memory error happened,
+ *   otherwise it returns the number of written characters
+ *   (excluding the \0)
+ */
+int
+abuf_chain_appendf(struct abuf_chain *chain, const char *fmt, ...) {
+  va_list ap;
+  int len;
+
+  va_start(ap, fmt);
+  len = abuf_chain_vappendf(chain, fmt, ap);
+  va_end(ap);
+  return len;
+}
+
+/**
+ * Move the content of an autobuffer to the end of a chained autobuffer
+ * without copying it. The autobuffer gets a new empty memory block.
+ * @param chain pointer to chained autobuffer
+ * @param autobuf pointer to autobuffer
+ * @return -1 if an out-of-memory error happened, 0 otherwise
+ */
+int
+abuf_chain_adopt(struct abuf_chain *chain, struct autobuf *autobuf) {
+  struct abuf_chain_chunk *chunk;
+  struct autobuf empty;
+
+  if (abuf_getlen(autobuf) == 0) {
+    return 0;
+  }
+
+  chunk = calloc(1, sizeof(*chunk));
+  if (!chunk) {
+    chain->_error = true;
+    return -1;
+  }
+  if (abuf_init(&empty)) {
+    free(chunk);
+    chain->_error = true;
+    return -1;
+  }
+
+  chunk->_buf = abuf_getptr(autobuf);
+  chunk->_len = abuf_getlen(autobuf);
+  chunk->_total = abuf_getmax(autobuf);
+  chunk->_adopted = true;
+
+  list_add_tail(&chain->_chunks, &chunk->_node);
+  chain->_len += chunk->_len;
+
+  memcpy(autobuf, &empty, sizeof(empty));
+  return 0;
+}
+
+/**
+ * Describe the content of a chained autobuffer as an iovec array
+ * suitable for writev()
+ * @param chain pointer to chained autobuffer
+ * @param iov pointer to iovec array
+ * @param iov_count number of elements in iovec array
+ * @return number of iovec elements filled
+ */
+int
+abuf_chain_get_iovec(struct abuf_chain *chain, struct iovec *iov, int iov_count) {
+  struct abuf_chain_chunk *chunk;
+  int i = 0;
+
+  list_for_each_element(&chain->_chunks, chunk, _node) {
+    if (i == iov_count) {
+      break;
+    }
+    if (chunk->_start == chunk->_len) {
+      continue;
+    }
+
+    iov[i].iov_base = chunk->_buf + chunk->_start;
+    iov[i].iov_len = chunk->_len - chunk->_start;
+    i++;
+  }
+  return i;
+}
+
+/**
+ * Remove a prefix from a chained autobuffer, chunks which
+ * have been completely removed are freed.
+ * @param chain pointer to chained autobuffer
+ * @param len number of bytes to be removed
+ */
+void
+abuf_chain_pull(struct abuf_chain *chain, size_t len) {
+  struct abuf_chain_chunk *chunk, *chunk_it;
+  size_t part;
+
+  list_for_each_element_safe(&chain->_chunks, chunk, _node, chunk_it) {
+    if (len == 0) {
+      return;
+    }
+
+    part = chunk->_len - chunk->_start;
+    if (part > len) {
+      part = len;
+    }
+
+    chunk->_start += part;
+    chain->_len -= part;
+    len -= part;
+
+    if (chunk->_start == chunk->_len) {
+      list_remove(&chunk->_node);
+      _free_chunk(chunk);
+    }
+  }
+}
+
+/**
+ * Remove data from the end of a chained autobuffer until it has the
+ * requested length, chunks which have become empty are freed.
+ * @param chain pointer to chained autobuffer
+ * @param len new length of the chained autobuffer, nothing
+ *   happens if it is not smaller than the current length
+ */
+void
+abuf_chain_setlen(struct abuf_chain *chain, size_t len) {
+  struct abuf_chain_chunk *chunk;
+  size_t part;
+
+  while (chain->_len > len) {
+    chunk = list_last_element(&chain->_chunks, chunk, _node);
+
+    part = chunk->_len - chunk->_start;
+    if (part > chain->_len - len) {
+      part = chain->_len - len;
+    }
+
+    chunk->_len -= part;
+    chain->_len -= part;
+
+    if (chunk->_start == chunk->_len) {
+      list_remove(&chunk->_node);
+      _free_chunk(chunk);
+    }
+  }
+}
+
+/**
+ * Get the last chunk of a chained autobuffer with enough free space,
+ * allocate a new one if necessary
+ * @param chain pointer to chained autobuffer
+ * @param len number of free bytes necessary
+ * @return pointer to chunk, NULL if an out-of-memory error happened
+ */
+static struct abuf_chain_chunk *
+_get_tail(struct abuf_chain *chain, size_t len) {
+  struct abuf_chain_chunk *chunk;
+
+  if (!list_is_empty(&chain->_chunks)) {
+    chunk = list_last_element(&chain->_chunks, chunk, _node);
+    if (chunk->_total - chunk->_len >= len) {
+      return chunk;
+    }
+  }
+  return _add_chunk(chain, len);
+}
+
+/**
+ * Add a new chunk to the end of a chained autobuffer
+ * @param chain pointer to chained autobuffer
+ * @param size minimum number of bytes of the chunk
+ * @return pointer to chunk, NULL if an out-of-memory error happened
+ */
+static struct abuf_chain_chunk *
+_add_chunk(struct abuf_chain *chain, size_t size) {
+  struct abuf_chain_chunk *chunk;
+
+  if (size < ABUF_CHAIN_CHUNK_SIZE) {
+    size = ABUF_CHAIN_CHUNK_SIZE;
+  }
+
+  /* chunk and its memory are allocated as one block */
+  chunk = malloc(sizeof(*chunk) + size);
+  if (!chunk) {
+    chain->_error = true;
+    return NULL;
+  }
+
+  chunk->_buf = (char *)(chunk + 1);
+  chunk->_start = 0;
+  chunk->_len = 0;
+  chunk->_total = size;
+  chunk->_adopted = false;
+
+  list_add_tail(&chain->_chunks, &chunk->_node);
+  return chunk;
+}
+
+/**
+ * Free the memory of a chunk
+ * @param chunk pointer to chunk
+ */
+static void
+_free_chunk(struct abuf_chain_chunk *chunk) {
+  if (chunk->_adopted) {
+    free(chunk->_buf);
+  }
+  free(chunk);
+}
@@ -0,0 +1,129 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#ifndef _COMMON_AUTOBUF_CHAIN_H
+#define _COMMON_AUTOBUF_CHAIN_H
+
+#include <stdarg.h>
+#include <sys/uio.h>
+
+#include "common/autobuf.h"
+#include "common/common_types.h"
+#include "common/list.h"
+
+/*! size of the memory blocks a chained autobuffer allocates for new data */
+#define ABUF_CHAIN_CHUNK_SIZE 16384
+
+/**
+ * Single memory block of a chained autobuffer
+ */
+struct abuf_chain_chunk {
+  /*! pointer to memory of chunk */
+  char *_buf;
+
+  /*! index of first byte of the chunk that has not been pulled yet */
+  size_t _start;
+
+  /*! number of bytes used in chunk */
+  size_t _len;
+
+  /*! number of bytes allocated in chunk */
+  size_t _total;
+
+  /*! true if memory has been taken over from an autobuffer */
+  bool _adopted;
+
+  /*! hook into list of chunks */
+  struct list_entity _node;
+};
+
+/**
+ * Buffer built from a list of memory blocks. Appending data never
+ * reallocates or moves data already in the buffer, the content can
+ * be handed to writev() without copying it into a single block.
+ */
+struct abuf_chain {
+  /*! list of memory chunks */
+  struct list_entity _chunks;
+
+  /*! number of bytes stored in the chain */
+  size_t _len;
+
+  /*! an error happened since the initialization of the chain */
+  bool _error;
+};
+
+EXPORT void abuf_chain_init(struct abuf_chain *chain);
+EXPORT void abuf_chain_free(struct abuf_chain *chain);
+EXPORT int abuf_chain_memcpy(struct abuf_chain *chain, const void *p, size_t len);
+EXPORT int abuf_chain_puts(struct abuf_chain *chain, const char *s);
+EXPORT int abuf_chain_vappendf(struct abuf_chain *chain, const char *fmt, va_list ap)
+  __attribute__((format(printf, 2, 0)));
+EXPORT int abuf_chain_appendf(struct abuf_chain *chain, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+EXPORT int abuf_chain_adopt(struct abuf_chain *chain, struct autobuf *autobuf);
+EXPORT int abuf_chain_get_iovec(struct abuf_chain *chain, struct iovec *iov, int iov_count);
+EXPORT void abuf_chain_pull(struct abuf_chain *chain, size_t len);
+EXPORT void abuf_chain_setlen(struct abuf_chain *chain, size_t len);
+
+/**
+ * @param chain chained autobuffer
+ * @return number of bytes stored in chained autobuffer
+ */
+static INLINE size_t
+abuf_chain_getlen(struct abuf_chain *chain) {
+  return chain->_len;
+}
+
+/**
+ * @param chain chained autobuffer
+ * @return true if an abuf_chain function failed
+ *   since the initialization of the chain
+ */
+static INLINE bool
+abuf_chain_has_failed(struct abuf_chain *chain) {
+  return chain->_error;
+}
+
+#endif /* _COMMON_AUTOBUF_CHAIN_H */
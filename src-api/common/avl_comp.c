@@ -137,9 +137,7 @@ avl_comp_uint8(const void *k1, const void *k2) {
  */
 int
 avl_comp_netaddr(const void *k1, const void *k2) {
-  const struct netaddr *n1 = k1;
-  const struct netaddr *n2 = k2;
-  return memcmp(n1, n2, sizeof(struct netaddr));
+  return netaddr_cmp(k1, k2);
 }
 
 /**
@@ -0,0 +1,388 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/autobuf.h"
+#include "common/cbor.h"
+#include "common/common_types.h"
+
+/*! maximum nesting depth cbor_skip() will follow */
+#define CBOR_MAX_NESTING 32
+
+static void _add_head(struct autobuf *out, enum cbor_type type, uint64_t value);
+static int _read_uint(struct cbor_reader *reader, uint8_t additional, uint64_t *value);
+static int _skip(struct cbor_reader *reader, int depth);
+
+/**
+ * Append an unsigned integer
+ * @param out output buffer
+ * @param value integer value
+ */
+void
+cbor_add_uint(struct autobuf *out, uint64_t value) {
+  _add_head(out, CBOR_TYPE_UINT, value);
+}
+
+/**
+ * Append a signed integer
+ * @param out output buffer
+ * @param value integer value
+ */
+void
+cbor_add_int(struct autobuf *out, int64_t value) {
+  if (value >= 0) {
+    _add_head(out, CBOR_TYPE_UINT, (uint64_t)value);
+  }
+  else {
+    /* negative integers are encoded as -1 - n */
+    _add_head(out, CBOR_TYPE_NEGINT, (uint64_t)(-(value + 1)));
+  }
+}
+
+/**
+ * Append a text string
+ * @param out output buffer
+ * @param text pointer to UTF-8 text
+ * @param len length of text in bytes
+ */
+void
+cbor_add_text(struct autobuf *out, const char *text, size_t len) {
+  _add_head(out, CBOR_TYPE_TEXT, len);
+  abuf_memcpy(out, text, len);
+}
+
+/**
+ * Append a double precision floating point number
+ * @param out output buffer
+ * @param value floating point number
+ */
+void
+cbor_add_double(struct autobuf *out, double value) {
+  uint8_t buf[9];
+  uint64_t bits;
+  int i;
+
+  memcpy(&bits, &value, sizeof(bits));
+
+  buf[0] = (CBOR_TYPE_SIMPLE << 5) | CBOR_SIMPLE_DOUBLE;
+  for (i = 8; i > 0; i--) {
+    buf[i] = (uint8_t)bits;
+    bits >>= 8;
+  }
+  abuf_memcpy(out, buf, sizeof(buf));
+}
+
+/**
+ * Append a simple value (boolean, null or break code)
+ * @param out output buffer
+ * @param value simple value
+ */
+void
+cbor_add_simple(struct autobuf *out, enum cbor_simple value) {
+  abuf_append_uint8(out, (uint8_t)((CBOR_TYPE_SIMPLE << 5) | value));
+}
+
+/**
+ * Append the value of a textual number as the most compact CBOR
+ * item. Integers and floating point numbers are converted,
+ * "true", "false" and "null" become simple values and all
+ * other text (e.g. numbers with iso prefix) is kept as text string.
+ * @param out output buffer
+ * @param value textual number
+ */
+void
+cbor_add_number_string(struct autobuf *out, const char *value) {
+  char *end;
+  double d;
+  long long ll;
+  unsigned long long ull;
+
+  if (*value == 0) {
+    /* same as JSON output */
+    cbor_add_uint(out, 0);
+    return;
+  }
+  if (strcmp(value, "true") == 0) {
+    cbor_add_simple(out, CBOR_SIMPLE_TRUE);
+    return;
+  }
+  if (strcmp(value, "false") == 0) {
+    cbor_add_simple(out, CBOR_SIMPLE_FALSE);
+    return;
+  }
+  if (strcmp(value, "null") == 0) {
+    cbor_add_simple(out, CBOR_SIMPLE_NULL);
+    return;
+  }
+
+  if (*value == '-') {
+    ll = strtoll(value, &end, 10);
+    if (*end == 0) {
+      cbor_add_int(out, ll);
+      return;
+    }
+  }
+  else {
+    ull = strtoull(value, &end, 10);
+    if (*end == 0) {
+      cbor_add_uint(out, ull);
+      return;
+    }
+  }
+
+  d = strtod(value, &end);
+  if (*end == 0) {
+    cbor_add_double(out, d);
+    return;
+  }
+
+  cbor_add_string(out, value);
+}
+
+/**
+ * Initialize a reader for CBOR encoded data
+ * @param reader CBOR reader
+ * @param buf pointer to encoded data
+ * @param len length of encoded data
+ */
+void
+cbor_reader_init(struct cbor_reader *reader, const void *buf, size_t len) {
+  reader->_buf = buf;
+  reader->_len = len;
+  reader->_offset = 0;
+}
+
+/**
+ * Read the next data item header. The content of strings is returned
+ * as part of the item, the elements of arrays and maps are the
+ * following items.
+ * @param reader CBOR reader
+ * @param item pointer to decoded item
+ * @return -1 if the data is truncated or not supported, 0 otherwise
+ */
+int
+cbor_read(struct cbor_reader *reader, struct cbor_item *item) {
+  uint8_t first, additional;
+  uint64_t bits;
+
+  if (cbor_reader_is_done(reader)) {
+    return -1;
+  }
+
+  memset(item, 0, sizeof(*item));
+
+  first = reader->_buf[reader->_offset++];
+  item->type = first >> 5;
+  additional = first & 0x1f;
+
+  if (item->type == CBOR_TYPE_SIMPLE) {
+    if (additional == CBOR_SIMPLE_DOUBLE) {
+      if (_read_uint(reader, additional, &bits)) {
+        return -1;
+      }
+      memcpy(&item->number, &bits, sizeof(bits));
+      item->value = CBOR_SIMPLE_DOUBLE;
+      return 0;
+    }
+    if (additional > 24) {
+      /* half and single precision floats are not supported */
+      item->value = additional;
+      return additional == CBOR_SIMPLE_BREAK ? 0 : -1;
+    }
+    return _read_uint(reader, additional, &item->value);
+  }
+
+  if (additional == 31) {
+    if (item->type != CBOR_TYPE_ARRAY && item->type != CBOR_TYPE_MAP) {
+      /* indefinite length strings are not supported */
+      return -1;
+    }
+    item->indefinite = true;
+    return 0;
+  }
+
+  if (_read_uint(reader, additional, &item->value)) {
+    return -1;
+  }
+
+  if (item->type == CBOR_TYPE_BYTES || item->type == CBOR_TYPE_TEXT) {
+    if (item->value > reader->_len - reader->_offset) {
+      return -1;
+    }
+    item->data = (const char *)&reader->_buf[reader->_offset];
+    reader->_offset += item->value;
+  }
+  return 0;
+}
+
+/**
+ * Skip the next complete data item including all elements
+ * of arrays and maps
+ * @param reader CBOR reader
+ * @return -1 if the data is truncated or not supported, 0 otherwise
+ */
+int
+cbor_skip(struct cbor_reader *reader) {
+  return _skip(reader, 0);
+}
+
+/**
+ * Append the head of a data item
+ * @param out output buffer
+ * @param type major type
+ * @param value argument of head
+ */
+static void
+_add_head(struct autobuf *out, enum cbor_type type, uint64_t value) {
+  uint8_t buf[9];
+  size_t len, i;
+
+  if (value < 24) {
+    abuf_append_uint8(out, (uint8_t)((type << 5) | value));
+    return;
+  }
+
+  if (value <= 0xff) {
+    buf[0] = 24;
+    len = 1;
+  }
+  else if (value <= 0xffff) {
+    buf[0] = 25;
+    len = 2;
+  }
+  else if (value <= 0xffffffff) {
+    buf[0] = 26;
+    len = 4;
+  }
+  else {
+    buf[0] = 27;
+    len = 8;
+  }
+
+  buf[0] |= type << 5;
+  for (i = len; i > 0; i--) {
+    buf[i] = (uint8_t)value;
+    value >>= 8;
+  }
+  abuf_memcpy(out, buf, len + 1);
+}
+
+/**
+ * Read the argument of a data item head
+ * @param reader CBOR reader
+ * @param additional additional information of first byte of head
+ * @param value pointer to argument
+ * @return -1 if the data is truncated or malformed, 0 otherwise
+ */
+static int
+_read_uint(struct cbor_reader *reader, uint8_t additional, uint64_t *value) {
+  size_t len;
+
+  if (additional < 24) {
+    *value = additional;
+    return 0;
+  }
+  if (additional > 27) {
+    return -1;
+  }
+
+  len = (size_t)1 << (additional - 24);
+  if (len > reader->_len - reader->_offset) {
+    return -1;
+  }
+
+  *value = 0;
+  while (len-- > 0) {
+    *value = (*value << 8) | reader->_buf[reader->_offset++];
+  }
+  return 0;
+}
+
+/**
+ * Skip the next complete data item
+ * @param reader CBOR reader
+ * @param depth nesting depth of item
+ * @return -1 if the data is truncated, too deeply nested or not supported,
+ *   0 otherwise
+ */
+static int
+_skip(struct cbor_reader *reader, int depth) {
+  struct cbor_item item;
+  uint64_t i, count;
+
+  if (depth > CBOR_MAX_NESTING || cbor_read(reader, &item)) {
+    return -1;
+  }
+
+  if (item.type == CBOR_TYPE_TAG) {
+    return _skip(reader, depth + 1);
+  }
+  if (item.type != CBOR_TYPE_ARRAY && item.type != CBOR_TYPE_MAP) {
+    return cbor_is_break(&item) ? -1 : 0;
+  }
+
+  if (item.indefinite) {
+    while (!cbor_reader_is_done(reader)) {
+      if (reader->_buf[reader->_offset] == ((CBOR_TYPE_SIMPLE << 5) | CBOR_SIMPLE_BREAK)) {
+        reader->_offset++;
+        return 0;
+      }
+      if (_skip(reader, depth + 1)) {
+        return -1;
+      }
+    }
+    return -1;
+  }
+
+  count = item.type == CBOR_TYPE_MAP ? item.value * 2 : item.value;
+  for (i = 0; i < count; i++) {
+    if (_skip(reader, depth + 1)) {
+      return -1;
+    }
+  }
+  return 0;
+}
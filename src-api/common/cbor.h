@@ -0,0 +1,218 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#ifndef _COMMON_CBOR_H
+#define _COMMON_CBOR_H
+
+#include "common/autobuf.h"
+#include "common/common_types.h"
+
+/**
+ * CBOR (RFC 7049) major types
+ */
+enum cbor_type
+{
+  /*! unsigned integer */
+  CBOR_TYPE_UINT = 0,
+
+  /*! negative integer */
+  CBOR_TYPE_NEGINT = 1,
+
+  /*! byte string */
+  CBOR_TYPE_BYTES = 2,
+
+  /*! UTF-8 text string */
+  CBOR_TYPE_TEXT = 3,
+
+  /*! array of data items */
+  CBOR_TYPE_ARRAY = 4,
+
+  /*! map of key/value pairs */
+  CBOR_TYPE_MAP = 5,
+
+  /*! semantic tag */
+  CBOR_TYPE_TAG = 6,
+
+  /*! simple values, floating point numbers and break code */
+  CBOR_TYPE_SIMPLE = 7,
+};
+
+/**
+ * CBOR simple values
+ */
+enum cbor_simple
+{
+  /*! boolean false */
+  CBOR_SIMPLE_FALSE = 20,
+
+  /*! boolean true */
+  CBOR_SIMPLE_TRUE = 21,
+
+  /*! null value */
+  CBOR_SIMPLE_NULL = 22,
+
+  /*! double precision floating point number */
+  CBOR_SIMPLE_DOUBLE = 27,
+
+  /*! end of an indefinite length array or map */
+  CBOR_SIMPLE_BREAK = 31,
+};
+
+/**
+ * A single decoded CBOR data item header
+ */
+struct cbor_item {
+  /*! major type of item */
+  enum cbor_type type;
+
+  /**
+   * integer value, length of a string, number of elements of an
+   * array/map, tag number or simple value
+   */
+  uint64_t value;
+
+  /*! true if item is an array or map with indefinite length */
+  bool indefinite;
+
+  /*! pointer to content of a byte or text string (not zero terminated) */
+  const char *data;
+
+  /*! value of a floating point number */
+  double number;
+};
+
+/**
+ * Iterator over a buffer of CBOR encoded data
+ */
+struct cbor_reader {
+  /*! pointer to encoded data */
+  const uint8_t *_buf;
+
+  /*! length of encoded data */
+  size_t _len;
+
+  /*! position of next item in encoded data */
+  size_t _offset;
+};
+
+EXPORT void cbor_add_uint(struct autobuf *out, uint64_t value);
+EXPORT void cbor_add_int(struct autobuf *out, int64_t value);
+EXPORT void cbor_add_text(struct autobuf *out, const char *text, size_t len);
+EXPORT void cbor_add_double(struct autobuf *out, double value);
+EXPORT void cbor_add_simple(struct autobuf *out, enum cbor_simple value);
+EXPORT void cbor_add_number_string(struct autobuf *out, const char *value);
+
+EXPORT void cbor_reader_init(struct cbor_reader *reader, const void *buf, size_t len);
+EXPORT int cbor_read(struct cbor_reader *reader, struct cbor_item *item);
+EXPORT int cbor_skip(struct cbor_reader *reader);
+
+/**
+ * Append a zero terminated string as CBOR text string
+ * @param out output buffer
+ * @param text zero terminated string
+ */
+static INLINE void
+cbor_add_string(struct autobuf *out, const char *text) {
+  cbor_add_text(out, text, strlen(text));
+}
+
+/**
+ * Append a CBOR boolean
+ * @param out output buffer
+ * @param value boolean value
+ */
+static INLINE void
+cbor_add_bool(struct autobuf *out, bool value) {
+  cbor_add_simple(out, value ? CBOR_SIMPLE_TRUE : CBOR_SIMPLE_FALSE);
+}
+
+/**
+ * Start a CBOR array with indefinite length,
+ * must be closed with cbor_add_break()
+ * @param out output buffer
+ */
+static INLINE void
+cbor_start_array(struct autobuf *out) {
+  abuf_append_uint8(out, (CBOR_TYPE_ARRAY << 5) | CBOR_SIMPLE_BREAK);
+}
+
+/**
+ * Start a CBOR map with indefinite length,
+ * must be closed with cbor_add_break()
+ * @param out output buffer
+ */
+static INLINE void
+cbor_start_map(struct autobuf *out) {
+  abuf_append_uint8(out, (CBOR_TYPE_MAP << 5) | CBOR_SIMPLE_BREAK);
+}
+
+/**
+ * Close a CBOR array or map with indefinite length
+ * @param out output buffer
+ */
+static INLINE void
+cbor_add_break(struct autobuf *out) {
+  cbor_add_simple(out, CBOR_SIMPLE_BREAK);
+}
+
+/**
+ * @param reader CBOR reader
+ * @return true if all data has been read
+ */
+static INLINE bool
+cbor_reader_is_done(struct cbor_reader *reader) {
+  return reader->_offset >= reader->_len;
+}
+
+/**
+ * @param item decoded CBOR item
+ * @return true if item is the end of an indefinite length array or map
+ */
+static INLINE bool
+cbor_is_break(struct cbor_item *item) {
+  return item->type == CBOR_TYPE_SIMPLE && item->value == CBOR_SIMPLE_BREAK;
+}
+
+#endif /* _COMMON_CBOR_H */
@@ -0,0 +1,115 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include "common/common_types.h"
+#include "common/histogram.h"
+
+/**
+ * Calculate the upper bound of a percentile of the values
+ * stored in a histogram
+ * @param hist histogram
+ * @param percent percentile (0-100)
+ * @return largest value of the bucket that contains the percentile,
+ *   but never more than the largest value added. 0 if the
+ *   histogram is empty.
+ */
+uint64_t
+histogram_get_percentile(const struct histogram *hist, unsigned percent) {
+  uint64_t target, sum, result;
+  size_t i;
+
+  if (hist->count == 0) {
+    return 0;
+  }
+  if (percent > 100) {
+    percent = 100;
+  }
+
+  /* number of values that must be smaller or equal, rounded up */
+  target = (hist->count * percent + 99) / 100;
+  if (target == 0) {
+    target = 1;
+  }
+
+  sum = 0;
+  for (i = 0; i < HISTOGRAM_BUCKETS; i++) {
+    sum += hist->buckets[i];
+    if (sum >= target) {
+      break;
+    }
+  }
+
+  result = histogram_get_bucket_max(i);
+  return result < hist->max ? result : hist->max;
+}
+
+/**
+ * @param idx index of histogram bucket
+ * @return smallest value counted in the bucket
+ */
+uint64_t
+histogram_get_bucket_min(size_t idx) {
+  unsigned bits;
+
+  if (idx < HISTOGRAM_SUB_BUCKETS) {
+    return idx;
+  }
+
+  bits = (idx >> HISTOGRAM_SUB_BITS) + HISTOGRAM_SUB_BITS - 1;
+  return (1ull << bits) + ((uint64_t)(idx & (HISTOGRAM_SUB_BUCKETS - 1)) << (bits - HISTOGRAM_SUB_BITS));
+}
+
+/**
+ * @param idx index of histogram bucket
+ * @return largest value counted in the bucket,
+ *   UINT64_MAX for the last bucket
+ */
+uint64_t
+histogram_get_bucket_max(size_t idx) {
+  if (idx >= HISTOGRAM_BUCKETS - 1) {
+    return UINT64_MAX;
+  }
+  return histogram_get_bucket_min(idx + 1) - 1;
+}
@@ -0,0 +1,124 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#ifndef _COMMON_HISTOGRAM_H
+#define _COMMON_HISTOGRAM_H
+
+#include "common/common_types.h"
+
+/*! number of bits of a value used for the linear part of a bucket index */
+#define HISTOGRAM_SUB_BITS 2
+
+/*! number of linear buckets between two powers of two */
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BITS)
+
+/*! values with this many significant bits or more are counted in the last bucket */
+#define HISTOGRAM_MAX_BITS 24
+
+/*! number of buckets of a histogram */
+#define HISTOGRAM_BUCKETS ((HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BITS + 1) << HISTOGRAM_SUB_BITS)
+
+/**
+ * Log-linear histogram. Every power of two is split into
+ * HISTOGRAM_SUB_BUCKETS linear buckets, so each bucket has a
+ * relative width of at most 1/HISTOGRAM_SUB_BUCKETS. Small values
+ * are counted exactly.
+ */
+struct histogram {
+  /*! number of values added */
+  uint64_t count;
+
+  /*! sum of all values added */
+  uint64_t sum;
+
+  /*! largest value added */
+  uint64_t max;
+
+  /*! number of values per bucket */
+  uint32_t buckets[HISTOGRAM_BUCKETS];
+};
+
+EXPORT uint64_t histogram_get_percentile(const struct histogram *hist, unsigned percent);
+EXPORT uint64_t histogram_get_bucket_min(size_t idx);
+EXPORT uint64_t histogram_get_bucket_max(size_t idx);
+
+/**
+ * @param value value to be added to a histogram
+ * @return index of the bucket the value belongs to
+ */
+static INLINE size_t
+histogram_get_bucket(uint64_t value) {
+  unsigned bits;
+
+  if (value < HISTOGRAM_SUB_BUCKETS) {
+    return value;
+  }
+
+  /* index of most significant bit */
+  bits = 63 - __builtin_clzll(value);
+  if (bits >= HISTOGRAM_MAX_BITS) {
+    return HISTOGRAM_BUCKETS - 1;
+  }
+
+  return ((bits - HISTOGRAM_SUB_BITS + 1) << HISTOGRAM_SUB_BITS)
+         + ((value >> (bits - HISTOGRAM_SUB_BITS)) & (HISTOGRAM_SUB_BUCKETS - 1));
+}
+
+/**
+ * Add a value to a histogram
+ * @param hist histogram
+ * @param value new value
+ */
+static INLINE void
+histogram_add(struct histogram *hist, uint64_t value) {
+  hist->buckets[histogram_get_bucket(value)]++;
+  hist->count++;
+  hist->sum += value;
+  if (value > hist->max) {
+    hist->max = value;
+  }
+}
+
+#endif /* _COMMON_HISTOGRAM_H */
@@ -44,13 +44,23 @@
  */
 
 #include "common/json.h"
+#include <stdarg.h>
+
 #include "common/autobuf.h"
+#include "common/autobuf_chain.h"
+#include "common/cbor.h"
 #include "common/common_types.h"
 #include "common/string.h"
 #include "common/template.h"
 
-static void _add_template(struct autobuf *out, bool brackets, struct abuf_template_data *data, size_t data_count);
-static void _json_printvalue(struct autobuf *out, const char *txt, bool delimiter);
+static void _add_template(
+  struct json_session *session, bool brackets, struct abuf_template_data *data, size_t data_count);
+static void _json_printvalue(struct json_session *session, const char *txt, bool delimiter);
+static void _memcpy(struct json_session *session, const void *p, size_t len);
+static void _puts(struct json_session *session, const char *s);
+static void _appendf(struct json_session *session, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+static void _add_cbor_template(struct autobuf *out, struct abuf_template_data *data, size_t data_count);
+static void _cbor_printvalue(struct autobuf *out, const char *txt, bool string);
 
 /**
  * Initialize the JSON session object for creating a nested JSON
@@ -65,6 +75,34 @@ json_init_session(struct json_session *session, struct autobuf *out) {
   session->empty = true;
 }
 
+/**
+ * Initialize the JSON session object for creating the same nested
+ * data structures encoded as CBOR. Objects and arrays become
+ * indefinite length maps and arrays.
+ * @param session JSON session
+ * @param out output buffer
+ */
+void
+json_init_cbor_session(struct json_session *session, struct autobuf *out) {
+  json_init_session(session, out);
+  session->cbor = true;
+}
+
+/**
+ * Initialize the JSON session object for creating a nested JSON
+ * string output in a chained autobuffer, so the output is never
+ * moved in memory while it grows. CBOR output still needs an
+ * autobuffer.
+ * @param session JSON session
+ * @param out chained output buffer
+ */
+void
+json_init_chain_session(struct json_session *session, struct abuf_chain *out) {
+  memset(session, 0, sizeof(*session));
+  session->chain = out;
+  session->empty = true;
+}
+
 /**
  * Starts a new JSON array
  * @param session JSON session
@@ -72,12 +110,19 @@ json_init_session(struct json_session *session, struct autobuf *out) {
  */
 void
 json_start_array(struct json_session *session, const char *name) {
+  if (session->cbor) {
+    session->empty = true;
+    cbor_add_string(session->out, name);
+    cbor_start_array(session->out);
+    return;
+  }
+
   if (!session->empty) {
-    abuf_puts(session->out, ",");
+    _puts(session, ",");
     session->empty = true;
   }
 
-  abuf_appendf(session->out, "\"%s\": [", name);
+  _appendf(session, "\"%s\": [", name);
 }
 
 /**
@@ -90,7 +135,11 @@ json_end_array(struct json_session *session) {
   /* close session */
   session->empty = false;
 
-  abuf_puts(session->out, "]");
+  if (session->cbor) {
+    cbor_add_break(session->out);
+    return;
+  }
+  _puts(session, "]");
 }
 
 /**
@@ -100,17 +149,26 @@ json_end_array(struct json_session *session) {
  */
 void
 json_start_object(struct json_session *session, const char *name) {
+  if (session->cbor) {
+    session->empty = true;
+    if (name) {
+      cbor_add_string(session->out, name);
+    }
+    cbor_start_map(session->out);
+    return;
+  }
+
   /* open new session */
   if (!session->empty) {
-    abuf_puts(session->out, ",");
+    _puts(session, ",");
     session->empty = true;
   }
 
   if (name) {
-    abuf_appendf(session->out, "\"%s\": {", name);
+    _appendf(session, "\"%s\": {", name);
   }
   else {
-    abuf_puts(session->out, "{");
+    _puts(session, "{");
   }
 }
 
@@ -123,13 +181,20 @@ json_start_object(struct json_session *session, const char *name) {
  */
 void
 json_print(struct json_session *session, const char *key, bool string, const char *value) {
+  if (session->cbor) {
+    session->empty = false;
+    cbor_add_string(session->out, key);
+    _cbor_printvalue(session->out, value, string);
+    return;
+  }
+
   if (!session->empty) {
-    abuf_puts(session->out, ",");
+    _puts(session, ",");
   }
   session->empty = false;
 
-  abuf_appendf(session->out, "\"%s\":", key);
-  _json_printvalue(session->out, value, string);
+  _appendf(session, "\"%s\":", key);
+  _json_printvalue(session, value, string);
 }
 
 /**
@@ -142,7 +207,11 @@ json_end_object(struct json_session *session) {
   /* close session */
   session->empty = false;
 
-  abuf_puts(session->out, "}");
+  if (session->cbor) {
+    cbor_add_break(session->out);
+    return;
+  }
+  _puts(session, "}");
 }
 
 /**
@@ -154,32 +223,78 @@ json_end_object(struct json_session *session) {
  */
 void
 json_print_templates(struct json_session *session, struct abuf_template_data *data, size_t count) {
+  if (session->cbor) {
+    session->empty = false;
+    _add_cbor_template(session->out, data, count);
+    return;
+  }
+
   if (session->empty) {
     session->empty = false;
-    abuf_puts(session->out, "\n");
+    _puts(session, "\n");
   }
   else {
-    abuf_puts(session->out, ",\n");
+    _puts(session, ",\n");
+  }
+
+  _add_template(session, false, data, count);
+}
+
+/**
+ * Initialize a resumable JSON generator
+ * @param generator json generator
+ * @param out output buffer
+ * @param chunk_size number of bytes to generate per run,
+ *   SIZE_MAX to generate the whole document in one run
+ * @param generate callback to generate the next part of the document
+ */
+void
+json_init_generator(struct json_generator *generator, struct autobuf *out, size_t chunk_size,
+  bool (*generate)(struct json_generator *generator)) {
+  memset(generator, 0, sizeof(*generator));
+  json_init_session(&generator->session, out);
+  generator->chunk_size = chunk_size;
+  generator->generate = generate;
+}
+
+/**
+ * Let a JSON generator append the next chunk of its document
+ * to the output buffer. The generate callback is called until
+ * the chunk is full or the document is complete.
+ * @param generator json generator
+ * @return true if the document is complete, false otherwise
+ */
+bool
+json_generator_run(struct json_generator *generator) {
+  if (generator->_finished) {
+    return true;
   }
 
-  _add_template(session->out, false, data, count);
+  generator->_chunk_start = json_get_length(&generator->session);
+  while (!json_generator_is_full(generator)) {
+    if (generator->generate(generator)) {
+      generator->_finished = true;
+      return true;
+    }
+  }
+  return false;
 }
 
 /**
  * Converts a key/value list for the template engine into
  * JSON compatible output.
- * @param out output buffer
+ * @param session JSON session
  * @param brackets true to add surrounding brackets and newlines
  * @param data array of template data
  * @param data_count number of template data entries
  */
 static void
-_add_template(struct autobuf *out, bool brackets, struct abuf_template_data *data, size_t data_count) {
+_add_template(struct json_session *session, bool brackets, struct abuf_template_data *data, size_t data_count) {
   bool first;
   size_t i, j;
 
   if (brackets) {
-    abuf_puts(out, "{");
+    _puts(session, "{");
   }
 
   first = true;
@@ -190,42 +305,42 @@ _add_template(struct autobuf *out, bool brackets, struct abuf_template_data *dat
       }
 
       if (!first) {
-        abuf_puts(out, ",\n");
+        _puts(session, ",\n");
       }
       else {
         first = false;
       }
 
-      abuf_appendf(out, "\"%s\":", data[i].data[j].key);
-      _json_printvalue(out, data[i].data[j].value, data[i].data[j].string);
+      _appendf(session, "\"%s\":", data[i].data[j].key);
+      _json_printvalue(session, data[i].data[j].value, data[i].data[j].string);
     }
 
     if (!first && brackets) {
-      abuf_puts(out, "\n");
+      _puts(session, "\n");
     }
   }
 
   if (brackets) {
-    abuf_puts(out, "}");
+    _puts(session, "}");
   }
 }
 
 /**
- * Prints a string to an autobuffer, using JSON escape rules
- * @param out pointer to output buffer
+ * Prints a string to the output of a JSON session, using JSON escape rules
+ * @param session JSON session
  * @param txt string to print
  * @param delimiter true if string must be enclosed in quotation marks
  */
 static void
-_json_printvalue(struct autobuf *out, const char *txt, bool delimiter) {
+_json_printvalue(struct json_session *session, const char *txt, bool delimiter) {
   const char *ptr;
   bool unprintable;
 
   if (delimiter) {
-    abuf_puts(out, "\"");
+    _puts(session, "\"");
   }
   else if (*txt == 0) {
-    abuf_puts(out, "0");
+    _puts(session, "0");
   }
 
   ptr = txt;
@@ -233,14 +348,14 @@ _json_printvalue(struct autobuf *out, const char *txt, bool delimiter) {
     unprintable = !str_char_is_printable(*ptr);
     if (unprintable || *ptr == '\\' || *ptr == '\"') {
       if (ptr != txt) {
-        abuf_memcpy(out, txt, ptr - txt);
+        _memcpy(session, txt, ptr - txt);
       }
 
       if (unprintable) {
-        abuf_appendf(out, "\\u00%02x", (unsigned char)(*ptr++));
+        _appendf(session, "\\u00%02x", (unsigned char)(*ptr++));
       }
       else {
-        abuf_appendf(out, "\\%c", *ptr++);
+        _appendf(session, "\\%c", *ptr++);
       }
       txt = ptr;
     }
@@ -249,8 +364,92 @@ _json_printvalue(struct autobuf *out, const char *txt, bool delimiter) {
     }
   }
 
-  abuf_puts(out, txt);
+  _puts(session, txt);
   if (delimiter) {
-    abuf_puts(out, "\"");
+    _puts(session, "\"");
+  }
+}
+
+/**
+ * Converts a key/value list for the template engine into
+ * CBOR map entries.
+ * @param out output buffer
+ * @param data array of template data
+ * @param data_count number of template data entries
+ */
+static void
+_add_cbor_template(struct autobuf *out, struct abuf_template_data *data, size_t data_count) {
+  size_t i, j;
+
+  for (i = 0; i < data_count; i++) {
+    for (j = 0; j < data[i].count; j++) {
+      if (data[i].data[j].value == NULL) {
+        continue;
+      }
+
+      cbor_add_string(out, data[i].data[j].key);
+      _cbor_printvalue(out, data[i].data[j].value, data[i].data[j].string);
+    }
+  }
+}
+
+/**
+ * Prints a value to an autobuffer as a CBOR item
+ * @param out pointer to output buffer
+ * @param txt value to print
+ * @param string true if value is a string, false if it is a number
+ */
+static void
+_cbor_printvalue(struct autobuf *out, const char *txt, bool string) {
+  if (string) {
+    cbor_add_string(out, txt);
+  }
+  else {
+    cbor_add_number_string(out, txt);
+  }
+}
+
+/**
+ * Append a memory block to the output buffer of a JSON session
+ * @param session JSON session
+ * @param p pointer to memory block
+ * @param len length of memory block
+ */
+static void
+_memcpy(struct json_session *session, const void *p, size_t len) {
+  if (session->chain) {
+    abuf_chain_memcpy(session->chain, p, len);
+  }
+  else {
+    abuf_memcpy(session->out, p, len);
+  }
+}
+
+/**
+ * Append a string to the output buffer of a JSON session
+ * @param session JSON session
+ * @param s zero terminated string
+ */
+static void
+_puts(struct json_session *session, const char *s) {
+  _memcpy(session, s, strlen(s));
+}
+
+/**
+ * printf()-style function that appends to the output buffer of a JSON session
+ * @param session JSON session
+ * @param fmt printf format string
+ */
+static void
+_appendf(struct json_session *session, const char *fmt, ...) {
+  va_list ap;
+
+  va_start(ap, fmt);
+  if (session->chain) {
+    abuf_chain_vappendf(session->chain, fmt, ap);
+  }
+  else {
+    abuf_vappendf(session->out, fmt, ap);
   }
+  va_end(ap);
 }
@@ -47,6 +47,7 @@
 #define JSON_H_
 
 #include "common/autobuf.h"
+#include "common/autobuf_chain.h"
 #include "common/common_types.h"
 #include "common/template.h"
 
@@ -57,11 +58,44 @@ struct json_session {
   /*! pointer to output buffer */
   struct autobuf *out;
 
+  /*! pointer to chained output buffer for JSON text, used instead of out if not NULL */
+  struct abuf_chain *chain;
+
   /*! true if we just started a new object/array */
   bool empty;
+
+  /*! true if output is encoded as CBOR (RFC 7049) instead of JSON text */
+  bool cbor;
+};
+
+/**
+ * resumable JSON generator that creates its output step by step,
+ * so a large document can be written in chunks
+ */
+struct json_generator {
+  /*! JSON session used for output */
+  struct json_session session;
+
+  /*! number of bytes the generator should produce per run */
+  size_t chunk_size;
+
+  /**
+   * Callback to generate the next part of the JSON document
+   * @param generator json generator
+   * @return true if the document is complete, false otherwise
+   */
+  bool (*generate)(struct json_generator *generator);
+
+  /*! length of the output buffer at the start of the current run */
+  size_t _chunk_start;
+
+  /*! true if the document is complete */
+  bool _finished;
 };
 
 EXPORT void json_init_session(struct json_session *, struct autobuf *out);
+EXPORT void json_init_cbor_session(struct json_session *, struct autobuf *out);
+EXPORT void json_init_chain_session(struct json_session *, struct abuf_chain *out);
 EXPORT void json_start_array(struct json_session *, const char *name);
 EXPORT void json_end_array(struct json_session *);
 EXPORT void json_start_object(struct json_session *, const char *name);
@@ -69,6 +103,29 @@ EXPORT void json_end_object(struct json_session *);
 EXPORT void json_print_templates(struct json_session *, struct abuf_template_data *data, size_t count);
 EXPORT void json_print(struct json_session *session, const char *key, bool string, const char *value);
 
+EXPORT void json_init_generator(struct json_generator *generator, struct autobuf *out, size_t chunk_size,
+  bool (*generate)(struct json_generator *generator));
+EXPORT bool json_generator_run(struct json_generator *generator);
+
+/**
+ * @param session JSON session
+ * @return number of bytes in the output buffer of the session
+ */
+static INLINE size_t
+json_get_length(struct json_session *session) {
+  return session->chain ? abuf_chain_getlen(session->chain) : abuf_getlen(session->out);
+}
+
+/**
+ * @param generator json generator
+ * @return true if the current run of the generator produced
+ *   at least one chunk of output
+ */
+static INLINE bool
+json_generator_is_full(struct json_generator *generator) {
+  return json_get_length(&generator->session) - generator->_chunk_start >= generator->chunk_size;
+}
+
 /**
  * Returns the JSON text representation of a boolean
  * @param value boolean value
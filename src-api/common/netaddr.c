@@ -59,7 +59,7 @@ static int _bin_from_hex(void *bin, size_t bin_size, const char *src, char separ
 static int _uuid_from_string(void *bin, size_t bin_size, const char *src);
 static int _subnetmask_to_prefixlen(const char *src);
 static int _read_hexdigit(const char c);
-static bool _binary_is_in_subnet(const struct netaddr *subnet, const void *bin);
+static bool _binary_is_in_subnet(const struct netaddr *subnet, const void *bin, size_t len);
 
 /* predefined network prefixes */
 
@@ -838,7 +838,7 @@ netaddr_binary_is_in_subnet(const struct netaddr *subnet, const void *bin, size_
   if (subnet->_type != af_family || netaddr_get_maxprefix(subnet) != len * 8) {
     return false;
   }
-  return _binary_is_in_subnet(subnet, bin);
+  return _binary_is_in_subnet(subnet, bin, len);
 }
 
 /**
@@ -853,7 +853,7 @@ netaddr_is_in_subnet(const struct netaddr *subnet, const struct netaddr *addr) {
   if (subnet->_type != addr->_type) {
     return false;
   }
-  return _binary_is_in_subnet(subnet, addr->_addr);
+  return _binary_is_in_subnet(subnet, addr->_addr, sizeof(addr->_addr));
 }
 
 /**
@@ -1194,29 +1194,38 @@ _subnetmask_to_prefixlen(const char *src) {
  * Calculates if a binary address is part of a netaddr prefix.
  * It will assume that the length of the binary address and its
  * address family makes sense.
+ * Both addresses are compared as two 64 bit words with a mask
+ * generated from the prefix length.
  * @param subnet netaddr prefix
  * @param bin pointer to binary address
+ * @param len length of binary address
  * @return true if part of the prefix, false otherwise
  */
 static bool
-_binary_is_in_subnet(const struct netaddr *subnet, const void *bin) {
-  size_t byte_length, bit_length;
+_binary_is_in_subnet(const struct netaddr *subnet, const void *bin, size_t len) {
+  uint8_t buffer[NETADDR_MAX_LENGTH];
+  uint64_t mask_hi, mask_lo, diff_hi, diff_lo;
   const uint8_t *_bin;
+  uint8_t prefix_len;
 
   _bin = bin;
-
-  /* split prefix length into whole bytes and bit rest */
-  byte_length = subnet->_prefix_len / 8;
-  bit_length = subnet->_prefix_len % 8;
-
-  /* compare whole bytes */
-  if (memcmp(subnet->_addr, bin, byte_length) != 0) {
-    return false;
+  if (len < sizeof(buffer)) {
+    /* copy shorter binaries so that we can read 16 bytes */
+    memset(buffer, 0, sizeof(buffer));
+    memcpy(buffer, bin, len);
+    _bin = buffer;
   }
 
-  /* compare bits if necessary */
-  if (bit_length != 0) {
-    return (subnet->_addr[byte_length] >> (8 - bit_length)) == (_bin[byte_length] >> (8 - bit_length));
+  prefix_len = subnet->_prefix_len;
+  if (prefix_len > 128) {
+    prefix_len = 128;
   }
-  return true;
+
+  /* generate mask for both halves of the binary */
+  mask_hi = prefix_len == 0 ? 0 : prefix_len >= 64 ? UINT64_MAX : UINT64_MAX << (64 - prefix_len);
+  mask_lo = prefix_len <= 64 ? 0 : prefix_len >= 128 ? UINT64_MAX : UINT64_MAX << (128 - prefix_len);
+
+  diff_hi = netaddr_read_be64(&subnet->_addr[0]) ^ netaddr_read_be64(&_bin[0]);
+  diff_lo = netaddr_read_be64(&subnet->_addr[8]) ^ netaddr_read_be64(&_bin[8]);
+  return ((diff_hi & mask_hi) | (diff_lo & mask_lo)) == 0;
 }
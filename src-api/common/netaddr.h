@@ -333,16 +333,63 @@ netaddr_from_binary(struct netaddr *dst, const void *binary, size_t len, uint8_t
   return netaddr_from_binary_prefix(dst, binary, len, addr_type, 255);
 }
 
+/**
+ * Reads 8 bytes of an address binary as a big endian integer,
+ * so that integer comparison gives the same order as memcmp()
+ * @param ptr pointer to binary data, no alignment required
+ * @return 64 bit integer
+ */
+static INLINE uint64_t
+netaddr_read_be64(const uint8_t *ptr) {
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  uint64_t value;
+
+  memcpy(&value, ptr, sizeof(value));
+  return __builtin_bswap64(value);
+#elif defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  uint64_t value;
+
+  memcpy(&value, ptr, sizeof(value));
+  return value;
+#else
+  uint64_t value;
+  size_t i;
+
+  value = 0;
+  for (i = 0; i < 8; i++) {
+    value = (value << 8) | ptr[i];
+  }
+  return value;
+#endif
+}
+
 /**
  * Compares two addresses.
- * Address type will be compared last.
+ * Address type will be compared last. The result has the same
+ * sign as a memcmp() over the whole netaddr struct.
  * @param a1 address 1
  * @param a2 address 2
  * @return >0 if a1>a2, <0 if a1<a2, 0 otherwise
  */
 static INLINE int
 netaddr_cmp(const struct netaddr *a1, const struct netaddr *a2) {
-  return memcmp(a1, a2, sizeof(*a1));
+  uint64_t w1, w2;
+
+  /* compare the address binary as two 64 bit words */
+  w1 = netaddr_read_be64(&a1->_addr[0]);
+  w2 = netaddr_read_be64(&a2->_addr[0]);
+  if (w1 == w2) {
+    w1 = netaddr_read_be64(&a1->_addr[8]);
+    w2 = netaddr_read_be64(&a2->_addr[8]);
+  }
+  if (w1 != w2) {
+    return w1 > w2 ? 1 : -1;
+  }
+
+  if (a1->_type != a2->_type) {
+    return (int)a1->_type - (int)a2->_type;
+  }
+  return (int)a1->_prefix_len - (int)a2->_prefix_len;
 }
 
 /**
@@ -46,9 +46,37 @@
 #include "common/common_types.h"
 #include "common/netaddr.h"
 #include "common/netaddr_acl.h"
+#include "common/netaddr_trie.h"
 #include "common/string.h"
 
+/**
+ * Flags of a trie node of an ACL
+ */
+struct _acl_flags {
+  /*! true if the prefix is part of the accept array */
+  bool accept;
+
+  /*! true if the prefix is part of the reject array */
+  bool reject;
+};
+
+/**
+ * Compiled form of the accept and reject arrays of an ACL
+ */
+struct netaddr_acl_trie {
+  /*! longest prefix match trie over both arrays */
+  struct netaddr_trie trie;
+
+  /*! flags of each trie node, allocated together with the trie */
+  struct _acl_flags *flags;
+};
+
 static bool _is_in_array(const struct netaddr *, size_t, const struct netaddr *);
+static void _compile_trie(struct netaddr_acl *acl);
+static void _free_trie(struct netaddr_acl *acl);
+static int _trie_insert(struct netaddr_acl_trie *trie, const struct netaddr *prefix, bool reject);
+static void _trie_lookup(
+  const struct netaddr_acl_trie *trie, const struct netaddr *addr, bool *in_accept, bool *in_reject);
 
 /**
  * Initialize an ACL object. It will contain no addresses on both
@@ -66,6 +94,7 @@ netaddr_acl_add(struct netaddr_acl *acl) {
  */
 void
 netaddr_acl_remove(struct netaddr_acl *acl) {
+  _free_trie(acl);
   free(acl->accept);
   free(acl->reject);
 
@@ -143,6 +172,8 @@ netaddr_acl_from_strarray(struct netaddr_acl *acl, const struct const_strarray *
       acl->accept_count++;
     }
   }
+
+  _compile_trie(acl);
   return 0;
 
 from_entry_error:
@@ -160,6 +191,7 @@ int
 netaddr_acl_copy(struct netaddr_acl *to, const struct netaddr_acl *from) {
   netaddr_acl_remove(to);
   memcpy(to, from, sizeof(*to));
+  to->_trie = NULL;
 
   if (to->accept_count) {
     to->accept = calloc(to->accept_count, sizeof(struct netaddr));
@@ -176,6 +208,8 @@ netaddr_acl_copy(struct netaddr_acl *to, const struct netaddr_acl *from) {
     }
     memcpy(to->reject, from->reject, to->reject_count * sizeof(struct netaddr));
   }
+
+  _compile_trie(to);
   return 0;
 }
 
@@ -187,6 +221,24 @@ netaddr_acl_copy(struct netaddr_acl *to, const struct netaddr_acl *from) {
  */
 bool
 netaddr_acl_check_accept(const struct netaddr_acl *acl, const struct netaddr *addr) {
+  bool in_accept, in_reject;
+
+  if (acl->_trie) {
+    /* one lookup answers both array checks */
+    _trie_lookup(acl->_trie, addr, &in_accept, &in_reject);
+
+    if (acl->reject_first && in_reject) {
+      return false;
+    }
+    if (in_accept) {
+      return true;
+    }
+    if (in_reject) {
+      return false;
+    }
+    return acl->accept_default;
+  }
+
   if (acl->reject_first) {
     if (_is_in_array(acl->reject, acl->reject_count, addr)) {
       return false;
@@ -252,3 +304,101 @@ _is_in_array(const struct netaddr *array, size_t length, const struct netaddr *a
   }
   return false;
 }
+
+/**
+ * Compile the accept and reject arrays of an ACL into a trie.
+ * Small ACLs and ACLs that cannot be compiled keep the linear search.
+ * @param acl pointer to ACL
+ */
+static void
+_compile_trie(struct netaddr_acl *acl) {
+  struct netaddr_acl_trie *trie;
+  struct netaddr_trie_node *nodes;
+  uint32_t capacity;
+  size_t i;
+
+  _free_trie(acl);
+
+  if (acl->accept_count + acl->reject_count < NETADDR_ACL_TRIE_MIN_PREFIXES) {
+    return;
+  }
+
+  capacity = netaddr_trie_get_capacity(acl->accept_count + acl->reject_count);
+  trie = calloc(1, sizeof(*trie) + capacity * (sizeof(struct netaddr_trie_node) + sizeof(struct _acl_flags)));
+  if (trie == NULL) {
+    return;
+  }
+  nodes = (struct netaddr_trie_node *)(trie + 1);
+  trie->flags = (struct _acl_flags *)(nodes + capacity);
+  netaddr_trie_init(&trie->trie, nodes, capacity);
+
+  for (i = 0; i < acl->accept_count; i++) {
+    if (_trie_insert(trie, &acl->accept[i], false)) {
+      free(trie);
+      return;
+    }
+  }
+  for (i = 0; i < acl->reject_count; i++) {
+    if (_trie_insert(trie, &acl->reject[i], true)) {
+      free(trie);
+      return;
+    }
+  }
+
+  acl->_trie = trie;
+}
+
+/**
+ * Free the trie of an ACL
+ * @param acl pointer to ACL
+ */
+static void
+_free_trie(struct netaddr_acl *acl) {
+  free(acl->_trie);
+  acl->_trie = NULL;
+}
+
+/**
+ * Insert a prefix of the accept or reject array into an ACL trie
+ * @param trie pointer to ACL trie
+ * @param prefix pointer to prefix
+ * @param reject true if prefix is part of the reject array
+ * @return -1 if the prefix cannot be stored in the trie, 0 otherwise
+ */
+static int
+_trie_insert(struct netaddr_acl_trie *trie, const struct netaddr *prefix, bool reject) {
+  uint32_t idx;
+
+  idx = netaddr_trie_insert(&trie->trie, prefix);
+  if (idx == NETADDR_TRIE_NONE) {
+    return -1;
+  }
+
+  if (reject) {
+    trie->flags[idx].reject = true;
+  }
+  else {
+    trie->flags[idx].accept = true;
+  }
+  return 0;
+}
+
+/**
+ * Lookup all prefixes of an ACL trie that contain an address
+ * @param trie pointer to ACL trie
+ * @param addr pointer to address
+ * @param in_accept set to true if a prefix of the accept array contains the address
+ * @param in_reject set to true if a prefix of the reject array contains the address
+ */
+static void
+_trie_lookup(const struct netaddr_acl_trie *trie, const struct netaddr *addr, bool *in_accept, bool *in_reject) {
+  uint32_t idx;
+
+  *in_accept = false;
+  *in_reject = false;
+
+  netaddr_trie_for_each_match(&trie->trie, addr, idx) {
+    *in_accept |= trie->flags[idx].accept;
+    *in_reject |= trie->flags[idx].reject;
+  }
+}
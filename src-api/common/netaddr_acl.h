@@ -69,6 +69,11 @@
 /*! text name for rejecting an address if no list matches */
 #define ACL_DEFAULT_REJECT "default_reject"
 
+/*! minimum number of prefixes before an ACL is compiled into a trie */
+#define NETADDR_ACL_TRIE_MIN_PREFIXES 8
+
+struct netaddr_acl_trie;
+
 /**
  * represents an netaddr access control list with white/blacklist
  */
@@ -93,6 +98,13 @@ struct netaddr_acl {
 
   /*! result of the check if neither of the arrays have a match */
   bool accept_default;
+
+  /**
+   * longest prefix match trie of both arrays, generated by
+   * netaddr_acl_from_strarray() and netaddr_acl_copy() for larger
+   * ACLs. NULL if the arrays are searched linear.
+   */
+  struct netaddr_acl_trie *_trie;
 };
 
 EXPORT void netaddr_acl_add(struct netaddr_acl *);
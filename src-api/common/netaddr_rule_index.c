@@ -0,0 +1,577 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/avl.h"
+#include "common/common_types.h"
+#include "common/list.h"
+#include "common/netaddr.h"
+#include "common/netaddr_acl.h"
+#include "common/netaddr_rule_index.h"
+#include "common/netaddr_trie.h"
+
+/**
+ * Rule positions stored at a trie node of a bucket
+ */
+struct _rule_prefix {
+  /*! positions of rules with this prefix in their accept array, sorted */
+  uint32_t *positions;
+
+  /*! number of rule positions */
+  uint32_t position_count;
+};
+
+/**
+ * Bucket for all rules with the same key and prefix length
+ */
+struct netaddr_rule_bucket {
+  /*! key and prefix length of the bucket */
+  int32_t id[2];
+
+  /*! positions of rules that accept addresses outside of their accept array, sorted */
+  uint32_t *wildcards;
+
+  /*! number of wildcard rules */
+  uint32_t wildcard_count;
+
+  /*! longest prefix match trie over the accept prefixes of the rules */
+  struct netaddr_trie trie;
+
+  /*! rule positions of each trie node */
+  struct _rule_prefix *prefixes;
+
+  /*! number of trie nodes the bucket needs */
+  uint32_t node_capacity;
+
+  /*! member of bucket tree of the index */
+  struct avl_node _node;
+};
+
+static int _rebuild(struct netaddr_rule_index *idx);
+static void _free_buckets(struct netaddr_rule_index *idx);
+static struct netaddr_rule_bucket *_get_bucket(struct netaddr_rule_index *idx, int32_t key, int32_t prefix_length);
+static void _add_lookup_bucket(
+  struct netaddr_rule_index *idx, struct netaddr_rule_iterator *iter, int32_t key, int32_t prefix_length);
+static int _add_position(uint32_t **array, uint32_t *count, uint32_t position);
+static int _trie_insert(struct netaddr_rule_bucket *bucket, const struct netaddr *prefix, uint32_t position);
+static uint32_t _get_lowest_position(const uint32_t *array, uint32_t count, uint32_t position);
+static uint32_t _get_next_position(struct netaddr_rule_iterator *iter);
+static struct netaddr_rule *_get_next_candidate(struct netaddr_rule_index *idx, struct netaddr_rule_iterator *iter);
+static struct netaddr_rule *_get_next_linear(struct netaddr_rule_index *idx, struct netaddr_rule_iterator *iter);
+static bool _rule_matches(const struct netaddr_rule *rule, int32_t key, const struct netaddr *dst);
+static int _avlcmp_bucket(const void *k1, const void *k2);
+
+/**
+ * Initialize an empty rule index
+ * @param idx pointer to rule index
+ */
+void
+netaddr_rule_index_init(struct netaddr_rule_index *idx) {
+  memset(idx, 0, sizeof(*idx));
+  list_init_head(&idx->_rules);
+  avl_init(&idx->_buckets, _avlcmp_bucket, false);
+}
+
+/**
+ * Remove all rules from an index and free its memory
+ * @param idx pointer to rule index
+ */
+void
+netaddr_rule_index_clear(struct netaddr_rule_index *idx) {
+  struct netaddr_rule *rule, *rule_it;
+
+  list_for_each_element_safe(&idx->_rules, rule, _node, rule_it) {
+    list_remove(&rule->_node);
+  }
+  idx->rule_count = 0;
+
+  _free_buckets(idx);
+  idx->_dirty = true;
+}
+
+/**
+ * Add a rule at the end of an index, it will be checked after
+ * all rules that are already part of the index.
+ * @param idx pointer to rule index
+ * @param rule pointer to rule
+ */
+void
+netaddr_rule_index_add(struct netaddr_rule_index *idx, struct netaddr_rule *rule) {
+  list_add_tail(&idx->_rules, &rule->_node);
+  idx->rule_count++;
+  idx->_dirty = true;
+}
+
+/**
+ * Remove a rule from an index
+ * @param idx pointer to rule index
+ * @param rule pointer to rule
+ */
+void
+netaddr_rule_index_remove(struct netaddr_rule_index *idx, struct netaddr_rule *rule) {
+  list_remove(&rule->_node);
+  idx->rule_count--;
+  idx->_dirty = true;
+}
+
+/**
+ * Signal that the ACL, key or prefix length of a rule inside
+ * the index has been changed
+ * @param idx pointer to rule index
+ */
+void
+netaddr_rule_index_changed(struct netaddr_rule_index *idx) {
+  idx->_dirty = true;
+}
+
+/**
+ * Start a lookup and get the first rule of an index that matches
+ * a destination
+ * @param idx pointer to rule index
+ * @param iter pointer to lookup state, initialized by this function
+ * @param key key of the lookup
+ * @param dst pointer to destination address
+ * @return first matching rule, NULL if no rule matches
+ */
+struct netaddr_rule *
+netaddr_rule_index_get_first(
+  struct netaddr_rule_index *idx, struct netaddr_rule_iterator *iter, int32_t key, const struct netaddr *dst) {
+  int32_t prefix_length;
+
+  if (idx->_dirty) {
+    idx->_linear = _rebuild(idx) != 0;
+    idx->_dirty = false;
+  }
+
+  memset(iter, 0, sizeof(*iter));
+  iter->key = key;
+  iter->dst = dst;
+  iter->_next = idx->_rules.next;
+
+  if (idx->_linear) {
+    return _get_next_linear(idx, iter);
+  }
+
+  prefix_length = netaddr_get_prefix_length(dst);
+
+  _add_lookup_bucket(idx, iter, key, prefix_length);
+  _add_lookup_bucket(idx, iter, key, NETADDR_RULE_ANY);
+  if (key != NETADDR_RULE_ANY) {
+    _add_lookup_bucket(idx, iter, NETADDR_RULE_ANY, prefix_length);
+    _add_lookup_bucket(idx, iter, NETADDR_RULE_ANY, NETADDR_RULE_ANY);
+  }
+  return _get_next_candidate(idx, iter);
+}
+
+/**
+ * Get the next rule of an index that matches the destination of a lookup
+ * @param idx pointer to rule index
+ * @param iter pointer to lookup state
+ * @return next matching rule, NULL if no further rule matches
+ */
+struct netaddr_rule *
+netaddr_rule_index_get_next(struct netaddr_rule_index *idx, struct netaddr_rule_iterator *iter) {
+  if (idx->_linear) {
+    return _get_next_linear(idx, iter);
+  }
+  return _get_next_candidate(idx, iter);
+}
+
+/**
+ * Recalculate the positions, buckets and tries of a rule index
+ * @param idx pointer to rule index
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_rebuild(struct netaddr_rule_index *idx) {
+  struct netaddr_rule *rule, **by_position;
+  struct netaddr_rule_bucket *bucket;
+  struct netaddr_trie_node *nodes;
+  uint32_t position;
+  size_t i;
+
+  _free_buckets(idx);
+
+  if (idx->rule_count == 0) {
+    return 0;
+  }
+
+  by_position = realloc(idx->_by_position, idx->rule_count * sizeof(*by_position));
+  if (!by_position) {
+    return -1;
+  }
+  idx->_by_position = by_position;
+
+  /* assign positions, create buckets and count their trie nodes */
+  position = 0;
+  list_for_each_element(&idx->_rules, rule, _node) {
+    rule->_position = position;
+    by_position[position++] = rule;
+
+    if (rule->acl->accept_count == 0 && !rule->acl->accept_default) {
+      /* rule cannot match anything */
+      continue;
+    }
+
+    bucket = _get_bucket(idx, rule->key, rule->prefix_length);
+    if (!bucket) {
+      return -1;
+    }
+
+    if (!rule->acl->accept_default) {
+      bucket->node_capacity += netaddr_trie_get_capacity(rule->acl->accept_count);
+    }
+  }
+
+  avl_for_each_element(&idx->_buckets, bucket, _node) {
+    nodes = NULL;
+    if (bucket->node_capacity > 0) {
+      nodes = calloc(bucket->node_capacity, sizeof(struct netaddr_trie_node));
+      bucket->prefixes = calloc(bucket->node_capacity, sizeof(struct _rule_prefix));
+      if (!nodes || !bucket->prefixes) {
+        free(nodes);
+        return -1;
+      }
+    }
+    netaddr_trie_init(&bucket->trie, nodes, bucket->node_capacity);
+  }
+
+  /*
+   * a rule accepting by default is checked for every destination, all
+   * other rules only for destinations inside one of their accept prefixes
+   */
+  list_for_each_element(&idx->_rules, rule, _node) {
+    if (rule->acl->accept_count == 0 && !rule->acl->accept_default) {
+      continue;
+    }
+
+    bucket = _get_bucket(idx, rule->key, rule->prefix_length);
+    if (rule->acl->accept_default) {
+      if (_add_position(&bucket->wildcards, &bucket->wildcard_count, rule->_position)) {
+        return -1;
+      }
+      continue;
+    }
+
+    for (i = 0; i < rule->acl->accept_count; i++) {
+      if (_trie_insert(bucket, &rule->acl->accept[i], rule->_position)) {
+        return -1;
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ * Free all buckets of a rule index
+ * @param idx pointer to rule index
+ */
+static void
+_free_buckets(struct netaddr_rule_index *idx) {
+  struct netaddr_rule_bucket *bucket, *bucket_it;
+  uint32_t i;
+
+  avl_for_each_element_safe(&idx->_buckets, bucket, _node, bucket_it) {
+    avl_remove(&idx->_buckets, &bucket->_node);
+
+    if (bucket->prefixes) {
+      for (i = 0; i < bucket->node_capacity; i++) {
+        free(bucket->prefixes[i].positions);
+      }
+    }
+    free(bucket->prefixes);
+    free(bucket->trie.nodes);
+    free(bucket->wildcards);
+    free(bucket);
+  }
+
+  if (idx->rule_count == 0) {
+    free(idx->_by_position);
+    idx->_by_position = NULL;
+  }
+}
+
+/**
+ * Get the bucket for a key/prefix length combination,
+ * create it if necessary
+ * @param idx pointer to rule index
+ * @param key key of rule
+ * @param prefix_length prefix length of rule
+ * @return pointer to bucket, NULL if out of memory
+ */
+static struct netaddr_rule_bucket *
+_get_bucket(struct netaddr_rule_index *idx, int32_t key, int32_t prefix_length) {
+  struct netaddr_rule_bucket *bucket;
+  int32_t id[2];
+
+  id[0] = key;
+  id[1] = prefix_length;
+
+  bucket = avl_find_element(&idx->_buckets, id, bucket, _node);
+  if (bucket) {
+    return bucket;
+  }
+
+  bucket = calloc(1, sizeof(*bucket));
+  if (!bucket) {
+    return NULL;
+  }
+
+  bucket->id[0] = key;
+  bucket->id[1] = prefix_length;
+  bucket->_node.key = bucket->id;
+  avl_insert(&idx->_buckets, &bucket->_node);
+  return bucket;
+}
+
+/**
+ * Add the bucket for a key/prefix length combination to a lookup
+ * if it exists
+ * @param idx pointer to rule index
+ * @param iter pointer to lookup state
+ * @param key key of bucket
+ * @param prefix_length prefix length of bucket
+ */
+static void
+_add_lookup_bucket(
+  struct netaddr_rule_index *idx, struct netaddr_rule_iterator *iter, int32_t key, int32_t prefix_length) {
+  struct netaddr_rule_bucket *bucket;
+  int32_t id[2];
+
+  id[0] = key;
+  id[1] = prefix_length;
+
+  bucket = avl_find_element(&idx->_buckets, id, bucket, _node);
+  if (bucket) {
+    iter->_buckets[iter->_bucket_count++] = bucket;
+  }
+}
+
+/**
+ * Append a rule position to an array
+ * @param array pointer to array pointer
+ * @param count pointer to number of elements in array
+ * @param position rule position
+ * @return -1 if out of memory, 0 otherwise
+ */
+static int
+_add_position(uint32_t **array, uint32_t *count, uint32_t position) {
+  uint32_t *ptr;
+
+  if (*count > 0 && (*array)[*count - 1] == position) {
+    /* rule has the same prefix twice */
+    return 0;
+  }
+
+  ptr = realloc(*array, (*count + 1) * sizeof(uint32_t));
+  if (!ptr) {
+    return -1;
+  }
+  ptr[(*count)++] = position;
+  *array = ptr;
+  return 0;
+}
+
+/**
+ * Insert an accept prefix of a rule into the trie of a bucket
+ * @param bucket pointer to bucket
+ * @param prefix pointer to prefix
+ * @param position position of rule
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_trie_insert(struct netaddr_rule_bucket *bucket, const struct netaddr *prefix, uint32_t position) {
+  struct _rule_prefix *rule_prefix;
+  uint32_t idx;
+
+  idx = netaddr_trie_insert(&bucket->trie, prefix);
+  if (idx == NETADDR_TRIE_NONE) {
+    return -1;
+  }
+
+  rule_prefix = &bucket->prefixes[idx];
+  return _add_position(&rule_prefix->positions, &rule_prefix->position_count, position);
+}
+
+/**
+ * @param array sorted array of rule positions
+ * @param count number of elements in array
+ * @param position lowest acceptable position
+ * @return lowest position of the array not below the acceptable one,
+ *   UINT32_MAX if there is none
+ */
+static uint32_t
+_get_lowest_position(const uint32_t *array, uint32_t count, uint32_t position) {
+  uint32_t low, high, mid;
+
+  low = 0;
+  high = count;
+  while (low < high) {
+    mid = low + (high - low) / 2;
+    if (array[mid] < position) {
+      low = mid + 1;
+    }
+    else {
+      high = mid;
+    }
+  }
+  return low < count ? array[low] : UINT32_MAX;
+}
+
+/**
+ * Get the position of the next rule that might match the destination
+ * of a lookup, only its ACL remains to be checked
+ * @param iter pointer to lookup state
+ * @return rule position, UINT32_MAX if there is no further candidate
+ */
+static uint32_t
+_get_next_position(struct netaddr_rule_iterator *iter) {
+  struct netaddr_rule_bucket *bucket;
+  struct _rule_prefix *rule_prefix;
+  uint32_t i, node, position, best;
+
+  best = UINT32_MAX;
+  for (i = 0; i < iter->_bucket_count; i++) {
+    bucket = iter->_buckets[i];
+
+    position = _get_lowest_position(bucket->wildcards, bucket->wildcard_count, iter->_position);
+    if (position < best) {
+      best = position;
+    }
+
+    /* check the rules of all prefixes containing the destination */
+    netaddr_trie_for_each_match(&bucket->trie, iter->dst, node) {
+      rule_prefix = &bucket->prefixes[node];
+      position = _get_lowest_position(rule_prefix->positions, rule_prefix->position_count, iter->_position);
+      if (position < best) {
+        best = position;
+      }
+    }
+  }
+  return best;
+}
+
+/**
+ * Get the next candidate of a lookup accepted by its rule ACL
+ * @param idx pointer to rule index
+ * @param iter pointer to lookup state
+ * @return pointer to rule, NULL if no further rule matches
+ */
+static struct netaddr_rule *
+_get_next_candidate(struct netaddr_rule_index *idx, struct netaddr_rule_iterator *iter) {
+  struct netaddr_rule *rule;
+  uint32_t position;
+
+  while ((position = _get_next_position(iter)) != UINT32_MAX) {
+    iter->_position = position + 1;
+
+    rule = idx->_by_position[position];
+    if (netaddr_acl_check_accept(rule->acl, iter->dst)) {
+      return rule;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Get the next matching rule of a lookup by searching the rule list
+ * @param idx pointer to rule index
+ * @param iter pointer to lookup state
+ * @return pointer to rule, NULL if no further rule matches
+ */
+static struct netaddr_rule *
+_get_next_linear(struct netaddr_rule_index *idx, struct netaddr_rule_iterator *iter) {
+  struct netaddr_rule *rule;
+
+  while (iter->_next != &idx->_rules) {
+    rule = container_of(iter->_next, struct netaddr_rule, _node);
+    iter->_next = iter->_next->next;
+
+    if (_rule_matches(rule, iter->key, iter->dst)) {
+      return rule;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Check if a rule matches a destination
+ * @param rule pointer to rule
+ * @param key key of the lookup
+ * @param dst pointer to destination
+ * @return true if rule matches
+ */
+static bool
+_rule_matches(const struct netaddr_rule *rule, int32_t key, const struct netaddr *dst) {
+  if (rule->key != NETADDR_RULE_ANY && rule->key != key) {
+    return false;
+  }
+  if (rule->prefix_length != NETADDR_RULE_ANY && rule->prefix_length != netaddr_get_prefix_length(dst)) {
+    return false;
+  }
+  return netaddr_acl_check_accept(rule->acl, dst);
+}
+
+/**
+ * AVL comparator for bucket ids (key and prefix length)
+ * @param k1 pointer to first id
+ * @param k2 pointer to second id
+ * @return -1/0/1 depending on comparison of both ids
+ */
+static int
+_avlcmp_bucket(const void *k1, const void *k2) {
+  const int32_t *id1 = k1;
+  const int32_t *id2 = k2;
+
+  if (id1[0] != id2[0]) {
+    return id1[0] < id2[0] ? -1 : 1;
+  }
+  if (id1[1] != id2[1]) {
+    return id1[1] < id2[1] ? -1 : 1;
+  }
+  return 0;
+}
@@ -0,0 +1,155 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#ifndef NETADDR_RULE_INDEX_H_
+#define NETADDR_RULE_INDEX_H_
+
+#include "common/avl.h"
+#include "common/common_types.h"
+#include "common/list.h"
+#include "common/netaddr.h"
+#include "common/netaddr_acl.h"
+
+/*! wildcard value for the key and prefix length of a rule */
+#define NETADDR_RULE_ANY -1
+
+/**
+ * A rule that matches destinations by an ACL, an integer key
+ * (e.g. a routing domain) and the prefix length of the destination.
+ */
+struct netaddr_rule {
+  /*! ACL the destination must be accepted by */
+  const struct netaddr_acl *acl;
+
+  /*! key the rule is restricted to, NETADDR_RULE_ANY for all keys */
+  int32_t key;
+
+  /*! prefix length the rule is restricted to, NETADDR_RULE_ANY for all */
+  int32_t prefix_length;
+
+  /*! position of the rule in the index, lower positions match first */
+  uint32_t _position;
+
+  /*! member of the ordered rule list of the index */
+  struct list_entity _node;
+};
+
+struct netaddr_rule_bucket;
+
+/**
+ * Index of rules for fast classification of destinations.
+ * Rules are bucketed by key and prefix length, each bucket has a
+ * longest prefix match trie over the accept prefixes of the rule ACLs.
+ * The index is rebuilt during the first lookup after a change.
+ */
+struct netaddr_rule_index {
+  /*! list of rules in matching order */
+  struct list_entity _rules;
+
+  /*! number of rules in index */
+  uint32_t rule_count;
+
+  /*! true if the compiled index must be rebuilt */
+  bool _dirty;
+
+  /*! true if the index could not be built, lookups will scan the list */
+  bool _linear;
+
+  /*! tree of buckets by key and prefix length */
+  struct avl_tree _buckets;
+
+  /*! array of rules by position */
+  struct netaddr_rule **_by_position;
+};
+
+/**
+ * State of a single lookup in a rule index. It is provided by the
+ * caller, so lookups of the same index can be nested.
+ */
+struct netaddr_rule_iterator {
+  /*! key of the lookup */
+  int32_t key;
+
+  /*! destination of the lookup */
+  const struct netaddr *dst;
+
+  /*! buckets that can contain rules matching the lookup */
+  struct netaddr_rule_bucket *_buckets[4];
+
+  /*! number of used buckets */
+  uint32_t _bucket_count;
+
+  /*! lowest rule position that has not been checked yet */
+  uint32_t _position;
+
+  /*! next rule to check if the index is searched linear */
+  struct list_entity *_next;
+};
+
+EXPORT void netaddr_rule_index_init(struct netaddr_rule_index *idx);
+EXPORT void netaddr_rule_index_clear(struct netaddr_rule_index *idx);
+EXPORT void netaddr_rule_index_add(struct netaddr_rule_index *idx, struct netaddr_rule *rule);
+EXPORT void netaddr_rule_index_remove(struct netaddr_rule_index *idx, struct netaddr_rule *rule);
+EXPORT void netaddr_rule_index_changed(struct netaddr_rule_index *idx);
+EXPORT struct netaddr_rule *netaddr_rule_index_get_first(
+  struct netaddr_rule_index *idx, struct netaddr_rule_iterator *iter, int32_t key, const struct netaddr *dst);
+EXPORT struct netaddr_rule *netaddr_rule_index_get_next(
+  struct netaddr_rule_index *idx, struct netaddr_rule_iterator *iter);
+
+/**
+ * Loop over all rules of an index matching a destination, in the
+ * order they were added to the index. The index must not be
+ * changed during the loop.
+ * @param idx pointer to rule index
+ * @param iter pointer to netaddr_rule_iterator for the lookup state
+ * @param key key of the lookup
+ * @param dst pointer to destination address
+ * @param rule pointer to netaddr_rule for the matching rules
+ */
+#define netaddr_rule_index_for_each_match(idx, iter, key, dst, rule)                                                   \
+  for (rule = netaddr_rule_index_get_first(idx, iter, key, dst); rule != NULL;                                         \
+       rule = netaddr_rule_index_get_next(idx, iter))
+
+#endif /* NETADDR_RULE_INDEX_H_ */
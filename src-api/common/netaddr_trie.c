@@ -0,0 +1,235 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <string.h>
+
+#include "common/common_types.h"
+#include "common/netaddr.h"
+#include "common/netaddr_trie.h"
+
+static uint32_t _add_node(struct netaddr_trie *trie, const struct netaddr *prefix, uint8_t len);
+static int _get_bit(const struct netaddr *addr, uint8_t bit);
+static uint8_t _get_common_bits(const struct netaddr *addr1, const struct netaddr *addr2, uint8_t max_len);
+
+/**
+ * Initialize an empty trie
+ * @param trie pointer to trie
+ * @param nodes pointer to array of trie nodes
+ * @param capacity number of nodes in array
+ */
+void
+netaddr_trie_init(struct netaddr_trie *trie, struct netaddr_trie_node *nodes, uint32_t capacity) {
+  memset(trie, 0, sizeof(*trie));
+  trie->nodes = nodes;
+  trie->node_capacity = capacity;
+}
+
+/**
+ * Insert a prefix into a trie
+ * @param trie pointer to trie
+ * @param prefix pointer to prefix
+ * @return index of the node of the prefix, NETADDR_TRIE_NONE if the
+ *   prefix cannot be stored in the trie
+ */
+uint32_t
+netaddr_trie_insert(struct netaddr_trie *trie, const struct netaddr *prefix) {
+  struct netaddr_trie_node *node;
+  uint32_t *ref, idx, leaf;
+  uint8_t len, common;
+  size_t i;
+
+  len = netaddr_get_prefix_length(prefix);
+  if (len > netaddr_get_maxprefix(prefix)) {
+    return NETADDR_TRIE_NONE;
+  }
+
+  /* an insert adds at most two nodes */
+  if (trie->node_count + 2 > trie->node_capacity) {
+    return NETADDR_TRIE_NONE;
+  }
+
+  /* find root for address family */
+  for (i = 0; i < trie->family_count; i++) {
+    if (trie->af_type[i] == netaddr_get_address_family(prefix)) {
+      break;
+    }
+  }
+  if (i == trie->family_count) {
+    if (i == NETADDR_TRIE_MAX_FAMILIES) {
+      return NETADDR_TRIE_NONE;
+    }
+    trie->af_type[i] = netaddr_get_address_family(prefix);
+    trie->root[i] = NETADDR_TRIE_NONE;
+    trie->family_count++;
+  }
+
+  leaf = NETADDR_TRIE_NONE;
+  ref = &trie->root[i];
+  while (*ref != NETADDR_TRIE_NONE) {
+    node = &trie->nodes[*ref];
+    common = _get_common_bits(&node->prefix, prefix, len < node->prefix._prefix_len ? len : node->prefix._prefix_len);
+
+    if (common < node->prefix._prefix_len) {
+      /* prefix leaves the path of the node, split it */
+      idx = _add_node(trie, prefix, common);
+      trie->nodes[idx].child[_get_bit(&node->prefix, common)] = *ref;
+
+      if (common == len) {
+        /* the new branching point is the prefix itself */
+        leaf = idx;
+      }
+      else {
+        leaf = _add_node(trie, prefix, len);
+        trie->nodes[idx].child[_get_bit(prefix, common)] = leaf;
+      }
+      *ref = idx;
+      break;
+    }
+
+    if (node->prefix._prefix_len == len) {
+      /* prefix already in trie */
+      leaf = *ref;
+      break;
+    }
+    ref = &node->child[_get_bit(prefix, node->prefix._prefix_len)];
+  }
+
+  if (leaf == NETADDR_TRIE_NONE) {
+    leaf = _add_node(trie, prefix, len);
+    *ref = leaf;
+  }
+  return leaf;
+}
+
+/**
+ * Get the shortest prefix of a trie containing an address
+ * @param trie pointer to trie
+ * @param addr pointer to address
+ * @return index of trie node, NETADDR_TRIE_NONE if no prefix contains the address
+ */
+uint32_t
+netaddr_trie_get_first_match(const struct netaddr_trie *trie, const struct netaddr *addr) {
+  size_t i;
+
+  for (i = 0; i < trie->family_count; i++) {
+    if (trie->af_type[i] == netaddr_get_address_family(addr)) {
+      if (!netaddr_is_in_subnet(&trie->nodes[trie->root[i]].prefix, addr)) {
+        return NETADDR_TRIE_NONE;
+      }
+      return trie->root[i];
+    }
+  }
+  return NETADDR_TRIE_NONE;
+}
+
+/**
+ * Get the next longer prefix of a trie containing an address
+ * @param trie pointer to trie
+ * @param addr pointer to address
+ * @param idx index of the last trie node containing the address
+ * @return index of trie node, NETADDR_TRIE_NONE if no longer prefix contains the address
+ */
+uint32_t
+netaddr_trie_get_next_match(const struct netaddr_trie *trie, const struct netaddr *addr, uint32_t idx) {
+  const struct netaddr_trie_node *node;
+
+  node = &trie->nodes[idx];
+  if (node->prefix._prefix_len >= netaddr_get_maxprefix(addr)) {
+    return NETADDR_TRIE_NONE;
+  }
+
+  idx = node->child[_get_bit(addr, node->prefix._prefix_len)];
+  if (idx == NETADDR_TRIE_NONE || !netaddr_is_in_subnet(&trie->nodes[idx].prefix, addr)) {
+    return NETADDR_TRIE_NONE;
+  }
+  return idx;
+}
+
+/**
+ * Add a new node to a trie
+ * @param trie pointer to trie
+ * @param prefix pointer to prefix of new node
+ * @param len prefix length of new node
+ * @return index of new node
+ */
+static uint32_t
+_add_node(struct netaddr_trie *trie, const struct netaddr *prefix, uint8_t len) {
+  struct netaddr_trie_node *node;
+
+  node = &trie->nodes[trie->node_count];
+  memcpy(&node->prefix, prefix, sizeof(*prefix));
+  node->prefix._prefix_len = len;
+  node->child[0] = NETADDR_TRIE_NONE;
+  node->child[1] = NETADDR_TRIE_NONE;
+  return trie->node_count++;
+}
+
+/**
+ * @param addr pointer to address
+ * @param bit index of bit, 0 is the most significant bit
+ * @return value of bit
+ */
+static int
+_get_bit(const struct netaddr *addr, uint8_t bit) {
+  return (addr->_addr[bit / 8] >> (7 - (bit & 7))) & 1;
+}
+
+/**
+ * @param addr1 pointer to first address
+ * @param addr2 pointer to second address
+ * @param max_len maximum number of bits to compare
+ * @return number of leading bits both addresses have in common
+ */
+static uint8_t
+_get_common_bits(const struct netaddr *addr1, const struct netaddr *addr2, uint8_t max_len) {
+  uint8_t bit;
+
+  for (bit = 0; bit < max_len; bit++) {
+    if (_get_bit(addr1, bit) != _get_bit(addr2, bit)) {
+      break;
+    }
+  }
+  return bit;
+}
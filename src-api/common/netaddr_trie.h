@@ -0,0 +1,123 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#ifndef NETADDR_TRIE_H_
+#define NETADDR_TRIE_H_
+
+#include "common/common_types.h"
+#include "common/netaddr.h"
+
+/*! marker for a missing trie node */
+#define NETADDR_TRIE_NONE UINT32_MAX
+
+/*! maximum number of address families in a trie */
+#define NETADDR_TRIE_MAX_FAMILIES 5
+
+/**
+ * Node of a prefix trie. Nodes that were not inserted as a prefix
+ * are branching points of the path compressed trie. Users of the trie
+ * keep their data for a node in an array indexed like the node array.
+ */
+struct netaddr_trie_node {
+  /*! prefix of the node, the prefix length is the depth of the node */
+  struct netaddr prefix;
+
+  /*! indices of the child nodes for the next bit being 0 or 1 */
+  uint32_t child[2];
+};
+
+/**
+ * Binary path compressed longest prefix match trie over a fixed
+ * array of nodes, one root per address family. Used as the compiled
+ * form of netaddr ACLs and netaddr rule indices.
+ */
+struct netaddr_trie {
+  /*! address family of each root node */
+  uint8_t af_type[NETADDR_TRIE_MAX_FAMILIES];
+
+  /*! index of root node for each address family */
+  uint32_t root[NETADDR_TRIE_MAX_FAMILIES];
+
+  /*! number of used address families */
+  size_t family_count;
+
+  /*! array of trie nodes, provided by the user of the trie */
+  struct netaddr_trie_node *nodes;
+
+  /*! number of used trie nodes */
+  uint32_t node_count;
+
+  /*! number of nodes in the node array */
+  uint32_t node_capacity;
+};
+
+EXPORT void netaddr_trie_init(struct netaddr_trie *trie, struct netaddr_trie_node *nodes, uint32_t capacity);
+EXPORT uint32_t netaddr_trie_insert(struct netaddr_trie *trie, const struct netaddr *prefix);
+EXPORT uint32_t netaddr_trie_get_first_match(const struct netaddr_trie *trie, const struct netaddr *addr);
+EXPORT uint32_t netaddr_trie_get_next_match(const struct netaddr_trie *trie, const struct netaddr *addr, uint32_t idx);
+
+/**
+ * @param prefix_count number of prefixes that will be inserted
+ * @return number of nodes a trie needs for the prefixes
+ */
+static INLINE uint32_t
+netaddr_trie_get_capacity(size_t prefix_count) {
+  /* each prefix adds at most one leaf and one branching node */
+  return (uint32_t)(2 * prefix_count);
+}
+
+/**
+ * Loop over the indices of all trie nodes containing an address,
+ * from the shortest to the longest prefix. Includes branching
+ * points that were not inserted as a prefix.
+ * @param trie pointer to trie
+ * @param addr pointer to address
+ * @param idx uint32_t variable for the node index
+ */
+#define netaddr_trie_for_each_match(trie, addr, idx)                                                                   \
+  for (idx = netaddr_trie_get_first_match(trie, addr); idx != NETADDR_TRIE_NONE;                                       \
+       idx = netaddr_trie_get_next_match(trie, addr, idx))
+
+#endif /* NETADDR_TRIE_H_ */
@@ -47,12 +47,17 @@
 #include <stdlib.h>
 
 #include "common/autobuf.h"
+#include "common/autobuf_chain.h"
 #include "common/common_types.h"
 #include "common/string.h"
 #include "common/template.h"
 
 static struct abuf_template_data_entry *_find_template(
   struct abuf_template_data *set, size_t set_count, const char *txt, size_t txtLength);
+static void _add_template(void *out, void (*write)(void *out, const char *p, size_t len),
+  struct abuf_template_storage *storage, bool keys);
+static void _write_autobuf(void *out, const char *p, size_t len);
+static void _write_chain(void *out, const char *p, size_t len);
 
 /**
  * Initialize an index table for a template engine.
@@ -147,8 +152,36 @@ abuf_template_init_ext(
  */
 void
 abuf_add_template(struct autobuf *out, struct abuf_template_storage *storage, bool keys) {
+  _add_template(out, _write_autobuf, storage, keys);
+}
+
+/**
+ * Append the result of a template engine into a chained autobuffer.
+ * Each usage of a key will be replaced with the corresponding
+ * value.
+ * @param out pointer to chained autobuffer
+ * @param storage pointer to template storage object
+ * @param keys true if the engine should leave the keys in there,
+ *   false to insert the values.
+ */
+void
+abuf_chain_add_template(struct abuf_chain *out, struct abuf_template_storage *storage, bool keys) {
+  _add_template(out, _write_chain, storage, keys);
+}
+
+/**
+ * Run the template engine and hand the resulting text pieces to a writer
+ * @param out pointer to output buffer
+ * @param write callback to append a memory block to the output buffer
+ * @param storage pointer to template storage object
+ * @param keys true if the engine should leave the keys in there,
+ *   false to insert the values.
+ */
+static void
+_add_template(void *out, void (*write)(void *out, const char *p, size_t len),
+  struct abuf_template_storage *storage, bool keys) {
   struct abuf_template_storage_entry *entry;
-  size_t i, last = 0;
+  size_t i, last = 0, len;
   const char *value;
 
   for (i = 0; i < storage->count; i++) {
@@ -156,7 +189,7 @@ abuf_add_template(struct autobuf *out, struct abuf_template_storage *storage, bo
 
     /* copy prefix text */
     if (last < entry->start) {
-      abuf_memcpy(out, &storage->format[last], entry->start - last);
+      write(out, &storage->format[last], entry->start - last);
     }
 
     if (keys) {
@@ -166,16 +199,39 @@ abuf_add_template(struct autobuf *out, struct abuf_template_storage *storage, bo
       value = entry->data->value;
     }
     if (value) {
-      abuf_puts(out, value);
+      write(out, value, strlen(value));
     }
     last = entry->end;
   }
 
-  if (last < strlen(storage->format)) {
-    abuf_puts(out, &storage->format[last]);
+  len = strlen(storage->format);
+  if (last < len) {
+    write(out, &storage->format[last], len - last);
   }
 }
 
+/**
+ * Template engine writer for autobuffers
+ * @param out pointer to autobuffer
+ * @param p pointer to memory block
+ * @param len length of memory block
+ */
+static void
+_write_autobuf(void *out, const char *p, size_t len) {
+  abuf_memcpy(out, p, len);
+}
+
+/**
+ * Template engine writer for chained autobuffers
+ * @param out pointer to chained autobuffer
+ * @param p pointer to memory block
+ * @param len length of memory block
+ */
+static void
+_write_chain(void *out, const char *p, size_t len) {
+  abuf_chain_memcpy(out, p, len);
+}
+
 /**
  * Find the template data corresponding to a key
  * @param set pointer to template data array
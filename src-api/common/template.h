@@ -47,6 +47,7 @@
 #define TEMPLATE_H_
 
 #include "common/autobuf.h"
+#include "common/autobuf_chain.h"
 #include "common/common_types.h"
 
 /*! text name for json boolean true value */
@@ -121,6 +122,7 @@ struct abuf_template_storage {
 EXPORT void abuf_template_init_ext(
   struct abuf_template_storage *storage, struct abuf_template_data *data, size_t data_count, const char *format);
 EXPORT void abuf_add_template(struct autobuf *out, struct abuf_template_storage *storage, bool keys);
+EXPORT void abuf_chain_add_template(struct abuf_chain *out, struct abuf_template_storage *storage, bool keys);
 
 /**
  * Helper function to initialize a template with
@@ -1423,4 +1423,23 @@ cfg_schema_find_section_entry(struct cfg_schema_section *section, const char *na
   return NULL;
 }
 
+/**
+ * Checks if one of a consecutive set of schema entries changed.
+ * Only valid during the call of a cb_delta_handler.
+ * @param entries pointer to first schema entry
+ * @param count number of schema entries to check
+ * @return true if at least one of the entries changed
+ */
+static INLINE bool
+cfg_schema_entries_changed(const struct cfg_schema_entry *entries, size_t count) {
+  size_t i;
+
+  for (i = 0; i < count; i++) {
+    if (entries[i].delta_changed) {
+      return true;
+    }
+  }
+  return false;
+}
+
 #endif /* CFG_SCHEMA_H_ */
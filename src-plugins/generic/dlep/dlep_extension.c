@@ -57,6 +57,12 @@
 #include "dlep/dlep_writer.h"
 
 static int _process_interface_specific_update(struct dlep_extension *ext, struct dlep_session *session);
+static struct oonf_layer2_data *_get_neigh_data(
+  const struct dlep_neighbor_mapping *map, struct oonf_layer2_neigh *l2neigh);
+static bool _is_neigh_value_changed(const struct dlep_neighbor_mapping *map, const struct dlep_local_neighbor *local,
+  const struct oonf_layer2_data *l2data);
+static void _set_neigh_value_sent(
+  const struct dlep_neighbor_mapping *map, struct dlep_local_neighbor *local, const struct oonf_layer2_data *l2data);
 
 static struct avl_tree _extension_tree;
 
@@ -347,7 +353,10 @@ dlep_extension_radio_write_session_update(
 
 /**
  * Generate destination up/update for DLEP extension
- * by automatically mapping oonf_layer2_data to DLEP TLVs
+ * by automatically mapping oonf_layer2_data to DLEP TLVs.
+ * Destination updates only contain the metrics that changed
+ * more than the update threshold of their mapping since
+ * they were sent the last time.
  * @param ext dlep extension
  * @param session dlep session
  * @param neigh neighbor that should be updated
@@ -356,9 +365,13 @@ dlep_extension_radio_write_session_update(
 int
 dlep_extension_radio_write_destination(
   struct dlep_extension *ext, struct dlep_session *session, const struct netaddr *neigh) {
+  struct dlep_neighbor_mapping *map;
+  struct dlep_local_neighbor *local;
   struct oonf_layer2_neigh *l2neigh;
+  struct oonf_layer2_data *l2data;
   struct netaddr_str nbuf;
-  int result;
+  bool delta;
+  size_t i;
 
   l2neigh = dlep_session_get_local_l2_neighbor(session, neigh);
   if (!l2neigh) {
@@ -369,17 +382,121 @@ dlep_extension_radio_write_destination(
     return -1;
   }
 
-  result = dlep_writer_map_l2neigh_data(&session->writer, ext, l2neigh->data, l2neigh->network->neighdata);
-  if (result) {
-    OONF_WARN(session->log_source,
-      "tlv mapping for extension %d"
-      " and neighbor %s failed: %d",
-      ext->id, netaddr_to_string(&nbuf, neigh), result);
-    return result;
+  /* the l2neigh lookup above already required the local neighbor */
+  local = dlep_session_get_local_neighbor(session, neigh);
+  delta = session->writer.signal_type == DLEP_DESTINATION_UPDATE;
+
+  for (i = 0; i < ext->neigh_mapping_count; i++) {
+    map = &ext->neigh_mapping[i];
+    l2data = _get_neigh_data(map, l2neigh);
+
+    if (delta && !_is_neigh_value_changed(map, local, l2data)) {
+      if (oonf_layer2_data_has_value(l2data)) {
+        session->stats.metrics_suppressed++;
+      }
+      continue;
+    }
+
+    if (map->to_tlv(&session->writer, l2data, oonf_layer2_neigh_metadata_get(map->layer2), map->dlep, map->length)) {
+      OONF_WARN(session->log_source,
+        "tlv mapping for extension %d"
+        " and neighbor %s failed: %d",
+        ext->id, netaddr_to_string(&nbuf, neigh), -(int)(i + 1));
+      return -(int)(i + 1);
+    }
+
+    if (delta && oonf_layer2_data_has_value(l2data)) {
+      session->stats.metrics_sent++;
+    }
+    _set_neigh_value_sent(map, local, l2data);
   }
   return 0;
 }
 
+/**
+ * Check if a destination update for a local neighbor would contain
+ * any metric that changed more than its update threshold or any
+ * pending IP modification.
+ * @param session dlep session
+ * @param local local dlep neighbor
+ * @param changed_data bitmap of layer2 neighbor indices that changed,
+ *   only these metrics are compared to the last sent values
+ * @return true if a destination update should be sent
+ */
+bool
+dlep_extension_radio_destination_changed(
+  struct dlep_session *session, struct dlep_local_neighbor *local, uint64_t changed_data) {
+  struct dlep_neighbor_mapping *map;
+  struct oonf_layer2_neigh *l2neigh;
+  struct dlep_extension *ext;
+  size_t e, i;
+
+  if (!avl_is_empty(&local->_ip_prefix_modification)) {
+    return true;
+  }
+
+  l2neigh = dlep_session_get_l2_from_neighbor(local);
+  if (!l2neigh) {
+    /* let the signal generation report the problem */
+    return true;
+  }
+
+  for (e = 0; e < session->parser.extension_count; e++) {
+    ext = session->parser.extensions[e];
+
+    for (i = 0; i < ext->neigh_mapping_count; i++) {
+      map = &ext->neigh_mapping[i];
+      if ((changed_data & (1ull << map->layer2)) != 0 &&
+          _is_neigh_value_changed(map, local, _get_neigh_data(map, l2neigh))) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/**
+ * @param session dlep session
+ * @return bitmap of all layer2 neighbor indices mapped to TLVs
+ *   by the extensions of the session
+ */
+uint64_t
+dlep_extension_get_l2neigh_mask(struct dlep_session *session) {
+  struct dlep_extension *ext;
+  uint64_t mask = 0;
+  size_t e, i;
+
+  for (e = 0; e < session->parser.extension_count; e++) {
+    ext = session->parser.extensions[e];
+
+    for (i = 0; i < ext->neigh_mapping_count; i++) {
+      mask |= 1ull << ext->neigh_mapping[i].layer2;
+    }
+  }
+  return mask;
+}
+
+/**
+ * @param session dlep session
+ * @return bitmap of all layer2 network indices mapped to TLVs
+ *   by the extensions of the session
+ */
+uint64_t
+dlep_extension_get_l2net_mask(struct dlep_session *session) {
+  struct dlep_extension *ext;
+  uint64_t mask = 0;
+  size_t e, i;
+
+  for (e = 0; e < session->parser.extension_count; e++) {
+    ext = session->parser.extensions[e];
+
+    for (i = 0; i < ext->if_mapping_count; i++) {
+      mask |= 1ull << ext->if_mapping[i].layer2;
+    }
+  }
+  return mask;
+}
+
 /**
  * Handle peer update and session init ACK for DLEP extension
  * by automatically mapping oonf_layer2_data to DLEP TLVs
@@ -411,3 +528,94 @@ _process_interface_specific_update(struct dlep_extension *ext, struct dlep_sessi
   }
   return 0;
 }
+
+/**
+ * Get the layer2 data of a neighbor for a TLV mapping,
+ * falling back to the network wide neighbor defaults
+ * @param map dlep neighbor mapping
+ * @param l2neigh layer2 neighbor
+ * @return layer2 data
+ */
+static struct oonf_layer2_data *
+_get_neigh_data(const struct dlep_neighbor_mapping *map, struct oonf_layer2_neigh *l2neigh) {
+  struct oonf_layer2_data *l2data;
+
+  l2data = &l2neigh->data[map->layer2];
+  if (!oonf_layer2_data_has_value(l2data)) {
+    l2data = &l2neigh->network->neighdata[map->layer2];
+  }
+  return l2data;
+}
+
+/**
+ * Check if layer2 data changed more than the update threshold
+ * of its mapping since it has been sent to the peer
+ * @param map dlep neighbor mapping
+ * @param local local dlep neighbor
+ * @param l2data current layer2 data
+ * @return true if value should be sent in the next destination update
+ */
+static bool
+_is_neigh_value_changed(const struct dlep_neighbor_mapping *map, const struct dlep_local_neighbor *local,
+  const struct oonf_layer2_data *l2data) {
+  const struct dlep_update_threshold *threshold;
+  int64_t value, last;
+  uint64_t diff, base;
+
+  if (!oonf_layer2_data_has_value(l2data)) {
+    /* nothing to send */
+    return false;
+  }
+  if ((local->_last_sent_mask & (1ull << map->layer2)) == 0) {
+    /* never sent before */
+    return true;
+  }
+
+  last = local->_last_sent[map->layer2];
+  switch (oonf_layer2_data_get_type(l2data)) {
+    case OONF_LAYER2_INTEGER_DATA:
+      value = oonf_layer2_data_get_int64(l2data, 0);
+      break;
+    case OONF_LAYER2_BOOLEAN_DATA:
+      return (oonf_layer2_data_get_boolean(l2data, false) ? 1 : 0) != last;
+    default:
+      /* no delta encoding for other data types */
+      return true;
+  }
+
+  threshold = &local->session->cfg.update_thresholds[map->update_threshold];
+
+  diff = value > last ? (uint64_t)value - (uint64_t)last : (uint64_t)last - (uint64_t)value;
+  if (diff == 0 || diff <= (uint64_t)threshold->delta) {
+    return false;
+  }
+
+  base = last < 0 ? -(uint64_t)last : (uint64_t)last;
+  return diff * 100 > base * (uint64_t)threshold->percent;
+}
+
+/**
+ * Remember the value of layer2 data that has been sent to the peer
+ * @param map dlep neighbor mapping
+ * @param local local dlep neighbor
+ * @param l2data layer2 data that has been sent
+ */
+static void
+_set_neigh_value_sent(
+  const struct dlep_neighbor_mapping *map, struct dlep_local_neighbor *local, const struct oonf_layer2_data *l2data) {
+  switch (oonf_layer2_data_get_type(l2data)) {
+    case OONF_LAYER2_INTEGER_DATA:
+      local->_last_sent[map->layer2] = oonf_layer2_data_get_int64(l2data, 0);
+      local->_last_sent_mask |= (1ull << map->layer2);
+      break;
+    case OONF_LAYER2_BOOLEAN_DATA:
+      local->_last_sent[map->layer2] = oonf_layer2_data_get_boolean(l2data, false) ? 1 : 0;
+      local->_last_sent_mask |= (1ull << map->layer2);
+      break;
+    case OONF_LAYER2_NO_DATA:
+      break;
+    default:
+      local->_last_sent_mask &= ~(1ull << map->layer2);
+      break;
+  }
+}
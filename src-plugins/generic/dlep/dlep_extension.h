@@ -47,6 +47,33 @@
 #define _DLEP_EXTENSION_H_
 
 struct dlep_extension;
+struct dlep_local_neighbor;
+
+/**
+ * Class of the threshold a neighbor metric must exceed before it
+ * is sent in a destination update, the values are part of the
+ * session configuration
+ */
+enum dlep_update_threshold_type
+{
+  /*! send every change */
+  DLEP_UPDATE_ON_CHANGE,
+
+  /*! current data rates */
+  DLEP_UPDATE_DATARATE,
+
+  /*! latency */
+  DLEP_UPDATE_LATENCY,
+
+  /*! relative link quality and resources */
+  DLEP_UPDATE_QUALITY,
+
+  /*! signal strength */
+  DLEP_UPDATE_SIGNAL,
+
+  /*! number of threshold classes */
+  DLEP_UPDATE_THRESHOLD_COUNT,
+};
 
 #include "common/autobuf.h"
 #include "common/avl.h"
@@ -180,6 +207,9 @@ struct dlep_neighbor_mapping {
   /*! default value for mandatory TLVs */
   union oonf_layer2_value default_value;
 
+  /*! threshold class of the session configuration used for destination updates */
+  enum dlep_update_threshold_type update_threshold;
+
   /**
    * callback to transform a TLV into layer2 data
    * @param l2data layer2 data
@@ -346,6 +376,10 @@ EXPORT int dlep_extension_radio_write_session_update(
   struct dlep_extension *ext, struct dlep_session *session, const struct netaddr *neigh);
 EXPORT int dlep_extension_radio_write_destination(
   struct dlep_extension *ext, struct dlep_session *session, const struct netaddr *neigh);
+EXPORT bool dlep_extension_radio_destination_changed(
+  struct dlep_session *session, struct dlep_local_neighbor *local, uint64_t changed_data);
+EXPORT uint64_t dlep_extension_get_l2neigh_mask(struct dlep_session *session);
+EXPORT uint64_t dlep_extension_get_l2net_mask(struct dlep_session *session);
 
 /**
  * @param id dlep extension id
@@ -48,6 +48,7 @@
 #include "common/common_types.h"
 #include "core/oonf_logging.h"
 #include "subsystems/oonf_class.h"
+#include "subsystems/oonf_clock.h"
 #include "subsystems/oonf_stream_socket.h"
 #include "subsystems/oonf_timer.h"
 
@@ -79,6 +80,7 @@ static enum dlep_parser_error _process_tlvs(
   struct dlep_session *, int32_t signal_type, uint16_t signal_length, const uint8_t *tlvs);
 static void _send_terminate(struct dlep_session *session);
 static void _cb_destination_timeout(struct oonf_timer_instance *);
+static void _cb_destination_update(struct oonf_timer_instance *);
 
 static struct oonf_class _tlv_class = {
   .name = "dlep reader tlv",
@@ -95,6 +97,11 @@ static struct oonf_timer_class _destination_ack_class = {
   .callback = _cb_destination_timeout,
 };
 
+static struct oonf_timer_class _destination_update_class = {
+  .name = "dlep destination update",
+  .callback = _cb_destination_update,
+};
+
 /**
  * Initialize DLEP session system
  */
@@ -103,6 +110,7 @@ dlep_session_init(void) {
   oonf_class_add(&_tlv_class);
   oonf_class_add(&_local_neighbor_class);
   oonf_timer_add(&_destination_ack_class);
+  oonf_timer_add(&_destination_update_class);
 }
 
 /**
@@ -192,6 +200,7 @@ dlep_session_add(struct dlep_session *session, const char *l2_ifname, const stru
  */
 void
 dlep_session_remove(struct dlep_session *session) {
+  struct dlep_local_neighbor *local, *local_it;
   struct dlep_parser_tlv *tlv, *tlv_it;
   struct dlep_session_parser *parser;
 #ifdef OONF_LOG_DEBUG_INFO
@@ -201,6 +210,18 @@ dlep_session_remove(struct dlep_session *session) {
   OONF_DEBUG(session->log_source, "Remove session if %s to %s", session->l2_listener.name,
     netaddr_socket_to_string(&nbuf, &session->remote_socket));
 
+  if (session->radio) {
+    OONF_INFO(session->log_source,
+      "Destination updates on %s: %" PRIu64 " sent, %" PRIu64 " suppressed, %" PRIu64 " delayed"
+      " (metrics: %" PRIu64 " sent, %" PRIu64 " suppressed)",
+      session->l2_listener.name, session->stats.updates_sent, session->stats.updates_suppressed,
+      session->stats.updates_delayed, session->stats.metrics_sent, session->stats.metrics_suppressed);
+  }
+
+  avl_for_each_element_safe(&session->local_neighbor_tree, local, _node, local_it) {
+    dlep_session_remove_local_neighbor(session, local);
+  }
+
   os_interface_remove(&session->l2_listener);
 
   parser = &session->parser;
@@ -293,10 +314,11 @@ dlep_session_process_tcp(struct oonf_stream_session *tcp_session, struct dlep_se
 {
   ssize_t processed;
 
-  OONF_DEBUG(
-    session->log_source, "Process TCP buffer of %" PRINTF_SIZE_T_SPECIFIER " bytes", abuf_getlen(&tcp_session->in));
+  OONF_DEBUG(session->log_source, "Process TCP buffer of %" PRINTF_SIZE_T_SPECIFIER " bytes",
+    oonf_stream_get_input_length(tcp_session));
 
-  processed = dlep_session_process_buffer(session, abuf_getptr(&tcp_session->in), abuf_getlen(&tcp_session->in), false);
+  processed = dlep_session_process_buffer(
+    session, oonf_stream_get_input(tcp_session), oonf_stream_get_input_length(tcp_session), false);
 
   if (processed < 0) {
     /* session is most likely invalid now */
@@ -309,7 +331,7 @@ dlep_session_process_tcp(struct oonf_stream_session *tcp_session, struct dlep_se
 
   OONF_DEBUG(session->log_source, "Processed %" PRINTF_SSIZE_T_SPECIFIER " bytes", processed);
 
-  abuf_pull(&tcp_session->in, processed);
+  oonf_stream_consume_input(tcp_session, processed);
 
   if (abuf_getlen(session->writer.out) > 0) {
     OONF_DEBUG(
@@ -474,8 +496,9 @@ dlep_session_add_local_neighbor(struct dlep_session *session, const struct netad
   local->_node.key = &local->addr;
   avl_insert(&session->local_neighbor_tree, &local->_node);
 
-  /* initialize timer */
+  /* initialize timers */
   local->_ack_timeout.class = &_destination_ack_class;
+  local->_update_timer.class = &_destination_update_class;
 
   /* initialize backpointer */
   local->session = session;
@@ -494,6 +517,7 @@ void
 dlep_session_remove_local_neighbor(struct dlep_session *session, struct dlep_local_neighbor *local) {
   avl_remove(&session->local_neighbor_tree, &local->_node);
   oonf_timer_stop(&local->_ack_timeout);
+  oonf_timer_stop(&local->_update_timer);
   oonf_class_free(&_local_neighbor_class, local);
 }
 
@@ -561,6 +585,51 @@ dlep_session_get_l2_from_neighbor(struct dlep_local_neighbor *dlep_neigh) {
   return l2neigh;
 }
 
+/**
+ * Generate a destination update for a local neighbor if one of its
+ * metrics changed more than its update threshold. Updates are
+ * delayed if the last one for this neighbor is more recent than
+ * the configured destination update interval.
+ * @param session dlep session
+ * @param local local dlep neighbor
+ * @param changed_data bitmap of layer2 neighbor indices that changed
+ * @return -1 if an error happened, 0 otherwise
+ */
+int
+dlep_session_generate_destination_update(
+  struct dlep_session *session, struct dlep_local_neighbor *local, uint64_t changed_data) {
+  uint64_t next_update;
+#ifdef OONF_LOG_DEBUG_INFO
+  struct netaddr_str nbuf;
+#endif
+
+  if (oonf_timer_is_active(&local->_update_timer)) {
+    /* update already scheduled */
+    return 0;
+  }
+
+  if (!dlep_extension_radio_destination_changed(session, local, changed_data)) {
+    OONF_DEBUG(session->log_source, "Suppress destination update for %s", netaddr_to_string(&nbuf, &local->addr));
+    session->stats.updates_suppressed++;
+    return 0;
+  }
+
+  next_update = local->_last_update + session->cfg.destination_update_interval;
+  if (session->cfg.destination_update_interval > 0 && !oonf_clock_is_past(next_update)) {
+    OONF_DEBUG(session->log_source, "Delay destination update for %s", netaddr_to_string(&nbuf, &local->addr));
+    session->stats.updates_delayed++;
+    oonf_timer_set(&local->_update_timer, oonf_clock_get_relative(next_update));
+    return 0;
+  }
+
+  if (dlep_session_generate_signal(session, DLEP_DESTINATION_UPDATE, &local->addr)) {
+    return -1;
+  }
+  session->stats.updates_sent++;
+  local->_last_update = oonf_clock_getNow();
+  return 0;
+}
+
 /**
  * Generate a DLEP signal/message
  * @param session dlep session
@@ -847,6 +916,21 @@ _cb_destination_timeout(struct oonf_timer_instance *ptr) {
   }
 }
 
+/**
+ * Callback to send a destination update delayed by rate limiting
+ * @param ptr timer instance that fired
+ */
+static void
+_cb_destination_update(struct oonf_timer_instance *ptr) {
+  struct dlep_local_neighbor *local;
+
+  local = container_of(ptr, struct dlep_local_neighbor, _update_timer);
+  if (local->state == DLEP_NEIGHBOR_UP_ACKED) {
+    /* the changes that triggered the delayed update are unknown here */
+    dlep_session_generate_destination_update(local->session, local, ~0ull);
+  }
+}
+
 /**
  * parse a stream of DLEP tlvs
  * @param session dlep session
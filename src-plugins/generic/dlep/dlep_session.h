@@ -226,6 +226,18 @@ struct dlep_local_neighbor {
   /*! timeout for acknowledgement signal */
   struct oonf_timer_instance _ack_timeout;
 
+  /*! timer for a destination update delayed by rate limiting */
+  struct oonf_timer_instance _update_timer;
+
+  /*! timestamp of the last destination update sent for this neighbor */
+  uint64_t _last_update;
+
+  /*! last integer value sent to the peer for each layer2 neighbor index */
+  int64_t _last_sent[OONF_LAYER2_NEIGH_COUNT];
+
+  /*! bitmap of layer2 neighbor indices with a valid _last_sent value */
+  uint64_t _last_sent_mask;
+
   /*! tree of modifications which should be put into the next destination update */
   struct avl_tree _ip_prefix_modification;
 
@@ -233,6 +245,18 @@ struct dlep_local_neighbor {
   struct avl_node _node;
 };
 
+/**
+ * Threshold a neighbor metric must exceed before it is sent
+ * in a destination update
+ */
+struct dlep_update_threshold {
+  /*! integer values must change by more than this value */
+  int64_t delta;
+
+  /*! integer values must change by more than this percentage of the last sent value */
+  int32_t percent;
+};
+
 /**
  * Configuration of a dlep session
  */
@@ -251,6 +275,32 @@ struct dlep_session_config {
 
   /*! true if proxied neighbors should be sent with DLEP */
   bool send_proxied;
+
+  /*! minimum time between two destination updates of the same neighbor, 0 to disable */
+  uint64_t destination_update_interval;
+
+  /*! thresholds for sending changed neighbor metrics in destination updates */
+  struct dlep_update_threshold update_thresholds[DLEP_UPDATE_THRESHOLD_COUNT];
+};
+
+/**
+ * Statistics about destination update generation of a dlep session
+ */
+struct dlep_session_stats {
+  /*! number of destination updates sent */
+  uint64_t updates_sent;
+
+  /*! number of destination updates suppressed because no metric changed enough */
+  uint64_t updates_suppressed;
+
+  /*! number of destination updates delayed by rate limiting */
+  uint64_t updates_delayed;
+
+  /*! number of metric TLVs written into destination updates */
+  uint64_t metrics_sent;
+
+  /*! number of metric TLVs left out of destination updates because they did not change enough */
+  uint64_t metrics_suppressed;
 };
 
 /**
@@ -324,6 +374,9 @@ struct dlep_session {
   /*! remote endpoint of current communication */
   union netaddr_socket remote_socket;
 
+  /*! destination update statistics */
+  struct dlep_session_stats stats;
+
   /*! timeout for acknowledgement signal */
   struct oonf_timer_instance _ack_timeout;
 
@@ -356,6 +409,8 @@ struct dlep_local_neighbor *dlep_session_add_local_neighbor(struct dlep_session
 void dlep_session_remove_local_neighbor(struct dlep_session *session, struct dlep_local_neighbor *local);
 struct oonf_layer2_neigh *dlep_session_get_local_l2_neighbor(struct dlep_session *session, const struct netaddr *neigh);
 struct oonf_layer2_neigh *dlep_session_get_l2_from_neighbor(struct dlep_local_neighbor *dlep_neigh);
+int dlep_session_generate_destination_update(
+  struct dlep_session *session, struct dlep_local_neighbor *local, uint64_t changed_data);
 
 /**
  * get the dlep session tlv
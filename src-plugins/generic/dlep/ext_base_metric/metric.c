@@ -185,6 +185,8 @@ static struct dlep_neighbor_mapping _neigh_mappings[] = {
     .mandatory = true,
     .default_value.integer = 0,
 
+    .update_threshold = DLEP_UPDATE_DATARATE,
+
     .from_tlv = dlep_reader_map_identity,
     .to_tlv = dlep_writer_map_identity,
   },
@@ -196,6 +198,8 @@ static struct dlep_neighbor_mapping _neigh_mappings[] = {
     .mandatory = true,
     .default_value.integer = 0,
 
+    .update_threshold = DLEP_UPDATE_DATARATE,
+
     .from_tlv = dlep_reader_map_identity,
     .to_tlv = dlep_writer_map_identity,
   },
@@ -207,6 +211,8 @@ static struct dlep_neighbor_mapping _neigh_mappings[] = {
     .mandatory = true,
     .default_value.integer = 1,
 
+    .update_threshold = DLEP_UPDATE_LATENCY,
+
     .from_tlv = dlep_reader_map_identity,
     .to_tlv = dlep_writer_map_identity,
   },
@@ -214,6 +220,7 @@ static struct dlep_neighbor_mapping _neigh_mappings[] = {
     .dlep = DLEP_RESOURCES_TLV,
     .layer2 = OONF_LAYER2_NEIGH_RESOURCES,
     .length = 1,
+    .update_threshold = DLEP_UPDATE_QUALITY,
     .from_tlv = dlep_reader_map_identity,
     .to_tlv = dlep_writer_map_identity,
   },
@@ -221,6 +228,7 @@ static struct dlep_neighbor_mapping _neigh_mappings[] = {
     .dlep = DLEP_RLQR_TLV,
     .layer2 = OONF_LAYER2_NEIGH_RX_RLQ,
     .length = 1,
+    .update_threshold = DLEP_UPDATE_QUALITY,
     .from_tlv = dlep_reader_map_identity,
     .to_tlv = dlep_writer_map_identity,
   },
@@ -228,6 +236,7 @@ static struct dlep_neighbor_mapping _neigh_mappings[] = {
     .dlep = DLEP_RLQT_TLV,
     .layer2 = OONF_LAYER2_NEIGH_TX_RLQ,
     .length = 1,
+    .update_threshold = DLEP_UPDATE_QUALITY,
     .from_tlv = dlep_reader_map_identity,
     .to_tlv = dlep_writer_map_identity,
   },
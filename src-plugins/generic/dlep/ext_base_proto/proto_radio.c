@@ -81,10 +81,10 @@ static void _l2_neigh_added_to_session(
 static void _l2_neigh_added(
   struct oonf_layer2_neigh *l2neigh, struct oonf_layer2_destination *l2dest, const struct netaddr *mac);
 
-static void _cb_l2_net_changed(void *);
+static void _cb_l2_net_changed(struct oonf_layer2_net *, uint64_t changed_data, uint64_t changed_neighdata);
 
 static void _cb_l2_neigh_added(void *);
-static void _cb_l2_neigh_changed(void *);
+static void _cb_l2_neigh_changed(struct oonf_layer2_neigh *, uint64_t changed_data);
 static void _cb_l2_neigh_removed(void *);
 
 static void _cb_l2_dst_added(void *);
@@ -152,11 +152,11 @@ static struct dlep_extension_implementation _radio_signals[] = {
   },
 };
 
-static struct oonf_class_extension _layer2_net_listener = {
-  .ext_name = "dlep radio",
-  .class_name = LAYER2_CLASS_NETWORK,
+static struct oonf_layer2_listener _layer2_change_listener = {
+  .name = "dlep radio",
 
-  .cb_change = _cb_l2_net_changed,
+  .cb_net_changed = _cb_l2_net_changed,
+  .cb_neigh_changed = _cb_l2_neigh_changed,
 };
 
 static struct oonf_class_extension _layer2_neigh_listener = {
@@ -164,7 +164,6 @@ static struct oonf_class_extension _layer2_neigh_listener = {
   .class_name = LAYER2_CLASS_NEIGHBOR,
 
   .cb_add = _cb_l2_neigh_added,
-  .cb_change = _cb_l2_neigh_changed,
   .cb_remove = _cb_l2_neigh_removed,
 };
 
@@ -186,7 +185,7 @@ dlep_base_proto_radio_init(void) {
   _base = dlep_base_proto_init();
   dlep_extension_add_processing(_base, true, _radio_signals, ARRAYSIZE(_radio_signals));
 
-  oonf_class_extension_add(&_layer2_net_listener);
+  oonf_layer2_listener_add(&_layer2_change_listener);
   oonf_class_extension_add(&_layer2_neigh_listener);
   oonf_class_extension_add(&_layer2_dst_listener);
 
@@ -219,7 +218,7 @@ static void
 _cb_cleanup_radio(struct dlep_session *session) {
   dlep_base_proto_stop_timers(session);
 
-  oonf_class_extension_remove(&_layer2_net_listener);
+  oonf_layer2_listener_remove(&_layer2_change_listener);
   oonf_class_extension_remove(&_layer2_neigh_listener);
   oonf_class_extension_remove(&_layer2_dst_listener);
 }
@@ -369,7 +368,8 @@ _radio_process_destination_up_ack(struct dlep_extension *ext __attribute__((unus
       oonf_timer_stop(&local->_ack_timeout);
 
       if (local->changed) {
-        dlep_session_generate_signal(session, DLEP_DESTINATION_UPDATE, &mac);
+        /* check all metrics, the neighbor might have changed more than once */
+        dlep_session_generate_destination_update(session, local, ~0ull);
         local->changed = false;
       }
     }
@@ -499,6 +499,8 @@ _l2_neigh_added_to_session(struct dlep_session *session, struct oonf_layer2_neig
   if (local) {
     memcpy(&local->neigh_addr, &l2neigh->addr, sizeof(local->neigh_addr));
 
+    /* destination up carries all metrics */
+    local->_last_sent_mask = 0;
     dlep_session_generate_signal(session, DLEP_DESTINATION_UP, mac);
     local->state = DLEP_NEIGHBOR_UP_SENT;
     oonf_timer_set(&local->_ack_timeout, session->cfg.heartbeat_interval * 2);
@@ -537,10 +539,11 @@ _l2_neigh_added(struct oonf_layer2_neigh *l2neigh, struct oonf_layer2_destinatio
  * @param l2neigh layer2 neighbor
  * @param l2dest layer2 destination (might be NULL)
  * @param mac MAC address of other endpoint
+ * @param changed_data bitmap of changed neighbor data
  */
 static void
-_l2_neigh_changed(
-  struct oonf_layer2_neigh *l2neigh, struct oonf_layer2_destination *l2dest, const struct netaddr *mac) {
+_l2_neigh_changed(struct oonf_layer2_neigh *l2neigh, struct oonf_layer2_destination *l2dest, const struct netaddr *mac,
+  uint64_t changed_data) {
   struct dlep_radio_if *radio_if;
   struct dlep_radio_session *radio_session;
   struct dlep_local_neighbor *local;
@@ -558,6 +561,14 @@ _l2_neigh_changed(
       continue;
     }
 
+    if ((changed_data & dlep_extension_get_l2neigh_mask(&radio_session->session)) == 0) {
+      /* no metric of the session changed, only pending IP changes need an update */
+      local = dlep_session_get_local_neighbor(&radio_session->session, mac);
+      if (!local || avl_is_empty(&local->_ip_prefix_modification)) {
+        continue;
+      }
+    }
+
     local = dlep_session_add_local_neighbor(&radio_session->session, mac);
 
     if (local) {
@@ -568,12 +579,14 @@ _l2_neigh_changed(
           local->changed = true;
           break;
         case DLEP_NEIGHBOR_UP_ACKED:
-          dlep_session_generate_signal(&radio_session->session, DLEP_DESTINATION_UPDATE, mac);
+          dlep_session_generate_destination_update(&radio_session->session, local, changed_data);
           local->changed = false;
           break;
         case DLEP_NEIGHBOR_IDLE:
         case DLEP_NEIGHBOR_DOWN_SENT:
         case DLEP_NEIGHBOR_DOWN_ACKED:
+          /* destination up carries all metrics */
+          local->_last_sent_mask = 0;
           dlep_session_generate_signal(&radio_session->session, DLEP_DESTINATION_UP, mac);
           local->state = DLEP_NEIGHBOR_UP_SENT;
           local->changed = false;
@@ -626,13 +639,16 @@ _l2_neigh_removed(
   }
 }
 
+/**
+ * Callback triggered once per scheduler iteration for a changed layer2 network
+ * @param l2net layer2 network
+ * @param changed_data bitmap of changed network data
+ * @param changed_neighdata bitmap of changed neighbor defaults
+ */
 static void
-_cb_l2_net_changed(void *ptr) {
+_cb_l2_net_changed(struct oonf_layer2_net *l2net, uint64_t changed_data, uint64_t changed_neighdata) {
   struct dlep_radio_session *radio_session;
   struct dlep_radio_if *radio_if;
-  struct oonf_layer2_net *l2net;
-
-  l2net = ptr;
 
   radio_if = dlep_radio_get_by_layer2_if(l2net->name);
   if (!radio_if) {
@@ -640,6 +656,12 @@ _cb_l2_net_changed(void *ptr) {
   }
 
   avl_for_each_element(&radio_if->interf.session_tree, radio_session, _node) {
+    if ((changed_data & dlep_extension_get_l2net_mask(&radio_session->session)) == 0 &&
+        (changed_neighdata & dlep_extension_get_l2neigh_mask(&radio_session->session)) == 0 &&
+        avl_is_empty(&radio_session->session._ip_prefix_modification)) {
+      /* nothing the session update would report changed */
+      continue;
+    }
     if (radio_session->session.restrict_signal == DLEP_ALL_SIGNALS) {
       dlep_session_generate_signal(&radio_session->session, DLEP_SESSION_UPDATE, NULL);
     }
@@ -658,19 +680,18 @@ _cb_l2_neigh_added(void *ptr) {
 }
 
 /**
- * Callback triggered when a layer2 neighbor object has been changed
- * @param ptr layer2 neighbor
+ * Callback triggered once per scheduler iteration for a changed layer2 neighbor
+ * @param l2neigh layer2 neighbor
+ * @param changed_data bitmap of changed neighbor data
  */
 static void
-_cb_l2_neigh_changed(void *ptr) {
-  struct oonf_layer2_neigh *l2neigh;
+_cb_l2_neigh_changed(struct oonf_layer2_neigh *l2neigh, uint64_t changed_data) {
   struct oonf_layer2_destination *l2dst;
 
-  l2neigh = ptr;
-  _l2_neigh_changed(l2neigh, NULL, &l2neigh->addr);
+  _l2_neigh_changed(l2neigh, NULL, &l2neigh->addr, changed_data);
 
   avl_for_each_element(&l2neigh->destinations, l2dst, _node) {
-    _l2_neigh_changed(l2neigh, l2dst, &l2dst->destination);
+    _l2_neigh_changed(l2neigh, l2dst, &l2dst->destination, changed_data);
   }
 }
 
@@ -164,6 +164,8 @@ static struct dlep_neighbor_mapping _neigh_mappings[] = {
     .layer2 = OONF_LAYER2_NEIGH_RX_SIGNAL,
     .length = 4,
 
+    .update_threshold = DLEP_UPDATE_SIGNAL,
+
     .from_tlv = dlep_reader_map_identity,
     .to_tlv = dlep_writer_map_identity,
   },
@@ -172,6 +174,8 @@ static struct dlep_neighbor_mapping _neigh_mappings[] = {
     .layer2 = OONF_LAYER2_NEIGH_TX_SIGNAL,
     .length = 4,
 
+    .update_threshold = DLEP_UPDATE_SIGNAL,
+
     .from_tlv = dlep_reader_map_identity,
     .to_tlv = dlep_writer_map_identity,
   },
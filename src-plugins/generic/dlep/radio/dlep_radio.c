@@ -49,7 +49,9 @@
 #include "common/avl.h"
 #include "common/avl_comp.h"
 #include "common/common_types.h"
+#include "common/isonumber.h"
 #include "common/netaddr.h"
+#include "common/template.h"
 
 #include "config/cfg_schema.h"
 #include "core/oonf_subsystem.h"
@@ -57,13 +59,16 @@
 #include "subsystems/oonf_layer2.h"
 #include "subsystems/oonf_packet_socket.h"
 #include "subsystems/oonf_stream_socket.h"
+#include "subsystems/oonf_telnet.h"
 #include "subsystems/oonf_timer.h"
+#include "subsystems/oonf_viewer.h"
 
 #include "dlep/dlep_iana.h"
 #include "dlep/dlep_writer.h"
 #include "dlep/radio/dlep_radio.h"
 #include "dlep/radio/dlep_radio_interface.h"
 #include "dlep/radio/dlep_radio_internal.h"
+#include "dlep/radio/dlep_radio_session.h"
 
 /* prototypes */
 static void _early_cfg_init(void);
@@ -73,6 +78,10 @@ static void _initiate_shutdown(void);
 
 static void _cb_config_changed(void);
 
+static enum oonf_telnet_result _cb_dlep_radio(struct oonf_telnet_data *con);
+static enum oonf_telnet_result _cb_dlep_radio_help(struct oonf_telnet_data *con);
+static int _cb_create_text_session(struct oonf_viewer_template *);
+
 /* configuration */
 static const char *_UDP_MODE[] = {
   [DLEP_IF_UDP_NONE] = DLEP_IF_UDP_NONE_STR,
@@ -111,6 +120,23 @@ static struct cfg_schema_entry _radio_entries[] = {
   CFG_MAP_BOOL(dlep_radio_if, interf.session.cfg.send_proxied, "proxied", "true",
     "Report 802.11s proxied mac address for neighbors"),
   CFG_MAP_BOOL(dlep_radio_if, interf.session.cfg.send_neighbors, "not_proxied", "false", "Report direct neighbors"),
+  CFG_MAP_CLOCK(dlep_radio_if, interf.session.cfg.destination_update_interval, "destination_update_interval", "0.000",
+    "Minimum time between two destination updates for the same neighbor, 0 to send every change immediately"),
+  CFG_MAP_INT32_MINMAX(dlep_radio_if, interf.session.cfg.update_thresholds[DLEP_UPDATE_DATARATE].percent,
+    "update_datarate_percent", "5",
+    "Minimum change of the current data rates of a neighbor in percent before a destination update reports it", 0, 0,
+    1000),
+  CFG_MAP_INT32_MINMAX(dlep_radio_if, interf.session.cfg.update_thresholds[DLEP_UPDATE_LATENCY].percent,
+    "update_latency_percent", "10",
+    "Minimum change of the latency of a neighbor in percent before a destination update reports it", 0, 0, 1000),
+  CFG_MAP_INT64_MINMAX(dlep_radio_if, interf.session.cfg.update_thresholds[DLEP_UPDATE_QUALITY].delta,
+    "update_quality_delta", "2",
+    "Minimum change of the relative link quality and resources of a neighbor before a destination update reports it",
+    0, 0, 100),
+  CFG_MAP_INT64_MINMAX(dlep_radio_if, interf.session.cfg.update_thresholds[DLEP_UPDATE_SIGNAL].delta,
+    "update_signal_delta", "1.000",
+    "Minimum change of the signal strength of a neighbor in dBm before a destination update reports it", 3, 0,
+    100000),
 };
 
 static struct cfg_schema_section _radio_section = {
@@ -125,13 +151,78 @@ static struct cfg_schema_section _radio_section = {
   .entry_count = ARRAYSIZE(_radio_entries),
 };
 
+/*! template key for layer2 interface of a session */
+#define KEY_SESSION_IF "session_if"
+
+/*! template key for remote socket of a session */
+#define KEY_SESSION_REMOTE "session_remote"
+
+/*! template key for number of destination updates sent */
+#define KEY_SESSION_UPDATES_SENT "session_updates_sent"
+
+/*! template key for number of destination updates suppressed */
+#define KEY_SESSION_UPDATES_SUPPRESSED "session_updates_suppressed"
+
+/*! template key for number of destination updates delayed by rate limiting */
+#define KEY_SESSION_UPDATES_DELAYED "session_updates_delayed"
+
+/*! template key for number of metric TLVs sent in destination updates */
+#define KEY_SESSION_METRICS_SENT "session_metrics_sent"
+
+/*! template key for number of metric TLVs suppressed in destination updates */
+#define KEY_SESSION_METRICS_SUPPRESSED "session_metrics_suppressed"
+
+/* buffer space for values that will be assembled into the output of the telnet command */
+static char _value_session_if[IF_NAMESIZE];
+static struct netaddr_str _value_session_remote;
+static struct isonumber_str _value_updates_sent;
+static struct isonumber_str _value_updates_suppressed;
+static struct isonumber_str _value_updates_delayed;
+static struct isonumber_str _value_metrics_sent;
+static struct isonumber_str _value_metrics_suppressed;
+
+/* definition of the template data entries for JSON and table output */
+static struct abuf_template_data_entry _tde_session[] = {
+  { KEY_SESSION_IF, _value_session_if, true },
+  { KEY_SESSION_REMOTE, _value_session_remote.buf, true },
+  { KEY_SESSION_UPDATES_SENT, _value_updates_sent.buf, false },
+  { KEY_SESSION_UPDATES_SUPPRESSED, _value_updates_suppressed.buf, false },
+  { KEY_SESSION_UPDATES_DELAYED, _value_updates_delayed.buf, false },
+  { KEY_SESSION_METRICS_SENT, _value_metrics_sent.buf, false },
+  { KEY_SESSION_METRICS_SUPPRESSED, _value_metrics_suppressed.buf, false },
+};
+
+static struct abuf_template_storage _template_storage;
+
+/* Template Data objects (contain one or more Template Data Entries) */
+static struct abuf_template_data _td_session[] = {
+  { _tde_session, ARRAYSIZE(_tde_session) },
+};
+
+/* OONF viewer templates (based on Template Data arrays) */
+static struct oonf_viewer_template _templates[] = {
+  {
+    .data = _td_session,
+    .data_size = ARRAYSIZE(_td_session),
+    .json_name = "session",
+    .cb_function = _cb_create_text_session,
+  },
+};
+
+/* telnet command of this plugin */
+static struct oonf_telnet_command _telnet_commands[] = {
+  TELNET_CMD(OONF_DLEP_RADIO_SUBSYSTEM, _cb_dlep_radio, "", .help_handler = _cb_dlep_radio_help),
+};
+
 /* subsystem declaration */
 static const char *_dependencies[] = {
   OONF_CLASS_SUBSYSTEM,
   OONF_LAYER2_SUBSYSTEM,
   OONF_PACKET_SUBSYSTEM,
   OONF_STREAM_SUBSYSTEM,
+  OONF_TELNET_SUBSYSTEM,
   OONF_TIMER_SUBSYSTEM,
+  OONF_VIEWER_SUBSYSTEM,
 };
 static struct oonf_subsystem _dlep_radio_subsystem = {
   .name = OONF_DLEP_RADIO_SUBSYSTEM,
@@ -164,6 +255,7 @@ _early_cfg_init(void) {
 static int
 _init(void) {
   dlep_radio_interface_init();
+  oonf_telnet_add(&_telnet_commands[0]);
   return 0;
 }
 
@@ -180,6 +272,7 @@ _initiate_shutdown(void) {
  */
 static void
 _cleanup(void) {
+  oonf_telnet_remove(&_telnet_commands[0]);
   dlep_radio_interface_cleanup();
 }
 
@@ -229,3 +322,56 @@ _cb_config_changed(void) {
   /* apply settings */
   dlep_radio_apply_interface_settings(interface);
 }
+
+/**
+ * Callback for the telnet command of this plugin
+ * @param con pointer to telnet session data
+ * @return telnet result value
+ */
+static enum oonf_telnet_result
+_cb_dlep_radio(struct oonf_telnet_data *con) {
+  return oonf_viewer_telnet_handler(
+    con, &_template_storage, OONF_DLEP_RADIO_SUBSYSTEM, _templates, ARRAYSIZE(_templates));
+}
+
+/**
+ * Callback for the help output of this plugin
+ * @param con pointer to telnet session data
+ * @return telnet result value
+ */
+static enum oonf_telnet_result
+_cb_dlep_radio_help(struct oonf_telnet_data *con) {
+  return oonf_viewer_telnet_help(
+    con->out, OONF_DLEP_RADIO_SUBSYSTEM, con->parameter, _templates, ARRAYSIZE(_templates));
+}
+
+/**
+ * Callback to generate text/json description of the destination update statistics of all radio sessions
+ * @param template viewer template
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_session(struct oonf_viewer_template *template) {
+  struct dlep_radio_if *interf;
+  struct dlep_radio_session *radio_session;
+  struct dlep_session_stats *stats;
+
+  avl_for_each_element(dlep_if_get_tree(true), interf, interf._node) {
+    avl_for_each_element(&interf->interf.session_tree, radio_session, _node) {
+      stats = &radio_session->session.stats;
+
+      strscpy(_value_session_if, radio_session->session.l2_listener.name, sizeof(_value_session_if));
+      netaddr_socket_to_string(&_value_session_remote, &radio_session->session.remote_socket);
+
+      isonumber_from_u64(&_value_updates_sent, stats->updates_sent, "", 0, template->create_raw);
+      isonumber_from_u64(&_value_updates_suppressed, stats->updates_suppressed, "", 0, template->create_raw);
+      isonumber_from_u64(&_value_updates_delayed, stats->updates_delayed, "", 0, template->create_raw);
+      isonumber_from_u64(&_value_metrics_sent, stats->metrics_sent, "", 0, template->create_raw);
+      isonumber_from_u64(&_value_metrics_suppressed, stats->metrics_suppressed, "", 0, template->create_raw);
+
+      /* generate template output */
+      oonf_viewer_output_print_line(template);
+    }
+  }
+  return 0;
+}
@@ -51,13 +51,23 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+#include "common/autobuf.h"
+#include "common/avl.h"
+#include "common/avl_comp.h"
 #include "common/common_types.h"
+#include "common/isonumber.h"
 #include "config/cfg_schema.h"
 #include "core/oonf_subsystem.h"
+#include "subsystems/oonf_class.h"
 #include "subsystems/oonf_clock.h"
 #include "subsystems/oonf_layer2.h"
+#include "subsystems/oonf_telnet.h"
 #include "subsystems/oonf_timer.h"
 #include "subsystems/os_interface.h"
+#include "subsystems/os_system.h"
 
 #include "eth_listener/eth_listener.h"
 #include "eth_listener/ethtool-copy.h"
@@ -65,25 +75,86 @@
 /* definitions */
 #define LOG_ETH _eth_listener_subsystem.logging
 
+/*! delay between a link event and the ethtool query in milliseconds */
+#define ETH_LISTENER_EVENT_DELAY 250
+
 /**
  * Configuration object for eth listener
  */
 struct _eth_config {
   /*! interval between two updates */
   uint64_t interval;
+
+  /*! true if link changes should trigger an update */
+  bool events;
+};
+
+/**
+ * Ethernet state of an interface known to the listener
+ */
+struct _eth_if {
+  /*! interface index */
+  unsigned index;
+
+  /*! link speed reported to the layer2 database, 0 if not known */
+  int64_t speed;
+
+  /*! duplex mode of interface */
+  uint8_t duplex;
+
+  /*! interface flags of the last link event */
+  unsigned link_flags;
+
+  /*! operational state of the last link event */
+  uint8_t operstate;
+
+  /*! true if the interface has to be queried after a link event */
+  bool dirty;
+
+  /*! true if the interface was found during the last periodic update */
+  bool seen;
+
+  /*! hook into tree of ethernet interfaces */
+  struct avl_node _node;
+};
+
+/**
+ * Statistics of the eth listener
+ */
+struct _eth_stats {
+  /*! number of ethtool queries */
+  uint64_t queries;
+
+  /*! number of rtnetlink link changes that triggered a query */
+  uint64_t events;
+
+  /*! number of changes committed to the layer2 database */
+  uint64_t updates;
+
+  /*! number of queries that did not change the layer2 database */
+  uint64_t suppressed;
 };
 
 /* prototypes */
 static int _init(void);
 static void _cleanup(void);
 
+static struct _eth_if *_eth_if_add(unsigned index);
+static void _eth_if_remove(struct _eth_if *eth_if);
+static void _query_interface(struct _eth_if *eth_if, struct os_interface *os_if);
+
 static void _cb_transmission_event(struct oonf_timer_instance *);
+static void _cb_event_delay(struct oonf_timer_instance *);
+static void _cb_nl_message(struct nlmsghdr *hdr);
+static enum oonf_telnet_result _cb_telnet_eth_listener(struct oonf_telnet_data *data);
 static void _cb_config_changed(void);
 
 /* configuration */
 static struct cfg_schema_entry _eth_entries[] = {
   CFG_MAP_CLOCK_MIN(
     _eth_config, interval, "interval", "60.0", "Interval between two linklayer information updates", 100),
+  CFG_MAP_BOOL(_eth_config, events, "events", "true",
+    "Update the linklayer information of an interface when the kernel reports a link change"),
 };
 
 static struct cfg_schema_section _eth_section = {
@@ -97,10 +168,13 @@ static struct _eth_config _config;
 
 /* plugin declaration */
 static const char *_dependencies[] = {
+  OONF_CLASS_SUBSYSTEM,
   OONF_CLOCK_SUBSYSTEM,
   OONF_LAYER2_SUBSYSTEM,
+  OONF_TELNET_SUBSYSTEM,
   OONF_TIMER_SUBSYSTEM,
   OONF_OS_INTERFACE_SUBSYSTEM,
+  OONF_OS_SYSTEM_SUBSYSTEM,
 };
 static struct oonf_subsystem _eth_listener_subsystem = {
   .name = OONF_ETH_LISTENER_SUBSYSTEM,
@@ -125,12 +199,47 @@ static struct oonf_timer_class _transmission_timer_info = {
 
 static struct oonf_timer_instance _transmission_timer = { .class = &_transmission_timer_info };
 
+/* timer for delaying the queries triggered by link events */
+static struct oonf_timer_class _event_timer_info = {
+  .name = "eth listener event delay",
+  .callback = _cb_event_delay,
+};
+
+static struct oonf_timer_instance _event_timer = { .class = &_event_timer_info };
+
+/* rtnetlink listener for link changes */
+static const uint32_t _rtnetlink_mcast[] = { RTNLGRP_LINK };
+
+static struct os_system_netlink _rtnetlink_receiver = {
+  .name = "eth listener link events",
+  .used_by = &_eth_listener_subsystem,
+  .cb_message = _cb_nl_message,
+};
+
+static bool _events_subscribed = false;
+
 static struct oonf_layer2_origin _l2_origin = {
   .name = "ethernet listener",
   .priority = OONF_LAYER2_ORIGIN_UNRELIABLE,
   .proactive = true,
 };
 
+/* ethernet interface handling */
+static struct avl_tree _eth_if_tree;
+
+static struct oonf_class _eth_if_class = {
+  .name = "eth listener if",
+  .size = sizeof(struct _eth_if),
+};
+
+static struct _eth_stats _stats;
+
+/* telnet command */
+static struct oonf_telnet_command _telnet_commands[] = {
+  TELNET_CMD(OONF_ETH_LISTENER_SUBSYSTEM, _cb_telnet_eth_listener,
+    "Shows the link speed of all interfaces and the update statistics of the ethernet listener"),
+};
+
 static int _ioctl_sock;
 
 static int
@@ -141,93 +250,308 @@ _init(void) {
     return -1;
   }
 
+  if (os_system_linux_netlink_add(&_rtnetlink_receiver, NETLINK_ROUTE)) {
+    close(_ioctl_sock);
+    return -1;
+  }
+
+  oonf_class_add(&_eth_if_class);
+  avl_init(&_eth_if_tree, avl_comp_uint32, false);
+
   oonf_timer_add(&_transmission_timer_info);
+  oonf_timer_add(&_event_timer_info);
   oonf_layer2_origin_add(&_l2_origin);
+  oonf_telnet_add(&_telnet_commands[0]);
 
   return 0;
 }
 
 static void
 _cleanup(void) {
+  struct _eth_if *eth_if, *eth_if_it;
+
+  oonf_telnet_remove(&_telnet_commands[0]);
   oonf_layer2_origin_remove(&_l2_origin);
 
   oonf_timer_stop(&_transmission_timer);
   oonf_timer_remove(&_transmission_timer_info);
+  oonf_timer_stop(&_event_timer);
+  oonf_timer_remove(&_event_timer_info);
 
+  avl_for_each_element_safe(&_eth_if_tree, eth_if, _node, eth_if_it) {
+    _eth_if_remove(eth_if);
+  }
+  oonf_class_remove(&_eth_if_class);
+
+  os_system_linux_netlink_remove(&_rtnetlink_receiver);
   close(_ioctl_sock);
 }
 
 /**
- * Callback for querying ethernet status
- * @param ptr timer instance that fired
+ * Add an ethernet interface to the tree
+ * @param index interface index
+ * @return ethernet interface, NULL if out of memory
+ */
+static struct _eth_if *
+_eth_if_add(unsigned index) {
+  struct _eth_if *eth_if;
+
+  eth_if = avl_find_element(&_eth_if_tree, &index, eth_if, _node);
+  if (eth_if) {
+    return eth_if;
+  }
+
+  eth_if = oonf_class_malloc(&_eth_if_class);
+  if (!eth_if) {
+    return NULL;
+  }
+
+  eth_if->index = index;
+  eth_if->duplex = DUPLEX_UNKNOWN;
+  eth_if->_node.key = &eth_if->index;
+  avl_insert(&_eth_if_tree, &eth_if->_node);
+  return eth_if;
+}
+
+/**
+ * Remove an ethernet interface from the tree
+ * @param eth_if ethernet interface
  */
 static void
-_cb_transmission_event(struct oonf_timer_instance *ptr __attribute((unused))) {
+_eth_if_remove(struct _eth_if *eth_if) {
+  avl_remove(&_eth_if_tree, &eth_if->_node);
+  oonf_class_free(&_eth_if_class, eth_if);
+}
+
+/**
+ * Query the link speed of an interface and write it into the
+ * layer2 database if it changed.
+ * @param eth_if ethernet interface
+ * @param os_if interface data
+ */
+static void
+_query_interface(struct _eth_if *eth_if, struct os_interface *os_if) {
   struct oonf_layer2_net *l2net;
-  struct os_interface *os_if;
   struct ethtool_cmd cmd;
   struct ifreq req;
   int64_t ethspeed;
+  bool changed;
   int err;
 #ifdef OONF_LOG_DEBUG_INFO
   struct isonumber_str ibuf;
 #endif
 
+  /* initialize ethtool command */
+  memset(&cmd, 0, sizeof(cmd));
+  cmd.cmd = ETHTOOL_GSET;
+
+  /* initialize interface request */
+  memset(&req, 0, sizeof(req));
+  req.ifr_data = (void *)&cmd;
+
+  if (os_if->base_index != os_if->index) {
+    /* get name of base interface */
+    if (if_indextoname(os_if->base_index, req.ifr_name) == NULL) {
+      /* do not use WARN, maybe the base-index is not available in this namespace */
+      OONF_DEBUG(
+        LOG_ETH, "Could not get interface name of index %u: %s (%d)", os_if->base_index, strerror(errno), errno);
+      return;
+    }
+  }
+  else {
+    /* copy interface name directly */
+    strscpy(req.ifr_name, os_if->name, IF_NAMESIZE);
+  }
+
+  /* request ethernet information from kernel */
+  _stats.queries++;
+  err = ioctl(_ioctl_sock, SIOCETHTOOL, &req);
+  if (err != 0) {
+    return;
+  }
+
+  /* get ethernet linkspeed */
+  ethspeed = ethtool_cmd_speed(&cmd);
+  if (ethspeed == 0 || ethspeed == (uint16_t)-1 || ethspeed == (uint32_t)-1) {
+    /* speed is not known */
+    return;
+  }
+  ethspeed *= 1000 * 1000;
+  eth_if->duplex = cmd.duplex;
+
+  /* layer-2 object for this interface */
+  l2net = oonf_layer2_net_add(os_if->name);
+  if (l2net == NULL) {
+    return;
+  }
+  if (l2net->if_type == OONF_LAYER2_TYPE_UNDEFINED) {
+    l2net->if_type = OONF_LAYER2_TYPE_ETHERNET;
+  }
+
+  /* set corresponding database entries */
+  changed = oonf_layer2_data_set_int64(&l2net->neighdata[OONF_LAYER2_NEIGH_RX_BITRATE], &_l2_origin, ethspeed);
+  changed |= oonf_layer2_data_set_int64(&l2net->neighdata[OONF_LAYER2_NEIGH_TX_BITRATE], &_l2_origin, ethspeed);
+  eth_if->speed = ethspeed;
+
+  if (!changed) {
+    /* nothing new, do not trigger the layer2 listeners */
+    _stats.suppressed++;
+    return;
+  }
+
+  OONF_DEBUG(LOG_ETH, "Set default link speed of interface %s to %s", os_if->name,
+    isonumber_from_s64(&ibuf, ethspeed, "bit/s", 0, false));
+
+  _stats.updates++;
+  oonf_layer2_net_commit(l2net);
+}
+
+/**
+ * Callback for querying ethernet status
+ * @param ptr timer instance that fired
+ */
+static void
+_cb_transmission_event(struct oonf_timer_instance *ptr __attribute((unused))) {
+  struct _eth_if *eth_if, *eth_if_it;
+  struct os_interface *os_if;
+
+  avl_for_each_element(&_eth_if_tree, eth_if, _node) {
+    eth_if->seen = false;
+  }
+
   avl_for_each_element(os_interface_get_tree(), os_if, _node) {
-    /* initialize ethtool command */
-    memset(&cmd, 0, sizeof(cmd));
-    cmd.cmd = ETHTOOL_GSET;
-
-    /* initialize interface request */
-    memset(&req, 0, sizeof(req));
-    req.ifr_data = (void *)&cmd;
-
-    if (os_if->base_index != os_if->index) {
-      /* get name of base interface */
-      if (if_indextoname(os_if->base_index, req.ifr_name) == NULL) {
-        /* do not use WARN, maybe the base-index is not available in this namespace */
-        OONF_DEBUG(
-          LOG_ETH, "Could not get interface name of index %u: %s (%d)", os_if->base_index, strerror(errno), errno);
-        continue;
-      }
+    eth_if = _eth_if_add(os_if->index);
+    if (!eth_if) {
+      continue;
     }
-    else {
-      /* copy interface name directly */
-      strscpy(req.ifr_name, os_if->name, IF_NAMESIZE);
+
+    eth_if->seen = true;
+    eth_if->dirty = false;
+    _query_interface(eth_if, os_if);
+  }
+
+  /* remove interfaces that are gone */
+  avl_for_each_element_safe(&_eth_if_tree, eth_if, _node, eth_if_it) {
+    if (!eth_if->seen) {
+      _eth_if_remove(eth_if);
     }
+  }
+}
 
-    /* request ethernet information from kernel */
-    err = ioctl(_ioctl_sock, SIOCETHTOOL, &req);
-    if (err != 0) {
+/**
+ * Callback for querying the interfaces that changed
+ * since the last query.
+ * @param ptr timer instance that fired
+ */
+static void
+_cb_event_delay(struct oonf_timer_instance *ptr __attribute((unused))) {
+  struct _eth_if *eth_if;
+  struct os_interface *os_if;
+
+  avl_for_each_element(&_eth_if_tree, eth_if, _node) {
+    if (!eth_if->dirty) {
       continue;
     }
 
-    /* get ethernet linkspeed */
-    ethspeed = ethtool_cmd_speed(&cmd);
-    if (ethspeed == 0 || ethspeed == (uint16_t)-1 || ethspeed == (uint32_t)-1) {
-      /* speed is not known */
-      continue;
+    eth_if->dirty = false;
+    os_if = os_interface_get_data_by_ifindex(eth_if->index);
+    if (os_if) {
+      _query_interface(eth_if, os_if);
     }
-    ethspeed *= 1000 * 1000;
+  }
+}
 
-    /* layer-2 object for this interface */
-    l2net = oonf_layer2_net_add(os_if->name);
-    if (l2net == NULL) {
-      continue;
+/**
+ * Handle an incoming rtnetlink link message
+ * @param hdr pointer to netlink message
+ */
+static void
+_cb_nl_message(struct nlmsghdr *hdr) {
+  struct ifinfomsg *ifi_msg;
+  struct rtattr *ifi_attr;
+  struct _eth_if *eth_if;
+  unsigned if_index, link_flags;
+  uint8_t operstate;
+  int ifi_len;
+
+  if (hdr->nlmsg_type != RTM_NEWLINK && hdr->nlmsg_type != RTM_DELLINK) {
+    return;
+  }
+
+  ifi_msg = NLMSG_DATA(hdr);
+  if_index = ifi_msg->ifi_index;
+  if (!os_interface_get_data_by_ifindex(if_index)) {
+    /* nobody is interested in this interface */
+    return;
+  }
+
+  eth_if = avl_find_element(&_eth_if_tree, &if_index, eth_if, _node);
+  if (hdr->nlmsg_type == RTM_DELLINK) {
+    if (eth_if) {
+      _eth_if_remove(eth_if);
+    }
+    return;
+  }
+
+  /* IF_OPER_UNKNOWN */
+  operstate = 0;
+  ifi_attr = (struct rtattr *)IFLA_RTA(ifi_msg);
+  ifi_len = RTM_PAYLOAD(hdr);
+  for (; RTA_OK(ifi_attr, ifi_len); ifi_attr = RTA_NEXT(ifi_attr, ifi_len)) {
+    if (ifi_attr->rta_type == IFLA_OPERSTATE) {
+      operstate = *(uint8_t *)RTA_DATA(ifi_attr);
     }
-    if (l2net->if_type == OONF_LAYER2_TYPE_UNDEFINED) {
-      l2net->if_type = OONF_LAYER2_TYPE_ETHERNET;
+  }
+  link_flags = ifi_msg->ifi_flags & (IFF_UP | IFF_RUNNING);
+
+  if (eth_if && eth_if->link_flags == link_flags && eth_if->operstate == operstate) {
+    /* speed and duplex only change together with the link state */
+    return;
+  }
+
+  if (!eth_if) {
+    eth_if = _eth_if_add(if_index);
+    if (!eth_if) {
+      return;
     }
+  }
 
-    /* set corresponding database entries */
-    OONF_DEBUG(LOG_ETH, "Set default link speed of interface %s to %s", os_if->name,
-      isonumber_from_s64(&ibuf, ethspeed, "bit/s", 0, false));
+  eth_if->link_flags = link_flags;
+  eth_if->operstate = operstate;
+  eth_if->dirty = true;
+  _stats.events++;
 
-    oonf_layer2_data_set_int64(&l2net->neighdata[OONF_LAYER2_NEIGH_RX_BITRATE], &_l2_origin, ethspeed);
-    oonf_layer2_data_set_int64(&l2net->neighdata[OONF_LAYER2_NEIGH_TX_BITRATE], &_l2_origin, ethspeed);
+  /* give the link some time to negotiate the speed */
+  if (!oonf_timer_is_active(&_event_timer)) {
+    oonf_timer_set(&_event_timer, ETH_LISTENER_EVENT_DELAY);
   }
 }
 
+/**
+ * Handle the telnet command of the eth listener
+ * @param data telnet data
+ * @return telnet result code
+ */
+static enum oonf_telnet_result
+_cb_telnet_eth_listener(struct oonf_telnet_data *data) {
+  struct _eth_if *eth_if;
+  struct os_interface *os_if;
+  struct isonumber_str ibuf;
+
+  abuf_appendf(data->out, "queries: %" PRIu64 "\n", _stats.queries);
+  abuf_appendf(data->out, "link events: %" PRIu64 "\n", _stats.events);
+  abuf_appendf(data->out, "updates: %" PRIu64 "\n", _stats.updates);
+  abuf_appendf(data->out, "suppressed updates: %" PRIu64 "\n", _stats.suppressed);
+
+  avl_for_each_element(&_eth_if_tree, eth_if, _node) {
+    os_if = os_interface_get_data_by_ifindex(eth_if->index);
+    abuf_appendf(data->out, "%s (%u): %s %s\n", os_if ? os_if->name : "-", eth_if->index,
+      isonumber_from_s64(&ibuf, eth_if->speed, "bit/s", 0, false),
+      eth_if->duplex == DUPLEX_FULL ? "full-duplex" : (eth_if->duplex == DUPLEX_HALF ? "half-duplex" : "-"));
+  }
+  return TELNET_RESULT_ACTIVE;
+}
+
 static void
 _cb_config_changed(void) {
   if (cfg_schema_tobin(&_config, _eth_section.post, _eth_entries, ARRAYSIZE(_eth_entries))) {
@@ -236,4 +560,14 @@ _cb_config_changed(void) {
   }
 
   oonf_timer_set_ext(&_transmission_timer, 1, _config.interval);
+
+  if (_config.events && !_events_subscribed) {
+    if (os_system_linux_netlink_add_mc(&_rtnetlink_receiver, _rtnetlink_mcast, ARRAYSIZE(_rtnetlink_mcast)) == 0) {
+      _events_subscribed = true;
+    }
+  }
+  else if (!_config.events && _events_subscribed) {
+    os_system_linux_netlink_drop_mc(&_rtnetlink_receiver, (const int *)_rtnetlink_mcast, ARRAYSIZE(_rtnetlink_mcast));
+    _events_subscribed = false;
+  }
 }
@@ -89,6 +89,9 @@ struct _l2_generator_config {
 
   /*! proxied MAC behind neighbor for event generation */
   struct netaddr destination;
+
+  /*! number of samples kept in the history of each generated value */
+  int32_t history;
 };
 
 static struct oonf_timer_class _l2gen_timer_info = {
@@ -112,6 +115,8 @@ static struct cfg_schema_entry _l2gen_entries[] = {
   CFG_MAP_NETADDR_MAC48(_l2_generator_config, destination, "destination", "02:00:00:00:00:02",
     "Mac address of example radio destination", false, true),
   CFG_MAP_BOOL(_l2_generator_config, active, "active", "false", "Activates artificially generated layer2 data"),
+  CFG_MAP_INT32_MINMAX(_l2_generator_config, history, "history", "0",
+    "Number of samples kept in the history of each generated value, 0 to disable", 0, 0, OONF_LAYER2_HISTORY_MAX),
 };
 
 static struct cfg_schema_section _l2gen_section = {
@@ -259,6 +264,7 @@ _cb_config_changed(void) {
   }
 
   cfg_get_phy_if(_l2gen_config.interface, _l2gen_config.interface);
+  _origin.history_size = _l2gen_config.history;
 
   OONF_DEBUG(LOG_L2GEN, "Generator is now %s for interface %s\n", _l2gen_config.active ? "active" : "inactive",
     _l2gen_config.interface);
@@ -47,6 +47,7 @@
 
 #include "common/autobuf.h"
 #include "common/common_types.h"
+#include "common/isonumber.h"
 #include "common/netaddr.h"
 #include "common/netaddr_acl.h"
 #include "common/string.h"
@@ -54,6 +55,7 @@
 
 #include "core/oonf_logging.h"
 #include "core/oonf_subsystem.h"
+#include "subsystems/oonf_class.h"
 #include "subsystems/oonf_clock.h"
 #include "subsystems/oonf_layer2.h"
 #include "subsystems/oonf_telnet.h"
@@ -70,6 +72,9 @@ static void _cleanup(void);
 
 static enum oonf_telnet_result _cb_layer2info(struct oonf_telnet_data *con);
 static enum oonf_telnet_result _cb_layer2info_help(struct oonf_telnet_data *con);
+static uint64_t _cb_layer2info_generation(struct oonf_telnet_data *con);
+static uint64_t _cb_get_layer2_generation(void);
+static void _cb_layer2_changed(void *ptr);
 
 static void _initialize_if_data_values(struct oonf_viewer_template *template, struct oonf_layer2_data *data);
 static void _initialize_if_origin_values(struct oonf_layer2_data *data);
@@ -80,6 +85,8 @@ static void _initialize_neigh_data_values(struct oonf_viewer_template *template,
 static void _initialize_neigh_origin_values(struct oonf_layer2_data *data);
 static void _initialize_neigh_values(struct oonf_layer2_neigh *neigh);
 static void _initialize_neigh_ip_values(struct oonf_layer2_neighbor_address *neigh_addr);
+static bool _initialize_history_values(struct oonf_viewer_template *template, const struct oonf_layer2_data *data,
+  const struct oonf_layer2_metadata *meta);
 
 static int _cb_create_text_interface(struct oonf_viewer_template *);
 static int _cb_create_text_interface_ip(struct oonf_viewer_template *);
@@ -87,6 +94,8 @@ static int _cb_create_text_neighbor(struct oonf_viewer_template *);
 static int _cb_create_text_neighbor_ip(struct oonf_viewer_template *);
 static int _cb_create_text_default(struct oonf_viewer_template *);
 static int _cb_create_text_dst(struct oonf_viewer_template *);
+static int _cb_create_text_interface_history(struct oonf_viewer_template *);
+static int _cb_create_text_neighbor_history(struct oonf_viewer_template *);
 
 /*
  * list of template keys and corresponding buffers for values.
@@ -142,6 +151,27 @@ static int _cb_create_text_dst(struct oonf_viewer_template *);
 /*! template key for destination origin */
 #define KEY_DST_ORIGIN "dst_origin"
 
+/*! template key for layer2 data key of a history */
+#define KEY_HISTORY_KEY "history_key"
+
+/*! template key for number of samples in a history */
+#define KEY_HISTORY_SAMPLES "history_samples"
+
+/*! template key for time between oldest and newest sample of a history */
+#define KEY_HISTORY_SPAN "history_span"
+
+/*! template key for minimum value of a history */
+#define KEY_HISTORY_MIN "history_min"
+
+/*! template key for maximum value of a history */
+#define KEY_HISTORY_MAX "history_max"
+
+/*! template key for average value of a history */
+#define KEY_HISTORY_AVG "history_avg"
+
+/*! template key for change of value per second of a history */
+#define KEY_HISTORY_RATE "history_rate"
+
 /*! string prefix for all interface keys */
 #define KEY_IF_PREFIX "if_"
 
@@ -177,6 +207,14 @@ static char _value_neigh_origin[OONF_LAYER2_NEIGH_COUNT][IF_NAMESIZE];
 static struct netaddr_str _value_dst_addr;
 static char _value_dst_origin[IF_NAMESIZE];
 
+static char _value_history_key[OONF_LAYER2_METADATA_KEY_LEN + 1];
+static char _value_history_samples[12];
+static struct isonumber_str _value_history_span;
+static struct isonumber_str _value_history_min;
+static struct isonumber_str _value_history_max;
+static struct isonumber_str _value_history_avg;
+static struct isonumber_str _value_history_rate;
+
 /* definition of the template data entries for JSON and table output */
 static struct abuf_template_data_entry _tde_if_key[] = {
   { KEY_IF, _value_if, true },
@@ -223,6 +261,16 @@ static struct abuf_template_data_entry _tde_dst[] = {
   { KEY_DST_ORIGIN, _value_dst_origin, true },
 };
 
+static struct abuf_template_data_entry _tde_history[] = {
+  { KEY_HISTORY_KEY, _value_history_key, true },
+  { KEY_HISTORY_SAMPLES, _value_history_samples, false },
+  { KEY_HISTORY_SPAN, _value_history_span.buf, false },
+  { KEY_HISTORY_MIN, _value_history_min.buf, false },
+  { KEY_HISTORY_MAX, _value_history_max.buf, false },
+  { KEY_HISTORY_AVG, _value_history_avg.buf, false },
+  { KEY_HISTORY_RATE, _value_history_rate.buf, false },
+};
+
 static struct abuf_template_storage _template_storage;
 static struct autobuf _key_storage;
 
@@ -260,6 +308,15 @@ static struct abuf_template_data _td_dst[] = {
   { _tde_dst_key, ARRAYSIZE(_tde_dst_key) },
   { _tde_dst, ARRAYSIZE(_tde_dst) },
 };
+static struct abuf_template_data _td_if_history[] = {
+  { _tde_if_key, ARRAYSIZE(_tde_if_key) },
+  { _tde_history, ARRAYSIZE(_tde_history) },
+};
+static struct abuf_template_data _td_neigh_history[] = {
+  { _tde_if_key, ARRAYSIZE(_tde_if_key) },
+  { _tde_neigh_key, ARRAYSIZE(_tde_neigh_key) },
+  { _tde_history, ARRAYSIZE(_tde_history) },
+};
 
 /* OONF viewer templates (based on Template Data arrays) */
 static struct oonf_viewer_template _templates[] = {
@@ -274,6 +331,7 @@ static struct oonf_viewer_template _templates[] = {
     .data_size = ARRAYSIZE(_td_if_ips),
     .json_name = "interface_ip",
     .cb_function = _cb_create_text_interface_ip,
+    .cb_generation = _cb_get_layer2_generation,
   },
   {
     .data = _td_neigh,
@@ -286,28 +344,84 @@ static struct oonf_viewer_template _templates[] = {
     .data_size = ARRAYSIZE(_td_neigh_ips),
     .json_name = "neighbor_ip",
     .cb_function = _cb_create_text_neighbor_ip,
+    .cb_generation = _cb_get_layer2_generation,
   },
   {
     .data = _td_default,
     .data_size = ARRAYSIZE(_td_default),
     .json_name = "default",
     .cb_function = _cb_create_text_default,
+    .cb_generation = _cb_get_layer2_generation,
   },
   {
     .data = _td_dst,
     .data_size = ARRAYSIZE(_td_dst),
     .json_name = "destination",
     .cb_function = _cb_create_text_dst,
+    .cb_generation = _cb_get_layer2_generation,
+  },
+  {
+    .data = _td_if_history,
+    .data_size = ARRAYSIZE(_td_if_history),
+    .json_name = "interface_history",
+    .cb_function = _cb_create_text_interface_history,
+  },
+  {
+    .data = _td_neigh_history,
+    .data_size = ARRAYSIZE(_td_neigh_history),
+    .json_name = "neighbor_history",
+    .cb_function = _cb_create_text_neighbor_history,
   },
 };
 
 /* telnet command of this plugin */
 static struct oonf_telnet_command _telnet_commands[] = {
-  TELNET_CMD(OONF_LAYER2INFO_SUBSYSTEM, _cb_layer2info, "", .help_handler = _cb_layer2info_help),
+  TELNET_CMD(OONF_LAYER2INFO_SUBSYSTEM, _cb_layer2info, "", .help_handler = _cb_layer2info_help,
+    .generation_handler = _cb_layer2info_generation),
 };
 
+/* listeners for changes of the layer2 database */
+static struct oonf_class_extension _layer2_listeners[] = {
+  {
+    .ext_name = "layer2info generation",
+    .class_name = LAYER2_CLASS_NETWORK,
+    .cb_add = _cb_layer2_changed,
+    .cb_change = _cb_layer2_changed,
+    .cb_remove = _cb_layer2_changed,
+  },
+  {
+    .ext_name = "layer2info generation",
+    .class_name = LAYER2_CLASS_NEIGHBOR,
+    .cb_add = _cb_layer2_changed,
+    .cb_change = _cb_layer2_changed,
+    .cb_remove = _cb_layer2_changed,
+  },
+  {
+    .ext_name = "layer2info generation",
+    .class_name = LAYER2_CLASS_DESTINATION,
+    .cb_add = _cb_layer2_changed,
+    .cb_remove = _cb_layer2_changed,
+  },
+  {
+    .ext_name = "layer2info generation",
+    .class_name = LAYER2_CLASS_NETWORK_ADDRESS,
+    .cb_add = _cb_layer2_changed,
+    .cb_remove = _cb_layer2_changed,
+  },
+  {
+    .ext_name = "layer2info generation",
+    .class_name = LAYER2_CLASS_NEIGHBOR_ADDRESS,
+    .cb_add = _cb_layer2_changed,
+    .cb_remove = _cb_layer2_changed,
+  },
+};
+
+/* generation counter of the layer2 database */
+static uint64_t _layer2_generation = 1;
+
 /* plugin declaration */
 static const char *_dependencies[] = {
+  OONF_CLASS_SUBSYSTEM,
   OONF_CLOCK_SUBSYSTEM,
   OONF_LAYER2_SUBSYSTEM,
   OONF_TELNET_SUBSYSTEM,
@@ -373,6 +487,9 @@ _init(void) {
     abuf_memcpy(&_key_storage, "\0", 1);
   }
 
+  for (i = 0; i < ARRAYSIZE(_layer2_listeners); i++) {
+    oonf_class_extension_add(&_layer2_listeners[i]);
+  }
   oonf_telnet_add(&_telnet_commands[0]);
 
   return abuf_has_failed(&_key_storage) ? -1 : 0;
@@ -383,7 +500,12 @@ _init(void) {
  */
 static void
 _cleanup(void) {
+  size_t i;
+
   oonf_telnet_remove(&_telnet_commands[0]);
+  for (i = 0; i < ARRAYSIZE(_layer2_listeners); i++) {
+    oonf_class_extension_remove(&_layer2_listeners[i]);
+  }
   abuf_free(&_key_storage);
 }
 
@@ -395,7 +517,7 @@ _cleanup(void) {
 static enum oonf_telnet_result
 _cb_layer2info(struct oonf_telnet_data *con) {
   return oonf_viewer_telnet_handler(
-    con->out, &_template_storage, OONF_LAYER2INFO_SUBSYSTEM, con->parameter, _templates, ARRAYSIZE(_templates));
+    con, &_template_storage, OONF_LAYER2INFO_SUBSYSTEM, _templates, ARRAYSIZE(_templates));
 }
 
 /**
@@ -409,6 +531,33 @@ _cb_layer2info_help(struct oonf_telnet_data *con) {
     con->out, OONF_LAYER2INFO_SUBSYSTEM, con->parameter, _templates, ARRAYSIZE(_templates));
 }
 
+/**
+ * Callback for the generation number of the output of this plugin
+ * @param con pointer to telnet session data
+ * @return generation number, 0 if output cannot be cached
+ */
+static uint64_t
+_cb_layer2info_generation(struct oonf_telnet_data *con) {
+  return oonf_viewer_get_generation(con->parameter, _templates, ARRAYSIZE(_templates));
+}
+
+/**
+ * @return generation number of the layer2 database
+ */
+static uint64_t
+_cb_get_layer2_generation(void) {
+  return _layer2_generation;
+}
+
+/**
+ * Callback for changes of layer2 database objects
+ * @param ptr unused
+ */
+static void
+_cb_layer2_changed(void *ptr __attribute__((unused))) {
+  _layer2_generation++;
+}
+
 /**
  * Initialize the value buffers for a layer2 interface
  * @param net pointer to layer2 interface
@@ -547,6 +696,32 @@ _initialize_destination_values(struct oonf_layer2_destination *l2dst) {
   strscpy(_value_dst_origin, l2dst->origin->name, IF_NAMESIZE);
 }
 
+/**
+ * Initialize the value buffers for the history of a layer2 data object
+ * @param template viewer template
+ * @param data layer2 data object
+ * @param meta metadata of layer2 data object
+ * @return true if the data object has a history, false otherwise
+ */
+static bool
+_initialize_history_values(struct oonf_viewer_template *template, const struct oonf_layer2_data *data,
+  const struct oonf_layer2_metadata *meta) {
+  struct oonf_layer2_history_stats stats;
+
+  if (oonf_layer2_data_get_history_stats(&stats, data, 0)) {
+    return false;
+  }
+
+  strscpy(_value_history_key, meta->key, sizeof(_value_history_key));
+  snprintf(_value_history_samples, sizeof(_value_history_samples), "%" PRINTF_SIZE_T_SPECIFIER, stats.count);
+  oonf_clock_toIntervalString(&_value_history_span, stats.span);
+  isonumber_from_s64(&_value_history_min, stats.min, meta->unit, meta->fraction, template->create_raw);
+  isonumber_from_s64(&_value_history_max, stats.max, meta->unit, meta->fraction, template->create_raw);
+  isonumber_from_s64(&_value_history_avg, stats.avg, meta->unit, meta->fraction, template->create_raw);
+  isonumber_from_s64(&_value_history_rate, stats.rate, meta->unit, meta->fraction, template->create_raw);
+  return true;
+}
+
 /**
  * Callback to generate text/json description of all layer2 interfaces
  * @param template viewer template
@@ -691,3 +866,56 @@ _cb_create_text_dst(struct oonf_viewer_template *template) {
   }
   return 0;
 }
+
+/**
+ * Callback to generate text/json description of the recorded history
+ * of all layer2 interface data
+ * @param template viewer template
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_interface_history(struct oonf_viewer_template *template) {
+  struct oonf_layer2_net *net;
+  size_t i;
+
+  avl_for_each_element(oonf_layer2_get_net_tree(), net, _node) {
+    _initialize_if_values(net);
+
+    for (i = 0; i < OONF_LAYER2_NET_COUNT; i++) {
+      if (_initialize_history_values(template, &net->data[i], oonf_layer2_net_metadata_get(i))) {
+        /* generate template output */
+        oonf_viewer_output_print_line(template);
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ * Callback to generate text/json description of the recorded history
+ * of all layer2 neighbor data
+ * @param template viewer template
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_neighbor_history(struct oonf_viewer_template *template) {
+  struct oonf_layer2_neigh *neigh;
+  struct oonf_layer2_net *net;
+  size_t i;
+
+  avl_for_each_element(oonf_layer2_get_net_tree(), net, _node) {
+    _initialize_if_values(net);
+
+    avl_for_each_element(&net->neighbors, neigh, _node) {
+      _initialize_neigh_values(neigh);
+
+      for (i = 0; i < OONF_LAYER2_NEIGH_COUNT; i++) {
+        if (_initialize_history_values(template, &neigh->data[i], oonf_layer2_neigh_metadata_get(i))) {
+          /* generate template output */
+          oonf_viewer_output_print_line(template);
+        }
+      }
+    }
+  }
+  return 0;
+}
@@ -79,7 +79,10 @@
 #include <netlink/genl/genl.h>
 #include <netlink/msg.h>
 
+#include "common/avl.h"
 #include "common/common_types.h"
+#include "common/netaddr.h"
+#include "subsystems/oonf_class.h"
 #include "subsystems/oonf_clock.h"
 #include "subsystems/os_system.h"
 
@@ -87,9 +90,57 @@
 #include "nl80211_listener/nl80211_internal.h"
 #include "nl80211_listener/nl80211_listener.h"
 
+/**
+ * Station reported by the running station dump of an interface
+ */
+struct _dump_station {
+  /*! MAC address of station */
+  struct netaddr mac;
+
+  /*! hook into tree of stations of the nl80211 interface */
+  struct avl_node _node;
+};
+
+static void _process_station(struct nl80211_if *interf, struct nlmsghdr *hdr, bool event);
+static void _add_dump_station(struct nl80211_if *interf, const struct netaddr *mac);
 static bool _handle_traffic(struct oonf_layer2_neigh *l2neigh, enum oonf_layer2_neighbor_index idx, uint32_t new_32bit);
 static int64_t _get_bitrate(struct nlattr *bitrate_attr);
 
+static struct oonf_class _dump_station_class = {
+  .name = "nl80211 dump station",
+  .size = sizeof(struct _dump_station),
+};
+
+/**
+ * Initialize the storage for the stations seen by a station dump
+ */
+void
+nl80211_init_station_dump(void) {
+  oonf_class_add(&_dump_station_class);
+}
+
+/**
+ * Cleanup the storage for the stations seen by a station dump
+ */
+void
+nl80211_cleanup_station_dump(void) {
+  oonf_class_remove(&_dump_station_class);
+}
+
+/**
+ * Forget all stations seen by the last station dump of an interface
+ * @param interf nl80211 listener interface
+ */
+void
+nl80211_clear_station_dump(struct nl80211_if *interf) {
+  struct _dump_station *station, *station_it;
+
+  avl_for_each_element_safe(&interf->_dump_stations, station, _node, station_it) {
+    avl_remove(&interf->_dump_stations, &station->_node);
+    oonf_class_free(&_dump_station_class, station);
+  }
+}
+
 /**
  * Send a netlink message to get the nl80211 station dump
  * @param nl pointer to netlink handler
@@ -102,6 +153,9 @@ nl80211_send_get_station_dump(
   struct os_system_netlink *nl, struct nlmsghdr *nl_msg, struct genlmsghdr *hdr, struct nl80211_if *interf) {
   int if_index = nl80211_get_if_baseindex(interf);
 
+  /* a new dump starts, forget the stations of an aborted one */
+  nl80211_clear_station_dump(interf);
+
   hdr->cmd = NL80211_CMD_GET_STATION;
   nl_msg->nlmsg_flags |= NLM_F_DUMP;
 
@@ -110,14 +164,103 @@ nl80211_send_get_station_dump(
 }
 
 /**
- * Process NL80211_CMD_NEW_STATION message
+ * Process NL80211_CMD_NEW_STATION message of a station dump
  * @param interf nl80211 listener interface
  * @param hdr pointer to netlink message header
  */
 void
 nl80211_process_get_station_dump_result(struct nl80211_if *interf, struct nlmsghdr *hdr) {
+  _process_station(interf, hdr, false);
+}
+
+/**
+ * Remove all stations of an interface which were missing from
+ * the station dump
+ * @param interf nl80211 listener interface
+ */
+void
+nl80211_finalize_get_station_dump(struct nl80211_if *interf) {
+  struct oonf_layer2_neigh *l2neigh, *l2neigh_it;
+#ifdef OONF_LOG_DEBUG_INFO
+  struct netaddr_str nbuf;
+#endif
+
+  avl_for_each_element_safe(&interf->l2net->neighbors, l2neigh, _node, l2neigh_it) {
+    if (netaddr_cmp(&l2neigh->addr, &NETADDR_MAC48_BROADCAST) == 0) {
+      /* the broadcast neighbor is generated by the interface query */
+      if (nl80211_create_broadcast_neighbor()) {
+        nl80211_relabel_l2neigh_data(l2neigh);
+      }
+      else {
+        nl80211_remove_l2neigh(l2neigh);
+      }
+    }
+    else if (!avl_find(&interf->_dump_stations, &l2neigh->addr)) {
+      OONF_DEBUG(LOG_NL80211, "Station %s missing from dump of %s", netaddr_to_string(&nbuf, &l2neigh->addr),
+        interf->name);
+      nl80211_remove_l2neigh(l2neigh);
+    }
+  }
+
+  nl80211_clear_station_dump(interf);
+}
+
+/**
+ * Process NL80211_CMD_NEW_STATION multicast event
+ * @param interf nl80211 listener interface
+ * @param hdr pointer to netlink message header
+ */
+void
+nl80211_process_new_station_event(struct nl80211_if *interf, struct nlmsghdr *hdr) {
+  _process_station(interf, hdr, true);
+}
+
+/**
+ * Process NL80211_CMD_DEL_STATION multicast event
+ * @param interf nl80211 listener interface
+ * @param hdr pointer to netlink message header
+ */
+void
+nl80211_process_del_station_event(struct nl80211_if *interf, struct nlmsghdr *hdr) {
+  struct oonf_layer2_neigh *l2neigh;
+  struct netaddr l2neigh_mac;
+  struct nlattr *tb[NL80211_ATTR_MAX + 1];
+  struct genlmsghdr *gnlh;
+#ifdef OONF_LOG_DEBUG_INFO
+  struct netaddr_str nbuf;
+#endif
+
+  gnlh = nlmsg_data(hdr);
+
+  nla_parse(tb, NL80211_ATTR_MAX, genlmsg_attrdata(gnlh, 0), genlmsg_attrlen(gnlh, 0), NULL);
+
+  if (!tb[NL80211_ATTR_MAC]) {
+    /* station address missing */
+    return;
+  }
+
+  netaddr_from_binary(&l2neigh_mac, nla_data(tb[NL80211_ATTR_MAC]), 6, AF_MAC48);
+
+  l2neigh = oonf_layer2_neigh_get(interf->l2net, &l2neigh_mac);
+  if (l2neigh) {
+    OONF_DEBUG(LOG_NL80211, "Station %s left %s", netaddr_to_string(&nbuf, &l2neigh_mac), interf->name);
+    nl80211_remove_l2neigh(l2neigh);
+  }
+}
+
+/**
+ * Parse the station information of a NL80211_CMD_NEW_STATION message
+ * and commit the layer2 neighbor if its data changed.
+ * @param interf nl80211 listener interface
+ * @param hdr pointer to netlink message header
+ * @param event true if message is a multicast event, false if its
+ *   part of a station dump
+ */
+static void
+_process_station(struct nl80211_if *interf, struct nlmsghdr *hdr, bool event) {
   struct oonf_layer2_neigh *l2neigh;
   struct netaddr l2neigh_mac;
+  bool changed;
 
   struct nlattr *tb[NL80211_ATTR_MAX + 1];
   struct genlmsghdr *gnlh;
@@ -143,7 +286,7 @@ nl80211_process_get_station_dump_result(struct nl80211_if *interf, struct nlmsgh
 
   nla_parse(tb, NL80211_ATTR_MAX, genlmsg_attrdata(gnlh, 0), genlmsg_attrlen(gnlh, 0), NULL);
 
-  if (!tb[NL80211_ATTR_STA_INFO]) {
+  if (!tb[NL80211_ATTR_STA_INFO] || !tb[NL80211_ATTR_MAC] || !tb[NL80211_ATTR_IFINDEX]) {
     /* station info missing */
     return;
   }
@@ -159,7 +302,11 @@ nl80211_process_get_station_dump_result(struct nl80211_if *interf, struct nlmsgh
 
   netaddr_from_binary(&l2neigh_mac, nla_data(tb[NL80211_ATTR_MAC]), 6, AF_MAC48);
 
-  OONF_DEBUG(LOG_NL80211, "Received Station Dump for %s", netaddr_to_string(&nbuf, &l2neigh_mac));
+  OONF_DEBUG(LOG_NL80211, "Received %s for %s", event ? "new station event" : "station dump",
+    netaddr_to_string(&nbuf, &l2neigh_mac));
+
+  /* a new neighbor must always be committed */
+  changed = oonf_layer2_neigh_get(interf->l2net, &l2neigh_mac) == NULL;
 
   l2neigh = oonf_layer2_neigh_add(interf->l2net, &l2neigh_mac);
   if (!l2neigh) {
@@ -170,40 +317,45 @@ nl80211_process_get_station_dump_result(struct nl80211_if *interf, struct nlmsgh
   if (sinfo[NL80211_STA_INFO_INACTIVE_TIME]) {
     l2neigh->last_seen = oonf_clock_get_absolute(-((int64_t)(nla_get_u32(sinfo[NL80211_STA_INFO_INACTIVE_TIME]))));
   }
+  else if (event) {
+    l2neigh->last_seen = oonf_clock_getNow();
+  }
 
   /* byte data is 64 bit */
   if (sinfo[NL80211_STA_INFO_RX_BYTES64]) {
-    nl80211_change_l2neigh_data(l2neigh, OONF_LAYER2_NEIGH_RX_BYTES, nla_get_u64(sinfo[NL80211_STA_INFO_RX_BYTES64]));
+    changed |= nl80211_change_l2neigh_data(
+      l2neigh, OONF_LAYER2_NEIGH_RX_BYTES, nla_get_u64(sinfo[NL80211_STA_INFO_RX_BYTES64]));
   }
   if (sinfo[NL80211_STA_INFO_TX_BYTES64]) {
-    nl80211_change_l2neigh_data(l2neigh, OONF_LAYER2_NEIGH_TX_BYTES, nla_get_u64(sinfo[NL80211_STA_INFO_TX_BYTES64]));
+    changed |= nl80211_change_l2neigh_data(
+      l2neigh, OONF_LAYER2_NEIGH_TX_BYTES, nla_get_u64(sinfo[NL80211_STA_INFO_TX_BYTES64]));
   }
 
   /* packet data is only 32 bit */
   if (sinfo[NL80211_STA_INFO_RX_PACKETS]) {
-    _handle_traffic(l2neigh, OONF_LAYER2_NEIGH_RX_FRAMES, nla_get_u32(sinfo[NL80211_STA_INFO_RX_PACKETS]));
+    changed |= _handle_traffic(l2neigh, OONF_LAYER2_NEIGH_RX_FRAMES, nla_get_u32(sinfo[NL80211_STA_INFO_RX_PACKETS]));
   }
   if (sinfo[NL80211_STA_INFO_TX_PACKETS]) {
-    _handle_traffic(l2neigh, OONF_LAYER2_NEIGH_TX_FRAMES, nla_get_u32(sinfo[NL80211_STA_INFO_TX_PACKETS]));
+    changed |= _handle_traffic(l2neigh, OONF_LAYER2_NEIGH_TX_FRAMES, nla_get_u32(sinfo[NL80211_STA_INFO_TX_PACKETS]));
   }
   if (sinfo[NL80211_STA_INFO_TX_RETRIES]) {
-    _handle_traffic(l2neigh, OONF_LAYER2_NEIGH_TX_RETRIES, nla_get_u32(sinfo[NL80211_STA_INFO_TX_RETRIES]));
+    changed |= _handle_traffic(l2neigh, OONF_LAYER2_NEIGH_TX_RETRIES, nla_get_u32(sinfo[NL80211_STA_INFO_TX_RETRIES]));
   }
   if (sinfo[NL80211_STA_INFO_TX_FAILED]) {
-    _handle_traffic(l2neigh, OONF_LAYER2_NEIGH_TX_FAILED, nla_get_u32(sinfo[NL80211_STA_INFO_TX_FAILED]));
+    changed |= _handle_traffic(l2neigh, OONF_LAYER2_NEIGH_TX_FAILED, nla_get_u32(sinfo[NL80211_STA_INFO_TX_FAILED]));
   }
 
   /* bitrates are special */
   if (sinfo[NL80211_STA_INFO_TX_BITRATE]) {
     int64_t rate = _get_bitrate(sinfo[NL80211_STA_INFO_TX_BITRATE]);
     if (rate) {
-      nl80211_change_l2neigh_data(l2neigh, OONF_LAYER2_NEIGH_TX_BITRATE, rate);
+      changed |= nl80211_change_l2neigh_data(l2neigh, OONF_LAYER2_NEIGH_TX_BITRATE, rate);
     }
   }
   if (sinfo[NL80211_STA_INFO_RX_BITRATE]) {
     int64_t rate = _get_bitrate(sinfo[NL80211_STA_INFO_RX_BITRATE]);
     if (rate) {
-      nl80211_change_l2neigh_data(l2neigh, OONF_LAYER2_NEIGH_RX_BITRATE, rate);
+      changed |= nl80211_change_l2neigh_data(l2neigh, OONF_LAYER2_NEIGH_RX_BITRATE, rate);
     }
   }
 
@@ -214,7 +366,7 @@ nl80211_process_get_station_dump_result(struct nl80211_if *interf, struct nlmsgh
     rate = nla_get_u32(sinfo[NL80211_STA_INFO_EXPECTED_THROUGHPUT]);
 
     /* convert in bps */
-    nl80211_change_l2neigh_data(l2neigh, OONF_LAYER2_NEIGH_TX_THROUGHPUT, rate * 1024ll);
+    changed |= nl80211_change_l2neigh_data(l2neigh, OONF_LAYER2_NEIGH_TX_THROUGHPUT, rate * 1024ll);
   }
 
   /* signal strength is special too */
@@ -222,14 +374,45 @@ nl80211_process_get_station_dump_result(struct nl80211_if *interf, struct nlmsgh
     int8_t signal;
 
     signal = nla_get_u8(sinfo[NL80211_STA_INFO_SIGNAL]);
-    nl80211_change_l2neigh_data(l2neigh, OONF_LAYER2_NEIGH_RX_SIGNAL, signal * 1000ll);
+    changed |= nl80211_change_l2neigh_data(l2neigh, OONF_LAYER2_NEIGH_RX_SIGNAL, signal * 1000ll);
   }
 
-  /* remove old data */
-  nl80211_cleanup_l2neigh_data(l2neigh);
+  /* events only contain part of the station data, keep the rest */
+  if (!event) {
+    /* remove old data, keep the new one until the next dump */
+    changed |= nl80211_cleanup_l2neigh_data(l2neigh);
+    nl80211_relabel_l2neigh_data(l2neigh);
+
+    _add_dump_station(interf, &l2neigh_mac);
+  }
 
   /* and commit the changes */
-  oonf_layer2_neigh_commit(l2neigh);
+  if (changed) {
+    oonf_layer2_neigh_commit(l2neigh);
+  }
+}
+
+/**
+ * Remember that a station was part of the running station dump
+ * @param interf nl80211 listener interface
+ * @param mac MAC address of station
+ */
+static void
+_add_dump_station(struct nl80211_if *interf, const struct netaddr *mac) {
+  struct _dump_station *station;
+
+  if (avl_find(&interf->_dump_stations, mac)) {
+    return;
+  }
+
+  station = oonf_class_malloc(&_dump_station_class);
+  if (!station) {
+    return;
+  }
+
+  memcpy(&station->mac, mac, sizeof(*mac));
+  station->_node.key = &station->mac;
+  avl_insert(&interf->_dump_stations, &station->_node);
 }
 
 static bool
@@ -94,6 +94,12 @@ struct _nl80211_config {
 
   /*! true if plugin should set multicast rate in the l2 db */
   bool report_multicast_rate;
+
+  /*! number of samples kept in the history of each reported value */
+  int32_t history;
+
+  /*! true if plugin should listen to nl80211 station and interface events */
+  bool events;
 };
 
 /**
@@ -135,6 +141,8 @@ enum _nl80211_cfg_idx
   IDX_INTERVAL,
   IDX_INTERFACES,
   IDX_MC_RATE,
+  IDX_HISTORY,
+  IDX_EVENTS,
 };
 
 /**
@@ -168,13 +176,21 @@ static void _cb_config_changed(void);
 static void _cb_if_config_changed(void);
 
 static void _cb_transmission_event(struct oonf_timer_instance *);
-static void _trigger_next_netlink_query(void);
+static uint32_t _send_netlink_message(struct os_system_netlink *nl, struct nl80211_if *interf, enum _if_query query);
+static void _start_queries(struct nl80211_if *interf);
+static void _finish_query(struct nl80211_if *interf, bool finalize);
+static void _update_event_subscription(void);
 
 static void _cb_nl_message(struct nlmsghdr *hdr);
 static void _cb_nl_error(uint32_t seq, int error);
 static void _cb_nl_timeout(void);
 static void _cb_nl_done(uint32_t seq);
 
+static void _cb_nl_event_message(struct nlmsghdr *hdr);
+static void _cb_nl_event_error(uint32_t seq, int error);
+static void _cb_nl_event_timeout(void);
+static void _cb_nl_event_done(uint32_t seq);
+
 /* configuration */
 static struct cfg_schema_section _if_section = {
   CFG_OSIF_SCHEMA_INTERFACE_SECTION_INIT,
@@ -191,6 +207,11 @@ static struct cfg_schema_entry _nl80211_entries[] = {
     "if", "", "List of additional interfaces to read nl80211 data from", IF_NAMESIZE, .list = true),
   [IDX_MC_RATE] = CFG_MAP_BOOL(_nl80211_config, report_multicast_rate, "report_mc_rate", "false",
     "Activate to write the multicast/broadcast speed into the layer2 database"),
+  [IDX_HISTORY] = CFG_MAP_INT32_MINMAX(_nl80211_config, history, "history", "0",
+    "Number of samples kept in the layer2 database history of each reported value, 0 to disable", 0, 0,
+    OONF_LAYER2_HISTORY_MAX),
+  [IDX_EVENTS] = CFG_MAP_BOOL(_nl80211_config, events, "events", "true",
+    "Listen to nl80211 station and interface events to detect changes without waiting for the next query"),
 };
 
 static struct cfg_schema_section _nl80211_section = {
@@ -229,14 +250,14 @@ DECLARE_OONF_PLUGIN(_nl80211_listener_subsystem);
 
 enum oonf_log_source LOG_NL80211;
 
-/* netlink specific data */
-static struct os_system_netlink _netlink_handler = {
-  .name = "nl80211 listener",
+/* netlink handler for the family query and the nl80211 multicast events */
+static struct os_system_netlink _netlink_event_handler = {
+  .name = "nl80211 events",
   .used_by = &_nl80211_listener_subsystem,
-  .cb_message = _cb_nl_message,
-  .cb_error = _cb_nl_error,
-  .cb_done = _cb_nl_done,
-  .cb_timeout = _cb_nl_timeout,
+  .cb_message = _cb_nl_event_message,
+  .cb_error = _cb_nl_event_error,
+  .cb_done = _cb_nl_event_done,
+  .cb_timeout = _cb_nl_event_timeout,
 };
 
 /* buffer for outgoing netlink message */
@@ -246,6 +267,11 @@ static struct nlmsghdr *_nl_msg = (void *)_nl_msgbuffer;
 /* netlink nl80211 identification */
 static uint32_t _nl80211_id = 0;
 static uint32_t _nl80211_multicast_group = 0;
+static uint32_t _nl80211_config_multicast_group = 0;
+
+/* state of the family query and the multicast subscription */
+static bool _family_query_in_progress = false;
+static bool _events_subscribed = false;
 
 /* layer2 metadata */
 static struct oonf_layer2_origin _layer2_updated_origin = {
@@ -259,11 +285,6 @@ static struct oonf_layer2_origin _layer2_data_origin = {
   .priority = OONF_LAYER2_ORIGIN_RELIABLE,
 };
 
-/* current query data */
-static struct nl80211_if *_current_query_if = NULL;
-static enum _if_query _current_query_number = QUERY_START;
-static bool _current_query_in_progress = false;
-
 /* timer for generating netlink requests */
 static struct oonf_timer_class _transmission_timer_info = {
   .name = "nl80211 listener timer",
@@ -315,7 +336,7 @@ static const struct _nl80211_query _if_query_ops[QUERY_COUNT] = {
       NL80211_CMD_NEW_STATION,
       nl80211_send_get_station_dump,
       nl80211_process_get_station_dump_result,
-      NULL,
+      nl80211_finalize_get_station_dump,
     },
 };
 
@@ -330,13 +351,14 @@ _early_cfg_init(void) {
  */
 static int
 _init(void) {
-  if (os_system_linux_netlink_add(&_netlink_handler, NETLINK_GENERIC)) {
+  if (os_system_linux_netlink_add(&_netlink_event_handler, NETLINK_GENERIC)) {
     return -1;
   }
 
   /* initialize nl80211 if storage system */
   oonf_class_add(&_nl80211_if_class);
   avl_init(&_nl80211_if_tree, avl_comp_strcasecmp, false);
+  nl80211_init_station_dump();
 
   /* get layer2 origin */
   oonf_layer2_origin_add(&_layer2_updated_origin);
@@ -355,12 +377,13 @@ _cleanup(void) {
   avl_for_each_element_safe(&_nl80211_if_tree, interf, _node, it_if) {
     _nl80211_if_remove(interf);
   }
+  nl80211_cleanup_station_dump();
   oonf_layer2_origin_remove(&_layer2_updated_origin);
   oonf_layer2_origin_remove(&_layer2_data_origin);
 
   oonf_timer_stop(&_transmission_timer);
   oonf_timer_remove(&_transmission_timer_info);
-  os_system_linux_netlink_remove(&_netlink_handler);
+  os_system_linux_netlink_remove(&_netlink_event_handler);
 }
 
 /**
@@ -409,10 +432,33 @@ nl80211_change_l2net_neighbor_default(
  * Cleanup all data generated by this listener from a layer2 neighbor,
  * but do not commit data
  * @param l2neigh pointer to layer2 neighbor
+ * @return true if a value was removed, false otherwise
  */
-void
+bool
 nl80211_cleanup_l2neigh_data(struct oonf_layer2_neigh *l2neigh) {
-  oonf_layer2_neigh_cleanup(l2neigh, &_layer2_data_origin);
+  return oonf_layer2_neigh_cleanup(l2neigh, &_layer2_data_origin);
+}
+
+/**
+ * Mark all new data of this listener on a layer2 neighbor as current,
+ * the next cleanup will remove it unless it is updated again
+ * @param l2neigh pointer to layer2 neighbor
+ */
+void
+nl80211_relabel_l2neigh_data(struct oonf_layer2_neigh *l2neigh) {
+  oonf_layer2_neigh_relabel(l2neigh, &_layer2_data_origin, &_layer2_updated_origin);
+}
+
+/**
+ * Remove all data of this listener from a layer2 neighbor and
+ * commit the neighbor, which might remove it from the database.
+ * @param l2neigh pointer to layer2 neighbor
+ */
+void
+nl80211_remove_l2neigh(struct oonf_layer2_neigh *l2neigh) {
+  /* only use one origin, the neighbor might be gone after the removal */
+  oonf_layer2_neigh_relabel(l2neigh, &_layer2_data_origin, &_layer2_updated_origin);
+  oonf_layer2_neigh_remove(l2neigh, &_layer2_data_origin);
 }
 
 /**
@@ -490,8 +536,24 @@ _nl80211_if_add(const char *name) {
     return NULL;
   }
 
+  /* initialize netlink handler for the queries of the interface */
+  interf->_netlink.name = interf->name;
+  interf->_netlink.used_by = &_nl80211_listener_subsystem;
+  interf->_netlink.cb_message = _cb_nl_message;
+  interf->_netlink.cb_error = _cb_nl_error;
+  interf->_netlink.cb_done = _cb_nl_done;
+  interf->_netlink.cb_timeout = _cb_nl_timeout;
+  if (os_system_linux_netlink_add(&interf->_netlink, NETLINK_GENERIC)) {
+    os_interface_remove(&interf->if_listener);
+    oonf_layer2_net_remove(interf->l2net, &_layer2_data_origin);
+    oonf_layer2_net_remove(interf->l2net, &_layer2_updated_origin);
+    oonf_class_free(&_nl80211_if_class, interf);
+    return NULL;
+  }
+
   /* initialize interface */
   interf->wifi_phy_if = -1;
+  avl_init(&interf->_dump_stations, avl_comp_netaddr, false);
 
   OONF_DEBUG(LOG_NL80211, "Add if %s", name);
   avl_insert(&_nl80211_if_tree, &interf->_node);
@@ -505,6 +567,8 @@ _nl80211_if_add(const char *name) {
 static void
 _nl80211_if_remove(struct nl80211_if *interf) {
   avl_remove(&_nl80211_if_tree, &interf->_node);
+  nl80211_clear_station_dump(interf);
+  os_system_linux_netlink_remove(&interf->_netlink);
   os_interface_remove(&interf->if_listener);
   oonf_class_free(&_nl80211_if_class, interf);
 }
@@ -538,23 +602,47 @@ _cb_if_config_changed(void) {
 }
 
 /**
- * Transmit the next netlink command to nl80211
+ * Start a new series of netlink queries on all interfaces
  * @param ptr timer instance that fired
  */
 static void
 _cb_transmission_event(struct oonf_timer_instance *ptr __attribute__((unused))) {
-  if (!_current_query_in_progress) {
-    _trigger_next_netlink_query();
+  struct nl80211_if *interf;
+
+  if (!_nl80211_id || !_nl80211_multicast_group) {
+    if (_family_query_in_progress) {
+      /* wait for the next timer */
+      _family_query_in_progress = false;
+      return;
+    }
+
+    /* first we need to get the ID and multicast group */
+    OONF_DEBUG(LOG_NL80211, "Get nl80211 family and multicast id");
+    _family_query_in_progress = true;
+    _send_netlink_message(&_netlink_event_handler, NULL, QUERY_GET_FAMILY);
+    return;
+  }
+
+  if (avl_is_empty(&_nl80211_if_tree)) {
+    OONF_DEBUG(LOG_NL80211, "No nl80211 interfaces");
+    return;
+  }
+
+  /* every interface has its own netlink socket, so all dumps can run in parallel */
+  avl_for_each_element(&_nl80211_if_tree, interf, _node) {
+    _start_queries(interf);
   }
 }
 
 /**
  * Send a netlink message to the nl80211 subsystem
+ * @param nl netlink handler to send the message
  * @param interf nl80211 interface for message
  * @param query query id
+ * @return sequence number of netlink message
  */
-static void
-_send_netlink_message(struct nl80211_if *interf, enum _if_query query) {
+static uint32_t
+_send_netlink_message(struct os_system_netlink *nl, struct nl80211_if *interf, enum _if_query query) {
   struct genlmsghdr *hdr;
 
   memset(&_nl_msgbuffer, 0, sizeof(_nl_msgbuffer));
@@ -582,87 +670,147 @@ _send_netlink_message(struct nl80211_if *interf, enum _if_query query) {
     genl_send_get_family(_nl_msg, hdr);
   }
   else if (_if_query_ops[query].send) {
-    _if_query_ops[query].send(&_netlink_handler, _nl_msg, hdr, interf);
+    _if_query_ops[query].send(nl, _nl_msg, hdr, interf);
   }
 
-  os_system_linux_netlink_send(&_netlink_handler, _nl_msg);
+  return os_system_linux_netlink_send(nl, _nl_msg);
 }
 
 /**
- * Proceed to next query
+ * Start a new series of queries for an interface
+ * if the last one is finished.
+ * @param interf nl80211 interface
  */
 static void
-_get_next_query(void) {
-  if (avl_is_empty(&_nl80211_if_tree)) {
-    OONF_DEBUG(LOG_NL80211, "No nl80211 interfaces");
-    _current_query_if = NULL;
+_start_queries(struct nl80211_if *interf) {
+  if (interf->_query_in_progress || !interf->if_listener.data->flags.up) {
     return;
   }
 
-  /* no query left to do? start again at the first */
-  if (!_current_query_if) {
-    /* start with first interface and query */
-    _current_query_if = avl_first_element(&_nl80211_if_tree, _current_query_if, _node);
-    _current_query_number = QUERY_START;
-    _current_query_in_progress = true;
-  }
-  else {
-    /* next query */
-    _current_query_number++;
-
-    if (_current_query_number == QUERY_END) {
-      /* commit interface data */
-      if (_current_query_if->ifdata_changed) {
-        /* set fixed flags for nl80211 data */
-        oonf_layer2_data_set_bool(
-          &_current_query_if->l2net->data[OONF_LAYER2_NET_MCS_BY_PROBING], &_layer2_updated_origin, true);
-
-        /* cleanup old data and relable new one, then commit everything */
-        oonf_layer2_net_cleanup(_current_query_if->l2net, &_layer2_data_origin, true);
-        oonf_layer2_net_relabel(_current_query_if->l2net, &_layer2_data_origin, &_layer2_updated_origin);
-        oonf_layer2_net_commit(_current_query_if->l2net);
-        _current_query_if->ifdata_changed = false;
-      }
+  interf->_query_in_progress = true;
+  interf->_query = QUERY_START;
 
-      _current_query_if = avl_next_element_safe(&_nl80211_if_tree, _current_query_if, _node);
-      _current_query_number = QUERY_START;
-    }
+  OONF_INFO(LOG_NL80211, "Sending query %u to interface %s", interf->_query, interf->name);
+  interf->_query_seq = _send_netlink_message(&interf->_netlink, interf, interf->_query);
+}
+
+/**
+ * Commit the interface data collected by a series of queries
+ * @param interf nl80211 interface
+ */
+static void
+_commit_interface(struct nl80211_if *interf) {
+  if (!interf->ifdata_changed) {
+    /* neighbors have already been cleaned up and committed by the station dump */
+    return;
   }
+
+  /* set fixed flags for nl80211 data */
+  oonf_layer2_data_set_bool(&interf->l2net->data[OONF_LAYER2_NET_MCS_BY_PROBING], &_layer2_updated_origin, true);
+
+  /* cleanup old interface data and relable new one, then commit everything */
+  oonf_layer2_net_cleanup(interf->l2net, &_layer2_data_origin, false);
+  oonf_layer2_net_relabel(interf->l2net, &_layer2_data_origin, &_layer2_updated_origin);
+  oonf_layer2_net_commit(interf->l2net);
+  interf->ifdata_changed = false;
 }
 
 /**
- * Trigger the next netlink query
+ * Finish the running query of an interface and send the next one
+ * @param interf nl80211 interface
+ * @param finalize true if the finalize callback of the query should be called
  */
 static void
-_trigger_next_netlink_query(void) {
-  if (!_nl80211_id || !_nl80211_multicast_group) {
-    if (_current_query_in_progress) {
-      /* wait for the next timer */
-      _current_query_in_progress = false;
-      return;
-    }
+_finish_query(struct nl80211_if *interf, bool finalize) {
+  if (finalize && _if_query_ops[interf->_query].finalize) {
+    _if_query_ops[interf->_query].finalize(interf);
+  }
 
-    /* first we need to get the ID and multicast group */
-    OONF_DEBUG(LOG_NL80211, "Get nl80211 family and multicast id");
-    _current_query_in_progress = true;
-    _send_netlink_message(NULL, QUERY_GET_FAMILY);
+  interf->_query++;
+  if (interf->_query == QUERY_END || !interf->if_listener.data->flags.up) {
+    OONF_INFO(LOG_NL80211, "All queries done for interface %s", interf->name);
+    _commit_interface(interf);
+    interf->_query_in_progress = false;
     return;
   }
 
-  /* calculate next interface/query, ignore interfaces that are down */
-  do {
-    _get_next_query();
-  } while (_current_query_if && !_current_query_if->if_listener.data->flags.up);
+  OONF_INFO(LOG_NL80211, "Sending query %u to interface %s", interf->_query, interf->name);
+  interf->_query_seq = _send_netlink_message(&interf->_netlink, interf, interf->_query);
+}
 
-  if (!_current_query_if) {
-    /* done with this series of queries, wait for next timer */
-    OONF_INFO(LOG_NL80211, "All queries done for all interfaces");
-    _current_query_in_progress = false;
+/**
+ * Get the nl80211 interface waiting for a netlink response
+ * @param seq netlink sequence number
+ * @return nl80211 interface, NULL if not found
+ */
+static struct nl80211_if *
+_get_if_by_seq(uint32_t seq) {
+  struct nl80211_if *interf;
+
+  avl_for_each_element(&_nl80211_if_tree, interf, _node) {
+    if (interf->_query_in_progress && interf->_query_seq == seq) {
+      return interf;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Get the nl80211 interface a netlink event was sent for
+ * @param hdr netlink message header
+ * @return nl80211 interface, NULL if not found
+ */
+static struct nl80211_if *
+_get_if_by_event(struct nlmsghdr *hdr) {
+  struct nlattr *tb[NL80211_ATTR_MAX + 1];
+  struct nl80211_if *interf;
+  unsigned if_index;
+
+  if (nlmsg_parse(hdr, sizeof(struct genlmsghdr), tb, NL80211_ATTR_MAX, NULL) < 0 || !tb[NL80211_ATTR_IFINDEX]) {
+    return NULL;
+  }
+
+  if_index = nla_get_u32(tb[NL80211_ATTR_IFINDEX]);
+  avl_for_each_element(&_nl80211_if_tree, interf, _node) {
+    if (nl80211_get_if_baseindex(interf) == if_index) {
+      return interf;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Join or leave the nl80211 multicast groups depending
+ * on the configuration
+ */
+static void
+_update_event_subscription(void) {
+  uint32_t groups[2];
+  int drop_groups[2];
+  size_t count;
+
+  if (!_nl80211_multicast_group || _config.events == _events_subscribed) {
     return;
   }
 
-  OONF_INFO(LOG_NL80211, "Sending query %u to interface %s", _current_query_number, _current_query_if->name);
-  _send_netlink_message(_current_query_if, _current_query_number);
+  count = 0;
+  groups[count++] = _nl80211_multicast_group;
+  if (_nl80211_config_multicast_group) {
+    groups[count++] = _nl80211_config_multicast_group;
+  }
+
+  if (_config.events) {
+    if (os_system_linux_netlink_add_mc(&_netlink_event_handler, groups, count) == 0) {
+      OONF_INFO(LOG_NL80211, "Listening to nl80211 events");
+      _events_subscribed = true;
+    }
+  }
+  else {
+    drop_groups[0] = groups[0];
+    drop_groups[1] = groups[1];
+    os_system_linux_netlink_drop_mc(&_netlink_event_handler, drop_groups, count);
+    _events_subscribed = false;
+  }
 }
 
 /**
@@ -672,25 +820,27 @@ _trigger_next_netlink_query(void) {
 static void
 _cb_nl_message(struct nlmsghdr *hdr) {
   struct genlmsghdr *gen_hdr;
+  struct nl80211_if *interf;
 
-  gen_hdr = NLMSG_DATA(hdr);
-  if (hdr->nlmsg_type == GENL_ID_CTRL && gen_hdr->cmd == CTRL_CMD_NEWFAMILY) {
-    genl_process_get_family_result(hdr, &_nl80211_id, &_nl80211_multicast_group);
+  if (hdr->nlmsg_type != _nl80211_id) {
+    OONF_WARN(LOG_NL80211, "Unhandled netlink message type: %u", hdr->nlmsg_type);
     return;
   }
 
-  if (hdr->nlmsg_type != _nl80211_id) {
-    OONF_WARN(LOG_NL80211, "Unhandled netlink message type: %u", hdr->nlmsg_type);
+  interf = _get_if_by_seq(hdr->nlmsg_seq);
+  if (!interf) {
+    OONF_INFO(LOG_NL80211, "Received nl80211 message for unknown seq %u", hdr->nlmsg_seq);
     return;
   }
 
-  if (gen_hdr->cmd != _if_query_ops[_current_query_number].cmd) {
-    OONF_INFO(LOG_NL80211, "Received Nl80211 command %u for query %u (should be %u)", gen_hdr->cmd,
-      _current_query_number, _if_query_ops[_current_query_number].cmd);
+  gen_hdr = NLMSG_DATA(hdr);
+  if (gen_hdr->cmd != _if_query_ops[interf->_query].cmd) {
+    OONF_INFO(LOG_NL80211, "Received Nl80211 command %u for query %u (should be %u)", gen_hdr->cmd, interf->_query,
+      _if_query_ops[interf->_query].cmd);
   }
-  else if (_if_query_ops[_current_query_number].process) {
-    OONF_DEBUG(LOG_NL80211, "Received Nl80211 command %u for query %u", gen_hdr->cmd, _current_query_number);
-    _if_query_ops[_current_query_number].process(_current_query_if, hdr);
+  else if (_if_query_ops[interf->_query].process) {
+    OONF_DEBUG(LOG_NL80211, "Received Nl80211 command %u for query %u", gen_hdr->cmd, interf->_query);
+    _if_query_ops[interf->_query].process(interf, hdr);
   }
 }
 
@@ -700,10 +850,13 @@ _cb_nl_message(struct nlmsghdr *hdr) {
  * @param error error code
  */
 static void
-_cb_nl_error(uint32_t seq __attribute((unused)), int error __attribute((unused))) {
+_cb_nl_error(uint32_t seq, int error __attribute((unused))) {
+  struct nl80211_if *interf;
+
   OONF_INFO(LOG_NL80211, "seq %u: Received error %d", seq, error);
-  if (_nl80211_id && _nl80211_multicast_group) {
-    _trigger_next_netlink_query();
+  interf = _get_if_by_seq(seq);
+  if (interf) {
+    _finish_query(interf, false);
   }
 }
 
@@ -712,12 +865,16 @@ _cb_nl_error(uint32_t seq __attribute((unused)), int error __attribute((unused))
  */
 static void
 _cb_nl_timeout(void) {
+  struct nl80211_if *interf;
+
   OONF_INFO(LOG_NL80211, "Received timeout");
-  if (_nl80211_id && _nl80211_multicast_group) {
-    if (_if_query_ops[_current_query_number].finalize) {
-      _if_query_ops[_current_query_number].finalize(_current_query_if);
+
+  /* the timer of the netlink handler that timed out is not running anymore */
+  avl_for_each_element(&_nl80211_if_tree, interf, _node) {
+    if (interf->_query_in_progress && interf->_netlink.msg_in_transit > 0 &&
+        !oonf_timer_is_active(&interf->_netlink.timeout)) {
+      _finish_query(interf, true);
     }
-    _trigger_next_netlink_query();
   }
 }
 
@@ -726,13 +883,102 @@ _cb_nl_timeout(void) {
  * @param seq sequence number
  */
 static void
-_cb_nl_done(uint32_t seq __attribute((unused))) {
+_cb_nl_done(uint32_t seq) {
+  struct nl80211_if *interf;
+
   OONF_INFO(LOG_NL80211, "%u: Received done", seq);
-  if (_nl80211_id && _nl80211_multicast_group) {
-    if (_if_query_ops[_current_query_number].finalize) {
-      _if_query_ops[_current_query_number].finalize(_current_query_if);
-    }
-    _trigger_next_netlink_query();
+  interf = _get_if_by_seq(seq);
+  if (interf) {
+    _finish_query(interf, true);
+  }
+}
+
+/**
+ * Parse an incoming netlink message of the event socket
+ * @param hdr pointer to netlink message
+ */
+static void
+_cb_nl_event_message(struct nlmsghdr *hdr) {
+  struct genlmsghdr *gen_hdr;
+  struct nl80211_if *interf;
+
+  gen_hdr = NLMSG_DATA(hdr);
+  if (hdr->nlmsg_type == GENL_ID_CTRL && gen_hdr->cmd == CTRL_CMD_NEWFAMILY) {
+    genl_process_get_family_result(hdr, &_nl80211_id, &_nl80211_multicast_group, &_nl80211_config_multicast_group);
+    return;
+  }
+
+  if (hdr->nlmsg_type != _nl80211_id) {
+    OONF_WARN(LOG_NL80211, "Unhandled netlink event type: %u", hdr->nlmsg_type);
+    return;
+  }
+
+  interf = _get_if_by_event(hdr);
+  if (!interf) {
+    /* event for an interface we are not listening to */
+    return;
+  }
+
+  switch (gen_hdr->cmd) {
+    case NL80211_CMD_NEW_STATION:
+      nl80211_process_new_station_event(interf, hdr);
+      break;
+    case NL80211_CMD_DEL_STATION:
+      nl80211_process_del_station_event(interf, hdr);
+      break;
+    case NL80211_CMD_NEW_INTERFACE:
+    case NL80211_CMD_SET_INTERFACE:
+    case NL80211_CMD_CH_SWITCH_NOTIFY:
+      /* interface settings changed, query them without waiting for the timer */
+      OONF_DEBUG(LOG_NL80211, "Received nl80211 event %u for %s", gen_hdr->cmd, interf->name);
+      _start_queries(interf);
+      break;
+    default:
+      OONF_DEBUG(LOG_NL80211, "Ignored nl80211 event %u for %s", gen_hdr->cmd, interf->name);
+      break;
+  }
+}
+
+/**
+ * Callback triggered when the family query failes
+ * @param seq sequence number
+ * @param error error code
+ */
+static void
+_cb_nl_event_error(uint32_t seq __attribute((unused)), int error __attribute((unused))) {
+  OONF_INFO(LOG_NL80211, "seq %u: Received error %d for family query", seq, error);
+  _family_query_in_progress = false;
+}
+
+/**
+ * Callback triggered when the family query times out
+ */
+static void
+_cb_nl_event_timeout(void) {
+  OONF_INFO(LOG_NL80211, "Received timeout for family query");
+  _family_query_in_progress = false;
+}
+
+/**
+ * Callback triggered when the family query is done
+ * @param seq sequence number
+ */
+static void
+_cb_nl_event_done(uint32_t seq __attribute((unused))) {
+  struct nl80211_if *interf;
+
+  OONF_INFO(LOG_NL80211, "%u: Received done for family query", seq);
+  _family_query_in_progress = false;
+
+  if (!_nl80211_id || !_nl80211_multicast_group) {
+    return;
+  }
+
+  _update_event_subscription();
+
+  /* start the first series of queries */
+  avl_for_each_element(&_nl80211_if_tree, interf, _node) {
+    _start_queries(interf);
   }
 }
 
@@ -753,6 +999,13 @@ _cb_config_changed(void) {
   /* set transmission timer */
   oonf_timer_set_ext(&_transmission_timer, 1, _config.interval);
 
+  /* join or leave the nl80211 multicast groups */
+  _update_event_subscription();
+
+  /* record the history of nl80211 values in the layer2 database */
+  _layer2_updated_origin.history_size = _config.history;
+  _layer2_data_origin.history_size = _config.history;
+
   /* mark old interfaces for removal */
   array = cfg_db_get_schema_entry_value(_nl80211_section.pre, &_nl80211_entries[IDX_INTERFACES]);
   if (array && strarray_get_count_c(array) > 0) {
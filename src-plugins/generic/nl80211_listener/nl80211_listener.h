@@ -50,6 +50,7 @@
 #include "core/oonf_subsystem.h"
 #include "subsystems/oonf_layer2.h"
 #include "subsystems/os_interface.h"
+#include "subsystems/os_system.h"
 
 /*! subsystem identifier */
 #define OONF_NL80211_LISTENER_SUBSYSTEM "nl80211_listener"
@@ -79,6 +80,21 @@ struct nl80211_if {
   /*! true if data of interface were changed */
   bool ifdata_changed;
 
+  /*! netlink handler for the queries of this interface */
+  struct os_system_netlink _netlink;
+
+  /*! index of the query currently running on this interface */
+  unsigned _query;
+
+  /*! netlink sequence number of the query currently running */
+  uint32_t _query_seq;
+
+  /*! true if a series of queries is running for this interface */
+  bool _query_in_progress;
+
+  /*! tree of stations reported by the running station dump */
+  struct avl_tree _dump_stations;
+
   /*! true if interface should be removed */
   bool _remove;
 
@@ -96,7 +112,9 @@ struct oonf_layer2_destination *nl80211_add_dst(struct oonf_layer2_neigh *, cons
 bool nl80211_change_l2net_data(struct oonf_layer2_net *l2net, enum oonf_layer2_network_index idx, uint64_t value);
 bool nl80211_change_l2net_neighbor_default(
   struct oonf_layer2_net *l2net, enum oonf_layer2_neighbor_index idx, uint64_t value);
-void nl80211_cleanup_l2neigh_data(struct oonf_layer2_neigh *l2neigh);
+bool nl80211_cleanup_l2neigh_data(struct oonf_layer2_neigh *l2neigh);
+void nl80211_relabel_l2neigh_data(struct oonf_layer2_neigh *l2neigh);
+void nl80211_remove_l2neigh(struct oonf_layer2_neigh *l2neigh);
 bool nl80211_change_l2neigh_data(
   struct oonf_layer2_neigh *l2neigh, enum oonf_layer2_neighbor_index idx, uint64_t value);
 bool nl80211_create_broadcast_neighbor(void);
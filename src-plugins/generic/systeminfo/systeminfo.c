@@ -47,6 +47,7 @@
 
 #include "common/autobuf.h"
 #include "common/common_types.h"
+#include "common/histogram.h"
 #include "common/netaddr.h"
 #include "common/netaddr_acl.h"
 #include "common/string.h"
@@ -76,6 +77,11 @@ static void _initialize_version_values(struct oonf_viewer_template *template);
 static void _initialize_memory_values(struct oonf_viewer_template *template, struct oonf_class *c);
 static void _initialize_timer_values(struct oonf_viewer_template *template, struct oonf_timer_class *tc);
 static void _initialize_socket_values(struct oonf_viewer_template *template, struct oonf_socket_entry *sock);
+static void _initialize_socket_event_values(struct oonf_viewer_template *template);
+static void _initialize_wakeup_values(struct oonf_viewer_template *template);
+static void _initialize_duration_values(struct oonf_viewer_template *template, const struct histogram *hist);
+static void _initialize_histogram_values(struct oonf_viewer_template *template, const char *name, const char *type,
+  const struct histogram *hist, size_t idx);
 static void _initialize_logging_values(struct oonf_viewer_template *template, enum oonf_log_source source);
 static void _initialize_interface_key_values(struct oonf_viewer_template *template, struct os_interface *);
 static void _initialize_interface_data_values(struct oonf_viewer_template *template, struct os_interface *);
@@ -86,6 +92,11 @@ static int _cb_create_text_version(struct oonf_viewer_template *);
 static int _cb_create_text_memory(struct oonf_viewer_template *);
 static int _cb_create_text_timer(struct oonf_viewer_template *);
 static int _cb_create_text_socket(struct oonf_viewer_template *);
+static int _cb_create_text_socket_events(struct oonf_viewer_template *);
+static int _cb_create_text_wakeup(struct oonf_viewer_template *);
+static int _cb_create_text_histogram(struct oonf_viewer_template *);
+static void _print_histogram(struct oonf_viewer_template *template, const char *name, const char *type,
+  const struct histogram *hist);
 static int _cb_create_text_logging(struct oonf_viewer_template *);
 static int _cb_create_text_interface(struct oonf_viewer_template *);
 static int _cb_create_text_ifaddr(struct oonf_viewer_template *);
@@ -136,6 +147,33 @@ static int _cb_create_text_ifpeer(struct oonf_viewer_template *);
 /*! template key for timer long usage events*/
 #define KEY_TIMER_LONG "timer_long"
 
+/*! template key for timer slack */
+#define KEY_TIMER_SLACK "timer_slack"
+
+/*! template key for cumulative timer callback time in microseconds */
+#define KEY_TIMER_CPU "timer_cpu"
+
+/*! template key for median timer callback duration in microseconds */
+#define KEY_TIMER_DURATION_P50 "timer_duration_p50"
+
+/*! template key for 90th percentile of timer callback duration in microseconds */
+#define KEY_TIMER_DURATION_P90 "timer_duration_p90"
+
+/*! template key for 99th percentile of timer callback duration in microseconds */
+#define KEY_TIMER_DURATION_P99 "timer_duration_p99"
+
+/*! template key for maximum timer callback duration in microseconds */
+#define KEY_TIMER_DURATION_MAX "timer_duration_max"
+
+/*! template key for median timer lateness in microseconds */
+#define KEY_TIMER_LATE_P50 "timer_late_p50"
+
+/*! template key for 99th percentile of timer lateness in microseconds */
+#define KEY_TIMER_LATE_P99 "timer_late_p99"
+
+/*! template key for maximum timer lateness in microseconds */
+#define KEY_TIMER_LATE_MAX "timer_late_max"
+
 /*! template key for socket receive events */
 #define KEY_SOCKET_RECV "socket_recv"
 
@@ -145,6 +183,69 @@ static int _cb_create_text_ifpeer(struct oonf_viewer_template *);
 /*! template key for socket long usage events */
 #define KEY_SOCKET_LONG "socket_long"
 
+/*! template key for payload bytes sent through socket */
+#define KEY_SOCKET_BYTES_SENT "socket_bytes_sent"
+
+/*! template key for payload bytes copied between buffers for socket */
+#define KEY_SOCKET_BYTES_COPIED "socket_bytes_copied"
+
+/*! template key for cumulative socket callback time in microseconds */
+#define KEY_SOCKET_CPU "socket_cpu"
+
+/*! template key for median socket callback duration in microseconds */
+#define KEY_SOCKET_DURATION_P50 "socket_duration_p50"
+
+/*! template key for 90th percentile of socket callback duration in microseconds */
+#define KEY_SOCKET_DURATION_P90 "socket_duration_p90"
+
+/*! template key for 99th percentile of socket callback duration in microseconds */
+#define KEY_SOCKET_DURATION_P99 "socket_duration_p99"
+
+/*! template key for maximum socket callback duration in microseconds */
+#define KEY_SOCKET_DURATION_MAX "socket_duration_max"
+
+/*! template key for number of calls waiting for socket events */
+#define KEY_EVENT_WAIT_CALLS "event_wait_calls"
+
+/*! template key for number of socket events returned by wait calls */
+#define KEY_EVENT_EVENTS "event_events"
+
+/*! template key for number of wait calls that returned a full event array */
+#define KEY_EVENT_FULL_BATCHES "event_full_batches"
+
+/*! template key for number of calls changing the events of a socket */
+#define KEY_EVENT_CTL_CALLS "event_ctl_calls"
+
+/*! template key for number of skipped changes of socket events */
+#define KEY_EVENT_CTL_SKIPPED "event_ctl_skipped"
+
+/*! template key for current size of event array */
+#define KEY_EVENT_BATCH_SIZE "event_batch_size"
+
+/*! template key for number of scheduler wakeups that fired a timer */
+#define KEY_WAKEUP_TIMER "wakeup_timer"
+
+/*! template key for average number of scheduler wakeups per second that fired a timer */
+#define KEY_WAKEUP_TIMER_RATE "wakeup_timer_rate"
+
+/*! template key for total number of scheduler wakeups */
+#define KEY_WAKEUP_TOTAL "wakeup_total"
+
+/*! template key for average number of scheduler wakeups per second */
+#define KEY_WAKEUP_TOTAL_RATE "wakeup_total_rate"
+
+/*! template key for type of histogram */
+#define KEY_HISTOGRAM_TYPE "histogram_type"
+
+/*! template key for smallest value of a histogram bucket */
+#define KEY_HISTOGRAM_MIN "histogram_min"
+
+/*! template key for largest value of a histogram bucket */
+#define KEY_HISTOGRAM_MAX "histogram_max"
+
+/*! template key for number of values in a histogram bucket */
+#define KEY_HISTOGRAM_COUNT "histogram_count"
+
 /*! template key for name of logging source */
 #define KEY_LOG_SOURCE "log_source"
 
@@ -194,9 +295,39 @@ static struct isonumber_str _value_timer_change;
 static struct isonumber_str _value_timer_fire;
 static struct isonumber_str _value_timer_long;
 
+static struct isonumber_str _value_timer_slack;
+static struct isonumber_str _value_late_p50;
+static struct isonumber_str _value_late_p99;
+static struct isonumber_str _value_late_max;
+
 static struct isonumber_str _value_socket_recv;
 static struct isonumber_str _value_socket_send;
 static struct isonumber_str _value_socket_long;
+static struct isonumber_str _value_socket_bytes_sent;
+static struct isonumber_str _value_socket_bytes_copied;
+
+static struct isonumber_str _value_cpu;
+static struct isonumber_str _value_duration_p50;
+static struct isonumber_str _value_duration_p90;
+static struct isonumber_str _value_duration_p99;
+static struct isonumber_str _value_duration_max;
+
+static struct isonumber_str _value_event_wait_calls;
+static struct isonumber_str _value_event_events;
+static struct isonumber_str _value_event_full_batches;
+static struct isonumber_str _value_event_ctl_calls;
+static struct isonumber_str _value_event_ctl_skipped;
+static struct isonumber_str _value_event_batch_size;
+
+static struct isonumber_str _value_wakeup_timer;
+static struct isonumber_str _value_wakeup_timer_rate;
+static struct isonumber_str _value_wakeup_total;
+static struct isonumber_str _value_wakeup_total_rate;
+
+static char _value_histogram_type[32];
+static struct isonumber_str _value_histogram_min;
+static struct isonumber_str _value_histogram_max;
+static struct isonumber_str _value_histogram_count;
 
 static char _value_log_source[64];
 static struct isonumber_str _value_log_warnings;
@@ -243,12 +374,49 @@ static struct abuf_template_data_entry _tde_timer_key[] = {
   { KEY_TIMER_CHANGE, _value_timer_change.buf, false },
   { KEY_TIMER_FIRE, _value_timer_fire.buf, false },
   { KEY_TIMER_LONG, _value_timer_long.buf, false },
+  { KEY_TIMER_SLACK, _value_timer_slack.buf, false },
+  { KEY_TIMER_CPU, _value_cpu.buf, false },
+  { KEY_TIMER_DURATION_P50, _value_duration_p50.buf, false },
+  { KEY_TIMER_DURATION_P90, _value_duration_p90.buf, false },
+  { KEY_TIMER_DURATION_P99, _value_duration_p99.buf, false },
+  { KEY_TIMER_DURATION_MAX, _value_duration_max.buf, false },
+  { KEY_TIMER_LATE_P50, _value_late_p50.buf, false },
+  { KEY_TIMER_LATE_P99, _value_late_p99.buf, false },
+  { KEY_TIMER_LATE_MAX, _value_late_max.buf, false },
 };
 static struct abuf_template_data_entry _tde_socket_key[] = {
   { KEY_STATISTICS_NAME, _value_stat_name, true },
   { KEY_SOCKET_RECV, _value_socket_recv.buf, false },
   { KEY_SOCKET_SEND, _value_socket_send.buf, false },
   { KEY_SOCKET_LONG, _value_socket_long.buf, false },
+  { KEY_SOCKET_BYTES_SENT, _value_socket_bytes_sent.buf, false },
+  { KEY_SOCKET_BYTES_COPIED, _value_socket_bytes_copied.buf, false },
+  { KEY_SOCKET_CPU, _value_cpu.buf, false },
+  { KEY_SOCKET_DURATION_P50, _value_duration_p50.buf, false },
+  { KEY_SOCKET_DURATION_P90, _value_duration_p90.buf, false },
+  { KEY_SOCKET_DURATION_P99, _value_duration_p99.buf, false },
+  { KEY_SOCKET_DURATION_MAX, _value_duration_max.buf, false },
+};
+static struct abuf_template_data_entry _tde_socket_events_key[] = {
+  { KEY_EVENT_WAIT_CALLS, _value_event_wait_calls.buf, false },
+  { KEY_EVENT_EVENTS, _value_event_events.buf, false },
+  { KEY_EVENT_FULL_BATCHES, _value_event_full_batches.buf, false },
+  { KEY_EVENT_CTL_CALLS, _value_event_ctl_calls.buf, false },
+  { KEY_EVENT_CTL_SKIPPED, _value_event_ctl_skipped.buf, false },
+  { KEY_EVENT_BATCH_SIZE, _value_event_batch_size.buf, false },
+};
+static struct abuf_template_data_entry _tde_wakeup_key[] = {
+  { KEY_WAKEUP_TIMER, _value_wakeup_timer.buf, false },
+  { KEY_WAKEUP_TIMER_RATE, _value_wakeup_timer_rate.buf, false },
+  { KEY_WAKEUP_TOTAL, _value_wakeup_total.buf, false },
+  { KEY_WAKEUP_TOTAL_RATE, _value_wakeup_total_rate.buf, false },
+};
+static struct abuf_template_data_entry _tde_histogram_key[] = {
+  { KEY_STATISTICS_NAME, _value_stat_name, true },
+  { KEY_HISTOGRAM_TYPE, _value_histogram_type, true },
+  { KEY_HISTOGRAM_MIN, _value_histogram_min.buf, false },
+  { KEY_HISTOGRAM_MAX, _value_histogram_max.buf, false },
+  { KEY_HISTOGRAM_COUNT, _value_histogram_count.buf, false },
 };
 static struct abuf_template_data_entry _tde_logging_key[] = {
   { KEY_LOG_SOURCE, _value_log_source, true },
@@ -298,6 +466,15 @@ static struct abuf_template_data _td_timer[] = {
 static struct abuf_template_data _td_socket[] = {
   { _tde_socket_key, ARRAYSIZE(_tde_socket_key) },
 };
+static struct abuf_template_data _td_socket_events[] = {
+  { _tde_socket_events_key, ARRAYSIZE(_tde_socket_events_key) },
+};
+static struct abuf_template_data _td_wakeup[] = {
+  { _tde_wakeup_key, ARRAYSIZE(_tde_wakeup_key) },
+};
+static struct abuf_template_data _td_histogram[] = {
+  { _tde_histogram_key, ARRAYSIZE(_tde_histogram_key) },
+};
 static struct abuf_template_data _td_logging[] = {
   { _tde_logging_key, ARRAYSIZE(_tde_logging_key) },
 };
@@ -342,6 +519,24 @@ static struct oonf_viewer_template _templates[] = {
     .json_name = "socket",
     .cb_function = _cb_create_text_socket,
   },
+  {
+    .data = _td_socket_events,
+    .data_size = ARRAYSIZE(_td_socket_events),
+    .json_name = "socket_events",
+    .cb_function = _cb_create_text_socket_events,
+  },
+  {
+    .data = _td_wakeup,
+    .data_size = ARRAYSIZE(_td_wakeup),
+    .json_name = "wakeup",
+    .cb_function = _cb_create_text_wakeup,
+  },
+  {
+    .data = _td_histogram,
+    .data_size = ARRAYSIZE(_td_histogram),
+    .json_name = "histogram",
+    .cb_function = _cb_create_text_histogram,
+  },
   {
     .data = _td_logging,
     .data_size = ARRAYSIZE(_td_logging),
@@ -417,7 +612,7 @@ _cleanup(void) {
 static enum oonf_telnet_result
 _cb_systeminfo(struct oonf_telnet_data *con) {
   return oonf_viewer_telnet_handler(
-    con->out, &_template_storage, OONF_SYSTEMINFO_SUBSYSTEM, con->parameter, _templates, ARRAYSIZE(_templates));
+    con, &_template_storage, OONF_SYSTEMINFO_SUBSYSTEM, _templates, ARRAYSIZE(_templates));
 }
 
 /**
@@ -467,16 +662,26 @@ _initialize_memory_values(struct oonf_viewer_template *template, struct oonf_cla
  */
 static void
 _initialize_timer_values(struct oonf_viewer_template *template, struct oonf_timer_class *tc) {
+  const struct histogram *hist;
+
   strscpy(_value_stat_name, tc->name, sizeof(_value_stat_name));
 
   isonumber_from_u64(&_value_timer_usage, oonf_timer_get_usage(tc), "", 0, template->create_raw);
   isonumber_from_u64(&_value_timer_change, oonf_timer_get_changes(tc), "", 0, template->create_raw);
   isonumber_from_u64(&_value_timer_fire, oonf_timer_get_fired(tc), "", 0, template->create_raw);
   isonumber_from_u64(&_value_timer_long, oonf_timer_get_long(tc), "", 0, template->create_raw);
+  isonumber_from_u64(&_value_timer_slack, tc->slack, "", 3, template->create_raw);
+
+  _initialize_duration_values(template, oonf_timer_get_duration(tc));
+
+  hist = oonf_timer_get_lateness(tc);
+  isonumber_from_u64(&_value_late_p50, histogram_get_percentile(hist, 50), "", 0, template->create_raw);
+  isonumber_from_u64(&_value_late_p99, histogram_get_percentile(hist, 99), "", 0, template->create_raw);
+  isonumber_from_u64(&_value_late_max, hist->max, "", 0, template->create_raw);
 }
 
 /**
- * Initialize the value buffers for a timer class
+ * Initialize the value buffers for a socket
  */
 static void
 _initialize_socket_values(struct oonf_viewer_template *template, struct oonf_socket_entry *sock) {
@@ -485,6 +690,84 @@ _initialize_socket_values(struct oonf_viewer_template *template, struct oonf_soc
   isonumber_from_u64(&_value_socket_recv, oonf_socket_get_recv(sock), "", 0, template->create_raw);
   isonumber_from_u64(&_value_socket_send, oonf_socket_get_send(sock), "", 0, template->create_raw);
   isonumber_from_u64(&_value_socket_long, oonf_socket_get_long(sock), "", 0, template->create_raw);
+  isonumber_from_u64(&_value_socket_bytes_sent, oonf_socket_get_bytes_sent(sock), "", 0, template->create_raw);
+  isonumber_from_u64(&_value_socket_bytes_copied, oonf_socket_get_bytes_copied(sock), "", 0, template->create_raw);
+
+  _initialize_duration_values(template, oonf_socket_get_duration(sock));
+}
+
+/**
+ * Initialize the value buffers for the scheduler wakeups
+ * @param template viewer template
+ */
+static void
+_initialize_wakeup_values(struct oonf_viewer_template *template) {
+  uint64_t timer, total, uptime;
+
+  timer = oonf_timer_get_wakeups();
+  total = oonf_socket_get_event_stats()->wait_calls;
+
+  /* average since startup, prevent division by zero */
+  uptime = oonf_clock_getNow();
+  if (uptime == 0) {
+    uptime = 1;
+  }
+
+  isonumber_from_u64(&_value_wakeup_timer, timer, "", 0, template->create_raw);
+  isonumber_from_u64(&_value_wakeup_timer_rate, timer * 1000000ull / uptime, "", 3, template->create_raw);
+  isonumber_from_u64(&_value_wakeup_total, total, "", 0, template->create_raw);
+  isonumber_from_u64(&_value_wakeup_total_rate, total * 1000000ull / uptime, "", 3, template->create_raw);
+}
+
+/**
+ * Initialize the value buffers for the callback duration of a timer class or socket
+ * @param template viewer template
+ * @param hist histogram of callback durations in microseconds
+ */
+static void
+_initialize_duration_values(struct oonf_viewer_template *template, const struct histogram *hist) {
+  isonumber_from_u64(&_value_cpu, hist->sum, "", 0, template->create_raw);
+  isonumber_from_u64(&_value_duration_p50, histogram_get_percentile(hist, 50), "", 0, template->create_raw);
+  isonumber_from_u64(&_value_duration_p90, histogram_get_percentile(hist, 90), "", 0, template->create_raw);
+  isonumber_from_u64(&_value_duration_p99, histogram_get_percentile(hist, 99), "", 0, template->create_raw);
+  isonumber_from_u64(&_value_duration_max, hist->max, "", 0, template->create_raw);
+}
+
+/**
+ * Initialize the value buffers for a histogram bucket
+ * @param template viewer template
+ * @param name name of timer class or socket
+ * @param type type of histogram
+ * @param hist histogram
+ * @param idx index of bucket
+ */
+static void
+_initialize_histogram_values(struct oonf_viewer_template *template, const char *name, const char *type,
+  const struct histogram *hist, size_t idx) {
+  strscpy(_value_stat_name, name, sizeof(_value_stat_name));
+  strscpy(_value_histogram_type, type, sizeof(_value_histogram_type));
+
+  isonumber_from_u64(&_value_histogram_min, histogram_get_bucket_min(idx), "", 0, template->create_raw);
+  isonumber_from_u64(&_value_histogram_max, histogram_get_bucket_max(idx), "", 0, template->create_raw);
+  isonumber_from_u64(&_value_histogram_count, hist->buckets[idx], "", 0, template->create_raw);
+}
+
+/**
+ * Initialize the value buffers for the socket event handler
+ * @param template viewer template
+ */
+static void
+_initialize_socket_event_values(struct oonf_viewer_template *template) {
+  const struct os_fd_select_stats *stats;
+
+  stats = oonf_socket_get_event_stats();
+
+  isonumber_from_u64(&_value_event_wait_calls, stats->wait_calls, "", 0, template->create_raw);
+  isonumber_from_u64(&_value_event_events, stats->events, "", 0, template->create_raw);
+  isonumber_from_u64(&_value_event_full_batches, stats->full_batches, "", 0, template->create_raw);
+  isonumber_from_u64(&_value_event_ctl_calls, stats->ctl_calls, "", 0, template->create_raw);
+  isonumber_from_u64(&_value_event_ctl_skipped, stats->ctl_skipped, "", 0, template->create_raw);
+  isonumber_from_u64(&_value_event_batch_size, stats->batch_size, "", 0, template->create_raw);
 }
 
 /**
@@ -634,6 +917,78 @@ _cb_create_text_socket(struct oonf_viewer_template *template) {
   return 0;
 }
 
+/**
+ * Callback to generate text/json description of the socket event handler
+ * @param template viewer template
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_socket_events(struct oonf_viewer_template *template) {
+  _initialize_socket_event_values(template);
+
+  /* generate template output */
+  oonf_viewer_output_print_line(template);
+  return 0;
+}
+
+/**
+ * Callback to generate text/json description of the scheduler wakeups
+ * @param template viewer template
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_wakeup(struct oonf_viewer_template *template) {
+  _initialize_wakeup_values(template);
+
+  /* generate template output */
+  oonf_viewer_output_print_line(template);
+  return 0;
+}
+
+/**
+ * Print all non-empty buckets of a histogram
+ * @param template viewer template
+ * @param name name of timer class or socket
+ * @param type type of histogram
+ * @param hist histogram
+ */
+static void
+_print_histogram(struct oonf_viewer_template *template, const char *name, const char *type,
+  const struct histogram *hist) {
+  size_t i;
+
+  for (i = 0; i < HISTOGRAM_BUCKETS; i++) {
+    if (hist->buckets[i] == 0) {
+      continue;
+    }
+    _initialize_histogram_values(template, name, type, hist, i);
+
+    /* generate template output */
+    oonf_viewer_output_print_line(template);
+  }
+}
+
+/**
+ * Callback to generate text/json description of the callback duration
+ * and lateness histograms of timers and sockets
+ * @param template viewer template
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_histogram(struct oonf_viewer_template *template) {
+  struct oonf_timer_class *tc;
+  struct oonf_socket_entry *sock;
+
+  list_for_each_element(oonf_timer_get_list(), tc, _node) {
+    _print_histogram(template, tc->name, "timer_duration", oonf_timer_get_duration(tc));
+    _print_histogram(template, tc->name, "timer_late", oonf_timer_get_lateness(tc));
+  }
+  list_for_each_element(oonf_socket_get_list(), sock, _node) {
+    _print_histogram(template, sock->name, "socket_duration", oonf_socket_get_duration(sock));
+  }
+  return 0;
+}
+
 /**
  * Callback to generate text/json description for logging sources
  * @param template viewer template
@@ -580,7 +580,7 @@ _get_median_rx_linkspeed(struct link_datff_data *ldata) {
 static int64_t
 _get_raw_rx_linkspeed(const char *ifname, struct nhdp_link *lnk) {
   struct oonf_layer2_net *l2net;
-  struct oonf_layer2_neigh *l2neigh;
+  struct oonf_layer2_neighbor_address *l2addr, *l2addr_start;
   const struct oonf_layer2_data *rx_bitrate_entry;
 
   rx_bitrate_entry = oonf_layer2_neigh_query(ifname, &lnk->remote_mac, OONF_LAYER2_NEIGH_RX_BITRATE);
@@ -595,12 +595,19 @@ _get_raw_rx_linkspeed(const char *ifname, struct nhdp_link *lnk) {
   }
 
   /* search for an entry in the l2 database which reports the remote link IP */
-  avl_for_each_element(&l2net->neighbors, l2neigh, _node) {
-    if (oonf_layer2_neigh_get_remote_ip(l2neigh, &lnk->if_addr)) {
-      rx_bitrate_entry = &l2neigh->data[OONF_LAYER2_NEIGH_RX_BITRATE];
-      if (oonf_layer2_data_has_value(rx_bitrate_entry)) {
-        return oonf_layer2_data_get_int64(rx_bitrate_entry, 0);
-      }
+  avl_for_each_elements_with_key(&l2net->remote_neighbor_ips, l2addr, _net_node, l2addr_start, &lnk->if_addr) {
+    rx_bitrate_entry = &l2addr->l2neigh->data[OONF_LAYER2_NEIGH_RX_BITRATE];
+    if (oonf_layer2_data_has_value(rx_bitrate_entry)) {
+      return oonf_layer2_data_get_int64(rx_bitrate_entry, 0);
+    }
+  }
+
+  /* search for the neighbor reporting the longest prefix containing the remote link IP */
+  l2addr = oonf_layer2_net_get_best_neighbor_match(&lnk->if_addr);
+  if (l2addr && l2addr->l2neigh->network == l2net) {
+    rx_bitrate_entry = &l2addr->l2neigh->data[OONF_LAYER2_NEIGH_RX_BITRATE];
+    if (oonf_layer2_data_has_value(rx_bitrate_entry)) {
+      return oonf_layer2_data_get_int64(rx_bitrate_entry, 0);
     }
   }
 
@@ -782,7 +789,6 @@ _cb_dat_sampling(struct oonf_timer_instance *ptr) {
 static void
 _calculate_link_neighborhood(struct nhdp_link *lnk, struct link_datff_data *data) {
   struct nhdp_l2hop *l2hop;
-  struct nhdp_laddr *laddr;
   int count;
 
   /* local link neighbors */
@@ -791,7 +797,7 @@ _calculate_link_neighborhood(struct nhdp_link *lnk, struct link_datff_data *data
   /* links twohop neighbors */
   avl_for_each_element(&lnk->_2hop, l2hop, _link_node) {
     if (l2hop->same_interface &&
-        !avl_find_element(&lnk->local_if->_link_addresses, &l2hop->twohop_addr, laddr, _if_node)) {
+        !nhdp_interface_get_link_addr(lnk->local_if, &l2hop->twohop_addr)) {
       count++;
     }
   }
@@ -91,10 +91,7 @@ static struct neighbor_graph_interface _rt_api_interface = {
  */
 static bool
 _is_reachable_neighbor_tuple(const struct nhdp_domain *domain, struct nhdp_neighbor *neigh) {
-  struct nhdp_neighbor_domaindata *neighbordata;
-  neighbordata = nhdp_domain_get_neighbordata(domain, neigh);
-
-  return neighbordata->metric.in <= RFC7181_METRIC_MAX && neigh->symmetric > 0;
+  return nhdp_domain_get_neighbor_metric_vector(domain)[neigh->_slot].in <= RFC7181_METRIC_MAX && neigh->symmetric > 0;
 }
 
 /**
@@ -132,10 +129,7 @@ _is_allowed_2hop_tuple(const struct nhdp_domain *domain, struct nhdp_l2hop *two_
  */
 static uint32_t
 _calculate_d1_x(const struct nhdp_domain *domain, struct n1_node *x) {
-  struct nhdp_neighbor_domaindata *neighdata;
-
-  neighdata = nhdp_domain_get_neighbordata(domain, x->neigh);
-  return neighdata->metric.in;
+  return nhdp_domain_get_neighbor_metric_vector(domain)[x->neigh->_slot].in;
 }
 
 /**
@@ -203,16 +197,17 @@ _calculate_d_x_y(
  */
 static uint32_t
 _calculate_d1_of_y(const struct nhdp_domain *domain, struct neighbor_graph *graph, struct addr_node *y) {
+  const struct nhdp_metric *metrics;
   struct n1_node *node_n1;
   struct nhdp_laddr *laddr;
-  struct nhdp_neighbor_domaindata *neighdata;
+
+  metrics = nhdp_domain_get_neighbor_metric_vector(domain);
 
   /* find the N1 neighbor corresponding to this address, if it exists */
   avl_for_each_element(&graph->set_n1, node_n1, _avl_node) {
     laddr = avl_find_element(&node_n1->neigh->_neigh_addresses, y, laddr, _neigh_node);
     if (laddr != NULL) {
-      neighdata = nhdp_domain_get_neighbordata(domain, node_n1->neigh);
-      return neighdata->metric.in;
+      return metrics[node_n1->neigh->_slot].in;
     }
   }
   return RFC7181_METRIC_INFINITE;
@@ -241,7 +236,10 @@ _calculate_d1_x_of_n2_addr(const struct nhdp_domain *domain, struct neighbor_gra
  */
 static void
 _calculate_n1(const struct nhdp_domain *domain, struct neighbor_graph *graph) {
+  const struct nhdp_metric *metrics;
+  struct nhdp_neighbor **neighbors;
   struct nhdp_neighbor *neigh;
+  size_t slot, slot_count;
 
 #ifdef OONF_LOG_DEBUG_INFO
   struct netaddr_str buf1;
@@ -249,13 +247,22 @@ _calculate_n1(const struct nhdp_domain *domain, struct neighbor_graph *graph) {
 
   OONF_DEBUG(LOG_MPR, "Calculate N1 for routing MPRs");
 
-  list_for_each_element(nhdp_db_get_neigh_list(), neigh, _global_node) {
-    // Reset temporary selection state
+  metrics = nhdp_domain_get_neighbor_metric_vector(domain);
+  neighbors = nhdp_db_get_neigh_slots();
+  slot_count = nhdp_db_get_neigh_slot_count();
+
+  for (slot = 0; slot < slot_count; slot++) {
+    neigh = neighbors[slot];
 
+    // Reset temporary selection state
     neigh->selection_is_mpr = false;
+
+    if (metrics[slot].in > RFC7181_METRIC_MAX) {
+      /* unreachable, no need to look at the neighbor itself */
+      continue;
+    }
     if (_is_allowed_neighbor_tuple(domain, neigh)) {
-      OONF_DEBUG(LOG_MPR, "Add neighbor %s in: %u", netaddr_to_string(&buf1, &neigh->originator),
-        nhdp_domain_get_neighbordata(domain, neigh)->metric.in);
+      OONF_DEBUG(LOG_MPR, "Add neighbor %s in: %u", netaddr_to_string(&buf1, &neigh->originator), metrics[slot].in);
       mpr_add_n1_node_to_set(&graph->set_n1, neigh, NULL, 0);
     }
   }
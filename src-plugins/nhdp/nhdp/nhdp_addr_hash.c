@@ -0,0 +1,208 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/common_types.h"
+#include "common/list.h"
+#include "common/netaddr.h"
+
+#include "nhdp/nhdp_addr_hash.h"
+
+/* prototypes */
+static uint32_t _hash_netaddr(const struct netaddr *addr);
+static bool _is_equal(const struct netaddr *addr1, const struct netaddr *addr2);
+static void _resize(struct nhdp_addr_hash *hash, uint32_t bucket_count);
+
+/**
+ * Initialize a NHDP address hash table
+ * @param hash pointer to hash table
+ */
+void
+nhdp_addr_hash_init(struct nhdp_addr_hash *hash) {
+  uint32_t i;
+
+  for (i = 0; i < NHDP_ADDR_HASH_MIN_BUCKETS; i++) {
+    list_init_head(&hash->_min_buckets[i]);
+  }
+  hash->_buckets = hash->_min_buckets;
+  hash->_bucket_count = NHDP_ADDR_HASH_MIN_BUCKETS;
+  hash->count = 0;
+}
+
+/**
+ * Free the allocated buckets of a NHDP address hash table.
+ * The hash table must be empty.
+ * @param hash pointer to hash table
+ */
+void
+nhdp_addr_hash_free(struct nhdp_addr_hash *hash) {
+  if (hash->_buckets != hash->_min_buckets) {
+    free(hash->_buckets);
+  }
+  nhdp_addr_hash_init(hash);
+}
+
+/**
+ * Add a node to a NHDP address hash table.
+ * The key of the node must be set before.
+ * @param hash pointer to hash table
+ * @param node pointer to hash node
+ */
+void
+nhdp_addr_hash_add(struct nhdp_addr_hash *hash, struct nhdp_addr_hash_node *node) {
+  node->_hash = _hash_netaddr(node->key);
+  list_add_tail(&hash->_buckets[node->_hash & (hash->_bucket_count - 1)], &node->_node);
+  hash->count++;
+
+  if (hash->count > hash->_bucket_count) {
+    _resize(hash, hash->_bucket_count * 2);
+  }
+}
+
+/**
+ * Remove a node from a NHDP address hash table
+ * @param hash pointer to hash table
+ * @param node pointer to hash node
+ */
+void
+nhdp_addr_hash_remove(struct nhdp_addr_hash *hash, struct nhdp_addr_hash_node *node) {
+  list_remove(&node->_node);
+  hash->count--;
+}
+
+/**
+ * Lookup an address in a NHDP address hash table
+ * @param hash pointer to hash table
+ * @param addr pointer to address
+ * @return pointer to hash node, NULL if not found
+ */
+struct nhdp_addr_hash_node *
+nhdp_addr_hash_find(const struct nhdp_addr_hash *hash, const struct netaddr *addr) {
+  struct nhdp_addr_hash_node *node;
+  uint32_t hash_value;
+
+  hash_value = _hash_netaddr(addr);
+  list_for_each_element(&hash->_buckets[hash_value & (hash->_bucket_count - 1)], node, _node) {
+    if (node->_hash == hash_value && _is_equal(node->key, addr)) {
+      return node;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Calculate the hash value of an address (FNV-1a over address family
+ * and the used address bytes)
+ * @param addr pointer to address
+ * @return hash value
+ */
+static uint32_t
+_hash_netaddr(const struct netaddr *addr) {
+  const uint8_t *ptr;
+  uint32_t hash;
+  size_t i, len;
+
+  ptr = netaddr_get_binptr(addr);
+  len = netaddr_get_binlength(addr);
+
+  hash = (2166136261u ^ netaddr_get_address_family(addr)) * 16777619u;
+  for (i = 0; i < len; i++) {
+    hash = (hash ^ ptr[i]) * 16777619u;
+  }
+
+  /* fold the upper bits into the bucket index */
+  return hash ^ (hash >> 16);
+}
+
+/**
+ * Compare two addresses for exact equality, including the prefix length
+ * like avl_comp_netaddr() does
+ * @param addr1 first address
+ * @param addr2 second address
+ * @return true if both addresses are equal
+ */
+static bool
+_is_equal(const struct netaddr *addr1, const struct netaddr *addr2) {
+  return netaddr_get_address_family(addr1) == netaddr_get_address_family(addr2) &&
+         netaddr_get_prefix_length(addr1) == netaddr_get_prefix_length(addr2) &&
+         memcmp(netaddr_get_binptr(addr1), netaddr_get_binptr(addr2), netaddr_get_binlength(addr1)) == 0;
+}
+
+/**
+ * Move all nodes of a hash table into a new bucket array.
+ * If the allocation fails the table keeps its old buckets.
+ * @param hash pointer to hash table
+ * @param bucket_count new number of buckets, must be a power of two
+ */
+static void
+_resize(struct nhdp_addr_hash *hash, uint32_t bucket_count) {
+  struct list_entity *buckets;
+  struct nhdp_addr_hash_node *node, *node_it;
+  uint32_t i;
+
+  buckets = calloc(bucket_count, sizeof(*buckets));
+  if (buckets == NULL) {
+    return;
+  }
+
+  for (i = 0; i < bucket_count; i++) {
+    list_init_head(&buckets[i]);
+  }
+
+  for (i = 0; i < hash->_bucket_count; i++) {
+    list_for_each_element_safe(&hash->_buckets[i], node, _node, node_it) {
+      list_remove(&node->_node);
+      list_add_tail(&buckets[node->_hash & (bucket_count - 1)], &node->_node);
+    }
+  }
+
+  if (hash->_buckets != hash->_min_buckets) {
+    free(hash->_buckets);
+  }
+  hash->_buckets = buckets;
+  hash->_bucket_count = bucket_count;
+}
@@ -0,0 +1,109 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#ifndef NHDP_ADDR_HASH_H_
+#define NHDP_ADDR_HASH_H_
+
+#include "common/common_types.h"
+#include "common/container_of.h"
+#include "common/list.h"
+#include "common/netaddr.h"
+
+/*! number of buckets embedded into each hash table */
+#define NHDP_ADDR_HASH_MIN_BUCKETS 16
+
+/**
+ * Node of a NHDP address hash table, embedded into the database object.
+ * The key must point to an address stored inside the object.
+ */
+struct nhdp_addr_hash_node {
+  /*! pointer to address of the object */
+  const struct netaddr *key;
+
+  /*! hash value of the key */
+  uint32_t _hash;
+
+  /*! member of bucket list */
+  struct list_entity _node;
+};
+
+/**
+ * Chained hash table for exact address lookups. It is kept next to an
+ * avl_tree with the same content, which is still used for ordered
+ * iteration. The table doubles its bucket count when the number of
+ * entries grows larger than the number of buckets.
+ */
+struct nhdp_addr_hash {
+  /*! array of bucket lists, points to _min_buckets for small tables */
+  struct list_entity *_buckets;
+
+  /*! number of buckets, always a power of two */
+  uint32_t _bucket_count;
+
+  /*! number of entries in hash table */
+  uint32_t count;
+
+  /*! buckets used until the first resize, cannot fail to allocate */
+  struct list_entity _min_buckets[NHDP_ADDR_HASH_MIN_BUCKETS];
+};
+
+EXPORT void nhdp_addr_hash_init(struct nhdp_addr_hash *hash);
+EXPORT void nhdp_addr_hash_free(struct nhdp_addr_hash *hash);
+EXPORT void nhdp_addr_hash_add(struct nhdp_addr_hash *hash, struct nhdp_addr_hash_node *node);
+EXPORT void nhdp_addr_hash_remove(struct nhdp_addr_hash *hash, struct nhdp_addr_hash_node *node);
+EXPORT struct nhdp_addr_hash_node *nhdp_addr_hash_find(const struct nhdp_addr_hash *hash, const struct netaddr *addr);
+
+/**
+ * Lookup the object containing an address in a NHDP address hash
+ * @param hash pointer to hash table
+ * @param addr pointer to address
+ * @param element pointer to a variable of the object type
+ * @param node_element name of the nhdp_addr_hash_node member in the object
+ * @return pointer to object, NULL if not found
+ */
+#define nhdp_addr_hash_find_element(hash, addr, element, node_element)                                                 \
+  container_of_if_notnull(nhdp_addr_hash_find(hash, addr), typeof(*(element)), node_element)
+
+#endif /* NHDP_ADDR_HASH_H_ */
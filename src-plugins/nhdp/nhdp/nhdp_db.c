@@ -43,6 +43,8 @@
  * @file
  */
 
+#include <stdlib.h>
+
 #include "common/avl.h"
 #include "common/avl_comp.h"
 #include "common/common_types.h"
@@ -70,6 +72,9 @@ static void _cb_link_symtime(struct oonf_timer_instance *);
 static void _cb_l2hop_vtime(struct oonf_timer_instance *);
 static void _cb_naddr_vtime(struct oonf_timer_instance *);
 
+static int _add_neighbor_slot(struct nhdp_neighbor *neigh);
+static void _remove_neighbor_slot(struct nhdp_neighbor *neigh);
+
 /* Link status names */
 static const char *_LINK_PENDING = "pending";
 static const char *_LINK_HEARD = "heard";
@@ -105,6 +110,7 @@ static struct oonf_class _naddr_info = {
 static struct oonf_timer_class _link_vtime_info = {
   .name = "NHDP link vtime",
   .callback = _cb_link_vtime,
+  .slack = 1000,
 };
 
 static struct oonf_timer_class _link_heard_info = {
@@ -120,15 +126,18 @@ static struct oonf_timer_class _link_symtime_info = {
 static struct oonf_timer_class _naddr_vtime_info = {
   .name = "NHDP neighbor address vtime",
   .callback = _cb_naddr_vtime,
+  .slack = 1000,
 };
 
 static struct oonf_timer_class _l2hop_vtime_info = {
   .name = "NHDP 2hop vtime",
   .callback = _cb_l2hop_vtime,
+  .slack = 1000,
 };
 
 /* global tree of neighbor addresses */
 static struct avl_tree _naddr_tree;
+static struct nhdp_addr_hash _naddr_hash;
 
 /* list of neighbors */
 static struct list_entity _neigh_list;
@@ -142,12 +151,25 @@ static struct list_entity _link_list;
 /* id that will be increased every times the symmetric neighbor set changes */
 static uint32_t _neighbor_set_id = 0;
 
+/* generation counter that will be increased every time a neighbor or link changes */
+static uint32_t _generation = 0;
+
+/* dense arrays of neighbor metrics per domain, indexed by neighbor slot */
+static struct nhdp_metric *_neigh_metric_vector[NHDP_MAXIMUM_DOMAINS];
+
+/* neighbor owning each slot of the metric vectors */
+static struct nhdp_neighbor **_neigh_slots;
+
+/* number of used and allocated neighbor slots */
+static size_t _neigh_slot_count, _neigh_slot_size;
+
 /**
  * Initialize NHDP databases
  */
 void
 nhdp_db_init(void) {
   avl_init(&_naddr_tree, avl_comp_netaddr, false);
+  nhdp_addr_hash_init(&_naddr_hash);
   list_init_head(&_neigh_list);
   avl_init(&_neigh_originator_tree, avl_comp_netaddr, false);
   list_init_head(&_link_list);
@@ -171,6 +193,7 @@ nhdp_db_init(void) {
 void
 nhdp_db_cleanup(void) {
   struct nhdp_neighbor *neigh, *n_it;
+  int i;
 
   /* remove all neighbors */
   list_for_each_element_safe(&_neigh_list, neigh, _global_node, n_it) {
@@ -190,6 +213,18 @@ nhdp_db_cleanup(void) {
   oonf_class_remove(&_link_info);
   oonf_class_remove(&_naddr_info);
   oonf_class_remove(&_neigh_info);
+
+  /* free metric vectors */
+  for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+    free(_neigh_metric_vector[i]);
+    _neigh_metric_vector[i] = NULL;
+  }
+  free(_neigh_slots);
+  nhdp_addr_hash_free(&_naddr_hash);
+
+  _neigh_slots = NULL;
+  _neigh_slot_count = 0;
+  _neigh_slot_size = 0;
 }
 
 /**
@@ -199,12 +234,18 @@ nhdp_db_cleanup(void) {
 struct nhdp_neighbor *
 nhdp_db_neighbor_add(void) {
   struct nhdp_neighbor *neigh;
+  int i;
 
   neigh = oonf_class_malloc(&_neigh_info);
   if (neigh == NULL) {
     return NULL;
   }
 
+  if (_add_neighbor_slot(neigh)) {
+    oonf_class_free(&_neigh_info, neigh);
+    return NULL;
+  }
+
   OONF_DEBUG(LOG_NHDP, "New Neighbor: 0x%0zx", (size_t)neigh);
 
   /* initialize trees and lists */
@@ -220,8 +261,12 @@ nhdp_db_neighbor_add(void) {
 
   /* initialize domain data */
   nhdp_domain_init_neighbor(neigh);
+  for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+    nhdp_db_neighbor_sync_metric(neigh, i);
+  }
 
   /* trigger event */
+  _generation++;
   oonf_class_event(&_neigh_info, neigh, OONF_OBJECT_ADDED);
   return neigh;
 }
@@ -244,6 +289,7 @@ nhdp_db_neighbor_remove(struct nhdp_neighbor *neigh) {
   OONF_DEBUG(LOG_NHDP, "Remove Neighbor: 0x%0zx (%s)", (size_t)neigh, netaddr_to_string(&nbuf, &neigh->originator));
 
   /* trigger event */
+  _generation++;
   oonf_class_event(&_neigh_info, neigh, OONF_OBJECT_REMOVED);
 
   /* disconnect from other IP version */
@@ -281,6 +327,7 @@ nhdp_db_neighbor_remove(struct nhdp_neighbor *neigh) {
 
   /* remove from global list and free memory */
   list_remove(&neigh->_global_node);
+  _remove_neighbor_slot(neigh);
   oonf_class_free(&_neigh_info, neigh);
 }
 
@@ -297,6 +344,7 @@ nhdp_db_neighbor_set_unsymmetric(struct nhdp_neighbor *neigh) {
   }
 
   /* trigger event */
+  _generation++;
   oonf_class_event(&_neigh_info, neigh, OONF_OBJECT_CHANGED);
 }
 
@@ -371,6 +419,7 @@ nhdp_db_neighbor_addr_add(struct nhdp_neighbor *neigh, const struct netaddr *add
   memcpy(&naddr->neigh_addr, addr, sizeof(naddr->neigh_addr));
   naddr->_neigh_node.key = &naddr->neigh_addr;
   naddr->_global_node.key = &naddr->neigh_addr;
+  naddr->_global_hnode.key = &naddr->neigh_addr;
 
   /* initialize backward link */
   naddr->neigh = neigh;
@@ -380,6 +429,7 @@ nhdp_db_neighbor_addr_add(struct nhdp_neighbor *neigh, const struct netaddr *add
 
   /* add to trees */
   avl_insert(&_naddr_tree, &naddr->_global_node);
+  nhdp_addr_hash_add(&_naddr_hash, &naddr->_global_hnode);
   avl_insert(&neigh->_neigh_addresses, &naddr->_neigh_node);
 
   /* trigger event */
@@ -399,6 +449,7 @@ nhdp_db_neighbor_addr_remove(struct nhdp_naddr *naddr) {
 
   /* remove from trees */
   avl_remove(&_naddr_tree, &naddr->_global_node);
+  nhdp_addr_hash_remove(&_naddr_hash, &naddr->_global_hnode);
   avl_remove(&naddr->neigh->_neigh_addresses, &naddr->_neigh_node);
 
   /* stop timer */
@@ -477,6 +528,7 @@ nhdp_db_neighbor_set_originator(struct nhdp_neighbor *neigh, const struct netadd
   }
 
   /* inform everyone */
+  _generation++;
   oonf_class_event(&_neigh_info, neigh, OONF_OBJECT_CHANGED);
 
   /* overwrite "old originator" */
@@ -522,6 +574,35 @@ nhdp_db_neighbor_get_set_id(void) {
   return _neighbor_set_id;
 }
 
+/**
+ * @return generation counter of the neighbors and links, will be
+ *   increased for every change.
+ */
+uint32_t
+nhdp_db_get_generation(void) {
+  return _generation;
+}
+
+/**
+ * Increase the generation counter for a change of neighbor or link
+ * data that does not trigger a database event, e.g. a new link metric
+ */
+void
+nhdp_db_increase_generation(void) {
+  _generation++;
+}
+
+/**
+ * Copy the metric of a neighbor domain into the dense metric vector
+ * of the domain. Must be called every time the neighbor metric changes.
+ * @param neigh nhdp neighbor
+ * @param domain_index index of NHDP domain
+ */
+void
+nhdp_db_neighbor_sync_metric(struct nhdp_neighbor *neigh, int domain_index) {
+  _neigh_metric_vector[domain_index][neigh->_slot] = neigh->_domaindata[domain_index].metric;
+}
+
 /**
  * Insert a new link into a nhdp neighbors database
  * @param neigh neighbor which will get the new link
@@ -568,6 +649,7 @@ nhdp_db_link_add(struct nhdp_neighbor *neigh, struct nhdp_interface *local_if) {
   nhdp_domain_init_link(lnk);
 
   /* trigger event */
+  _generation++;
   oonf_class_event(&_link_info, lnk, OONF_OBJECT_ADDED);
 
   return lnk;
@@ -597,6 +679,7 @@ nhdp_db_link_set_unsymmetric(struct nhdp_link *lnk) {
   lnk->last_status_change = oonf_clock_getNow();
 
   /* trigger event */
+  _generation++;
   oonf_class_event(&_link_info, lnk, OONF_OBJECT_CHANGED);
 }
 
@@ -610,6 +693,7 @@ nhdp_db_link_remove(struct nhdp_link *lnk) {
   struct nhdp_l2hop *twohop, *th_it;
 
   /* trigger event */
+  _generation++;
   oonf_class_event(&_link_info, lnk, OONF_OBJECT_REMOVED);
 
   oonf_timer_stop(&lnk->sym_time);
@@ -666,6 +750,7 @@ nhdp_db_link_addr_add(struct nhdp_link *lnk, const struct netaddr *addr) {
   laddr->_link_node.key = &laddr->link_addr;
   laddr->_neigh_node.key = &laddr->link_addr;
   laddr->_if_node.key = &laddr->link_addr;
+  laddr->_if_hnode.key = &laddr->link_addr;
 
   /* initialize back link */
   laddr->link = lnk;
@@ -852,6 +937,7 @@ nhdp_db_link_update_status(struct nhdp_link *lnk) {
     nhdp_domain_delayed_mpr_recalculation(NULL, lnk->neigh);
 
     /* trigger change event */
+    _generation++;
     oonf_class_event(&_link_info, lnk, OONF_OBJECT_CHANGED);
   }
 }
@@ -901,6 +987,15 @@ nhdp_db_get_naddr_tree(void) {
   return &_naddr_tree;
 }
 
+/**
+ * get global hash of nhdp neighbor addresses for exact lookups
+ * @return neighbor address hash
+ */
+const struct nhdp_addr_hash *
+nhdp_db_get_naddr_hash(void) {
+  return &_naddr_hash;
+}
+
 /**
  * get global tree of nhdp originators
  * @return originator tree
@@ -910,6 +1005,34 @@ nhdp_db_get_neigh_originator_tree(void) {
   return &_neigh_originator_tree;
 }
 
+/**
+ * @return number of used slots of the neighbor metric vectors
+ */
+size_t
+nhdp_db_get_neigh_slot_count(void) {
+  return _neigh_slot_count;
+}
+
+/**
+ * get array of neighbors, indexed by their metric vector slot
+ * @return neighbor slot array
+ */
+struct nhdp_neighbor **
+nhdp_db_get_neigh_slots(void) {
+  return _neigh_slots;
+}
+
+/**
+ * get dense array of neighbor metrics of a domain,
+ * indexed by the slot of the neighbor
+ * @param domain_index index of NHDP domain
+ * @return neighbor metric vector
+ */
+const struct nhdp_metric *
+nhdp_db_get_neigh_metric_vector(int domain_index) {
+  return _neigh_metric_vector[domain_index];
+}
+
 /**
  * Helper function to calculate NHDP link status
  * @param lnk nhdp link
@@ -1076,3 +1199,61 @@ _cb_l2hop_vtime(struct oonf_timer_instance *ptr) {
   OONF_DEBUG(LOG_NHDP, "2Hop vtime fired: 0x%0zx", (size_t)ptr);
   nhdp_db_link_2hop_remove(l2hop);
 }
+
+/**
+ * Allocate a slot in the dense metric vectors for a new neighbor
+ * @param neigh nhdp neighbor
+ * @return -1 if out of memory, 0 otherwise
+ */
+static int
+_add_neighbor_slot(struct nhdp_neighbor *neigh) {
+  struct nhdp_neighbor **slots;
+  struct nhdp_metric *vector;
+  size_t new_size;
+  int i;
+
+  if (_neigh_slot_count == _neigh_slot_size) {
+    new_size = _neigh_slot_size ? _neigh_slot_size * 2 : 32;
+
+    slots = realloc(_neigh_slots, sizeof(*slots) * new_size);
+    if (!slots) {
+      return -1;
+    }
+    _neigh_slots = slots;
+
+    for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+      vector = realloc(_neigh_metric_vector[i], sizeof(*vector) * new_size);
+      if (!vector) {
+        return -1;
+      }
+      _neigh_metric_vector[i] = vector;
+    }
+    _neigh_slot_size = new_size;
+  }
+
+  neigh->_slot = _neigh_slot_count++;
+  _neigh_slots[neigh->_slot] = neigh;
+  return 0;
+}
+
+/**
+ * Release the metric vector slot of a neighbor and move the
+ * last slot into the gap to keep the vectors dense
+ * @param neigh nhdp neighbor
+ */
+static void
+_remove_neighbor_slot(struct nhdp_neighbor *neigh) {
+  struct nhdp_neighbor *last;
+  int i;
+
+  last = _neigh_slots[--_neigh_slot_count];
+  if (last == neigh) {
+    return;
+  }
+
+  last->_slot = neigh->_slot;
+  _neigh_slots[last->_slot] = last;
+  for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+    _neigh_metric_vector[i][last->_slot] = _neigh_metric_vector[i][_neigh_slot_count];
+  }
+}
@@ -59,6 +59,7 @@ struct nhdp_laddr;
 #include "subsystems/oonf_timer.h"
 
 #include "nhdp/nhdp.h"
+#include "nhdp/nhdp_addr_hash.h"
 
 /*! memory class for NHDP links */
 #define NHDP_CLASS_LINK "nhdp_link"
@@ -266,6 +267,9 @@ struct nhdp_laddr {
 
   /*! member entry for interface tree of link addresses */
   struct avl_node _if_node;
+
+  /*! member entry for interface hash of link addresses */
+  struct nhdp_addr_hash_node _if_hnode;
 };
 
 /**
@@ -310,6 +314,9 @@ struct nhdp_neighbor {
   /*! internal field for NHDP processing */
   int _process_count;
 
+  /*! index of this neighbor in the dense per-domain metric vectors */
+  size_t _slot;
+
   /*! true if the neighbor has been selected as an MPR during selection algorithm */
   bool selection_is_mpr;
 
@@ -361,6 +368,9 @@ struct nhdp_naddr {
   /*! member entry for global neighbor address tree */
   struct avl_node _global_node;
 
+  /*! member entry for global neighbor address hash */
+  struct nhdp_addr_hash_node _global_hnode;
+
   /**
    * temporary variables for NHDP Hello processing
    * true if address is part of the local interface
@@ -388,6 +398,9 @@ EXPORT void nhdp_db_neighbor_set_originator(struct nhdp_neighbor *, const struct
 EXPORT void nhdp_db_neighbor_connect_dualstack(struct nhdp_neighbor *, struct nhdp_neighbor *);
 EXPORT void nhdp_db_neigbor_disconnect_dualstack(struct nhdp_neighbor *neigh);
 EXPORT uint32_t nhdp_db_neighbor_get_set_id(void);
+EXPORT uint32_t nhdp_db_get_generation(void);
+EXPORT void nhdp_db_increase_generation(void);
+EXPORT void nhdp_db_neighbor_sync_metric(struct nhdp_neighbor *neigh, int domain_index);
 
 EXPORT struct nhdp_link *nhdp_db_link_add(struct nhdp_neighbor *ipv4, struct nhdp_interface *ipv6);
 EXPORT void nhdp_db_link_remove(struct nhdp_link *);
@@ -408,7 +421,11 @@ EXPORT const char *nhdp_db_link_status_to_string(struct nhdp_link *);
 EXPORT struct list_entity *nhdp_db_get_neigh_list(void);
 EXPORT struct list_entity *nhdp_db_get_link_list(void);
 EXPORT struct avl_tree *nhdp_db_get_naddr_tree(void);
+EXPORT const struct nhdp_addr_hash *nhdp_db_get_naddr_hash(void);
 EXPORT struct avl_tree *nhdp_db_get_neigh_originator_tree(void);
+EXPORT size_t nhdp_db_get_neigh_slot_count(void);
+EXPORT struct nhdp_neighbor **nhdp_db_get_neigh_slots(void);
+EXPORT const struct nhdp_metric *nhdp_db_get_neigh_metric_vector(int domain_index);
 
 /**
  * @param addr network address
@@ -417,7 +434,7 @@ EXPORT struct avl_tree *nhdp_db_get_neigh_originator_tree(void);
 static INLINE struct nhdp_naddr *
 nhdp_db_neighbor_addr_get(const struct netaddr *addr) {
   struct nhdp_naddr *naddr;
-  return avl_find_element(nhdp_db_get_naddr_tree(), addr, naddr, _global_node);
+  return nhdp_addr_hash_find_element(nhdp_db_get_naddr_hash(), addr, naddr, _global_hnode);
 }
 
 /**
@@ -445,11 +445,14 @@ nhdp_domain_process_metric_linktlv(struct nhdp_domain *domain, struct nhdp_link
   memcpy(&metric_field, value, sizeof(metric_field));
   metric = rfc7181_metric_decode(&metric_field);
 
-  if (rfc7181_metric_has_flag(&metric_field, RFC7181_LINKMETRIC_INCOMING_LINK)) {
+  if (rfc7181_metric_has_flag(&metric_field, RFC7181_LINKMETRIC_INCOMING_LINK) &&
+      nhdp_domain_get_linkdata(domain, lnk)->metric.out != metric) {
     nhdp_domain_get_linkdata(domain, lnk)->metric.out = metric;
+    nhdp_db_increase_generation();
   }
   if (rfc7181_metric_has_flag(&metric_field, RFC7181_LINKMETRIC_INCOMING_NEIGH)) {
     nhdp_domain_get_neighbordata(domain, lnk->neigh)->metric.out = metric;
+    nhdp_db_neighbor_sync_metric(lnk->neigh, domain->index);
   }
 }
 
@@ -916,6 +919,10 @@ nhdp_domain_set_incoming_metric(struct nhdp_domain_metric *metric, struct nhdp_l
       linkdata->metric.in = new_metric;
     }
   }
+
+  if (changed) {
+    nhdp_db_increase_generation();
+  }
   return changed;
 }
 
@@ -1063,6 +1070,7 @@ _recalculate_neighbor_metric(struct nhdp_domain *domain, struct nhdp_neighbor *n
     neighdata->best_out_link_metric = linkdata->metric.out;
   }
 
+  nhdp_db_neighbor_sync_metric(neigh, domain->index);
   return changed;
 }
 
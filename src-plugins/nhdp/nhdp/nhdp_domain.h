@@ -350,6 +350,18 @@ nhdp_domain_get_neighbordata(const struct nhdp_domain *domain, struct nhdp_neigh
   return &neigh->_domaindata[domain->index];
 }
 
+/**
+ * Dense view of the metrics of all neighbors of a domain,
+ * use the _slot field of a neighbor or nhdp_db_get_neigh_slots()
+ * to map between neighbors and vector indices.
+ * @param domain NHDP domain
+ * @return array of neighbor metrics, nhdp_db_get_neigh_slot_count() entries long
+ */
+static INLINE const struct nhdp_metric *
+nhdp_domain_get_neighbor_metric_vector(const struct nhdp_domain *domain) {
+  return nhdp_db_get_neigh_metric_vector(domain->index);
+}
+
 /**
  * @param domain NHDP domain
  * @param l2hop NHDP twohop neighbor
@@ -70,6 +70,7 @@ static void _cb_addr_timeout(struct oonf_timer_instance *ptr);
 
 static int avl_comp_ifaddr(const void *k1, const void *k2);
 
+static void _apply_hello_timing(struct nhdp_interface *interf);
 static void _cb_generate_hello(struct oonf_timer_instance *ptr);
 static void _cb_interface_event(struct oonf_rfc5444_interface_listener *, bool);
 
@@ -241,6 +242,7 @@ nhdp_interface_add(const char *name) {
 
     /* init link address tree */
     avl_init(&interf->_link_addresses, avl_comp_netaddr, false);
+    nhdp_addr_hash_init(&interf->_link_address_hash);
 
     /*
      * init originator tree
@@ -308,6 +310,7 @@ nhdp_interface_remove(struct nhdp_interface *interf) {
   /* now clean up the rest */
   os_interface_remove(&interf->os_if_listener);
   oonf_rfc5444_remove_interface(interf->rfc5444_if.interface, &interf->rfc5444_if);
+  nhdp_addr_hash_free(&interf->_link_address_hash);
   oonf_class_free(&_interface_info, interf);
 }
 
@@ -317,28 +320,10 @@ nhdp_interface_remove(struct nhdp_interface *interf) {
  */
 void
 nhdp_interface_apply_settings(struct nhdp_interface *interf) {
-  uint64_t itime, vtime;
   /* parse ip address list again and apply ACL */
   _cb_interface_event(&interf->rfc5444_if, false);
 
-  /* calculate interval and validity time */
-  itime = interf->overwrite_hello_interval;
-  if (!itime) {
-    itime = interf->refresh_interval;
-  }
-  vtime = interf->overwrite_hello_validity;
-  if (!vtime) {
-    vtime = interf->validity_time;
-  }
-
-  /* reset hello generation frequency */
-  oonf_timer_set(&interf->_hello_timer, itime);
-
-  /* just copy validity_time for now */
-  interf->h_hold_time = vtime;
-  interf->l_hold_time = vtime;
-  interf->n_hold_time = vtime;
-  interf->i_hold_time = vtime;
+  _apply_hello_timing(interf);
 }
 
 /**
@@ -373,7 +358,7 @@ nhdp_interface_set_hello_interval(struct nhdp_interface *interf, uint64_t interv
   old = interf->overwrite_hello_interval;
   interf->overwrite_hello_interval = interval;
 
-  nhdp_interface_apply_settings(interf);
+  _apply_hello_timing(interf);
   return old;
 }
 
@@ -391,10 +376,65 @@ nhdp_set_hello_validity(struct nhdp_interface *interf, uint64_t interval) {
   old = interf->overwrite_hello_validity;
   interf->overwrite_hello_validity = interval;
 
-  nhdp_interface_apply_settings(interf);
+  _apply_hello_timing(interf);
   return old;
 }
 
+/**
+ * Set or reset both the hello interval and validity time of a
+ * NHDP interface. This will overwrite the configured values and
+ * reschedule a running hello generation timer without delaying
+ * the pending hello.
+ * @param interf NHDP interface
+ * @param interval hello interval, 0 to reset to configured value
+ * @param validity hello validity, 0 to reset to configured value
+ */
+void
+nhdp_interface_set_hello_timing(struct nhdp_interface *interf, uint64_t interval, uint64_t validity) {
+  interf->overwrite_hello_interval = interval;
+  interf->overwrite_hello_validity = validity;
+
+  _apply_hello_timing(interf);
+}
+
+/**
+ * Apply the hello interval and validity time of a NHDP interface
+ * @param interf pointer to nhdp interface
+ */
+static void
+_apply_hello_timing(struct nhdp_interface *interf) {
+  uint64_t itime, vtime, first;
+  int64_t due;
+
+  /* calculate interval and validity time */
+  itime = interf->overwrite_hello_interval;
+  if (!itime) {
+    itime = interf->refresh_interval;
+  }
+  vtime = interf->overwrite_hello_validity;
+  if (!vtime) {
+    vtime = interf->validity_time;
+  }
+
+  /* reset hello generation frequency */
+  if (!oonf_timer_is_active(&interf->_hello_timer)) {
+    oonf_timer_set(&interf->_hello_timer, itime);
+  }
+  else if (oonf_timer_get_period(&interf->_hello_timer) != itime) {
+    /* keep the next hello, but do not delay it more than the new interval */
+    due = oonf_timer_get_due(&interf->_hello_timer);
+
+    first = (due > 0 && (uint64_t)due < itime) ? (uint64_t)due : itime;
+    oonf_timer_set_ext(&interf->_hello_timer, first, itime);
+  }
+
+  /* just copy validity_time for now */
+  interf->h_hold_time = vtime;
+  interf->l_hold_time = vtime;
+  interf->n_hold_time = vtime;
+  interf->i_hold_time = vtime;
+}
+
 /**
  * Add a nhdp interface address to an interface
  * @param interf pointer to nhdp interface
@@ -141,6 +141,9 @@ struct nhdp_interface {
   /*! tree of addresses of links (nhdp_laddr objects) */
   struct avl_tree _link_addresses;
 
+  /*! hash of addresses of links for exact lookups (nhdp_laddr objects) */
+  struct nhdp_addr_hash _link_address_hash;
+
   /*! tree of originator addresses of links (nhdp_link objects) */
   struct avl_tree _link_originators;
 
@@ -196,6 +199,7 @@ EXPORT struct avl_tree *nhdp_interface_get_address_tree(void);
 
 EXPORT uint64_t nhdp_interface_set_hello_interval(struct nhdp_interface *interf, uint64_t new_interval);
 EXPORT uint64_t nhdp_set_hello_validity(struct nhdp_interface *interf, uint64_t new_interval);
+EXPORT void nhdp_interface_set_hello_timing(struct nhdp_interface *interf, uint64_t interval, uint64_t validity);
 
 /**
  * @param name interface name
@@ -289,6 +293,7 @@ nhdp_interface_remove_l2hop(struct nhdp_l2hop *twohop) {
 static INLINE void
 nhdp_interface_add_laddr(struct nhdp_laddr *laddr) {
   avl_insert(&laddr->link->local_if->_link_addresses, &laddr->_if_node);
+  nhdp_addr_hash_add(&laddr->link->local_if->_link_address_hash, &laddr->_if_hnode);
 }
 
 /**
@@ -298,6 +303,7 @@ nhdp_interface_add_laddr(struct nhdp_laddr *laddr) {
 static INLINE void
 nhdp_interface_remove_laddr(struct nhdp_laddr *laddr) {
   avl_remove(&laddr->link->local_if->_link_addresses, &laddr->_if_node);
+  nhdp_addr_hash_remove(&laddr->link->local_if->_link_address_hash, &laddr->_if_hnode);
 }
 
 /**
@@ -309,7 +315,7 @@ static INLINE struct nhdp_laddr *
 nhdp_interface_get_link_addr(const struct nhdp_interface *interf, const struct netaddr *addr) {
   struct nhdp_laddr *laddr;
 
-  return avl_find_element(&interf->_link_addresses, addr, laddr, _if_node);
+  return nhdp_addr_hash_find_element(&interf->_link_address_hash, addr, laddr, _if_hnode);
 }
 
 /**
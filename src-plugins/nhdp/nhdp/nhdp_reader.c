@@ -662,7 +662,10 @@ _cb_addresstlvs_pass1_end(struct rfc5444_reader_tlvblock_context *context, bool
   }
 
   /* copy interface address of link */
-  memcpy(&_current.link->if_addr, _protocol->input.src_address, sizeof(struct netaddr));
+  if (netaddr_cmp(&_current.link->if_addr, _protocol->input.src_address) != 0) {
+    memcpy(&_current.link->if_addr, _protocol->input.src_address, sizeof(struct netaddr));
+    nhdp_db_increase_generation();
+  }
 
   /* copy mac address */
   if (netaddr_get_address_family(&_current.mac) == AF_MAC48) {
@@ -740,6 +743,7 @@ _process_domainspecific_linkdata(struct netaddr *addr __attribute__((unused))) {
     neighdata->willingness = 0;
     nhdp_domain_get_linkdata(domain, _current.link)->metric.out = RFC7181_METRIC_INFINITE;
     neighdata->metric.out = RFC7181_METRIC_INFINITE;
+    nhdp_db_neighbor_sync_metric(_current.neighbor, domain->index);
   }
 
   /* process MPR settings of link */
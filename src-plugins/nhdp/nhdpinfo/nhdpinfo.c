@@ -49,6 +49,7 @@
 
 #include "core/oonf_logging.h"
 #include "core/oonf_subsystem.h"
+#include "subsystems/oonf_class.h"
 #include "subsystems/oonf_clock.h"
 #include "subsystems/oonf_telnet.h"
 #include "subsystems/oonf_viewer.h"
@@ -68,6 +69,7 @@ static void _cleanup(void);
 
 static enum oonf_telnet_result _cb_nhdpinfo(struct oonf_telnet_data *con);
 static enum oonf_telnet_result _cb_nhdpinfo_help(struct oonf_telnet_data *con);
+static uint64_t _cb_nhdpinfo_generation(struct oonf_telnet_data *con);
 
 static void _initialize_interface_values(struct nhdp_interface *nhdp_if);
 static void _initialize_interface_address_values(struct nhdp_interface_addr *if_addr);
@@ -89,6 +91,9 @@ static int _cb_create_text_link_twohop(struct oonf_viewer_template *);
 static int _cb_create_text_neighbor(struct oonf_viewer_template *);
 static int _cb_create_text_neighbor_address(struct oonf_viewer_template *);
 
+static uint64_t _cb_get_link_address_generation(void);
+static void _cb_link_address_changed(void *ptr);
+
 /*
  * list of template keys and corresponding buffers for values.
  *
@@ -436,6 +441,7 @@ static struct oonf_viewer_template _templates[] = { {
     .data_size = ARRAYSIZE(_td_link_addr),
     .json_name = "link_addr",
     .cb_function = _cb_create_text_link_address,
+    .cb_generation = _cb_get_link_address_generation,
   },
   {
     .data = _td_twohop_addr,
@@ -458,11 +464,34 @@ static struct oonf_viewer_template _templates[] = { {
 
 /* telnet command of this plugin */
 static struct oonf_telnet_command _telnet_commands[] = {
-  TELNET_CMD(OONF_NHDPINFO_SUBSYSTEM, _cb_nhdpinfo, "", .help_handler = _cb_nhdpinfo_help),
+  TELNET_CMD(OONF_NHDPINFO_SUBSYSTEM, _cb_nhdpinfo, "", .help_handler = _cb_nhdpinfo_help,
+    .generation_handler = _cb_nhdpinfo_generation),
+};
+
+/* listeners for changes of the link address output */
+static struct oonf_class_extension _laddr_listener = {
+  .ext_name = "nhdpinfo generation",
+  .class_name = NHDP_CLASS_LINK_ADDRESS,
+
+  .cb_add = _cb_link_address_changed,
+  .cb_remove = _cb_link_address_changed,
 };
 
+static struct oonf_class_extension _neigh_listener = {
+  .ext_name = "nhdpinfo generation",
+  .class_name = NHDP_CLASS_NEIGHBOR,
+
+  .cb_add = _cb_link_address_changed,
+  .cb_change = _cb_link_address_changed,
+  .cb_remove = _cb_link_address_changed,
+};
+
+/* generation counter of the link address output */
+static uint64_t _link_address_generation = 1;
+
 /* plugin declaration */
 static const char *_dependencies[] = {
+  OONF_CLASS_SUBSYSTEM,
   OONF_CLOCK_SUBSYSTEM,
   OONF_TELNET_SUBSYSTEM,
   OONF_VIEWER_SUBSYSTEM,
@@ -485,6 +514,8 @@ DECLARE_OONF_PLUGIN(_olsrv2_nhdpinfo_subsystem);
  */
 static int
 _init(void) {
+  oonf_class_extension_add(&_laddr_listener);
+  oonf_class_extension_add(&_neigh_listener);
   oonf_telnet_add(&_telnet_commands[0]);
   return 0;
 }
@@ -495,6 +526,8 @@ _init(void) {
 static void
 _cleanup(void) {
   oonf_telnet_remove(&_telnet_commands[0]);
+  oonf_class_extension_remove(&_neigh_listener);
+  oonf_class_extension_remove(&_laddr_listener);
 }
 
 /**
@@ -505,7 +538,7 @@ _cleanup(void) {
 static enum oonf_telnet_result
 _cb_nhdpinfo(struct oonf_telnet_data *con) {
   return oonf_viewer_telnet_handler(
-    con->out, &_template_storage, OONF_NHDPINFO_SUBSYSTEM, con->parameter, _templates, ARRAYSIZE(_templates));
+    con, &_template_storage, OONF_NHDPINFO_SUBSYSTEM, _templates, ARRAYSIZE(_templates));
 }
 
 /**
@@ -518,6 +551,33 @@ _cb_nhdpinfo_help(struct oonf_telnet_data *con) {
   return oonf_viewer_telnet_help(con->out, OONF_NHDPINFO_SUBSYSTEM, con->parameter, _templates, ARRAYSIZE(_templates));
 }
 
+/**
+ * Callback for the generation number of the output of this plugin
+ * @param con pointer to telnet session data
+ * @return generation number, 0 if output cannot be cached
+ */
+static uint64_t
+_cb_nhdpinfo_generation(struct oonf_telnet_data *con) {
+  return oonf_viewer_get_generation(con->parameter, _templates, ARRAYSIZE(_templates));
+}
+
+/**
+ * @return generation number of the link address output
+ */
+static uint64_t
+_cb_get_link_address_generation(void) {
+  return _link_address_generation;
+}
+
+/**
+ * Callback for changes of NHDP link addresses and neighbors
+ * @param ptr unused
+ */
+static void
+_cb_link_address_changed(void *ptr __attribute__((unused))) {
+  _link_address_generation++;
+}
+
 /**
  * Initialize the value buffers for a NHDP interface
  * @param nhdp_if nhdp interface
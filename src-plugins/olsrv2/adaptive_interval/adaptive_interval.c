@@ -0,0 +1,621 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include "common/autobuf.h"
+#include "common/avl.h"
+#include "common/common_types.h"
+#include "common/isonumber.h"
+#include "common/list.h"
+#include "common/string.h"
+#include "common/template.h"
+
+#include "config/cfg_schema.h"
+#include "core/oonf_logging.h"
+#include "core/oonf_subsystem.h"
+#include "subsystems/oonf_class.h"
+#include "subsystems/oonf_clock.h"
+#include "subsystems/oonf_telnet.h"
+#include "subsystems/oonf_timer.h"
+#include "subsystems/oonf_viewer.h"
+
+#include "nhdp/nhdp_db.h"
+#include "nhdp/nhdp_domain.h"
+#include "nhdp/nhdp_interfaces.h"
+
+#include "olsrv2/olsrv2.h"
+#include "olsrv2/olsrv2_routing.h"
+
+#include "adaptive_interval/adaptive_interval.h"
+
+/* definitions */
+#define LOG_ADAPTIVE_INTERVAL _adaptive_interval_subsystem.logging
+
+/**
+ * adaptive interval plugin configuration
+ */
+struct _config {
+  /*! minimal HELLO interval */
+  uint64_t hello_min;
+
+  /*! maximal HELLO interval */
+  uint64_t hello_max;
+
+  /*! minimal TC interval */
+  uint64_t tc_min;
+
+  /*! maximal TC interval */
+  uint64_t tc_max;
+
+  /*! time between two churn samples */
+  uint64_t sample_interval;
+
+  /*! exponential aging of churn score per sample (multiplied by 1000) */
+  int32_t decay;
+
+  /*! churn score that results in the minimal intervals (multiplied by 1000) */
+  int32_t churn_threshold;
+};
+
+/* prototypes */
+static int _init(void);
+static void _cleanup(void);
+
+static uint64_t _calculate_interval(uint64_t min, uint64_t max);
+static bool _interval_changed(uint64_t current, uint64_t interval, uint64_t min, uint64_t max);
+static void _apply_hello_intervals(void);
+static void _apply_tc_interval(void);
+static void _reset_intervals(void);
+
+static void _cb_link_added(void *);
+static void _cb_link_changed(void *);
+static void _cb_link_removed(void *);
+static void _cb_metric_update(struct nhdp_domain *);
+static void _cb_sample_churn(struct oonf_timer_instance *);
+
+static enum oonf_telnet_result _cb_adaptive_interval(struct oonf_telnet_data *con);
+static enum oonf_telnet_result _cb_adaptive_interval_help(struct oonf_telnet_data *con);
+static int _cb_create_text_status(struct oonf_viewer_template *);
+static int _cb_create_text_interface(struct oonf_viewer_template *);
+
+static void _cb_cfg_changed(void);
+static int _cb_cfg_validate(const char *section_name, struct cfg_named_section *, struct autobuf *);
+
+/* configuration options */
+static struct cfg_schema_entry _adaptive_entries[] = {
+  CFG_MAP_CLOCK_MIN(_config, hello_min, "hello_min", "1.0", "Minimal interval between two HELLOs", 100),
+  CFG_MAP_CLOCK_MIN(_config, hello_max, "hello_max", "6.0", "Maximal interval between two HELLOs", 100),
+  CFG_MAP_CLOCK_MIN(_config, tc_min, "tc_min", "2.0", "Minimal interval between two TCs", 100),
+  CFG_MAP_CLOCK_MIN(_config, tc_max, "tc_max", "20.0", "Maximal interval between two TCs", 100),
+  CFG_MAP_CLOCK_MIN(
+    _config, sample_interval, "sample_interval", "1.0", "Time between two samples of the topology churn", 100),
+  CFG_MAP_INT32_MINMAX(_config, decay, "decay", "0.5",
+    "Exponential aging of the churn score per sample, 0 only uses the last sample", 3, 0, 999),
+  CFG_MAP_INT32_MINMAX(_config, churn_threshold, "churn_threshold", "10",
+    "Churn score (link status changes, ANSN increments and metric updates)"
+    " that results in the minimal intervals",
+    3, 1, INT32_MAX),
+};
+
+static struct cfg_schema_section _adaptive_section = {
+  .type = OONF_ADAPTIVE_INTERVAL_SUBSYSTEM,
+  .cb_delta_handler = _cb_cfg_changed,
+  .cb_validate = _cb_cfg_validate,
+  .entries = _adaptive_entries,
+  .entry_count = ARRAYSIZE(_adaptive_entries),
+};
+
+static struct _config _adaptive_config;
+
+/* plugin declaration */
+static const char *_dependencies[] = {
+  OONF_CLASS_SUBSYSTEM,
+  OONF_TELNET_SUBSYSTEM,
+  OONF_TIMER_SUBSYSTEM,
+  OONF_VIEWER_SUBSYSTEM,
+  OONF_NHDP_SUBSYSTEM,
+  OONF_OLSRV2_SUBSYSTEM,
+};
+static struct oonf_subsystem _adaptive_interval_subsystem = {
+  .name = OONF_ADAPTIVE_INTERVAL_SUBSYSTEM,
+  .dependencies = _dependencies,
+  .dependencies_count = ARRAYSIZE(_dependencies),
+  .descr = "OLSRv2 adaptive HELLO and TC interval plugin",
+
+  .cfg_section = &_adaptive_section,
+
+  .init = _init,
+  .cleanup = _cleanup,
+};
+DECLARE_OONF_PLUGIN(_adaptive_interval_subsystem);
+
+/* listener for NHDP link status changes */
+static struct oonf_class_extension _link_listener = {
+  .ext_name = OONF_ADAPTIVE_INTERVAL_SUBSYSTEM,
+  .class_name = NHDP_CLASS_LINK,
+  .cb_add = _cb_link_added,
+  .cb_change = _cb_link_changed,
+  .cb_remove = _cb_link_removed,
+};
+
+/* listener for NHDP metric changes */
+static struct nhdp_domain_listener _domain_listener = {
+  .metric_update = _cb_metric_update,
+};
+
+/* timer for sampling the topology churn */
+static struct oonf_timer_class _sample_timer_info = {
+  .name = "Adaptive interval churn sampling",
+  .callback = _cb_sample_churn,
+  .periodic = true,
+};
+
+static struct oonf_timer_instance _sample_timer = {
+  .class = &_sample_timer_info,
+};
+
+/* events counted since last sample */
+static uint32_t _link_events, _metric_events;
+
+/* ANSN during last sample */
+static uint16_t _last_ansn;
+
+/* total number of counted events */
+static uint64_t _total_link_events, _total_ansn_events, _total_metric_events;
+
+/* current churn score (multiplied by 1000) */
+static uint64_t _churn_score;
+
+/*
+ * list of template keys and corresponding buffers for values.
+ *
+ * The keys are API, so they should not be changed after published
+ */
+
+/*! template key for churn score */
+#define KEY_CHURN_SCORE "churn_score"
+
+/*! template key for total number of link status changes */
+#define KEY_CHURN_LINKS "churn_links"
+
+/*! template key for total number of ANSN increments */
+#define KEY_CHURN_ANSN "churn_ansn"
+
+/*! template key for total number of metric updates */
+#define KEY_CHURN_METRICS "churn_metrics"
+
+/*! template key for effective TC interval */
+#define KEY_TC_INTERVAL "tc_interval"
+
+/*! template key for effective TC validity */
+#define KEY_TC_VALIDITY "tc_validity"
+
+/*! template key for NHDP interface name */
+#define KEY_IF "if"
+
+/*! template key for effective HELLO interval */
+#define KEY_HELLO_INTERVAL "hello_interval"
+
+/*! template key for effective HELLO validity */
+#define KEY_HELLO_VALIDITY "hello_validity"
+
+/*
+ * buffer space for values that will be assembled
+ * into the output of the plugin
+ */
+static struct isonumber_str _value_churn_score;
+static struct isonumber_str _value_churn_links;
+static struct isonumber_str _value_churn_ansn;
+static struct isonumber_str _value_churn_metrics;
+static struct isonumber_str _value_tc_interval;
+static struct isonumber_str _value_tc_validity;
+static char _value_if[IF_NAMESIZE];
+static struct isonumber_str _value_hello_interval;
+static struct isonumber_str _value_hello_validity;
+
+/* definition of the template data entries for JSON and table output */
+static struct abuf_template_data_entry _tde_status[] = {
+  { KEY_CHURN_SCORE, _value_churn_score.buf, false },
+  { KEY_CHURN_LINKS, _value_churn_links.buf, false },
+  { KEY_CHURN_ANSN, _value_churn_ansn.buf, false },
+  { KEY_CHURN_METRICS, _value_churn_metrics.buf, false },
+  { KEY_TC_INTERVAL, _value_tc_interval.buf, false },
+  { KEY_TC_VALIDITY, _value_tc_validity.buf, false },
+};
+static struct abuf_template_data_entry _tde_if[] = {
+  { KEY_IF, _value_if, true },
+  { KEY_HELLO_INTERVAL, _value_hello_interval.buf, false },
+  { KEY_HELLO_VALIDITY, _value_hello_validity.buf, false },
+};
+
+static struct abuf_template_storage _template_storage;
+
+/* Template Data objects (contain one or more Template Data Entries) */
+static struct abuf_template_data _td_status[] = {
+  { _tde_status, ARRAYSIZE(_tde_status) },
+};
+static struct abuf_template_data _td_if[] = {
+  { _tde_if, ARRAYSIZE(_tde_if) },
+};
+
+/* OONF viewer templates (based on Template Data arrays) */
+static struct oonf_viewer_template _templates[] = {
+  {
+    .data = _td_status,
+    .data_size = ARRAYSIZE(_td_status),
+    .json_name = "status",
+    .cb_function = _cb_create_text_status,
+  },
+  {
+    .data = _td_if,
+    .data_size = ARRAYSIZE(_td_if),
+    .json_name = "interface",
+    .cb_function = _cb_create_text_interface,
+  },
+};
+
+/* telnet command of this plugin */
+static struct oonf_telnet_command _telnet_commands[] = {
+  TELNET_CMD(OONF_ADAPTIVE_INTERVAL_SUBSYSTEM, _cb_adaptive_interval, "", .help_handler = _cb_adaptive_interval_help),
+};
+
+/**
+ * Initialize plugin
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_init(void) {
+  if (oonf_class_extension_add(&_link_listener)) {
+    return -1;
+  }
+  nhdp_domain_listener_add(&_domain_listener);
+  oonf_timer_add(&_sample_timer_info);
+  oonf_telnet_add(&_telnet_commands[0]);
+
+  _last_ansn = olsrv2_routing_get_ansn();
+  return 0;
+}
+
+/**
+ * Cleanup plugin
+ */
+static void
+_cleanup(void) {
+  oonf_telnet_remove(&_telnet_commands[0]);
+  oonf_timer_stop(&_sample_timer);
+  oonf_timer_remove(&_sample_timer_info);
+  nhdp_domain_listener_remove(&_domain_listener);
+  oonf_class_extension_remove(&_link_listener);
+
+  /* return to configured intervals */
+  _reset_intervals();
+}
+
+/**
+ * Calculate an interval for the current churn score
+ * @param min interval for maximal churn
+ * @param max interval without churn
+ * @return interval between min and max
+ */
+static uint64_t
+_calculate_interval(uint64_t min, uint64_t max) {
+  uint64_t score, threshold;
+
+  threshold = _adaptive_config.churn_threshold;
+  score = _churn_score < threshold ? _churn_score : threshold;
+
+  return max - (max - min) * score / threshold;
+}
+
+/**
+ * Check if a new interval is different enough from the current one
+ * to be applied. Small changes are ignored to prevent restarting the
+ * HELLO/TC timers on every sample.
+ * @param current current interval
+ * @param interval new interval
+ * @param min minimal interval
+ * @param max maximal interval
+ * @return true if interval should be applied, false otherwise
+ */
+static bool
+_interval_changed(uint64_t current, uint64_t interval, uint64_t min, uint64_t max) {
+  uint64_t diff;
+
+  if (current == interval) {
+    return false;
+  }
+  if (interval == min || interval == max) {
+    return true;
+  }
+
+  /* ignore changes of less than 10 percent */
+  diff = current > interval ? current - interval : interval - current;
+  return diff * 10 >= current;
+}
+
+/**
+ * Apply adaptive HELLO interval and validity to all NHDP interfaces
+ */
+static void
+_apply_hello_intervals(void) {
+  struct nhdp_interface *interf;
+  uint64_t itime, vtime, current;
+
+  itime = _calculate_interval(_adaptive_config.hello_min, _adaptive_config.hello_max);
+
+  avl_for_each_element(nhdp_interface_get_tree(), interf, _node) {
+    current = interf->overwrite_hello_interval;
+    if (!current) {
+      current = interf->refresh_interval;
+    }
+
+    if (!_interval_changed(current, itime, _adaptive_config.hello_min, _adaptive_config.hello_max)) {
+      continue;
+    }
+
+    /* keep the configured ratio between validity and interval */
+    vtime = itime * interf->validity_time / interf->refresh_interval;
+
+    OONF_DEBUG(LOG_ADAPTIVE_INTERVAL, "Set hello interval of %s to %" PRIu64 " (validity %" PRIu64 ")",
+      nhdp_interface_get_name(interf), itime, vtime);
+
+    nhdp_interface_set_hello_timing(interf, itime, vtime);
+  }
+}
+
+/**
+ * Apply adaptive TC interval and validity to OLSRv2
+ */
+static void
+_apply_tc_interval(void) {
+  uint64_t itime, vtime;
+
+  itime = _calculate_interval(_adaptive_config.tc_min, _adaptive_config.tc_max);
+  if (!_interval_changed(olsrv2_get_tc_interval(), itime, _adaptive_config.tc_min, _adaptive_config.tc_max)) {
+    return;
+  }
+
+  /* keep the configured ratio between validity and interval */
+  vtime = itime * olsrv2_get_configured_tc_validity() / olsrv2_get_configured_tc_interval();
+
+  OONF_DEBUG(LOG_ADAPTIVE_INTERVAL, "Set TC interval to %" PRIu64 " (validity %" PRIu64 ")", itime, vtime);
+
+  olsrv2_set_tc_validity(vtime);
+  olsrv2_set_tc_interval(itime);
+}
+
+/**
+ * Reset HELLO and TC intervals to their configured values
+ */
+static void
+_reset_intervals(void) {
+  struct nhdp_interface *interf;
+
+  avl_for_each_element(nhdp_interface_get_tree(), interf, _node) {
+    if (interf->overwrite_hello_interval || interf->overwrite_hello_validity) {
+      nhdp_interface_set_hello_timing(interf, 0, 0);
+    }
+  }
+
+  olsrv2_set_tc_validity(0);
+  olsrv2_set_tc_interval(0);
+}
+
+/**
+ * Callback for new NHDP links
+ * @param ptr nhdp link
+ */
+static void
+_cb_link_added(void *ptr __attribute__((unused))) {
+  _link_events++;
+}
+
+/**
+ * Callback for changed NHDP links, only counts status changes
+ * @param ptr nhdp link
+ */
+static void
+_cb_link_changed(void *ptr) {
+  struct nhdp_link *lnk = ptr;
+
+  if (lnk->last_status != lnk->status) {
+    _link_events++;
+  }
+}
+
+/**
+ * Callback for removed NHDP links
+ * @param ptr nhdp link
+ */
+static void
+_cb_link_removed(void *ptr __attribute__((unused))) {
+  _link_events++;
+}
+
+/**
+ * Callback for NHDP metric updates
+ * @param domain NHDP domain with changed metric
+ */
+static void
+_cb_metric_update(struct nhdp_domain *domain __attribute__((unused))) {
+  _metric_events++;
+}
+
+/**
+ * Callback to sample the topology churn and update the intervals
+ * @param ptr timer instance that fired
+ */
+static void
+_cb_sample_churn(struct oonf_timer_instance *ptr __attribute__((unused))) {
+  uint16_t ansn, ansn_events;
+
+  ansn = olsrv2_routing_get_ansn();
+  ansn_events = ansn - _last_ansn;
+  _last_ansn = ansn;
+
+  _total_link_events += _link_events;
+  _total_ansn_events += ansn_events;
+  _total_metric_events += _metric_events;
+
+  /* age old churn score and add new events */
+  _churn_score = _churn_score * _adaptive_config.decay / 1000;
+  _churn_score += 1000ull * (_link_events + ansn_events + _metric_events);
+
+  OONF_DEBUG(LOG_ADAPTIVE_INTERVAL, "Churn sample: links=%u ansn=%u metrics=%u score=%" PRIu64, _link_events,
+    ansn_events, _metric_events, _churn_score);
+
+  _link_events = 0;
+  _metric_events = 0;
+
+  _apply_hello_intervals();
+  _apply_tc_interval();
+}
+
+/**
+ * Callback for the telnet command of this plugin
+ * @param con pointer to telnet session data
+ * @return telnet result value
+ */
+static enum oonf_telnet_result
+_cb_adaptive_interval(struct oonf_telnet_data *con) {
+  return oonf_viewer_telnet_handler(
+    con, &_template_storage, OONF_ADAPTIVE_INTERVAL_SUBSYSTEM, _templates, ARRAYSIZE(_templates));
+}
+
+/**
+ * Callback for the help output of this plugin
+ * @param con pointer to telnet session data
+ * @return telnet result value
+ */
+static enum oonf_telnet_result
+_cb_adaptive_interval_help(struct oonf_telnet_data *con) {
+  return oonf_viewer_telnet_help(
+    con->out, OONF_ADAPTIVE_INTERVAL_SUBSYSTEM, con->parameter, _templates, ARRAYSIZE(_templates));
+}
+
+/**
+ * Callback to generate text/json description of churn score and TC interval
+ * @param template viewer template
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_status(struct oonf_viewer_template *template) {
+  isonumber_from_u64(&_value_churn_score, _churn_score, "", 3, template->create_raw);
+  isonumber_from_u64(&_value_churn_links, _total_link_events, "", 0, template->create_raw);
+  isonumber_from_u64(&_value_churn_ansn, _total_ansn_events, "", 0, template->create_raw);
+  isonumber_from_u64(&_value_churn_metrics, _total_metric_events, "", 0, template->create_raw);
+  isonumber_from_u64(&_value_tc_interval, olsrv2_get_tc_interval(), "", 3, template->create_raw);
+  isonumber_from_u64(&_value_tc_validity, olsrv2_get_tc_validity(), "", 3, template->create_raw);
+
+  /* generate template output */
+  oonf_viewer_output_print_line(template);
+  return 0;
+}
+
+/**
+ * Callback to generate text/json description of effective HELLO intervals
+ * @param template viewer template
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_interface(struct oonf_viewer_template *template) {
+  struct nhdp_interface *interf;
+  uint64_t itime, vtime;
+
+  avl_for_each_element(nhdp_interface_get_tree(), interf, _node) {
+    itime = interf->overwrite_hello_interval ? interf->overwrite_hello_interval : interf->refresh_interval;
+    vtime = interf->overwrite_hello_validity ? interf->overwrite_hello_validity : interf->validity_time;
+
+    strscpy(_value_if, nhdp_interface_get_name(interf), sizeof(_value_if));
+    isonumber_from_u64(&_value_hello_interval, itime, "", 3, template->create_raw);
+    isonumber_from_u64(&_value_hello_validity, vtime, "", 3, template->create_raw);
+
+    /* generate template output */
+    oonf_viewer_output_print_line(template);
+  }
+  return 0;
+}
+
+/**
+ * Callback triggered when configuration changes
+ */
+static void
+_cb_cfg_changed(void) {
+  if (cfg_schema_tobin(&_adaptive_config, _adaptive_section.post, _adaptive_entries, ARRAYSIZE(_adaptive_entries))) {
+    OONF_WARN(LOG_ADAPTIVE_INTERVAL, "Could not convert " OONF_ADAPTIVE_INTERVAL_SUBSYSTEM " plugin configuration");
+    return;
+  }
+
+  oonf_timer_set(&_sample_timer, _adaptive_config.sample_interval);
+}
+
+/**
+ * Callback triggered to check validity of configuration section
+ * @param section_name name of section
+ * @param named configuration data of section
+ * @param out output buffer for error messages
+ * @return 0 if data is okay, -1 if an error happened
+ */
+static int
+_cb_cfg_validate(const char *section_name, struct cfg_named_section *named, struct autobuf *out) {
+  struct _config cfg;
+  struct isonumber_str buf1, buf2;
+
+  if (cfg_schema_tobin(&cfg, named, _adaptive_entries, ARRAYSIZE(_adaptive_entries))) {
+    cfg_append_printable_line(out, "Could not parse adaptive interval configuration in section %s", section_name);
+    return -1;
+  }
+
+  if (cfg.hello_min > cfg.hello_max) {
+    cfg_append_printable_line(out, "hello_min (%s) is larger than hello_max (%s)",
+      isonumber_from_u64(&buf1, cfg.hello_min, "", 3, true), isonumber_from_u64(&buf2, cfg.hello_max, "", 3, true));
+    return -1;
+  }
+  if (cfg.tc_min > cfg.tc_max) {
+    cfg_append_printable_line(out, "tc_min (%s) is larger than tc_max (%s)",
+      isonumber_from_u64(&buf1, cfg.tc_min, "", 3, true), isonumber_from_u64(&buf2, cfg.tc_max, "", 3, true));
+    return -1;
+  }
+  return 0;
+}
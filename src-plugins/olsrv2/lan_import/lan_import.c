@@ -50,6 +50,7 @@
 #include "common/list.h"
 #include "common/netaddr.h"
 #include "common/netaddr_acl.h"
+#include "common/netaddr_rule_index.h"
 
 #include "core/oonf_logging.h"
 #include "core/oonf_subsystem.h"
@@ -103,6 +104,9 @@ struct _import_entry {
   /*! list of lan entries imported by this filter */
   struct avl_tree imported_lan_tree;
 
+  /*! rule for the prefix length and address filter */
+  struct netaddr_rule _rule;
+
   /*! tree of all configured lan import */
   struct avl_node _node;
 };
@@ -126,6 +130,7 @@ static void _cleanup(void);
 
 static struct _import_entry *_get_import(const char *name);
 static void _destroy_import(struct _import_entry *);
+static void _update_index(void);
 
 static struct _imported_lan *_add_lan(
   struct _import_entry *, struct os_route_key *key, uint32_t metric, uint8_t distance);
@@ -230,6 +235,9 @@ static struct os_route_listener _routing_listener = {
 /* tree of lan importers */
 static struct avl_tree _import_tree;
 
+/* index of lan importers, sorted like the import tree */
+static struct netaddr_rule_index _import_index;
+
 static struct oonf_timer_class _aging_timer_class = {
   .name = "lan import metric aging",
   .callback = _cb_metric_aging,
@@ -246,6 +254,7 @@ static struct os_route _unicast_query;
 static int
 _init(void) {
   avl_init(&_import_tree, avl_comp_strcasecmp, false);
+  netaddr_rule_index_init(&_import_index);
   oonf_class_add(&_import_class);
   oonf_class_add(&_lan_import_class);
   os_routing_listener_add(&_routing_listener);
@@ -275,6 +284,7 @@ _cleanup(void) {
   avl_for_each_element_safe(&_import_tree, import, _node, import_it) {
     _destroy_import(import);
   }
+  netaddr_rule_index_clear(&_import_index);
 
   oonf_timer_remove(&_aging_timer_class);
   oonf_class_remove(&_lan_import_class);
@@ -335,6 +345,8 @@ static void
 _cb_rt_event(const struct os_route *route, bool set) {
   struct _import_entry *import;
   struct _imported_lan *lan;
+  struct netaddr_rule_iterator iter;
+  struct netaddr_rule *rule;
   char ifname[IF_NAMESIZE];
   struct os_route_key ssprefix;
   int metric;
@@ -369,21 +381,11 @@ _cb_rt_event(const struct os_route *route, bool set) {
     if_indextoname(route->p.if_index, ifname);
   }
 
-  avl_for_each_element(&_import_tree, import, _node) {
+  /* the index checks prefix length and destination */
+  netaddr_rule_index_for_each_match(&_import_index, &iter, NETADDR_RULE_ANY, &route->p.key.dst, rule) {
+    import = container_of(rule, struct _import_entry, _rule);
     OONF_DEBUG(LOG_LAN_IMPORT, "Check for import: %s", import->name);
 
-    /* check prefix length */
-    if (import->prefix_length != -1 && import->prefix_length != netaddr_get_prefix_length(&route->p.key.dst)) {
-      OONF_DEBUG(LOG_LAN_IMPORT, "Bad prefix length");
-      continue;
-    }
-
-    /* check if destination matches */
-    if (!netaddr_acl_check_accept(&import->filter, &route->p.key.dst)) {
-      OONF_DEBUG(LOG_LAN_IMPORT, "Bad prefix");
-      continue;
-    }
-
     /* check routing table */
     if (import->table != -1 && import->table != route->p.table) {
       OONF_DEBUG(LOG_LAN_IMPORT, "Bad routing table");
@@ -468,6 +470,8 @@ _get_import(const char *name) {
 
   avl_init(&import->imported_lan_tree, os_routing_avl_cmp_route_key, false);
 
+  import->_rule.acl = &import->filter;
+  _update_index();
   return import;
 }
 
@@ -477,6 +481,7 @@ _get_import(const char *name) {
  */
 static void
 _destroy_import(struct _import_entry *import) {
+  netaddr_rule_index_remove(&_import_index, &import->_rule);
   avl_remove(&_import_tree, &import->_node);
   netaddr_acl_remove(&import->filter);
   oonf_class_free(&_import_class, import);
@@ -605,13 +610,34 @@ _cb_cfg_changed(void) {
     if (_import_section.pre == NULL) {
       _destroy_import(import);
     }
+    else {
+      /* filter might have been changed partially */
+      _update_index();
+    }
     return;
   }
 
   cfg_get_phy_if(import->ifname, import->ifname);
+  _update_index();
 
   /* trigger wildcard query */
   if (!os_routing_is_in_progress(&_unicast_query)) {
     os_routing_query(&_unicast_query);
   }
 }
+
+/**
+ * Refill the rule index with all lan importers, keeping
+ * the order of the import tree
+ */
+static void
+_update_index(void) {
+  struct _import_entry *import;
+
+  netaddr_rule_index_clear(&_import_index);
+  avl_for_each_element(&_import_tree, import, _node) {
+    import->_rule.key = NETADDR_RULE_ANY;
+    import->_rule.prefix_length = import->prefix_length;
+    netaddr_rule_index_add(&_import_index, &import->_rule);
+  }
+}
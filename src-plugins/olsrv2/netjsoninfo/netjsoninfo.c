@@ -43,6 +43,9 @@
  * @file
  */
 
+#include <stdlib.h>
+#include <string.h>
+
 #include "common/autobuf.h"
 #include "common/common_types.h"
 #include "common/json.h"
@@ -79,6 +82,9 @@
 /*! name of domain command/json-object */
 #define JSON_NAME_DOMAIN "domain"
 
+/*! number of bytes netjsoninfo generates before the output is sent */
+#define NETJSONINFO_CHUNK_SIZE 65536
+
 /*! Text buffer for a domain id string */
 struct domain_id_str {
   /*! string buffer */
@@ -123,17 +129,134 @@ enum netjson_edge_type
   NETJSON_EDGE_ATTACHED,
 };
 
+/*! types of netjson objects generated for a sub-command */
+enum netjson_object_type
+{
+  /*! no sub-command is processed */
+  NETJSON_OBJECT_NONE,
+
+  /*! NetworkGraph objects */
+  NETJSON_OBJECT_GRAPH,
+
+  /*! NetworkRoutes objects */
+  NETJSON_OBJECT_ROUTE,
+};
+
+/*! parts of a netjson object, generated one after another */
+enum netjson_step
+{
+  /*! no object is generated at the moment */
+  NETJSON_STEP_NONE,
+
+  /*! header of the object */
+  NETJSON_STEP_START,
+
+  /*! graph nodes for locally attached networks */
+  NETJSON_STEP_NODES_LAN,
+
+  /*! graph nodes for remote routers and their attached networks */
+  NETJSON_STEP_NODES_TC,
+
+  /*! graph edges to NHDP neighbors */
+  NETJSON_STEP_LINKS_NEIGH,
+
+  /*! graph edges to locally attached networks */
+  NETJSON_STEP_LINKS_LAN,
+
+  /*! graph edges between remote routers */
+  NETJSON_STEP_LINKS_TC,
+
+  /*! graph edges to attached networks of remote routers */
+  NETJSON_STEP_LINKS_ATTACHED,
+
+  /*! entries of routing tree */
+  NETJSON_STEP_ROUTES,
+
+  /*! end of the object */
+  NETJSON_STEP_END,
+};
+
+/*! state of a netjsoninfo command that generates its output in chunks */
+struct netjson_generator {
+  /*! json generator for output */
+  struct json_generator json;
+
+  /*! copy of the command parameters */
+  char *parameter;
+
+  /*! next sub-command to parse, NULL if no sub-command is left */
+  const char *next;
+
+  /*! parameter string reported with a parser error */
+  const char *error_parameter;
+
+  /*! id of the domain to print, NULL for all domains */
+  const char *filter;
+
+  /*! true if output is a NetworkCollection */
+  bool collection;
+
+  /*! true if the start of the output has been generated */
+  bool started;
+
+  /*! true if a sub-command could not be parsed */
+  bool error;
+
+  /*! type of objects for the current sub-command */
+  enum netjson_object_type type;
+
+  /*! domain of the current object, NULL if none selected yet */
+  struct nhdp_domain *domain;
+
+  /*! address family of the current object */
+  int af_type;
+
+  /*! part of the current object that is generated next */
+  enum netjson_step step;
+
+  /*! true if key contains the next database entry of the current step */
+  bool has_key;
+
+  /*! key of the database entry to continue the current step with */
+  union {
+    /*! key of tc node or nhdp neighbor */
+    struct netaddr addr;
+
+    /*! key of locally attached network or routing entry */
+    struct os_route_key route;
+  } key;
+
+  /*! topology generation at the start of the current object */
+  uint32_t generation;
+};
+
 /* prototypes */
 static int _init(void);
 static void _cleanup(void);
 
-static void _print_graph(struct json_session *session, struct nhdp_domain *domain, int af_type);
-static void _create_graph_json(struct json_session *session, const char *filter);
-static void _print_routing_tree(struct json_session *session, struct nhdp_domain *domain, int af_type);
-static void _create_route_json(struct json_session *session, const char *filter);
 static void _create_domain_json(struct json_session *session);
 static void _create_error_json(struct json_session *session, const char *message, const char *parameter);
+static void _set_step(struct netjson_generator *gen, enum netjson_step step);
+static void _print_graph_start(struct netjson_generator *gen, const struct netaddr *originator);
+static void _print_graph_lan_nodes(struct netjson_generator *gen);
+static void _print_graph_tc_nodes(struct netjson_generator *gen, const struct netaddr *originator);
+static void _print_graph_neighbor_links(struct netjson_generator *gen, const struct netaddr *originator);
+static void _print_graph_lan_links(struct netjson_generator *gen, const struct netaddr *originator);
+static void _print_graph_tc_links(struct netjson_generator *gen, const struct netaddr *originator);
+static void _print_graph_attached_links(struct netjson_generator *gen);
+static void _print_routing_start(struct netjson_generator *gen, const struct netaddr *originator);
+static void _print_routing_entry(
+  struct json_session *session, struct nhdp_domain *domain, struct olsrv2_routing_entry *rtentry);
+static void _print_routing_entries(struct netjson_generator *gen);
+static void _print_object_step(struct netjson_generator *gen);
+static bool _select_next_domain(struct netjson_generator *gen);
+static bool _handle_next_subcommand(struct netjson_generator *gen);
+static bool _cb_generate_netjson(struct json_generator *json);
+static void _free_generator(struct netjson_generator *gen);
 static enum oonf_telnet_result _cb_netjsoninfo(struct oonf_telnet_data *con);
+static enum oonf_telnet_result _cb_netjsoninfo_underrun(struct oonf_telnet_data *con);
+static void _cb_netjsoninfo_stop(struct oonf_telnet_data *con);
+static uint64_t _cb_netjsoninfo_generation(struct oonf_telnet_data *con);
 static void _print_json_string(struct json_session *session, const char *key, const char *value);
 static void _print_json_number(struct json_session *session, const char *key, uint64_t value);
 static void _print_json_netaddr(struct json_session *session, const char *key, const struct netaddr *addr);
@@ -149,7 +272,8 @@ static struct oonf_telnet_command _telnet_commands[] = {
     "The filter prefix use an id (which can be queried by 'domain') to output"
     " a single domain of route/graph without the NetworkCollection object"
     " around it. The domain_id's are ipv4_<domain_number> and ipv6_<domain_number>.\n"
-    "> netjsoninfo filter route ipv4_0\n"),
+    "> netjsoninfo filter route ipv4_0\n",
+    .generation_handler = _cb_netjsoninfo_generation),
 };
 
 /* plugin declaration */
@@ -565,36 +689,99 @@ _print_graph_edge(struct json_session *session, struct nhdp_domain *domain, cons
   json_end_object(session);
 }
 
+static void
+_create_domain_json(struct json_session *session) {
+  const struct netaddr *originator_v4, *originator_v6;
+  struct nhdp_domain *domain;
+  struct domain_id_str dbuf;
+
+  originator_v4 = olsrv2_originator_get(AF_INET);
+  originator_v6 = olsrv2_originator_get(AF_INET6);
+
+  json_start_object(session, NULL);
+
+  _print_json_string(session, "type", "NetworkDomain");
+  _print_json_string(session, "protocol", "olsrv2");
+  _print_json_string(session, "version", oonf_log_get_libdata()->version);
+  _print_json_string(session, "revision", oonf_log_get_libdata()->git_commit);
+
+  json_start_array(session, JSON_NAME_DOMAIN);
+
+  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    if (!netaddr_is_unspec(originator_v4)) {
+      json_start_object(session, NULL);
+
+      _print_json_string(session, "id", _create_domain_id(&dbuf, domain, AF_INET));
+      _print_json_number(session, "number", domain->ext);
+      _print_json_netaddr(session, "router_id", originator_v4);
+      _print_json_string(session, "metric", domain->metric->name);
+      _print_json_string(session, "mpr", domain->mpr->name);
+
+      json_end_object(session);
+    }
+
+    if (!netaddr_is_unspec(originator_v6)) {
+      json_start_object(session, NULL);
+
+      _print_json_string(session, "id", _create_domain_id(&dbuf, domain, AF_INET6));
+      _print_json_number(session, "number", domain->ext);
+      _print_json_netaddr(session, "router_id", originator_v6);
+      _print_json_string(session, "metric", domain->metric->name);
+      _print_json_string(session, "mpr", domain->mpr->name);
+
+      json_end_object(session);
+    }
+  }
+
+  json_end_array(session);
+  json_end_object(session);
+}
+
 /**
- * Print the JSON graph object
+ * Print a JSON error
  * @param session json session
- * @param domain NHDP domain
- * @param af_type address family type
+ * @param message error message
+ * @param parameter error parameter
  */
 static void
-_print_graph(struct json_session *session, struct nhdp_domain *domain, int af_type) {
-  struct os_route_key routekey;
-  const struct netaddr *originator, *dualstack;
-  struct nhdp_neighbor *neigh;
-  struct olsrv2_tc_node *node;
-  struct olsrv2_tc_edge *edge;
-  struct olsrv2_tc_attachment *attached;
-  struct olsrv2_lan_entry *lan;
-  struct avl_tree *rt_tree;
-  struct olsrv2_routing_entry *rt_entry;
+_create_error_json(struct json_session *session, const char *message, const char *parameter) {
+  json_start_object(session, NULL);
+
+  _print_json_string(session, "type", "Error");
+  _print_json_string(session, "message", message);
+  _print_json_string(session, "parameter", parameter);
+
+  json_end_object(session);
+}
+
+/**
+ * Start a new step of a netjson object
+ * @param gen netjson generator
+ * @param step next step
+ */
+static void
+_set_step(struct netjson_generator *gen, enum netjson_step step) {
+  gen->step = step;
+  gen->has_key = false;
+}
+
+/**
+ * Print the header of a JSON graph object including the local node
+ * @param gen netjson generator
+ * @param originator originator of the local node
+ */
+static void
+_print_graph_start(struct netjson_generator *gen, const struct netaddr *originator) {
+  struct json_session *session;
+  const struct netaddr *dualstack;
   struct domain_id_str dbuf;
-  struct _node_id_str node_id1, node_id2;
+  struct _node_id_str node_id;
   int other_af;
 
-  bool outgoing;
-
-  originator = olsrv2_originator_get(af_type);
-  if (netaddr_is_unspec(originator)) {
-    return;
-  }
+  session = &gen->json.session;
 
   /* get "other" originator */
-  other_af = _get_other_af_type(af_type);
+  other_af = _get_other_af_type(gen->af_type);
 
   /* get dualstack originator */
   dualstack = olsrv2_originator_get(AF_INET6);
@@ -605,176 +792,324 @@ _print_graph(struct json_session *session, struct nhdp_domain *domain, int af_ty
   _print_json_string(session, "protocol", "olsrv2");
   _print_json_string(session, "version", oonf_log_get_libdata()->version);
   _print_json_string(session, "revision", oonf_log_get_libdata()->git_commit);
-
-  _print_json_string(session, "router_id", _get_node_id_me(&node_id1, af_type));
-
-  _print_json_string(session, "metric", domain->metric->name);
-  _print_json_string(session, "topology_id", _create_domain_id(&dbuf, domain, af_type));
+  _print_json_string(session, "router_id", _get_node_id_me(&node_id, gen->af_type));
+  _print_json_string(session, "metric", gen->domain->metric->name);
+  _print_json_string(session, "topology_id", _create_domain_id(&dbuf, gen->domain, gen->af_type));
 
   json_start_object(session, "properties");
   _print_json_netaddr(session, "router_addr", originator);
   if (dualstack) {
-    _print_json_string(session, "dualstack_id", _get_node_id_me(&node_id1, other_af));
-    _print_json_string(session, "dualstack_topology", _create_domain_id(&dbuf, domain, other_af));
+    _print_json_string(session, "dualstack_id", _get_node_id_me(&node_id, other_af));
+    _print_json_string(session, "dualstack_topology", _create_domain_id(&dbuf, gen->domain, other_af));
     _print_json_netaddr(session, "dualstack_addr", dualstack);
   }
+  _print_json_number(session, "topology_generation", gen->generation);
   json_end_object(session);
 
   json_start_array(session, "nodes");
 
   /* local node */
-  _print_graph_node_me(session, af_type);
+  _print_graph_node_me(session, gen->af_type);
+}
 
-  /* locally attached networks */
-  avl_for_each_element(olsrv2_lan_get_tree(), lan, _node) {
-    if (netaddr_get_address_family(&lan->prefix.dst) == af_type && olsrv2_lan_get_domaindata(domain, lan)->active) {
-      _print_graph_node_lan(session, lan);
+/**
+ * Print the JSON node elements of the locally attached networks
+ * @param gen netjson generator
+ */
+static void
+_print_graph_lan_nodes(struct netjson_generator *gen) {
+  struct olsrv2_lan_entry *lan;
+
+  if (gen->has_key) {
+    lan = avl_find_ge_element(olsrv2_lan_get_tree(), &gen->key.route, lan, _node);
+  }
+  else {
+    lan = avl_first_element_safe(olsrv2_lan_get_tree(), lan, _node);
+  }
+
+  for (; lan != NULL; lan = avl_next_element_safe(olsrv2_lan_get_tree(), lan, _node)) {
+    if (json_generator_is_full(&gen->json)) {
+      /* continue with this entry in the next chunk */
+      memcpy(&gen->key.route, &lan->prefix, sizeof(gen->key.route));
+      gen->has_key = true;
+      return;
+    }
+
+    if (netaddr_get_address_family(&lan->prefix.dst) == gen->af_type &&
+        olsrv2_lan_get_domaindata(gen->domain, lan)->active) {
+      _print_graph_node_lan(&gen->json.session, lan);
     }
   }
+  _set_step(gen, NETJSON_STEP_NODES_TC);
+}
 
-  /* originators of all other nodes */
-  avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
-    if (netaddr_get_address_family(&node->target.prefix.dst) == af_type) {
-      if (netaddr_cmp(&node->target.prefix.dst, originator) == 0) {
-        continue;
-      }
+/**
+ * Print the JSON node elements of all other routers and their
+ * attached networks
+ * @param gen netjson generator
+ * @param originator originator of the local node
+ */
+static void
+_print_graph_tc_nodes(struct netjson_generator *gen, const struct netaddr *originator) {
+  struct olsrv2_tc_attachment *attached;
+  struct olsrv2_tc_node *node;
 
-      _print_graph_node_tc(session, node);
+  if (gen->has_key) {
+    node = avl_find_ge_element(olsrv2_tc_get_tree(), &gen->key.addr, node, _originator_node);
+  }
+  else {
+    node = avl_first_element_safe(olsrv2_tc_get_tree(), node, _originator_node);
+  }
 
-      /* attached networks */
-      avl_for_each_element(&node->_attached_networks, attached, _src_node) {
-        _print_graph_node_attached(session, attached);
-      }
+  for (; node != NULL; node = avl_next_element_safe(olsrv2_tc_get_tree(), node, _originator_node)) {
+    if (json_generator_is_full(&gen->json)) {
+      /* continue with this node in the next chunk */
+      memcpy(&gen->key.addr, &node->target.prefix.dst, sizeof(gen->key.addr));
+      gen->has_key = true;
+      return;
     }
-  }
-  json_end_array(session);
 
-  json_start_array(session, "links");
+    if (netaddr_get_address_family(&node->target.prefix.dst) != gen->af_type ||
+        netaddr_cmp(&node->target.prefix.dst, originator) == 0) {
+      continue;
+    }
 
-  rt_tree = olsrv2_routing_get_tree(domain);
+    _print_graph_node_tc(&gen->json.session, node);
 
-  /* print local links to neighbors */
-  _get_node_id_me(&node_id1, af_type);
+    /* attached networks */
+    avl_for_each_element(&node->_attached_networks, attached, _src_node) {
+      _print_graph_node_attached(&gen->json.session, attached);
+    }
+  }
 
-  avl_for_each_element(nhdp_db_get_neigh_originator_tree(), neigh, _originator_node) {
-    if (netaddr_get_address_family(&neigh->originator) == af_type && neigh->symmetric > 0) {
-      os_routing_init_sourcespec_prefix(&routekey, &neigh->originator);
+  json_end_array(&gen->json.session);
+  json_start_array(&gen->json.session, "links");
+  _set_step(gen, NETJSON_STEP_LINKS_NEIGH);
+}
 
-      rt_entry = avl_find_element(rt_tree, &routekey, rt_entry, _node);
-      outgoing = rt_entry != NULL && netaddr_cmp(&rt_entry->last_originator, originator) == 0;
+/**
+ * Print the JSON edges between the local router and its neighbors
+ * @param gen netjson generator
+ * @param originator originator of the local node
+ */
+static void
+_print_graph_neighbor_links(struct netjson_generator *gen, const struct netaddr *originator) {
+  struct os_route_key routekey;
+  struct nhdp_neighbor *neigh;
+  struct olsrv2_routing_entry *rt_entry;
+  struct avl_tree *rt_tree;
+  struct _node_id_str node_id1, node_id2;
+  bool outgoing;
 
-      _get_nhdp_neighbor_id(&node_id2, neigh);
+  rt_tree = olsrv2_routing_get_tree(gen->domain);
+  _get_node_id_me(&node_id1, gen->af_type);
+
+  if (gen->has_key) {
+    neigh = avl_find_ge_element(nhdp_db_get_neigh_originator_tree(), &gen->key.addr, neigh, _originator_node);
+  }
+  else {
+    neigh = avl_first_element_safe(nhdp_db_get_neigh_originator_tree(), neigh, _originator_node);
+  }
 
-      _print_graph_edge(session, domain, &node_id1, &node_id2, originator, &neigh->originator,
-        nhdp_domain_get_neighbordata(domain, neigh)->metric.out, nhdp_domain_get_neighbordata(domain, neigh)->metric.in,
-        0, outgoing, NETJSON_EDGE_LOCAL, neigh);
+  for (; neigh != NULL; neigh = avl_next_element_safe(nhdp_db_get_neigh_originator_tree(), neigh, _originator_node)) {
+    if (json_generator_is_full(&gen->json)) {
+      /* continue with this neighbor in the next chunk */
+      memcpy(&gen->key.addr, &neigh->originator, sizeof(gen->key.addr));
+      gen->has_key = true;
+      return;
+    }
 
-      _print_graph_edge(session, domain, &node_id2, &node_id1, &neigh->originator, originator,
-        nhdp_domain_get_neighbordata(domain, neigh)->metric.in, nhdp_domain_get_neighbordata(domain, neigh)->metric.out,
-        0, false, NETJSON_EDGE_ROUTERS, NULL);
+    if (netaddr_get_address_family(&neigh->originator) != gen->af_type || neigh->symmetric == 0) {
+      continue;
     }
-  }
 
-  /* print local endpoints */
-  avl_for_each_element(olsrv2_lan_get_tree(), lan, _node) {
-    if (netaddr_get_address_family(&lan->prefix.dst) == af_type && olsrv2_lan_get_domaindata(domain, lan)->active) {
-      rt_entry = avl_find_element(rt_tree, &lan->prefix, rt_entry, _node);
-      outgoing = rt_entry == NULL;
+    os_routing_init_sourcespec_prefix(&routekey, &neigh->originator);
+    rt_entry = avl_find_element(rt_tree, &routekey, rt_entry, _node);
+    outgoing = rt_entry != NULL && netaddr_cmp(&rt_entry->last_originator, originator) == 0;
 
-      _get_tc_lan_id(&node_id2, lan);
+    _get_nhdp_neighbor_id(&node_id2, neigh);
 
-      _print_graph_edge(session, domain, &node_id1, &node_id2, originator, &lan->prefix.dst,
-        olsrv2_lan_get_domaindata(domain, lan)->outgoing_metric, 0, olsrv2_lan_get_domaindata(domain, lan)->distance,
-        outgoing, NETJSON_EDGE_LAN, NULL);
-    }
+    _print_graph_edge(&gen->json.session, gen->domain, &node_id1, &node_id2, originator, &neigh->originator,
+      nhdp_domain_get_neighbordata(gen->domain, neigh)->metric.out,
+      nhdp_domain_get_neighbordata(gen->domain, neigh)->metric.in, 0, outgoing, NETJSON_EDGE_LOCAL, neigh);
+
+    _print_graph_edge(&gen->json.session, gen->domain, &node_id2, &node_id1, &neigh->originator, originator,
+      nhdp_domain_get_neighbordata(gen->domain, neigh)->metric.in,
+      nhdp_domain_get_neighbordata(gen->domain, neigh)->metric.out, 0, false, NETJSON_EDGE_ROUTERS, NULL);
   }
+  _set_step(gen, NETJSON_STEP_LINKS_LAN);
+}
 
-  /* print remote node links to neighbors */
-  avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
-    if (netaddr_get_address_family(&node->target.prefix.dst) == af_type) {
-      _get_tc_node_id(&node_id1, node);
+/**
+ * Print the JSON edges between the local router and its
+ * locally attached networks
+ * @param gen netjson generator
+ * @param originator originator of the local node
+ */
+static void
+_print_graph_lan_links(struct netjson_generator *gen, const struct netaddr *originator) {
+  struct olsrv2_lan_entry *lan;
+  struct olsrv2_routing_entry *rt_entry;
+  struct avl_tree *rt_tree;
+  struct _node_id_str node_id1, node_id2;
+  bool outgoing;
 
-      avl_for_each_element(&node->_edges, edge, _node) {
-        if (!edge->virtual) {
-          if (netaddr_cmp(&edge->dst->target.prefix.dst, originator) == 0) {
-            /* we already have this information from NHDP */
-            continue;
-          }
+  rt_tree = olsrv2_routing_get_tree(gen->domain);
+  _get_node_id_me(&node_id1, gen->af_type);
 
-          rt_entry = avl_find_element(rt_tree, &edge->dst->target.prefix, rt_entry, _node);
-          outgoing = rt_entry != NULL && netaddr_cmp(&rt_entry->last_originator, &node->target.prefix.dst) == 0;
+  if (gen->has_key) {
+    lan = avl_find_ge_element(olsrv2_lan_get_tree(), &gen->key.route, lan, _node);
+  }
+  else {
+    lan = avl_first_element_safe(olsrv2_lan_get_tree(), lan, _node);
+  }
 
-          _get_tc_node_id(&node_id2, edge->dst);
+  for (; lan != NULL; lan = avl_next_element_safe(olsrv2_lan_get_tree(), lan, _node)) {
+    if (json_generator_is_full(&gen->json)) {
+      /* continue with this entry in the next chunk */
+      memcpy(&gen->key.route, &lan->prefix, sizeof(gen->key.route));
+      gen->has_key = true;
+      return;
+    }
 
-          _print_graph_edge(session, domain, &node_id1, &node_id2, &node->target.prefix.dst,
-            &edge->dst->target.prefix.dst, edge->cost[domain->index], edge->inverse->cost[domain->index], 0, outgoing,
-            NETJSON_EDGE_ROUTERS, NULL);
-        }
-      }
+    if (netaddr_get_address_family(&lan->prefix.dst) != gen->af_type ||
+        !olsrv2_lan_get_domaindata(gen->domain, lan)->active) {
+      continue;
     }
+
+    rt_entry = avl_find_element(rt_tree, &lan->prefix, rt_entry, _node);
+    outgoing = rt_entry == NULL;
+
+    _get_tc_lan_id(&node_id2, lan);
+
+    _print_graph_edge(&gen->json.session, gen->domain, &node_id1, &node_id2, originator, &lan->prefix.dst,
+      olsrv2_lan_get_domaindata(gen->domain, lan)->outgoing_metric, 0,
+      olsrv2_lan_get_domaindata(gen->domain, lan)->distance, outgoing, NETJSON_EDGE_LAN, NULL);
   }
+  _set_step(gen, NETJSON_STEP_LINKS_TC);
+}
 
-  /* print remote nodes neighbors */
-  avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
-    if (netaddr_get_address_family(&node->target.prefix.dst) == af_type) {
-      _get_tc_node_id(&node_id1, node);
+/**
+ * Print the JSON edges between remote routers
+ * @param gen netjson generator
+ * @param originator originator of the local node
+ */
+static void
+_print_graph_tc_links(struct netjson_generator *gen, const struct netaddr *originator) {
+  struct olsrv2_tc_node *node;
+  struct olsrv2_tc_edge *edge;
+  struct olsrv2_routing_entry *rt_entry;
+  struct avl_tree *rt_tree;
+  struct _node_id_str node_id1, node_id2;
+  bool outgoing;
 
-      avl_for_each_element(&node->_attached_networks, attached, _src_node) {
-        rt_entry = avl_find_element(rt_tree, &attached->dst->target.prefix, rt_entry, _node);
-        outgoing = rt_entry != NULL && netaddr_cmp(&rt_entry->originator, &node->target.prefix.dst) == 0;
+  rt_tree = olsrv2_routing_get_tree(gen->domain);
 
-        _get_tc_endpoint_id(&node_id2, attached);
+  if (gen->has_key) {
+    node = avl_find_ge_element(olsrv2_tc_get_tree(), &gen->key.addr, node, _originator_node);
+  }
+  else {
+    node = avl_first_element_safe(olsrv2_tc_get_tree(), node, _originator_node);
+  }
 
-        _print_graph_edge(session, domain, &node_id1, &node_id2, &node->target.prefix.dst,
-          &attached->dst->target.prefix.dst, attached->cost[domain->index], 0, attached->distance[domain->index],
-          outgoing, NETJSON_EDGE_ATTACHED, NULL);
+  for (; node != NULL; node = avl_next_element_safe(olsrv2_tc_get_tree(), node, _originator_node)) {
+    if (json_generator_is_full(&gen->json)) {
+      /* continue with this node in the next chunk */
+      memcpy(&gen->key.addr, &node->target.prefix.dst, sizeof(gen->key.addr));
+      gen->has_key = true;
+      return;
+    }
+
+    if (netaddr_get_address_family(&node->target.prefix.dst) != gen->af_type) {
+      continue;
+    }
+
+    _get_tc_node_id(&node_id1, node);
+
+    avl_for_each_element(&node->_edges, edge, _node) {
+      if (edge->virtual) {
+        continue;
+      }
+      if (netaddr_cmp(&edge->dst->target.prefix.dst, originator) == 0) {
+        /* we already have this information from NHDP */
+        continue;
       }
+
+      rt_entry = avl_find_element(rt_tree, &edge->dst->target.prefix, rt_entry, _node);
+      outgoing = rt_entry != NULL && netaddr_cmp(&rt_entry->last_originator, &node->target.prefix.dst) == 0;
+
+      _get_tc_node_id(&node_id2, edge->dst);
+
+      _print_graph_edge(&gen->json.session, gen->domain, &node_id1, &node_id2, &node->target.prefix.dst,
+        &edge->dst->target.prefix.dst, edge->cost[gen->domain->index], edge->inverse->cost[gen->domain->index], 0,
+        outgoing, NETJSON_EDGE_ROUTERS, NULL);
     }
   }
-  json_end_array(session);
-
-  json_end_object(session);
+  _set_step(gen, NETJSON_STEP_LINKS_ATTACHED);
 }
 
 /**
- * Print all JSON graph objects
- * @param session json session
- * @param filter domain filter
+ * Print the JSON edges between remote routers and their attached networks
+ * @param gen netjson generator
  */
 static void
-_create_graph_json(struct json_session *session, const char *filter) {
-  struct nhdp_domain *domain;
-  struct domain_id_str dbuf;
+_print_graph_attached_links(struct netjson_generator *gen) {
+  struct olsrv2_tc_attachment *attached;
+  struct olsrv2_tc_node *node;
+  struct olsrv2_routing_entry *rt_entry;
+  struct avl_tree *rt_tree;
+  struct _node_id_str node_id1, node_id2;
+  bool outgoing;
 
-  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
-    if (filter == NULL || strcmp(_create_domain_id(&dbuf, domain, AF_INET), filter) == 0) {
-      _print_graph(session, domain, AF_INET);
+  rt_tree = olsrv2_routing_get_tree(gen->domain);
+
+  if (gen->has_key) {
+    node = avl_find_ge_element(olsrv2_tc_get_tree(), &gen->key.addr, node, _originator_node);
+  }
+  else {
+    node = avl_first_element_safe(olsrv2_tc_get_tree(), node, _originator_node);
+  }
+
+  for (; node != NULL; node = avl_next_element_safe(olsrv2_tc_get_tree(), node, _originator_node)) {
+    if (json_generator_is_full(&gen->json)) {
+      /* continue with this node in the next chunk */
+      memcpy(&gen->key.addr, &node->target.prefix.dst, sizeof(gen->key.addr));
+      gen->has_key = true;
+      return;
     }
-    if (filter == NULL || strcmp(_create_domain_id(&dbuf, domain, AF_INET6), filter) == 0) {
-      _print_graph(session, domain, AF_INET6);
+
+    if (netaddr_get_address_family(&node->target.prefix.dst) != gen->af_type) {
+      continue;
+    }
+
+    _get_tc_node_id(&node_id1, node);
+
+    avl_for_each_element(&node->_attached_networks, attached, _src_node) {
+      rt_entry = avl_find_element(rt_tree, &attached->dst->target.prefix, rt_entry, _node);
+      outgoing = rt_entry != NULL && netaddr_cmp(&rt_entry->originator, &node->target.prefix.dst) == 0;
+
+      _get_tc_endpoint_id(&node_id2, attached);
+
+      _print_graph_edge(&gen->json.session, gen->domain, &node_id1, &node_id2, &node->target.prefix.dst,
+        &attached->dst->target.prefix.dst, attached->cost[gen->domain->index], 0,
+        attached->distance[gen->domain->index], outgoing, NETJSON_EDGE_ATTACHED, NULL);
     }
   }
+  _set_step(gen, NETJSON_STEP_END);
 }
 
 /**
- * Print the JSON routing tree
- * @param session json session
- * @param domain NHDP domain
- * @param af_type address family
+ * Print the header of a JSON routing tree object
+ * @param gen netjson generator
+ * @param originator originator of the local node
  */
 static void
-_print_routing_tree(struct json_session *session, struct nhdp_domain *domain, int af_type) {
-  struct olsrv2_routing_entry *rtentry;
-  const struct netaddr *originator;
-  char ibuf[IF_NAMESIZE];
-  struct nhdp_metric_str mbuf;
+_print_routing_start(struct netjson_generator *gen, const struct netaddr *originator) {
+  struct json_session *session;
   struct domain_id_str dbuf;
   struct _node_id_str idbuf;
 
-  originator = olsrv2_originator_get(af_type);
-  if (netaddr_get_address_family(originator) != af_type) {
-    return;
-  }
+  session = &gen->json.session;
 
   json_start_object(session, NULL);
 
@@ -783,227 +1118,383 @@ _print_routing_tree(struct json_session *session, struct nhdp_domain *domain, in
   _print_json_string(session, "version", oonf_log_get_libdata()->version);
   _print_json_string(session, "revision", oonf_log_get_libdata()->git_commit);
 
-  _get_node_id_me(&idbuf, af_type);
+  _get_node_id_me(&idbuf, gen->af_type);
   _print_json_string(session, "router_id", idbuf.buf);
-  _print_json_string(session, "metric", domain->metric->name);
-  _print_json_string(session, "topology_id", _create_domain_id(&dbuf, domain, af_type));
+  _print_json_string(session, "metric", gen->domain->metric->name);
+  _print_json_string(session, "topology_id", _create_domain_id(&dbuf, gen->domain, gen->af_type));
 
   json_start_object(session, "properties");
   _print_json_netaddr(session, "router_addr", originator);
+  _print_json_number(session, "topology_generation", gen->generation);
   json_end_object(session);
 
   json_start_array(session, JSON_NAME_ROUTE);
+}
 
-  avl_for_each_element(olsrv2_routing_get_tree(domain), rtentry, _node) {
-    if (rtentry->route.p.family == af_type) {
-      json_start_object(session, NULL);
+/**
+ * Print a JSON route
+ * @param session json session
+ * @param domain NHDP domain
+ * @param rtentry olsrv2 routing entry
+ */
+static void
+_print_routing_entry(struct json_session *session, struct nhdp_domain *domain, struct olsrv2_routing_entry *rtentry) {
+  char ibuf[IF_NAMESIZE];
+  struct nhdp_metric_str mbuf;
+  struct _node_id_str idbuf;
 
-      _print_json_netaddr(session, "destination", &rtentry->route.p.key.dst);
+  json_start_object(session, NULL);
 
-      if (netaddr_get_prefix_length(&rtentry->route.p.key.src) > 0) {
-        _print_json_netaddr(session, "source", &rtentry->route.p.key.src);
-      }
+  _print_json_netaddr(session, "destination", &rtentry->route.p.key.dst);
 
-      _get_node_id(&idbuf, &rtentry->next_originator, NULL);
-      _print_json_netaddr(session, "next", &rtentry->route.p.gw);
+  if (netaddr_get_prefix_length(&rtentry->route.p.key.src) > 0) {
+    _print_json_netaddr(session, "source", &rtentry->route.p.key.src);
+  }
 
-      _print_json_string(session, "device", if_indextoname(rtentry->route.p.if_index, ibuf));
-      _print_json_number(session, "cost", rtentry->path_cost);
-      _print_json_string(
-        session, "cost_text", nhdp_domain_get_path_metric_value(&mbuf, domain, rtentry->path_cost, rtentry->path_hops));
+  _get_node_id(&idbuf, &rtentry->next_originator, NULL);
+  _print_json_netaddr(session, "next", &rtentry->route.p.gw);
 
-      json_start_object(session, "properties");
-      if (!netaddr_is_unspec(&rtentry->originator)) {
-        _get_node_id(&idbuf, &rtentry->originator, NULL);
-        _print_json_string(session, "destination_id", idbuf.buf);
-      }
-      _print_json_string(session, "next_router_id", idbuf.buf);
-      _print_json_netaddr(session, "next_router_addr", &rtentry->next_originator);
+  _print_json_string(session, "device", if_indextoname(rtentry->route.p.if_index, ibuf));
+  _print_json_number(session, "cost", rtentry->path_cost);
+  _print_json_string(
+    session, "cost_text", nhdp_domain_get_path_metric_value(&mbuf, domain, rtentry->path_cost, rtentry->path_hops));
 
-      _print_json_number(session, "hops", rtentry->path_hops);
+  json_start_object(session, "properties");
+  if (!netaddr_is_unspec(&rtentry->originator)) {
+    _get_node_id(&idbuf, &rtentry->originator, NULL);
+    _print_json_string(session, "destination_id", idbuf.buf);
+  }
+  _print_json_string(session, "next_router_id", idbuf.buf);
+  _print_json_netaddr(session, "next_router_addr", &rtentry->next_originator);
 
-      _get_node_id(&idbuf, &rtentry->last_originator, NULL);
-      _print_json_string(session, "last_router_id", idbuf.buf);
-      _print_json_netaddr(session, "last_router_addr", &rtentry->last_originator);
-      json_end_object(session);
+  _print_json_number(session, "hops", rtentry->path_hops);
 
-      json_end_object(session);
-    }
-  }
+  _get_node_id(&idbuf, &rtentry->last_originator, NULL);
+  _print_json_string(session, "last_router_id", idbuf.buf);
+  _print_json_netaddr(session, "last_router_addr", &rtentry->last_originator);
+  json_end_object(session);
 
-  json_end_array(session);
   json_end_object(session);
 }
 
 /**
- * Print all JSON routes
- * @param session json session
- * @param filter filter value to select domain
+ * Print the JSON routes of the routing tree
+ * @param gen netjson generator
  */
 static void
-_create_route_json(struct json_session *session, const char *filter) {
-  struct nhdp_domain *domain;
-  struct domain_id_str dbuf;
+_print_routing_entries(struct netjson_generator *gen) {
+  struct olsrv2_routing_entry *rtentry;
+  struct avl_tree *rt_tree;
 
-  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
-    if (filter == NULL || strcmp(_create_domain_id(&dbuf, domain, AF_INET), filter) == 0) {
-      _print_routing_tree(session, domain, AF_INET);
+  rt_tree = olsrv2_routing_get_tree(gen->domain);
+
+  if (gen->has_key) {
+    rtentry = avl_find_ge_element(rt_tree, &gen->key.route, rtentry, _node);
+  }
+  else {
+    rtentry = avl_first_element_safe(rt_tree, rtentry, _node);
+  }
+
+  for (; rtentry != NULL; rtentry = avl_next_element_safe(rt_tree, rtentry, _node)) {
+    if (json_generator_is_full(&gen->json)) {
+      /* continue with this route in the next chunk */
+      memcpy(&gen->key.route, &rtentry->route.p.key, sizeof(gen->key.route));
+      gen->has_key = true;
+      return;
     }
-    if (filter == NULL || strcmp(_create_domain_id(&dbuf, domain, AF_INET6), filter) == 0) {
-      _print_routing_tree(session, domain, AF_INET6);
+
+    if (rtentry->route.p.family == gen->af_type) {
+      _print_routing_entry(&gen->json.session, gen->domain, rtentry);
     }
   }
+  _set_step(gen, NETJSON_STEP_END);
 }
 
+/**
+ * Print the next part of the current JSON graph or routing tree object
+ * @param gen netjson generator
+ */
 static void
-_create_domain_json(struct json_session *session) {
-  const struct netaddr *originator_v4, *originator_v6;
-  struct nhdp_domain *domain;
-  struct domain_id_str dbuf;
-
-  originator_v4 = olsrv2_originator_get(AF_INET);
-  originator_v6 = olsrv2_originator_get(AF_INET6);
-
-  json_start_object(session, NULL);
-
-  _print_json_string(session, "type", "NetworkDomain");
-  _print_json_string(session, "protocol", "olsrv2");
-  _print_json_string(session, "version", oonf_log_get_libdata()->version);
-  _print_json_string(session, "revision", oonf_log_get_libdata()->git_commit);
+_print_object_step(struct netjson_generator *gen) {
+  const struct netaddr *originator;
 
-  json_start_array(session, JSON_NAME_DOMAIN);
+  originator = olsrv2_originator_get(gen->af_type);
 
-  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
-    if (!netaddr_is_unspec(originator_v4)) {
-      json_start_object(session, NULL);
+  switch (gen->step) {
+    case NETJSON_STEP_START:
+      gen->generation = olsrv2_routing_get_topology_generation();
+      if (gen->type == NETJSON_OBJECT_GRAPH) {
+        if (netaddr_is_unspec(originator)) {
+          _set_step(gen, NETJSON_STEP_NONE);
+          return;
+        }
+        _print_graph_start(gen, originator);
+        _set_step(gen, NETJSON_STEP_NODES_LAN);
+      }
+      else {
+        if (netaddr_get_address_family(originator) != gen->af_type) {
+          _set_step(gen, NETJSON_STEP_NONE);
+          return;
+        }
+        _print_routing_start(gen, originator);
+        _set_step(gen, NETJSON_STEP_ROUTES);
+      }
+      break;
+    case NETJSON_STEP_NODES_LAN:
+      _print_graph_lan_nodes(gen);
+      break;
+    case NETJSON_STEP_NODES_TC:
+      _print_graph_tc_nodes(gen, originator);
+      break;
+    case NETJSON_STEP_LINKS_NEIGH:
+      _print_graph_neighbor_links(gen, originator);
+      break;
+    case NETJSON_STEP_LINKS_LAN:
+      _print_graph_lan_links(gen, originator);
+      break;
+    case NETJSON_STEP_LINKS_TC:
+      _print_graph_tc_links(gen, originator);
+      break;
+    case NETJSON_STEP_LINKS_ATTACHED:
+      _print_graph_attached_links(gen);
+      break;
+    case NETJSON_STEP_ROUTES:
+      _print_routing_entries(gen);
+      break;
+    case NETJSON_STEP_END:
+      json_end_array(&gen->json.session);
+
+      /* tell the client if the topology changed while the object was generated */
+      json_print(&gen->json.session, "snapshot_consistent", false,
+        json_getbool(gen->generation == olsrv2_routing_get_topology_generation()));
+      json_end_object(&gen->json.session);
+      _set_step(gen, NETJSON_STEP_NONE);
+      break;
+    default:
+      _set_step(gen, NETJSON_STEP_NONE);
+      break;
+  }
+}
 
-      _print_json_string(session, "id", _create_domain_id(&dbuf, domain, AF_INET));
-      _print_json_number(session, "number", domain->ext);
-      _print_json_netaddr(session, "router_id", originator_v4);
-      _print_json_string(session, "metric", domain->metric->name);
-      _print_json_string(session, "mpr", domain->mpr->name);
+/**
+ * Select the next domain/address family combination for the current
+ * sub-command that matches the domain filter
+ * @param gen netjson generator
+ * @return true if a domain was selected, false if all domains are done
+ */
+static bool
+_select_next_domain(struct netjson_generator *gen) {
+  struct domain_id_str dbuf;
 
-      json_end_object(session);
+  do {
+    if (gen->domain == NULL) {
+      if (list_is_empty(nhdp_domain_get_list())) {
+        return false;
+      }
+      gen->domain = list_first_element(nhdp_domain_get_list(), gen->domain, _node);
+      gen->af_type = AF_INET;
     }
-
-    if (!netaddr_is_unspec(originator_v6)) {
-      json_start_object(session, NULL);
-
-      _print_json_string(session, "id", _create_domain_id(&dbuf, domain, AF_INET6));
-      _print_json_number(session, "number", domain->ext);
-      _print_json_netaddr(session, "router_id", originator_v6);
-      _print_json_string(session, "metric", domain->metric->name);
-      _print_json_string(session, "mpr", domain->mpr->name);
-
-      json_end_object(session);
+    else if (gen->af_type == AF_INET) {
+      gen->af_type = AF_INET6;
     }
-  }
+    else if (list_is_last(nhdp_domain_get_list(), &gen->domain->_node)) {
+      return false;
+    }
+    else {
+      gen->domain = list_next_element(gen->domain, _node);
+      gen->af_type = AF_INET;
+    }
+  } while (gen->filter != NULL && strcmp(_create_domain_id(&dbuf, gen->domain, gen->af_type), gen->filter) != 0);
 
-  json_end_array(session);
-  json_end_object(session);
+  return true;
 }
 
 /**
- * Print a JSON error
- * @param session json session
- * @param message error message
- * @param parameter error parameter
+ * Parse the next sub-command of the netjsoninfo parameters
+ * @param gen netjson generator
+ * @return true if a sub-command was parsed, false if no sub-command was left
  */
-static void
-_create_error_json(struct json_session *session, const char *message, const char *parameter) {
-  json_start_object(session, NULL);
-
-  _print_json_string(session, "type", "Error");
-  _print_json_string(session, "message", message);
-  _print_json_string(session, "parameter", parameter);
+static bool
+_handle_next_subcommand(struct netjson_generator *gen) {
+  const char *ptr;
 
-  json_end_object(session);
-}
+  gen->type = NETJSON_OBJECT_NONE;
+  gen->domain = NULL;
 
-static const char *
-_handle_netjson_object(struct json_session *session, const char *parameter, bool filter, bool *error) {
-  const char *ptr;
+  if (gen->next == NULL || *gen->next == 0) {
+    return false;
+  }
 
-  if ((ptr = str_hasnextword(parameter, JSON_NAME_GRAPH))) {
-    _create_graph_json(session, filter ? ptr : NULL);
+  if ((ptr = str_hasnextword(gen->next, JSON_NAME_GRAPH))) {
+    gen->type = NETJSON_OBJECT_GRAPH;
   }
-  else if ((ptr = str_hasnextword(parameter, JSON_NAME_ROUTE))) {
-    _create_route_json(session, filter ? ptr : NULL);
+  else if ((ptr = str_hasnextword(gen->next, JSON_NAME_ROUTE))) {
+    gen->type = NETJSON_OBJECT_ROUTE;
   }
-  else if (!filter && (ptr = str_hasnextword(parameter, JSON_NAME_DOMAIN))) {
-    _create_domain_json(session);
+  else if (gen->collection && (ptr = str_hasnextword(gen->next, JSON_NAME_DOMAIN))) {
+    _create_domain_json(&gen->json.session);
   }
   else {
-    ptr = str_skipnextword(parameter);
-    *error = true;
+    ptr = str_skipnextword(gen->next);
+    gen->error = true;
   }
-  return ptr;
-}
 
-static void
-_handle_filter(struct json_session *session, const char *parameter) {
-  bool error = false;
-
-  _handle_netjson_object(session, parameter, true, &error);
-  if (error) {
-    _create_error_json(session, "Could not parse sub-command for netjsoninfo", parameter);
+  if (gen->collection) {
+    gen->next = ptr;
   }
+  else {
+    /* filter command has a single sub-command followed by the domain id */
+    gen->filter = ptr;
+    gen->next = NULL;
+  }
+  return true;
 }
 
-static void
-_handle_collection(struct json_session *session, const char *parameter) {
-  const char *next;
-  bool error;
+/**
+ * Generate the next part of the netjsoninfo output
+ * @param json json generator
+ * @return true if the output is complete, false otherwise
+ */
+static bool
+_cb_generate_netjson(struct json_generator *json) {
+  struct netjson_generator *gen;
+
+  gen = container_of(json, struct netjson_generator, json);
+
+  if (!gen->started) {
+    gen->started = true;
+    if (gen->collection) {
+      json_start_object(&json->session, NULL);
+      _print_json_string(&json->session, "type", "NetworkCollection");
+      json_start_array(&json->session, "collection");
+    }
+    return false;
+  }
 
-  json_start_object(session, NULL);
-  _print_json_string(session, "type", "NetworkCollection");
-  json_start_array(session, "collection");
+  if (gen->step != NETJSON_STEP_NONE) {
+    /* continue current object */
+    _print_object_step(gen);
+    return false;
+  }
 
-  error = 0;
-  next = parameter;
-  while (next && *next) {
-    next = _handle_netjson_object(session, next, false, &error);
+  if (gen->type != NETJSON_OBJECT_NONE && _select_next_domain(gen)) {
+    /* start object for next domain */
+    _set_step(gen, NETJSON_STEP_START);
+    return false;
   }
 
-  if (error) {
-    _create_error_json(session, "Could not parse sub-command for netjsoninfo", parameter);
+  if (_handle_next_subcommand(gen)) {
+    return false;
   }
 
-  json_end_array(session);
-  json_end_object(session);
+  /* all sub-commands are done */
+  if (gen->error) {
+    _create_error_json(&json->session, "Could not parse sub-command for netjsoninfo", gen->error_parameter);
+  }
+  if (gen->collection) {
+    json_end_array(&json->session);
+    json_end_object(&json->session);
+  }
+  return true;
+}
+
+/**
+ * Free a netjson generator
+ * @param gen netjson generator
+ */
+static void
+_free_generator(struct netjson_generator *gen) {
+  free(gen->parameter);
+  free(gen);
 }
 
 /**
  * Callback for netjsoninfo telnet command
  * @param con telnet connection
- * @return active or internal_error
+ * @return active, continous or internal_error
  */
 static enum oonf_telnet_result
 _cb_netjsoninfo(struct oonf_telnet_data *con) {
-  struct json_session session;
-  struct autobuf out;
-  const char *ptr, *next;
+  struct netjson_generator *gen;
+  const char *ptr;
 
-  if (abuf_init(&out)) {
+  gen = calloc(1, sizeof(*gen));
+  if (!gen) {
+    return TELNET_RESULT_INTERNAL_ERROR;
+  }
+  if (con->parameter && (gen->parameter = strdup(con->parameter)) == NULL) {
+    free(gen);
     return TELNET_RESULT_INTERNAL_ERROR;
   }
 
-  json_init_session(&session, &out);
+  /* a command which is already continuous (e.g. repeat) needs the output in one piece */
+  json_init_generator(
+    &gen->json, con->out, con->stop_handler ? SIZE_MAX : NETJSONINFO_CHUNK_SIZE, _cb_generate_netjson);
 
-  next = con->parameter;
-  if (next && *next) {
-    if ((ptr = str_hasnextword(next, JSON_NAME_FILTER))) {
-      _handle_filter(&session, ptr);
+  if (gen->parameter && *gen->parameter) {
+    if ((ptr = str_hasnextword(gen->parameter, JSON_NAME_FILTER))) {
+      gen->next = ptr;
     }
     else {
-      _handle_collection(&session, next);
+      gen->next = gen->parameter;
+      gen->collection = true;
     }
+    gen->error_parameter = gen->next;
+  }
+
+  if (json_generator_run(&gen->json)) {
+    _free_generator(gen);
+    return TELNET_RESULT_ACTIVE;
+  }
+
+  /* generate the rest of the output when the socket has sent the first chunk */
+  con->stop_handler = _cb_netjsoninfo_stop;
+  con->underrun_handler = _cb_netjsoninfo_underrun;
+  con->stop_data[0] = gen;
+  return TELNET_RESULT_CONTINOUS;
+}
+
+/**
+ * Callback for the generation number of the netjsoninfo output.
+ * The output contains no timers, so it only changes together
+ * with the topology and routing data or the NHDP links and neighbors.
+ * @param con telnet connection
+ * @return generation number
+ */
+static uint64_t
+_cb_netjsoninfo_generation(struct oonf_telnet_data *con __attribute__((unused))) {
+  /* never return 0, both generation counters start at zero */
+  return (uint64_t)olsrv2_routing_get_topology_generation() + nhdp_db_get_generation() + 1;
+}
+
+/**
+ * Callback to generate the next chunk of netjsoninfo output
+ * @param con telnet connection
+ * @return active if output is complete, continous otherwise
+ */
+static enum oonf_telnet_result
+_cb_netjsoninfo_underrun(struct oonf_telnet_data *con) {
+  struct netjson_generator *gen;
+
+  gen = con->stop_data[0];
+  if (json_generator_run(&gen->json)) {
+    return TELNET_RESULT_ACTIVE;
   }
+  return TELNET_RESULT_CONTINOUS;
+}
+
+/**
+ * Stop handler for netjsoninfo output, frees the generator state
+ * @param con telnet connection
+ */
+static void
+_cb_netjsoninfo_stop(struct oonf_telnet_data *con) {
+  struct netjson_generator *gen;
+
+  gen = con->stop_data[0];
+  con->stop_data[0] = NULL;
 
-  /* copy output into telnet buffer */
-  abuf_memcpy(con->out, abuf_getptr(&out), abuf_getlen(&out));
-  abuf_free(&out);
-  return TELNET_RESULT_ACTIVE;
+  _free_generator(gen);
 }
 
 /**
@@ -358,6 +358,22 @@ olsrv2_get_tc_validity(void) {
   return _olsrv2_config.tc_validity;
 }
 
+/**
+ * @return configured interval between two tcs, ignoring overwrites
+ */
+uint64_t
+olsrv2_get_configured_tc_interval(void) {
+  return _olsrv2_config.tc_interval;
+}
+
+/**
+ * @return configured validity of the local TCs, ignoring overwrites
+ */
+uint64_t
+olsrv2_get_configured_tc_validity(void) {
+  return _olsrv2_config.tc_validity;
+}
+
 /**
  * @param addr NHDP address to be checked
  * @return true if address should be routed, false otherwise
@@ -539,15 +555,36 @@ olsrv2_generate_tcs(bool generate) {
   }
 }
 
+/**
+ * Set or reset the TC interval. This will overwrite the configured value
+ * and reschedule a running TC generation timer.
+ * @param interval TC interval, 0 to reset to configured value
+ * @return last TC interval overwrite, 0 if configuration was used
+ */
 uint64_t
 olsrv2_set_tc_interval(uint64_t interval) {
-  uint64_t old;
+  uint64_t old, period, first;
+  int64_t due;
 
   old = _overwrite_tc_interval;
   _overwrite_tc_interval = interval;
+
+  if (old != interval && oonf_timer_is_active(&_tc_timer)) {
+    /* keep the next TC, but do not delay it more than the new interval */
+    period = olsrv2_get_tc_interval();
+    due = oonf_timer_get_due(&_tc_timer);
+
+    first = (due > 0 && (uint64_t)due < period) ? (uint64_t)due : period;
+    oonf_timer_set_ext(&_tc_timer, first, period);
+  }
   return old;
 }
 
+/**
+ * Set or reset the validity time of TCs. This will overwrite the configured value.
+ * @param interval TC validity, 0 to reset to configured value
+ * @return last TC validity overwrite, 0 if configuration was used
+ */
 uint64_t
 olsrv2_set_tc_validity(uint64_t interval) {
   uint64_t old;
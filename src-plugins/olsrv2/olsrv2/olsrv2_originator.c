@@ -73,6 +73,7 @@ static struct oonf_class _originator_entry_class = {
 static struct oonf_timer_class _originator_entry_timer = {
   .name = "OLSRV2 originator set vtime",
   .callback = _cb_originator_entry_vtime,
+  .slack = 1000,
 };
 
 /* global tree of originator set entries */
@@ -95,7 +95,7 @@ static struct olsrv2_routing_domain _domain_parameter[NHDP_MAXIMUM_DOMAINS];
 
 /* memory class for routing entries */
 static struct oonf_class _rtset_entry = {
-  .name = "Olsrv2 Routing Set Entry",
+  .name = OLSRV2_CLASS_ROUTING_ENTRY,
   .size = sizeof(struct olsrv2_routing_entry),
 };
 
@@ -120,6 +120,9 @@ static uint16_t _ansn;
 static bool _domain_changed[NHDP_MAXIMUM_DOMAINS];
 static bool _update_ansn;
 
+/* counter for changes of topology and routing data */
+static uint32_t _topology_generation;
+
 /* global datastructures for routing */
 static struct avl_tree _routing_tree[NHDP_MAXIMUM_DOMAINS];
 static struct list_entity _routing_filter_list;
@@ -224,6 +227,15 @@ olsrv2_routing_get_ansn(void) {
   return _ansn;
 }
 
+/**
+ * @return generation counter of the topology and routing data,
+ *   increases every time either of them changes
+ */
+uint32_t
+olsrv2_routing_get_topology_generation(void) {
+  return _topology_generation;
+}
+
 /**
  * Force the answer set number to increase
  * @param increment amount of increase
@@ -240,6 +252,7 @@ olsrv2_routing_force_ansn_increment(uint16_t increment) {
 void
 olsrv2_routing_trigger_update(void) {
   _trigger_dijkstra = true;
+  _topology_generation++;
   if (!oonf_timer_is_active(&_rate_limit_timer)) {
     /* trigger as soon as we hit the next time slice */
     oonf_timer_set(&_rate_limit_timer, 1);
@@ -336,6 +349,7 @@ olsrv2_routing_force_update(bool skip_wait) {
       continue;
     }
     _domain_changed[domain->index] = false;
+    _topology_generation++;
 
     /* initialize dijkstra specific fields */
     _prepare_routes(domain);
@@ -943,7 +957,8 @@ _handle_working_queue(struct nhdp_domain *domain, bool use_non_ss, bool use_ss)
  */
 static void
 _handle_nhdp_routes(struct nhdp_domain *domain) {
-  struct nhdp_neighbor_domaindata *neigh_data;
+  const struct nhdp_metric *metrics;
+  struct nhdp_neighbor **neighbors;
   struct nhdp_neighbor *neigh;
   struct nhdp_naddr *naddr;
   struct nhdp_l2hop *l2hop;
@@ -952,19 +967,28 @@ _handle_nhdp_routes(struct nhdp_domain *domain) {
   uint32_t neighcost;
   uint32_t l2hop_pathcost;
   int family;
+  size_t slot, slot_count;
   struct os_route_key ssprefix;
 
-  list_for_each_element(nhdp_db_get_neigh_list(), neigh, _global_node) {
-    family = netaddr_get_address_family(&neigh->originator);
+  /* walk the dense metric vector, only touch reachable neighbors */
+  metrics = nhdp_domain_get_neighbor_metric_vector(domain);
+  neighbors = nhdp_db_get_neigh_slots();
+  slot_count = nhdp_db_get_neigh_slot_count();
 
+  for (slot = 0; slot < slot_count; slot++) {
     /* get linkcost to neighbor */
-    neigh_data = nhdp_domain_get_neighbordata(domain, neigh);
-    neighcost = neigh_data->metric.out;
+    neighcost = metrics[slot].out;
+    if (neighcost > RFC7181_METRIC_MAX) {
+      continue;
+    }
 
-    if (neigh->symmetric == 0 || neighcost > RFC7181_METRIC_MAX) {
+    neigh = neighbors[slot];
+    if (neigh->symmetric == 0) {
       continue;
     }
 
+    family = netaddr_get_address_family(&neigh->originator);
+
     /* make sure all addresses of the neighbor are better than our direct link */
     avl_for_each_element(&neigh->_neigh_addresses, naddr, _neigh_node) {
       if (!olsrv2_is_nhdp_routable(&naddr->neigh_addr)) {
@@ -1189,9 +1213,13 @@ _cb_route_finished(struct os_route *route, int error) {
   if (rtentry->set) {
     /* route was set/updated successfully */
     OONF_INFO(LOG_OLSRV2_ROUTING, "Successfully set route %s", os_routing_to_string(&rbuf, &rtentry->route.p));
+    oonf_class_event(&_rtset_entry, rtentry, OONF_OBJECT_CHANGED);
   }
   else {
     OONF_INFO(LOG_OLSRV2_ROUTING, "Successfully removed route %s", os_routing_to_string(&rbuf, &rtentry->route.p));
+    if (!error) {
+      oonf_class_event(&_rtset_entry, rtentry, OONF_OBJECT_REMOVED);
+    }
     _remove_entry(rtentry);
   }
 }
@@ -57,6 +57,13 @@
 #include "nhdp/nhdp_db.h"
 #include "nhdp/nhdp_domain.h"
 
+/**
+ * memory class for routing entries, triggers a change event when
+ * a route was set in the kernel and a remove event when it was
+ * removed from the kernel
+ */
+#define OLSRV2_CLASS_ROUTING_ENTRY "Olsrv2 Routing Set Entry"
+
 /*! minimum time between two dijkstra calculations in milliseconds */
 enum
 {
@@ -189,6 +196,7 @@ void olsrv2_routing_cleanup(void);
 void olsrv2_routing_dijkstra_node_init(struct olsrv2_dijkstra_node *, const struct netaddr *originator);
 
 EXPORT uint16_t olsrv2_routing_get_ansn(void);
+EXPORT uint32_t olsrv2_routing_get_topology_generation(void);
 EXPORT void olsrv2_routing_force_ansn_increment(uint16_t increment);
 
 EXPORT void olsrv2_routing_set_domain_parameter(struct nhdp_domain *domain, struct olsrv2_routing_domain *parameter);
@@ -97,6 +97,7 @@ static struct oonf_class_extension _nhdp_neighbor_extension = {
 static struct oonf_timer_class _validity_info = {
   .name = "olsrv2 tc node validity",
   .callback = _cb_tc_node_timeout,
+  .slack = 1000,
 };
 
 /* global trees for tc nodes and endpoints */
@@ -72,6 +72,8 @@ static void _cleanup(void);
 
 static enum oonf_telnet_result _cb_olsrv2info(struct oonf_telnet_data *con);
 static enum oonf_telnet_result _cb_olsrv2info_help(struct oonf_telnet_data *con);
+static uint64_t _cb_olsrv2info_generation(struct oonf_telnet_data *con);
+static uint64_t _cb_get_topology_generation(void);
 
 static void _initialize_originator_values(int af_type);
 static void _initialize_old_originator_values(struct olsrv2_originator_set_entry *);
@@ -365,6 +367,7 @@ static struct oonf_viewer_template _templates[] = { {
     .data_size = ARRAYSIZE(_td_lan),
     .json_name = "lan",
     .cb_function = _cb_create_text_lan,
+    .cb_generation = _cb_get_topology_generation,
   },
   {
     .data = _td_node,
@@ -377,23 +380,27 @@ static struct oonf_viewer_template _templates[] = { {
     .data_size = ARRAYSIZE(_td_attached_net),
     .json_name = "attached_network",
     .cb_function = _cb_create_text_attached_network,
+    .cb_generation = _cb_get_topology_generation,
   },
   {
     .data = _td_edge,
     .data_size = ARRAYSIZE(_td_edge),
     .json_name = "edge",
     .cb_function = _cb_create_text_edge,
+    .cb_generation = _cb_get_topology_generation,
   },
   {
     .data = _td_route,
     .data_size = ARRAYSIZE(_td_route),
     .json_name = "route",
     .cb_function = _cb_create_text_route,
+    .cb_generation = _cb_get_topology_generation,
   } };
 
 /* telnet command of this plugin */
 static struct oonf_telnet_command _telnet_commands[] = {
-  TELNET_CMD(OONF_OLSRV2INFO_SUBSYSTEM, _cb_olsrv2info, "", .help_handler = _cb_olsrv2info_help),
+  TELNET_CMD(OONF_OLSRV2INFO_SUBSYSTEM, _cb_olsrv2info, "", .help_handler = _cb_olsrv2info_help,
+    .generation_handler = _cb_olsrv2info_generation),
 };
 
 /* plugin declaration */
@@ -438,7 +445,7 @@ _cleanup(void) {
 static enum oonf_telnet_result
 _cb_olsrv2info(struct oonf_telnet_data *con) {
   return oonf_viewer_telnet_handler(
-    con->out, &_template_storage, OONF_OLSRV2INFO_SUBSYSTEM, con->parameter, _templates, ARRAYSIZE(_templates));
+    con, &_template_storage, OONF_OLSRV2INFO_SUBSYSTEM, _templates, ARRAYSIZE(_templates));
 }
 
 /**
@@ -452,6 +459,25 @@ _cb_olsrv2info_help(struct oonf_telnet_data *con) {
     con->out, OONF_OLSRV2INFO_SUBSYSTEM, con->parameter, _templates, ARRAYSIZE(_templates));
 }
 
+/**
+ * Callback for the generation number of the output of this plugin
+ * @param con pointer to telnet session data
+ * @return generation number, 0 if output cannot be cached
+ */
+static uint64_t
+_cb_olsrv2info_generation(struct oonf_telnet_data *con) {
+  return oonf_viewer_get_generation(con->parameter, _templates, ARRAYSIZE(_templates));
+}
+
+/**
+ * @return generation number of the topology and routing output
+ */
+static uint64_t
+_cb_get_topology_generation(void) {
+  /* never return 0, the generation counter starts at zero */
+  return (uint64_t)olsrv2_routing_get_topology_generation() + 1;
+}
+
 /**
  * Initialize the value buffers for an originator entry
  * @param af_type address family of originator
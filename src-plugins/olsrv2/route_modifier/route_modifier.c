@@ -50,6 +50,7 @@
 #include "common/list.h"
 #include "common/netaddr.h"
 #include "common/netaddr_acl.h"
+#include "common/netaddr_rule_index.h"
 
 #include "core/oonf_logging.h"
 #include "core/oonf_subsystem.h"
@@ -88,6 +89,9 @@ struct _routemodifier {
   /*! filter by routing metric, 0 to ignore */
   int32_t distance;
 
+  /*! rule for the domain, prefix length and address filter */
+  struct netaddr_rule _rule;
+
   /*! tree of all configured routing filters */
   struct avl_node _node;
 };
@@ -98,6 +102,7 @@ static void _cleanup(void);
 
 static struct _routemodifier *_get_modifier(const char *name);
 static void _destroy_modifier(struct _routemodifier *);
+static void _update_index(void);
 
 static bool _cb_rt_filter(struct nhdp_domain *, struct os_route_parameter *, bool set);
 static void _cb_cfg_changed(void);
@@ -159,6 +164,9 @@ static struct olsrv2_routing_filter _dijkstra_filter = {
 /* tree of routing filters */
 static struct avl_tree _modifier_tree;
 
+/* index of routing filters, sorted like the modifier tree */
+static struct netaddr_rule_index _modifier_index;
+
 /**
  * Initialize plugin
  * @return always returns 0 (cannot fail)
@@ -166,6 +174,7 @@ static struct avl_tree _modifier_tree;
 static int
 _init(void) {
   avl_init(&_modifier_tree, avl_comp_strcasecmp, false);
+  netaddr_rule_index_init(&_modifier_index);
   oonf_class_add(&_modifier_class);
   olsrv2_routing_filter_add(&_dijkstra_filter);
   return 0;
@@ -181,6 +190,7 @@ _cleanup(void) {
   avl_for_each_element_safe(&_modifier_tree, mod, _node, mod_it) {
     _destroy_modifier(mod);
   }
+  netaddr_rule_index_clear(&_modifier_index);
 
   olsrv2_routing_filter_remove(&_dijkstra_filter);
   oonf_class_remove(&_modifier_class);
@@ -196,25 +206,15 @@ _cleanup(void) {
 static bool
 _cb_rt_filter(struct nhdp_domain *domain, struct os_route_parameter *route_param, bool set __attribute__((unused))) {
   struct _routemodifier *modifier;
+  struct netaddr_rule_iterator iter;
+  struct netaddr_rule *rule;
 #ifdef OONF_LOG_DEBUG_INFO
   struct netaddr_str nbuf;
 #endif
 
-  avl_for_each_element(&_modifier_tree, modifier, _node) {
-    /* check filter matches this domain */
-    if (domain->index != modifier->domain) {
-      continue;
-    }
-
-    /* check prefix length */
-    if (modifier->prefix_length != -1 && modifier->prefix_length != netaddr_get_prefix_length(&route_param->key.dst)) {
-      continue;
-    }
-
-    /* check if destination matches */
-    if (!netaddr_acl_check_accept(&modifier->filter, &route_param->key.dst)) {
-      continue;
-    }
+  /* the index checks domain, prefix length and destination */
+  netaddr_rule_index_for_each_match(&_modifier_index, &iter, domain->index, &route_param->key.dst, rule) {
+    modifier = container_of(rule, struct _routemodifier, _rule);
 
     /* apply modifiers */
     if (modifier->table) {
@@ -261,6 +261,8 @@ _get_modifier(const char *name) {
   mod->_node.key = mod->name;
   avl_insert(&_modifier_tree, &mod->_node);
 
+  mod->_rule.acl = &mod->filter;
+  _update_index();
   return mod;
 }
 
@@ -270,6 +272,7 @@ _get_modifier(const char *name) {
  */
 static void
 _destroy_modifier(struct _routemodifier *mod) {
+  netaddr_rule_index_remove(&_modifier_index, &mod->_rule);
   avl_remove(&_modifier_tree, &mod->_node);
   netaddr_acl_remove(&mod->filter);
   oonf_class_free(&_modifier_class, mod);
@@ -302,6 +305,28 @@ _cb_cfg_changed(void) {
     if (_modifier_section.pre == NULL) {
       _destroy_modifier(modifier);
     }
+    else {
+      /* filter might have been changed partially */
+      _update_index();
+    }
     return;
   }
+
+  _update_index();
+}
+
+/**
+ * Refill the rule index with all route modifiers, keeping
+ * the order of the modifier tree
+ */
+static void
+_update_index(void) {
+  struct _routemodifier *mod;
+
+  netaddr_rule_index_clear(&_modifier_index);
+  avl_for_each_element(&_modifier_tree, mod, _node) {
+    mod->_rule.key = mod->domain;
+    mod->_rule.prefix_length = mod->prefix_length;
+    netaddr_rule_index_add(&_modifier_index, &mod->_rule);
+  }
 }
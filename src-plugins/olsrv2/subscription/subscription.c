@@ -0,0 +1,676 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdio.h>
+
+#include "common/autobuf.h"
+#include "common/common_types.h"
+#include "common/json.h"
+#include "common/list.h"
+#include "common/netaddr.h"
+#include "common/string.h"
+
+#include "config/cfg_schema.h"
+#include "core/oonf_logging.h"
+#include "core/oonf_subsystem.h"
+#include "subsystems/oonf_class.h"
+#include "subsystems/oonf_layer2.h"
+#include "subsystems/oonf_telnet.h"
+
+#include "nhdp/nhdp_db.h"
+#include "olsrv2/olsrv2.h"
+#include "olsrv2/olsrv2_routing.h"
+#include "olsrv2/olsrv2_tc.h"
+
+#include "subscription/subscription.h"
+
+/* definitions */
+#define LOG_SUBSCRIPTION _subscription_subsystem.logging
+
+/**
+ * Topics a client can subscribe to
+ */
+enum _topic
+{
+  /*! NHDP neighbors */
+  TOPIC_NEIGHBOR,
+
+  /*! OLSRv2 topology nodes */
+  TOPIC_TC_NODE,
+
+  /*! OLSRv2 routes set in the kernel */
+  TOPIC_ROUTE,
+
+  /*! layer2 networks and neighbors */
+  TOPIC_LAYER2,
+
+  /*! number of topics */
+  TOPIC_COUNT,
+};
+
+/**
+ * subscription plugin configuration
+ */
+struct _config {
+  /*! maximum number of bytes waiting to be sent to a subscriber */
+  int32_t queue_size;
+};
+
+/**
+ * A telnet session that receives events
+ */
+struct _subscriber {
+  /*! telnet session of subscriber */
+  struct oonf_telnet_data *telnet;
+
+  /*! bitmask of subscribed topics */
+  uint32_t topics;
+
+  /*! number of events dropped because the output queue was full */
+  uint32_t dropped;
+
+  /*! hook into list of subscribers */
+  struct list_entity _node;
+};
+
+/* prototypes */
+static int _init(void);
+static void _cleanup(void);
+
+static enum oonf_telnet_result _cb_subscribe(struct oonf_telnet_data *con);
+static void _cb_subscribe_stop(struct oonf_telnet_data *con);
+static void _update_topics(void);
+
+static bool _start_event(enum _topic topic, const char *event);
+static void _publish_event(enum _topic topic);
+
+static void _neighbor_event(struct nhdp_neighbor *neigh, const char *event);
+static void _cb_neighbor_added(void *ptr);
+static void _cb_neighbor_changed(void *ptr);
+static void _cb_neighbor_removed(void *ptr);
+static void _tc_node_event(struct olsrv2_tc_node *node, const char *event);
+static void _cb_tc_node_added(void *ptr);
+static void _cb_tc_node_changed(void *ptr);
+static void _cb_tc_node_removed(void *ptr);
+static void _route_event(struct olsrv2_routing_entry *rtentry, const char *event);
+static void _cb_route_set(void *ptr);
+static void _cb_route_removed(void *ptr);
+static void _l2net_event(struct oonf_layer2_net *l2net, const char *event);
+static void _cb_l2net_added(void *ptr);
+static void _cb_l2net_changed(void *ptr);
+static void _cb_l2net_removed(void *ptr);
+static void _l2neigh_event(struct oonf_layer2_neigh *l2neigh, const char *event);
+static void _cb_l2neigh_added(void *ptr);
+static void _cb_l2neigh_changed(void *ptr);
+static void _cb_l2neigh_removed(void *ptr);
+
+static void _cb_cfg_changed(void);
+
+/* names of the topics, used as telnet parameters and in the output */
+static const char *_topic_names[TOPIC_COUNT] = {
+  [TOPIC_NEIGHBOR] = "neighbor",
+  [TOPIC_TC_NODE] = "tc_node",
+  [TOPIC_ROUTE] = "route",
+  [TOPIC_LAYER2] = "layer2",
+};
+
+/* names of the events */
+static const char EVENT_ADD[] = "add";
+static const char EVENT_CHANGE[] = "change";
+static const char EVENT_REMOVE[] = "remove";
+
+/* configuration options */
+static struct cfg_schema_entry _subscription_entries[] = {
+  CFG_MAP_INT32_MINMAX(_config, queue_size, "queue_size", "65536",
+    "Maximum number of bytes waiting to be sent to a subscriber, further events are dropped"
+    " until the subscriber has received the queued data",
+    0, 1024, INT32_MAX),
+};
+
+static struct cfg_schema_section _subscription_section = {
+  .type = OONF_SUBSCRIPTION_SUBSYSTEM,
+  .cb_delta_handler = _cb_cfg_changed,
+  .entries = _subscription_entries,
+  .entry_count = ARRAYSIZE(_subscription_entries),
+};
+
+static struct _config _subscription_config;
+
+/* telnet command of this plugin */
+static struct oonf_telnet_command _telnet_commands[] = {
+  TELNET_CMD("subscribe", _cb_subscribe,
+    "subscribe [<topic> ...]: Prints a JSON object for each change of the subscribed topics until"
+    " the next input. Topics are 'neighbor', 'tc_node', 'route' and 'layer2', all topics are"
+    " subscribed if none is given. A {\"dropped\":<n>} object reports events that were dropped"
+    " because the client did not read its output fast enough.\n"),
+};
+
+/* plugin declaration */
+static const char *_dependencies[] = {
+  OONF_CLASS_SUBSYSTEM,
+  OONF_LAYER2_SUBSYSTEM,
+  OONF_TELNET_SUBSYSTEM,
+  OONF_NHDP_SUBSYSTEM,
+  OONF_OLSRV2_SUBSYSTEM,
+};
+static struct oonf_subsystem _subscription_subsystem = {
+  .name = OONF_SUBSCRIPTION_SUBSYSTEM,
+  .dependencies = _dependencies,
+  .dependencies_count = ARRAYSIZE(_dependencies),
+  .descr = "OLSRv2 topology and route change subscription plugin",
+
+  .cfg_section = &_subscription_section,
+
+  .init = _init,
+  .cleanup = _cleanup,
+};
+DECLARE_OONF_PLUGIN(_subscription_subsystem);
+
+/* listeners for the database changes */
+static struct oonf_class_extension _listeners[] = {
+  {
+    .ext_name = OONF_SUBSCRIPTION_SUBSYSTEM,
+    .class_name = NHDP_CLASS_NEIGHBOR,
+    .cb_add = _cb_neighbor_added,
+    .cb_change = _cb_neighbor_changed,
+    .cb_remove = _cb_neighbor_removed,
+  },
+  {
+    .ext_name = OONF_SUBSCRIPTION_SUBSYSTEM,
+    .class_name = OLSRV2_CLASS_TC_NODE,
+    .cb_add = _cb_tc_node_added,
+    .cb_change = _cb_tc_node_changed,
+    .cb_remove = _cb_tc_node_removed,
+  },
+  {
+    .ext_name = OONF_SUBSCRIPTION_SUBSYSTEM,
+    .class_name = OLSRV2_CLASS_ROUTING_ENTRY,
+    .cb_change = _cb_route_set,
+    .cb_remove = _cb_route_removed,
+  },
+  {
+    .ext_name = OONF_SUBSCRIPTION_SUBSYSTEM,
+    .class_name = LAYER2_CLASS_NETWORK,
+    .cb_add = _cb_l2net_added,
+    .cb_change = _cb_l2net_changed,
+    .cb_remove = _cb_l2net_removed,
+  },
+  {
+    .ext_name = OONF_SUBSCRIPTION_SUBSYSTEM,
+    .class_name = LAYER2_CLASS_NEIGHBOR,
+    .cb_add = _cb_l2neigh_added,
+    .cb_change = _cb_l2neigh_changed,
+    .cb_remove = _cb_l2neigh_removed,
+  },
+};
+
+/* memory class for subscribers */
+static struct oonf_class _subscriber_class = {
+  .name = "subscriber",
+  .size = sizeof(struct _subscriber),
+};
+
+/* list of subscribers */
+static struct list_entity _subscriber_list;
+
+/* bitmask of topics with at least one subscriber */
+static uint32_t _active_topics;
+
+/* buffer for the event that is sent to the subscribers */
+static struct autobuf _event_buf;
+static struct json_session _event_json;
+
+/**
+ * Initialize plugin
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_init(void) {
+  size_t i;
+
+  if (abuf_init(&_event_buf)) {
+    return -1;
+  }
+
+  oonf_class_add(&_subscriber_class);
+  list_init_head(&_subscriber_list);
+
+  for (i = 0; i < ARRAYSIZE(_listeners); i++) {
+    oonf_class_extension_add(&_listeners[i]);
+  }
+  oonf_telnet_add(&_telnet_commands[0]);
+  return 0;
+}
+
+/**
+ * Cleanup plugin
+ */
+static void
+_cleanup(void) {
+  struct _subscriber *sub, *sub_it;
+  size_t i;
+
+  list_for_each_element_safe(&_subscriber_list, sub, _node, sub_it) {
+    oonf_telnet_stop(sub->telnet, false);
+  }
+
+  oonf_telnet_remove(&_telnet_commands[0]);
+  for (i = 0; i < ARRAYSIZE(_listeners); i++) {
+    oonf_class_extension_remove(&_listeners[i]);
+  }
+
+  oonf_class_remove(&_subscriber_class);
+  abuf_free(&_event_buf);
+}
+
+/**
+ * Callback for the subscribe telnet command
+ * @param con pointer to telnet session data
+ * @return telnet result value
+ */
+static enum oonf_telnet_result
+_cb_subscribe(struct oonf_telnet_data *con) {
+  struct _subscriber *sub;
+  char buffer[32];
+  const char *next;
+  uint32_t topics;
+  size_t i;
+
+  if (con->stop_handler) {
+    abuf_puts(con->out, "Error, you cannot stack continous output commands\n");
+    return TELNET_RESULT_ACTIVE;
+  }
+
+  topics = 0;
+  next = con->parameter;
+  while (next && *next) {
+    next = str_cpynextword(buffer, next, sizeof(buffer));
+
+    for (i = 0; i < TOPIC_COUNT; i++) {
+      if (strcasecmp(buffer, _topic_names[i]) == 0) {
+        topics |= 1u << i;
+        break;
+      }
+    }
+    if (i == TOPIC_COUNT) {
+      abuf_appendf(con->out, "Unknown topic: %s\n", buffer);
+      return TELNET_RESULT_ACTIVE;
+    }
+  }
+  if (topics == 0) {
+    topics = (1u << TOPIC_COUNT) - 1;
+  }
+
+  sub = oonf_class_malloc(&_subscriber_class);
+  if (sub == NULL) {
+    return TELNET_RESULT_INTERNAL_ERROR;
+  }
+
+  sub->telnet = con;
+  sub->topics = topics;
+  list_add_tail(&_subscriber_list, &sub->_node);
+  _update_topics();
+
+  con->stop_handler = _cb_subscribe_stop;
+  con->stop_data[0] = sub;
+
+  OONF_DEBUG(LOG_SUBSCRIPTION, "New subscriber for topics 0x%x", topics);
+  return TELNET_RESULT_CONTINOUS;
+}
+
+/**
+ * Stop handler for a subscription, called when the telnet
+ * session receives new input or is closed
+ * @param con pointer to telnet session data
+ */
+static void
+_cb_subscribe_stop(struct oonf_telnet_data *con) {
+  struct _subscriber *sub;
+
+  sub = con->stop_data[0];
+
+  list_remove(&sub->_node);
+  oonf_class_free(&_subscriber_class, sub);
+  _update_topics();
+
+  con->stop_handler = NULL;
+  con->stop_data[0] = NULL;
+}
+
+/**
+ * Recalculate the bitmask of topics with at least one subscriber
+ */
+static void
+_update_topics(void) {
+  struct _subscriber *sub;
+
+  _active_topics = 0;
+  list_for_each_element(&_subscriber_list, sub, _node) {
+    _active_topics |= sub->topics;
+  }
+}
+
+/**
+ * Start a new event in the event buffer
+ * @param topic topic of event
+ * @param event type of event
+ * @return true if the event has subscribers, false otherwise
+ */
+static bool
+_start_event(enum _topic topic, const char *event) {
+  if ((_active_topics & (1u << topic)) == 0) {
+    return false;
+  }
+
+  abuf_clear(&_event_buf);
+  json_init_session(&_event_json, &_event_buf);
+
+  json_start_object(&_event_json, NULL);
+  json_print(&_event_json, "topic", true, _topic_names[topic]);
+  json_print(&_event_json, "event", true, event);
+  return true;
+}
+
+/**
+ * Finish the event in the event buffer and send it to all subscribers
+ * of its topic. Subscribers whose output queue is full do not get the
+ * event, they get the number of dropped events together with the next
+ * event that fits into their queue.
+ * @param topic topic of event
+ */
+static void
+_publish_event(enum _topic topic) {
+  struct _subscriber *sub;
+  size_t len;
+
+  json_end_object(&_event_json);
+  abuf_puts(&_event_buf, "\n");
+  if (abuf_has_failed(&_event_buf)) {
+    OONF_WARN(LOG_SUBSCRIPTION, "Out of memory for subscription event");
+    return;
+  }
+
+  len = abuf_getlen(&_event_buf);
+  list_for_each_element(&_subscriber_list, sub, _node) {
+    if ((sub->topics & (1u << topic)) == 0) {
+      continue;
+    }
+
+    if (oonf_telnet_get_output_length(sub->telnet) + len > (size_t)_subscription_config.queue_size) {
+      sub->dropped++;
+      continue;
+    }
+
+    if (sub->dropped) {
+      abuf_appendf(sub->telnet->out, "{\"dropped\":%u}\n", sub->dropped);
+      OONF_INFO(LOG_SUBSCRIPTION, "Dropped %u events for slow subscriber", sub->dropped);
+      sub->dropped = 0;
+    }
+    abuf_memcpy(sub->telnet->out, abuf_getptr(&_event_buf), len);
+    oonf_telnet_flush_session(sub->telnet);
+  }
+}
+
+/**
+ * Generate an event for a NHDP neighbor
+ * @param neigh NHDP neighbor
+ * @param event type of event
+ */
+static void
+_neighbor_event(struct nhdp_neighbor *neigh, const char *event) {
+  struct netaddr_str nbuf;
+
+  if (_start_event(TOPIC_NEIGHBOR, event)) {
+    json_print(&_event_json, "originator", true, netaddr_to_string(&nbuf, &neigh->originator));
+    json_print(&_event_json, "symmetric", false, json_getbool(neigh->symmetric > 0));
+    _publish_event(TOPIC_NEIGHBOR);
+  }
+}
+
+/**
+ * Callback for new NHDP neighbors
+ * @param ptr NHDP neighbor
+ */
+static void
+_cb_neighbor_added(void *ptr) {
+  _neighbor_event(ptr, EVENT_ADD);
+}
+
+/**
+ * Callback for changed NHDP neighbors
+ * @param ptr NHDP neighbor
+ */
+static void
+_cb_neighbor_changed(void *ptr) {
+  _neighbor_event(ptr, EVENT_CHANGE);
+}
+
+/**
+ * Callback for removed NHDP neighbors
+ * @param ptr NHDP neighbor
+ */
+static void
+_cb_neighbor_removed(void *ptr) {
+  _neighbor_event(ptr, EVENT_REMOVE);
+}
+
+/**
+ * Generate an event for an OLSRv2 topology node
+ * @param node topology node
+ * @param event type of event
+ */
+static void
+_tc_node_event(struct olsrv2_tc_node *node, const char *event) {
+  struct netaddr_str nbuf;
+
+  if (_start_event(TOPIC_TC_NODE, event)) {
+    json_print(&_event_json, "originator", true, netaddr_to_string(&nbuf, &node->target.prefix.dst));
+    _publish_event(TOPIC_TC_NODE);
+  }
+}
+
+/**
+ * Callback for new OLSRv2 topology nodes
+ * @param ptr topology node
+ */
+static void
+_cb_tc_node_added(void *ptr) {
+  _tc_node_event(ptr, EVENT_ADD);
+}
+
+/**
+ * Callback for changed OLSRv2 topology nodes
+ * @param ptr topology node
+ */
+static void
+_cb_tc_node_changed(void *ptr) {
+  _tc_node_event(ptr, EVENT_CHANGE);
+}
+
+/**
+ * Callback for removed OLSRv2 topology nodes
+ * @param ptr topology node
+ */
+static void
+_cb_tc_node_removed(void *ptr) {
+  _tc_node_event(ptr, EVENT_REMOVE);
+}
+
+/**
+ * Generate an event for an OLSRv2 route
+ * @param rtentry routing entry
+ * @param event type of event
+ */
+static void
+_route_event(struct olsrv2_routing_entry *rtentry, const char *event) {
+  struct netaddr_str nbuf;
+  char value[16];
+
+  if (_start_event(TOPIC_ROUTE, event)) {
+    snprintf(value, sizeof(value), "%d", rtentry->domain->ext);
+    json_print(&_event_json, "domain", false, value);
+    json_print(&_event_json, "destination", true, netaddr_to_string(&nbuf, &rtentry->route.p.key.dst));
+    json_print(&_event_json, "source", true, netaddr_to_string(&nbuf, &rtentry->route.p.key.src));
+    json_print(&_event_json, "gateway", true, netaddr_to_string(&nbuf, &rtentry->route.p.gw));
+    snprintf(value, sizeof(value), "%u", rtentry->path_cost);
+    json_print(&_event_json, "cost", false, value);
+    snprintf(value, sizeof(value), "%u", rtentry->path_hops);
+    json_print(&_event_json, "hops", false, value);
+    _publish_event(TOPIC_ROUTE);
+  }
+}
+
+/**
+ * Callback for routes that were set in the kernel
+ * @param ptr routing entry
+ */
+static void
+_cb_route_set(void *ptr) {
+  _route_event(ptr, EVENT_CHANGE);
+}
+
+/**
+ * Callback for routes that were removed from the kernel
+ * @param ptr routing entry
+ */
+static void
+_cb_route_removed(void *ptr) {
+  _route_event(ptr, EVENT_REMOVE);
+}
+
+/**
+ * Generate an event for a layer2 network
+ * @param l2net layer2 network
+ * @param event type of event
+ */
+static void
+_l2net_event(struct oonf_layer2_net *l2net, const char *event) {
+  if (_start_event(TOPIC_LAYER2, event)) {
+    json_print(&_event_json, "interface", true, l2net->name);
+    _publish_event(TOPIC_LAYER2);
+  }
+}
+
+/**
+ * Callback for new layer2 networks
+ * @param ptr layer2 network
+ */
+static void
+_cb_l2net_added(void *ptr) {
+  _l2net_event(ptr, EVENT_ADD);
+}
+
+/**
+ * Callback for changed layer2 networks
+ * @param ptr layer2 network
+ */
+static void
+_cb_l2net_changed(void *ptr) {
+  _l2net_event(ptr, EVENT_CHANGE);
+}
+
+/**
+ * Callback for removed layer2 networks
+ * @param ptr layer2 network
+ */
+static void
+_cb_l2net_removed(void *ptr) {
+  _l2net_event(ptr, EVENT_REMOVE);
+}
+
+/**
+ * Generate an event for a layer2 neighbor
+ * @param l2neigh layer2 neighbor
+ * @param event type of event
+ */
+static void
+_l2neigh_event(struct oonf_layer2_neigh *l2neigh, const char *event) {
+  struct netaddr_str nbuf;
+
+  if (_start_event(TOPIC_LAYER2, event)) {
+    json_print(&_event_json, "interface", true, l2neigh->network->name);
+    json_print(&_event_json, "neighbor", true, netaddr_to_string(&nbuf, &l2neigh->addr));
+    _publish_event(TOPIC_LAYER2);
+  }
+}
+
+/**
+ * Callback for new layer2 neighbors
+ * @param ptr layer2 neighbor
+ */
+static void
+_cb_l2neigh_added(void *ptr) {
+  _l2neigh_event(ptr, EVENT_ADD);
+}
+
+/**
+ * Callback for changed layer2 neighbors
+ * @param ptr layer2 neighbor
+ */
+static void
+_cb_l2neigh_changed(void *ptr) {
+  _l2neigh_event(ptr, EVENT_CHANGE);
+}
+
+/**
+ * Callback for removed layer2 neighbors
+ * @param ptr layer2 neighbor
+ */
+static void
+_cb_l2neigh_removed(void *ptr) {
+  _l2neigh_event(ptr, EVENT_REMOVE);
+}
+
+/**
+ * Callback triggered when configuration changes
+ */
+static void
+_cb_cfg_changed(void) {
+  if (cfg_schema_tobin(
+        &_subscription_config, _subscription_section.post, _subscription_entries, ARRAYSIZE(_subscription_entries))) {
+    OONF_WARN(LOG_SUBSCRIPTION, "Could not convert " OONF_SUBSCRIPTION_SUBSYSTEM " plugin configuration");
+    return;
+  }
+}
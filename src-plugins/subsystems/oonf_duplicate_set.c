@@ -71,6 +71,7 @@ static void _remove_duplicate_entry(struct oonf_duplicate_entry *entry);
 static struct oonf_timer_class _vtime_info = {
   .name = "Valdity time for duplicate set",
   .callback = _cb_vtime,
+  .slack = 1000,
 };
 
 static struct oonf_class _dupset_class = {
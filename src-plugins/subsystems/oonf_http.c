@@ -43,14 +43,17 @@
  * @file
  */
 
+#include <ctype.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <time.h>
 
 #include "common/avl.h"
 #include "common/avl_comp.h"
 #include "common/common_types.h"
+#include "common/list.h"
 #include "common/netaddr.h"
 #include "common/netaddr_acl.h"
 
@@ -61,6 +64,7 @@
 #include "core/oonf_logging.h"
 #include "core/oonf_subsystem.h"
 #include "core/os_core.h"
+#include "subsystems/oonf_class.h"
 #include "subsystems/oonf_stream_socket.h"
 #include "subsystems/oonf_telnet.h"
 
@@ -86,7 +90,79 @@ struct _http_config {
 
   /*! internal variable with file descriptor to webserver directory */
   int www_dir_fd;
+
+  /*! true if clients can send multiple requests through one connection */
+  bool keepalive;
+
+  /*! maximum number of cached telnet command results */
+  int32_t cache_entries;
+};
+
+/**
+ * HTTP connection, keeps the state of the request parser
+ * between two reads
+ */
+struct _http_connection {
+  /*! stream session of connection */
+  struct oonf_stream_session stream;
+
+  /*! number of input bytes already searched for the end of the request header */
+  size_t header_scanned;
+
+  /*! length of request header including the empty line, 0 if not complete */
+  size_t header_length;
+
+  /*! length of request body */
+  size_t content_length;
+
+  /*! error found in the request header, 0 if none */
+  enum oonf_http_result header_error;
+
+  /*! callback for the next chunk of the current response, NULL if no chunked transfer is running */
+  bool (*chunk_handler)(struct autobuf *out, void *data);
+
+  /*! callback to free the custom data of the chunked transfer */
+  void (*chunk_cleanup)(void *data);
+
+  /*! custom data of the chunked transfer */
+  void *chunk_data;
+};
+
+/**
+ * Telnet command of a http to telnet bridge request whose
+ * output is sent with chunked transfer encoding
+ */
+struct _http_telnet_transfer {
+  /*! telnet session object of the running command */
+  struct oonf_telnet_session telnet;
+
+  /*! copy of the telnet command name */
+  char command[OONF_HTTP_MAX_URI_LENGTH];
+
+  /*! copy of the telnet command parameters */
+  char parameter[OONF_HTTP_MAX_URI_LENGTH];
 };
+
+/**
+ * Cached output of a http to telnet bridge request
+ */
+struct _http_cache_entry {
+  /*! decoded telnet command part of the request URI */
+  char commands[OONF_HTTP_MAX_URI_LENGTH];
+
+  /*! sum of the generation numbers of all commands when the output was created */
+  uint64_t generation;
+
+  /*! output of the telnet commands */
+  struct autobuf content;
+
+  /*! hook into tree of cache entries */
+  struct avl_node _node;
+
+  /*! hook into list of cache entries, least recently used first */
+  struct list_entity _lru;
+};
+
 /* HTTP text constants */
 static const char HTTP_VERSION_1_0[] = "HTTP/1.0";
 static const char HTTP_VERSION_1_1[] = "HTTP/1.1";
@@ -96,8 +172,17 @@ static const char HTTP_POST[] = "POST";
 
 static const char HTTP_CONTENT_LENGTH[] = "Content-Length";
 static const char HTTP_CONTENT_TYPE[] = "Content-Type";
+static const char HTTP_CONNECTION[] = "Connection";
+static const char HTTP_IF_NONE_MATCH[] = "If-None-Match";
+static const char HTTP_TRANSFER_ENCODING[] = "Transfer-Encoding";
+
+static const char HTTP_CONNECTION_CLOSE[] = "close";
+static const char HTTP_CONNECTION_KEEPALIVE[] = "keep-alive";
+
+static const char HTTP_TRANSFER_ENCODING_CHUNKED[] = "chunked";
 
 static const char HTTP_RESPONSE_200[] = "OK";
+static const char HTTP_RESPONSE_304[] = "Not Modified";
 static const char HTTP_RESPONSE_400[] = "Bad Request";
 static const char HTTP_RESPONSE_401[] = "Unauthorized";
 static const char HTTP_RESPONSE_403[] = "Forbidden";
@@ -119,17 +204,39 @@ static void _cb_config_changed(void);
 static enum oonf_stream_session_state _cb_receive_data(struct oonf_stream_session *session);
 static void _cb_create_error(struct oonf_stream_session *session, enum oonf_stream_errors error);
 static void _cb_cleanup_session(struct oonf_stream_session *);
-
+static enum oonf_stream_session_state _cb_buffer_underrun(struct oonf_stream_session *session);
+static void _stop_chunked_transfer(struct _http_connection *con);
+
+static bool _find_request(struct _http_connection *con);
+static enum oonf_http_result _get_content_length(size_t *length, const char *header, size_t header_len);
+static enum oonf_stream_session_state _handle_request(
+  struct oonf_stream_session *session, char *request, size_t header_len);
+static bool _use_keepalive(struct oonf_http_session *header);
 static bool _auth_okay(struct oonf_http_handler *handler, struct oonf_http_session *session);
-static void _create_http_error(struct oonf_stream_session *session, enum oonf_http_result error);
+static enum oonf_stream_session_state _create_http_error(
+  struct oonf_stream_session *session, enum oonf_http_result error, bool keepalive);
 static struct oonf_http_handler *_get_site_handler(const char *uri);
 static const char *_get_headertype_string(enum oonf_http_result type);
-static void _create_http_header(
-  struct oonf_stream_session *session, enum oonf_http_result code, const char *content_type, size_t content_length);
+static enum oonf_stream_session_state _create_http_header(struct oonf_stream_session *session,
+  enum oonf_http_result code, const char *content_type, size_t content_length, const char *etag, bool keepalive,
+  bool chunked);
 static int _parse_http_header(char *header_data, size_t header_len, struct oonf_http_session *header);
 static size_t _parse_query_string(char *s, char **name, char **value, size_t count);
 static void _decode_uri(char *src);
 static enum oonf_http_result _cb_telnet_handler(struct autobuf *out, struct oonf_http_session *);
+static enum oonf_http_result _execute_telnet_commands(
+  struct autobuf *out, struct oonf_http_session *session, const char *commands);
+static enum oonf_http_result _start_telnet_transfer(
+  struct autobuf *out, struct oonf_http_session *session, const char *cmd, const char *para);
+static bool _cb_telnet_transfer_chunk(struct autobuf *out, void *data);
+static void _cb_telnet_transfer_cleanup(void *data);
+static enum oonf_http_result _get_telnet_http_result(enum oonf_telnet_result result);
+static uint64_t _get_telnet_generation(const char *commands, struct netaddr *remote);
+static void _store_cache_entry(
+  struct _http_cache_entry *entry, const char *commands, uint64_t generation, const char *content, size_t len);
+static void _remove_cache_entry(struct _http_cache_entry *entry);
+static void _trim_cache(size_t count);
+static int _avl_comp_commands(const void *k1, const void *k2);
 static enum oonf_http_result _cb_file_handler(struct autobuf *out, struct oonf_http_session *);
 
 /* configuration variables */
@@ -143,6 +250,12 @@ static struct cfg_schema_entry _http_entries[] = {
   CFG_MAP_STRING(_http_config, www_dir, "webserver", "",
     "Path to map into the /www subdirectory of the HTTP server, empty path"
     " feature will be disabled"),
+  CFG_MAP_BOOL(_http_config, keepalive, "keepalive", "true",
+    "Keep connections open after a request, allows clients to send multiple (pipelined) requests"),
+  CFG_MAP_INT32_MINMAX(_http_config, cache_entries, "cache_entries", "16",
+    "Number of telnet command results kept for answering requests while the data has not changed,"
+    " 0 disables the cache",
+    0, 0, 1024),
 };
 
 static struct cfg_schema_section _http_section = { .type = OONF_HTTP_SUBSYSTEM,
@@ -155,16 +268,46 @@ static struct cfg_schema_section _http_section = { .type = OONF_HTTP_SUBSYSTEM,
 /* tree of http sites */
 static struct avl_tree _http_site_tree;
 
+/* cache of telnet command results, tree and least recently used list */
+static struct avl_tree _cache_tree;
+static struct list_entity _cache_lru;
+
+/* memory class for cache entries */
+static struct oonf_class _cache_class = {
+  .name = "http cache",
+  .size = sizeof(struct _http_cache_entry),
+};
+
+/* memory class for telnet commands streamed with chunked transfer encoding */
+static struct oonf_class _telnet_transfer_class = {
+  .name = "http telnet transfer",
+  .size = sizeof(struct _http_telnet_transfer),
+};
+
+/* random value to make entity tags of different program runs unique */
+static uint32_t _etag_epoch;
+
+/* buffer for the entity tag of the current request */
+static char _etag[32];
+
+/* memory class for http connections */
+static struct oonf_class _connection_class = {
+  .name = "http connection",
+  .size = sizeof(struct _http_connection),
+};
+
 /* http session handling */
 static struct oonf_stream_managed _http_managed_socket = {
   .config =
     {
+      .memcookie = &_connection_class,
       .session_timeout = 120000, /* 120 seconds */
       .maximum_input_buffer = 65536,
       .allowed_sessions = 10,
       .receive_data = _cb_receive_data,
       .create_error = _cb_create_error,
       .cleanup_session = _cb_cleanup_session,
+      .buffer_underrun = _cb_buffer_underrun,
     },
 };
 
@@ -191,6 +334,7 @@ static struct oonf_http_handler _file_handler = {
 
 /* subsystem definition */
 static const char *_dependencies[] = {
+  OONF_CLASS_SUBSYSTEM,
   OONF_STREAM_SUBSYSTEM,
   OONF_TELNET_SUBSYSTEM,
 };
@@ -211,8 +355,17 @@ DECLARE_OONF_PLUGIN(_oonf_http_subsystem);
  */
 static int
 _init(void) {
+  oonf_class_add(&_connection_class);
+  oonf_class_add(&_cache_class);
+  oonf_class_add(&_telnet_transfer_class);
   oonf_stream_add_managed(&_http_managed_socket);
   avl_init(&_http_site_tree, avl_comp_strcasecmp, false);
+  avl_init(&_cache_tree, _avl_comp_commands, false);
+  list_init_head(&_cache_lru);
+
+  if (os_core_get_random(&_etag_epoch, sizeof(_etag_epoch))) {
+    _etag_epoch = (uint32_t)time(NULL);
+  }
 
   oonf_http_add(&_telnet_handler);
   oonf_http_add(&_file_handler);
@@ -235,6 +388,10 @@ _cleanup(void) {
   oonf_http_remove(&_file_handler);
   oonf_stream_remove_managed(&_http_managed_socket, true);
   oonf_stream_free_managed_config(&_config.smc);
+  _trim_cache(0);
+  oonf_class_remove(&_telnet_transfer_class);
+  oonf_class_remove(&_cache_class);
+  oonf_class_remove(&_connection_class);
 }
 
 /**
@@ -284,73 +441,232 @@ oonf_http_lookup_value(char **keys, char **values, size_t count, const char *key
 }
 
 /**
- * Callback for incoming http data
+ * Callback for incoming http data, handles all complete
+ * (pipelined) requests in the input buffer
  * @param session pointer to tcp session
  * @return state of tcp session
  */
 static enum oonf_stream_session_state
 _cb_receive_data(struct oonf_stream_session *session) {
+  struct _http_connection *con;
+  enum oonf_stream_session_state state;
+  size_t request_len;
+  char *request, next;
+
+  con = container_of(session, typeof(*con), stream);
+
+  if (con->chunk_handler) {
+    /* pipelined requests are answered after the chunked response is complete */
+    return session->state;
+  }
+
+  while (_find_request(con)) {
+    request = oonf_stream_get_input(session);
+    request_len = con->header_length + con->content_length;
+
+    /* terminate the request body, this overwrites the first byte of the next request */
+    next = request[request_len];
+    request[request_len] = 0;
+
+    state = _handle_request(session, request, con->header_length);
+
+    request[request_len] = next;
+    oonf_stream_consume_input(session, request_len);
+
+    con->header_scanned = 0;
+    con->header_length = 0;
+    con->content_length = 0;
+
+    if (state != STREAM_SESSION_ACTIVE || con->chunk_handler) {
+      return state;
+    }
+  }
+
+  if (con->header_error) {
+    return _create_http_error(session, con->header_error, false);
+  }
+
+  if (con->header_length + con->content_length > _http_managed_socket.config.maximum_input_buffer) {
+    OONF_INFO(LOG_HTTP, "Content of HTTP request is too large: %" PRINTF_SIZE_T_SPECIFIER, con->content_length);
+    return _create_http_error(session, HTTP_413_REQUEST_TOO_LARGE, false);
+  }
+
+  /* a session closed by the remote side has answered all complete requests now */
+  return session->state;
+}
+
+/**
+ * Check if the input buffer contains a complete request. Only the data
+ * received since the last call is searched for the end of the header.
+ * @param con http connection
+ * @return true if a complete request is available, false if more data
+ *   is necessary or the header_error of the connection has been set
+ */
+static bool
+_find_request(struct _http_connection *con) {
+  enum oonf_http_result result;
+  const char *input, *ptr;
+  size_t len, i;
+
+  input = oonf_stream_get_input(&con->stream);
+  len = oonf_stream_get_input_length(&con->stream);
+
+  if (con->header_length > 0) {
+    /* header already found, still waiting for the body */
+    return con->header_length + con->content_length <= len;
+  }
+
+  for (i = con->header_scanned; i < len; i++) {
+    ptr = memchr(&input[i], '\n', len - i);
+    if (ptr == NULL) {
+      i = len;
+      break;
+    }
+    i = ptr - input;
+
+    /* both "\n\n" and "\r\n\r\n" end the header */
+    if (i + 1 < len && input[i + 1] == '\n') {
+      con->header_length = i + 2;
+    }
+    else if (i + 2 < len && input[i + 1] == '\r' && input[i + 2] == '\n') {
+      con->header_length = i + 3;
+    }
+    else if (i + 2 >= len) {
+      /* look at this line end again after the next read */
+      break;
+    }
+    else {
+      continue;
+    }
+
+    result = _get_content_length(&con->content_length, input, con->header_length);
+    if (result != HTTP_200_OK) {
+      con->header_error = result;
+      return false;
+    }
+    return con->header_length + con->content_length <= len;
+  }
+
+  con->header_scanned = i;
+  return false;
+}
+
+/**
+ * Get the length of the body of a request from its header
+ * without modifying the header.
+ * @param length pointer to store length of request body,
+ *   0 if header contains no content length
+ * @param header pointer to request header
+ * @param header_len length of request header
+ * @return HTTP_200_OK if the content length is valid, HTTP_400_BAD_REQ if it is
+ *   no decimal number, HTTP_413_REQUEST_TOO_LARGE if the body does not
+ *   fit into the input buffer
+ */
+static enum oonf_http_result
+_get_content_length(size_t *length, const char *header, size_t header_len) {
+  const char *ptr, *end;
+  size_t key_len, value;
+
+  *length = 0;
+
+  key_len = sizeof(HTTP_CONTENT_LENGTH) - 1;
+  end = header + header_len;
+
+  ptr = header;
+  while ((ptr = memchr(ptr, '\n', end - ptr)) != NULL) {
+    ptr++;
+
+    if ((size_t)(end - ptr) > key_len && strncasecmp(ptr, HTTP_CONTENT_LENGTH, key_len) == 0 && ptr[key_len] == ':') {
+      break;
+    }
+  }
+  if (ptr == NULL) {
+    return HTTP_200_OK;
+  }
+
+  /* skip key and whitespace in front of the value */
+  ptr += key_len + 1;
+  while (ptr < end && (*ptr == ' ' || *ptr == '\t')) {
+    ptr++;
+  }
+
+  if (ptr == end || !isdigit((unsigned char)*ptr)) {
+    OONF_INFO(LOG_HTTP, "Content-Length of HTTP request is not a number");
+    return HTTP_400_BAD_REQ;
+  }
+
+  value = 0;
+  while (ptr < end && isdigit((unsigned char)*ptr)) {
+    value = value * 10 + (size_t)(*ptr++ - '0');
+
+    if (value > _http_managed_socket.config.maximum_input_buffer) {
+      OONF_INFO(LOG_HTTP, "Content-Length of HTTP request is larger than the input buffer");
+      return HTTP_413_REQUEST_TOO_LARGE;
+    }
+  }
+
+  /* only whitespace is allowed behind the value */
+  while (ptr < end && (*ptr == ' ' || *ptr == '\t' || *ptr == '\r')) {
+    ptr++;
+  }
+  if (ptr == end || *ptr != '\n') {
+    OONF_INFO(LOG_HTTP, "Content-Length of HTTP request has trailing characters");
+    return HTTP_400_BAD_REQ;
+  }
+
+  *length = value;
+  return HTTP_200_OK;
+}
+
+/**
+ * Handle a single complete http request
+ * @param session pointer to tcp session
+ * @param request pointer to request, will be modified by the parser
+ * @param header_len length of request header, the zero terminated
+ *   body starts directly behind it
+ * @return state of tcp session
+ */
+static enum oonf_stream_session_state
+_handle_request(struct oonf_stream_session *session, char *request, size_t header_len) {
+  struct _http_connection *con;
   struct oonf_http_session header;
   struct oonf_http_handler *handler;
   char uri[OONF_HTTP_MAX_URI_LENGTH + 1];
-  char *first_header;
+  bool keepalive;
   char *ptr;
   size_t len;
 
-  /* search for end of http header */
-  if ((first_header = strstr(abuf_getptr(&session->in), "\r\n\r\n"))) {
-    first_header += 4;
-  }
-  else if ((first_header = strstr(abuf_getptr(&session->in), "\n\n"))) {
-    first_header += 2;
-  }
-  else {
-    /* still waiting for end of http header */
-    return STREAM_SESSION_ACTIVE;
-  }
-
-  if (_parse_http_header(abuf_getptr(&session->in), abuf_getlen(&session->in), &header)) {
+  if (_parse_http_header(request, header_len, &header)) {
     OONF_INFO(LOG_HTTP, "Error, malformed HTTP header.\n");
-    _create_http_error(session, HTTP_400_BAD_REQ);
-    return STREAM_SESSION_SEND_AND_QUIT;
+    return _create_http_error(session, HTTP_400_BAD_REQ, false);
   }
 
   if (strcmp(header.http_version, HTTP_VERSION_1_0) != 0 && strcmp(header.http_version, HTTP_VERSION_1_1) != 0) {
     OONF_INFO(LOG_HTTP, "Unknown HTTP version: '%s'\n", header.http_version);
-    _create_http_error(session, HTTP_400_BAD_REQ);
-    return STREAM_SESSION_SEND_AND_QUIT;
+    return _create_http_error(session, HTTP_400_BAD_REQ, false);
   }
 
   len = strlen(header.request_uri);
   if (len >= OONF_HTTP_MAX_URI_LENGTH) {
     OONF_INFO(LOG_HTTP, "Too long URI in HTTP header: '%s'\n", header.request_uri);
-    _create_http_error(session, HTTP_400_BAD_REQ);
-    return STREAM_SESSION_SEND_AND_QUIT;
+    return _create_http_error(session, HTTP_400_BAD_REQ, false);
   }
 
   OONF_DEBUG(LOG_HTTP, "Incoming HTTP request: %s %s %s\n", header.method, header.request_uri, header.http_version);
 
+  keepalive = _use_keepalive(&header);
+
   /* make working copy of URI string */
   strscpy(uri, header.request_uri, sizeof(uri));
 
   if (strcmp(header.method, HTTP_POST) == 0) {
-    const char *content_length;
-
-    content_length =
-      oonf_http_lookup_value(header.header_name, header.header_value, header.header_count, HTTP_CONTENT_LENGTH);
-    if (!content_length) {
+    if (!oonf_http_lookup_header(&header, HTTP_CONTENT_LENGTH)) {
       OONF_INFO(LOG_HTTP, "Need 'content-length' for POST requests");
-      _create_http_error(session, HTTP_400_BAD_REQ);
-      return STREAM_SESSION_SEND_AND_QUIT;
+      return _create_http_error(session, HTTP_400_BAD_REQ, false);
     }
 
-    if (strtoul(content_length, NULL, 10) > abuf_getlen(&session->in)) {
-      /* header not complete */
-      return STREAM_SESSION_ACTIVE;
-      ;
-    }
-
-    header.param_count = _parse_query_string(first_header, header.param_name, header.param_value, OONF_HTTP_MAX_PARAMS);
+    header.param_count =
+      _parse_query_string(&request[header_len], header.param_name, header.param_value, OONF_HTTP_MAX_PARAMS);
   }
 
   /* strip the URL fragment away */
@@ -372,8 +688,7 @@ _cb_receive_data(struct oonf_stream_session *session) {
   }
   else if (strcmp(header.method, HTTP_POST) != 0) {
     OONF_INFO(LOG_HTTP, "HTTP method not implemented :'%s'", header.method);
-    _create_http_error(session, HTTP_501_NOT_IMPLEMENTED);
-    return STREAM_SESSION_SEND_AND_QUIT;
+    return _create_http_error(session, HTTP_501_NOT_IMPLEMENTED, keepalive);
   }
 
   header.decoded_request_uri = uri;
@@ -382,35 +697,42 @@ _cb_receive_data(struct oonf_stream_session *session) {
   handler = _get_site_handler(uri);
   if (handler == NULL) {
     OONF_DEBUG(LOG_HTTP, "No HTTP handler for site: %s", uri);
-    _create_http_error(session, HTTP_404_NOT_FOUND);
-    return STREAM_SESSION_SEND_AND_QUIT;
+    return _create_http_error(session, HTTP_404_NOT_FOUND, keepalive);
   }
 
   if (handler->content) {
     /* static content */
     abuf_memcpy(&session->out, handler->content, handler->content_size);
-    _create_http_header(session, HTTP_200_OK, NULL, abuf_getlen(&session->out));
+    return _create_http_header(session, HTTP_200_OK, NULL, abuf_getlen(&session->out), NULL, keepalive, false);
   }
   else {
     /* custom handler */
     enum oonf_http_result result;
     /* check acl */
     if (!netaddr_acl_check_accept(&handler->acl, &session->remote_address)) {
-      _create_http_error(session, HTTP_403_FORBIDDEN);
-      return STREAM_SESSION_SEND_AND_QUIT;
+      return _create_http_error(session, HTTP_403_FORBIDDEN, keepalive);
     }
 
     /* check if username/password is necessary */
     if (!strarray_is_empty(&handler->auth)) {
       if (!_auth_okay(handler, &header)) {
-        _create_http_error(session, HTTP_401_UNAUTHORIZED);
-        return STREAM_SESSION_SEND_AND_QUIT;
+        return _create_http_error(session, HTTP_401_UNAUTHORIZED, keepalive);
       }
     }
 
     len = abuf_getlen(&session->out);
     result = handler->content_handler(&session->out, &header);
+    if (result == HTTP_START_CHUNKED_TRANSFER && strcmp(header.http_version, HTTP_VERSION_1_1) != 0) {
+      /* only HTTP/1.1 clients understand chunks, generate the whole content now */
+      while (!abuf_has_failed(&session->out) && !header.chunk_handler(&session->out, header.chunk_data))
+        ;
+      header.chunk_cleanup(header.chunk_data);
+      result = HTTP_200_OK;
+    }
     if (abuf_has_failed(&session->out)) {
+      if (result == HTTP_START_CHUNKED_TRANSFER) {
+        header.chunk_cleanup(header.chunk_data);
+      }
       abuf_setlen(&session->out, len);
       result = HTTP_500_INTERNAL_SERVER_ERROR;
     }
@@ -420,28 +742,135 @@ _cb_receive_data(struct oonf_stream_session *session) {
       session->copy_total_size = header.transfer_length;
       session->copy_bytes_sent = 0;
 
-      _create_http_header(session, HTTP_200_OK, header.content_type, header.transfer_length);
+      /* files are only sent at the end of a session */
+      return _create_http_header(
+        session, HTTP_200_OK, header.content_type, header.transfer_length, NULL, false, false);
+    }
+    else if (result == HTTP_START_CHUNKED_TRANSFER) {
+      /* the rest of the content is generated when the output buffer runs empty */
+      con = container_of(session, typeof(*con), stream);
+      con->chunk_handler = header.chunk_handler;
+      con->chunk_cleanup = header.chunk_cleanup;
+      con->chunk_data = header.chunk_data;
+
+      return _create_http_header(
+        session, HTTP_200_OK, header.content_type, abuf_getlen(&session->out), header.etag, keepalive, true);
+    }
+    else if (result == HTTP_304_NOT_MODIFIED) {
+      /* client already has the current content */
+      return _create_http_header(session, result, header.content_type, 0, header.etag, keepalive, false);
     }
     else if (result != HTTP_200_OK) {
       /* create error message */
-      _create_http_error(session, result);
-    }
-    else {
-      _create_http_header(session, HTTP_200_OK, header.content_type, abuf_getlen(&session->out));
+      return _create_http_error(session, result, keepalive);
     }
+    return _create_http_header(
+      session, HTTP_200_OK, header.content_type, abuf_getlen(&session->out), header.etag, keepalive, false);
   }
-  return STREAM_SESSION_SEND_AND_QUIT;
 }
 
 /**
- * Close file transfer descriptor during cleanup
+ * Check if the connection should stay open after answering a request
+ * @param header parsed http request header
+ * @return true if connection should be kept open
+ */
+static bool
+_use_keepalive(struct oonf_http_session *header) {
+  const char *connection;
+
+  if (!_config.keepalive) {
+    return false;
+  }
+
+  connection = oonf_http_lookup_header(header, HTTP_CONNECTION);
+  if (strcmp(header->http_version, HTTP_VERSION_1_1) == 0) {
+    /* persistent connections are the default for HTTP/1.1 */
+    return connection == NULL || strcasecmp(connection, HTTP_CONNECTION_CLOSE) != 0;
+  }
+  return connection != NULL && strcasecmp(connection, HTTP_CONNECTION_KEEPALIVE) == 0;
+}
+
+/**
+ * Close file transfer descriptor and stop a running chunked
+ * transfer during cleanup
  * @param session stream session to be cleaned up
  */
 static void
 _cb_cleanup_session(struct oonf_stream_session *session) {
+  struct _http_connection *con;
+
+  con = container_of(session, typeof(*con), stream);
+  _stop_chunked_transfer(con);
   os_fd_close(&session->copy_fd);
 }
 
+/**
+ * Callback for an empty output buffer, sends the next chunk
+ * of a running chunked transfer. Pipelined requests are handled
+ * after the last chunk.
+ * @param session pointer to tcp session
+ * @return state of tcp session
+ */
+static enum oonf_stream_session_state
+_cb_buffer_underrun(struct oonf_stream_session *session) {
+  struct _http_connection *con;
+  char prefix[24];
+  bool done, failed;
+  size_t len;
+
+  con = container_of(session, typeof(*con), stream);
+  if (!con->chunk_handler) {
+    return session->state;
+  }
+
+  /* an empty chunk would end the response */
+  do {
+    done = con->chunk_handler(&session->out, con->chunk_data);
+    len = abuf_getlen(&session->out);
+  } while (!done && len == 0 && !abuf_has_failed(&session->out));
+
+  failed = abuf_has_failed(&session->out);
+  if (!failed && len > 0) {
+    /* the chunk size is queued in front of the chunk data */
+    snprintf(prefix, sizeof(prefix), "%zx\r\n", len);
+    failed = oonf_stream_queue_memcpy(session, prefix, strlen(prefix)) != 0;
+    abuf_puts(&session->out, "\r\n");
+  }
+  if (done) {
+    /* the last chunk has a size of zero */
+    _stop_chunked_transfer(con);
+    abuf_puts(&session->out, "0\r\n\r\n");
+  }
+
+  if (failed || abuf_has_failed(&session->out) || oonf_stream_queue_output(session) != 0) {
+    OONF_WARN(LOG_HTTP, "Out of memory for chunked HTTP response");
+    return STREAM_SESSION_CLEANUP;
+  }
+
+  if (done && session->state == STREAM_SESSION_ACTIVE && oonf_stream_get_input_length(session) > 0) {
+    return _cb_receive_data(session);
+  }
+  return session->state;
+}
+
+/**
+ * Stop a running chunked transfer and free its custom data
+ * @param con http connection
+ */
+static void
+_stop_chunked_transfer(struct _http_connection *con) {
+  void (*chunk_cleanup)(void *);
+
+  if (con->chunk_handler) {
+    chunk_cleanup = con->chunk_cleanup;
+    con->chunk_handler = NULL;
+    con->chunk_cleanup = NULL;
+
+    chunk_cleanup(con->chunk_data);
+    con->chunk_data = NULL;
+  }
+}
+
 /**
  * Check if an incoming session is authorized to view a http site.
  * @param handler pointer to site handler
@@ -478,22 +907,24 @@ _auth_okay(struct oonf_http_handler *handler, struct oonf_http_session *session)
  */
 static void
 _cb_create_error(struct oonf_stream_session *session, enum oonf_stream_errors error) {
-  _create_http_error(session, (enum oonf_http_result)error);
+  _create_http_error(session, (enum oonf_http_result)error, false);
 }
 
 /**
  * Create body and header for a HTTP error
  * @param session pointer to tcp session
  * @param error http error code
+ * @param keepalive true if connection should stay open after the error
+ * @return state of tcp session
  */
-static void
-_create_http_error(struct oonf_stream_session *session, enum oonf_http_result error) {
+static enum oonf_stream_session_state
+_create_http_error(struct oonf_stream_session *session, enum oonf_http_result error, bool keepalive) {
   abuf_clear(&session->out);
   abuf_appendf(&session->out,
     "<html><head><title>%s %s http server</title></head>"
     "<body><h1>HTTP error %d: %s</h1></body></html>",
     oonf_log_get_appdata()->app_name, oonf_log_get_libdata()->version, error, _get_headertype_string(error));
-  _create_http_header(session, error, NULL, abuf_getlen(&session->out));
+  return _create_http_header(session, error, NULL, abuf_getlen(&session->out), NULL, keepalive, false);
 }
 
 /**
@@ -546,6 +977,8 @@ _get_headertype_string(enum oonf_http_result type) {
   switch (type) {
     case HTTP_200_OK:
       return HTTP_RESPONSE_200;
+    case HTTP_304_NOT_MODIFIED:
+      return HTTP_RESPONSE_304;
     case HTTP_400_BAD_REQ:
       return HTTP_RESPONSE_400;
     case HTTP_401_UNAUTHORIZED:
@@ -568,23 +1001,30 @@ _get_headertype_string(enum oonf_http_result type) {
 }
 
 /**
- * Create a http header for an existing content and put
- * it in front of the content.
+ * Create a http header for the content in the output buffer and put
+ * it in front of the content. The content is not moved, both are
+ * queued behind the responses to previous requests.
  * @param session pointer to tcp session
  * @param code http result code
  * @param content_type explicit content type or NULL for
- * @param content_length length of content, 0 for no content length
  *   plain html
+ * @param content_length length of content
+ * @param etag entity tag of content, NULL if none
+ * @param keepalive true if connection should stay open after the response
+ * @param chunked true if the content is the first chunk of a response
+ *   with chunked transfer encoding
+ * @return state of tcp session
  */
-static void
-_create_http_header(
-  struct oonf_stream_session *session, enum oonf_http_result code, const char *content_type, size_t content_length) {
+static enum oonf_stream_session_state
+_create_http_header(struct oonf_stream_session *session, enum oonf_http_result code, const char *content_type,
+  size_t content_length, const char *etag, bool keepalive, bool chunked) {
   struct autobuf buf;
   struct timeval currtime;
+  bool failed;
 
   abuf_init(&buf);
 
-  abuf_appendf(&buf, "%s %d %s\r\n", HTTP_VERSION_1_0, code, _get_headertype_string(code));
+  abuf_appendf(&buf, "%s %d %s\r\n", HTTP_VERSION_1_1, code, _get_headertype_string(code));
 
   /* Date */
   os_core_gettimeofday(&currtime);
@@ -594,7 +1034,7 @@ _create_http_header(
   abuf_appendf(&buf, "Server: %s\r\n", oonf_log_get_libdata()->version);
 
   /* connection-type */
-  abuf_puts(&buf, "Connection: closed\r\n");
+  abuf_appendf(&buf, "%s: %s\r\n", HTTP_CONNECTION, keepalive ? HTTP_CONNECTION_KEEPALIVE : HTTP_CONNECTION_CLOSE);
 
   /* allow cross domain access */
   abuf_puts(&buf, "Access-Control-Allow-Origin: *\r\n");
@@ -605,9 +1045,17 @@ _create_http_header(
   }
   abuf_appendf(&buf, "%s: %s\r\n", HTTP_CONTENT_TYPE, content_type);
 
-  /* Content length */
-  if (content_length > 0) {
-    abuf_appendf(&buf, "Content-length: %zu\r\n", content_length);
+  /* Content length, the client needs it to find the end of the response */
+  if (chunked) {
+    abuf_appendf(&buf, "%s: %s\r\n", HTTP_TRANSFER_ENCODING, HTTP_TRANSFER_ENCODING_CHUNKED);
+  }
+  else if (code != HTTP_304_NOT_MODIFIED) {
+    abuf_appendf(&buf, "%s: %zu\r\n", HTTP_CONTENT_LENGTH, content_length);
+  }
+
+  /* Entity tag, allows the client to ask if the content has changed */
+  if (etag) {
+    abuf_appendf(&buf, "ETag: %s\r\n", etag);
   }
 
   if (code == HTTP_401_UNAUTHORIZED) {
@@ -616,17 +1064,30 @@ _create_http_header(
 
   /*
    * Cache-control
-   * No caching dynamic pages
+   * No caching dynamic pages without asking the server (e.g. with the entity tag)
    */
   abuf_puts(&buf, "Cache-Control: no-cache\r\n");
 
   /* End header */
   abuf_puts(&buf, "\r\n");
 
-  abuf_memcpy_prepend(&session->out, abuf_getptr(&buf), abuf_getlen(&buf));
   OONF_DEBUG(LOG_HTTP, "Generated Http-Header:\n%s", abuf_getptr(&buf));
 
+  if (chunked && content_length > 0) {
+    /* size of the first chunk */
+    abuf_appendf(&buf, "%zx\r\n", content_length);
+    abuf_puts(&session->out, "\r\n");
+  }
+
+  failed = abuf_has_failed(&buf) || oonf_stream_queue_memcpy(session, abuf_getptr(&buf), abuf_getlen(&buf)) != 0 ||
+           oonf_stream_queue_output(session) != 0;
   abuf_free(&buf);
+
+  if (failed) {
+    OONF_WARN(LOG_HTTP, "Out of memory for HTTP response");
+    return STREAM_SESSION_CLEANUP;
+  }
+  return keepalive ? STREAM_SESSION_ACTIVE : STREAM_SESSION_SEND_AND_QUIT;
 }
 
 /**
@@ -869,20 +1330,73 @@ _decode_uri(char *src) {
 }
 
 /**
- * Http to Telnet bridge
+ * Http to Telnet bridge. Answers requests with the cached output
+ * or a 'not modified' if the data of all commands has not changed.
  * @param out output stream
  * @param session http session
  * @return http result calculated from telnet result
  */
 static enum oonf_http_result
 _cb_telnet_handler(struct autobuf *out, struct oonf_http_session *session) {
+  struct _http_cache_entry *entry;
+  enum oonf_http_result result;
+  const char *commands, *if_none_match;
+  uint64_t generation;
+  size_t start;
+
+  session->content_type = HTTP_CONTENTTYPE_TEXT;
+  commands = &session->decoded_request_uri[sizeof(HTTP_TO_TELNET) - 1];
+
+  generation = _get_telnet_generation(commands, session->remote);
+  if (generation == 0) {
+    /* output cannot be cached */
+    return _execute_telnet_commands(out, session, commands);
+  }
+
+  snprintf(_etag, sizeof(_etag), "\"%08x-%" PRIx64 "\"", _etag_epoch, generation);
+  session->etag = _etag;
+
+  if_none_match = oonf_http_lookup_header(session, HTTP_IF_NONE_MATCH);
+  if (if_none_match != NULL && strstr(if_none_match, _etag) != NULL) {
+    OONF_DEBUG(LOG_HTTP, "Content of '%s' not modified", commands);
+    return HTTP_304_NOT_MODIFIED;
+  }
+
+  entry = avl_find_element(&_cache_tree, commands, entry, _node);
+  if (entry != NULL && entry->generation == generation) {
+    OONF_DEBUG(LOG_HTTP, "Answer '%s' from cache", commands);
+
+    list_remove(&entry->_lru);
+    list_add_tail(&_cache_lru, &entry->_lru);
+
+    abuf_memcpy(out, abuf_getptr(&entry->content), abuf_getlen(&entry->content));
+    return HTTP_200_OK;
+  }
+
+  start = abuf_getlen(out);
+  result = _execute_telnet_commands(out, session, commands);
+  if (result == HTTP_200_OK && !abuf_has_failed(out)) {
+    _store_cache_entry(entry, commands, generation, abuf_getptr(out) + start, abuf_getlen(out) - start);
+  }
+  return result;
+}
+
+/**
+ * Execute a list of telnet commands separated by '/'. The output of
+ * a continuous last command is streamed with chunked transfer encoding.
+ * @param out output stream
+ * @param session http session
+ * @param commands decoded command part of the request URI
+ * @return http result calculated from telnet result
+ */
+static enum oonf_http_result
+_execute_telnet_commands(struct autobuf *out, struct oonf_http_session *session, const char *commands) {
   static char EOL = 0;
   enum oonf_telnet_result result;
   char buffer[1024];
   char *ptr1, *ptr2, *ptr3;
 
-  session->content_type = HTTP_CONTENTTYPE_TEXT;
-  strscpy(buffer, &session->decoded_request_uri[sizeof(HTTP_TO_TELNET) - 1], sizeof(buffer));
+  strscpy(buffer, commands, sizeof(buffer));
 
   ptr1 = buffer;
   while (true) {
@@ -900,25 +1414,218 @@ _cb_telnet_handler(struct autobuf *out, struct oonf_http_session *session) {
       ptr3 = &EOL;
     }
 
+    if (!ptr2) {
+      return _start_telnet_transfer(out, session, ptr1, ptr3);
+    }
+
     result = oonf_telnet_execute(ptr1, ptr3, out, session->remote);
-    switch (result) {
-      case TELNET_RESULT_ACTIVE:
-      case TELNET_RESULT_QUIT:
-        break;
+    if (result != TELNET_RESULT_ACTIVE && result != TELNET_RESULT_QUIT) {
+      return _get_telnet_http_result(result);
+    }
+    ptr1 = ptr2 + 1;
+  }
+}
+
+/**
+ * Execute the last telnet command of a request. If the command
+ * continues its output when the buffer runs empty, the rest of
+ * the output is sent with chunked transfer encoding.
+ * @param out output stream
+ * @param session http session
+ * @param cmd name of telnet command
+ * @param para parameters of telnet command
+ * @return http result calculated from telnet result
+ */
+static enum oonf_http_result
+_start_telnet_transfer(struct autobuf *out, struct oonf_http_session *session, const char *cmd, const char *para) {
+  struct _http_telnet_transfer *transfer;
+  enum oonf_telnet_result result;
 
-      case _TELNET_RESULT_UNKNOWN_COMMAND:
-        return HTTP_404_NOT_FOUND;
+  transfer = oonf_class_malloc(&_telnet_transfer_class);
+  if (transfer == NULL) {
+    return HTTP_500_INTERNAL_SERVER_ERROR;
+  }
 
-      default:
-        return HTTP_400_BAD_REQ;
+  /* the command keeps running after the request buffer is gone */
+  strscpy(transfer->command, cmd, sizeof(transfer->command));
+  strscpy(transfer->parameter, para, sizeof(transfer->parameter));
+
+  result = oonf_telnet_execute_start(&transfer->telnet, transfer->command, transfer->parameter, out, session->remote);
+  if (result == TELNET_RESULT_CONTINOUS && transfer->telnet.data.underrun_handler) {
+    session->chunk_handler = _cb_telnet_transfer_chunk;
+    session->chunk_cleanup = _cb_telnet_transfer_cleanup;
+    session->chunk_data = transfer;
+    return HTTP_START_CHUNKED_TRANSFER;
+  }
+
+  _cb_telnet_transfer_cleanup(transfer);
+  return _get_telnet_http_result(result);
+}
+
+/**
+ * Callback to generate the next chunk of a streamed telnet command
+ * @param out output stream
+ * @param data http telnet transfer
+ * @return true if the output of the command is complete
+ */
+static bool
+_cb_telnet_transfer_chunk(struct autobuf *out, void *data) {
+  struct _http_telnet_transfer *transfer = data;
+
+  transfer->telnet.data.out = out;
+  return oonf_telnet_execute_continue(&transfer->telnet) != TELNET_RESULT_CONTINOUS;
+}
+
+/**
+ * Callback to stop a streamed telnet command and free its memory
+ * @param data http telnet transfer
+ */
+static void
+_cb_telnet_transfer_cleanup(void *data) {
+  struct _http_telnet_transfer *transfer = data;
+
+  oonf_telnet_execute_stop(&transfer->telnet);
+  oonf_class_free(&_telnet_transfer_class, transfer);
+}
+
+/**
+ * @param result result of a telnet command
+ * @return http result for the telnet result
+ */
+static enum oonf_http_result
+_get_telnet_http_result(enum oonf_telnet_result result) {
+  switch (result) {
+    case TELNET_RESULT_ACTIVE:
+    case TELNET_RESULT_QUIT:
+      return HTTP_200_OK;
+
+    case _TELNET_RESULT_UNKNOWN_COMMAND:
+      return HTTP_404_NOT_FOUND;
+
+    default:
+      return HTTP_400_BAD_REQ;
+  }
+}
+
+/**
+ * Get the combined generation number of a list of telnet commands.
+ * Generation numbers never decrease, so the sum changes every time
+ * the data of one of the commands changes.
+ * @param commands decoded command part of the request URI
+ * @param remote address of remote client
+ * @return sum of generation numbers, 0 if one of the commands
+ *   cannot be cached
+ */
+static uint64_t
+_get_telnet_generation(const char *commands, struct netaddr *remote) {
+  uint64_t generation, sum;
+  char buffer[1024];
+  char *ptr1, *ptr2, *ptr3;
+
+  strscpy(buffer, commands, sizeof(buffer));
+
+  sum = 0;
+  ptr1 = buffer;
+  while (ptr1 != NULL) {
+    ptr2 = strchr(ptr1, '/');
+    if (ptr2) {
+      *ptr2++ = 0;
     }
 
-    if (!ptr2) {
-      break;
+    ptr3 = strchr(ptr1, ' ');
+    if (ptr3) {
+      *ptr3++ = 0;
     }
-    ptr1 = ptr2 + 1;
+
+    generation = oonf_telnet_get_generation(ptr1, ptr3, remote);
+    if (generation == 0) {
+      return 0;
+    }
+    sum += generation;
+
+    ptr1 = ptr2;
   }
-  return HTTP_200_OK;
+  return sum;
+}
+
+/**
+ * Store the output of telnet commands in the cache
+ * @param entry existing cache entry for the commands, NULL if none
+ * @param commands decoded command part of the request URI
+ * @param generation combined generation number of the commands
+ * @param content pointer to output
+ * @param len length of output
+ */
+static void
+_store_cache_entry(
+  struct _http_cache_entry *entry, const char *commands, uint64_t generation, const char *content, size_t len) {
+  if (_config.cache_entries == 0) {
+    return;
+  }
+
+  if (entry == NULL) {
+    _trim_cache(_config.cache_entries - 1);
+
+    entry = oonf_class_malloc(&_cache_class);
+    if (entry == NULL) {
+      return;
+    }
+    if (abuf_init(&entry->content)) {
+      oonf_class_free(&_cache_class, entry);
+      return;
+    }
+
+    strscpy(entry->commands, commands, sizeof(entry->commands));
+    entry->_node.key = entry->commands;
+    avl_insert(&_cache_tree, &entry->_node);
+  }
+  else {
+    list_remove(&entry->_lru);
+  }
+  list_add_tail(&_cache_lru, &entry->_lru);
+
+  entry->generation = generation;
+  abuf_clear(&entry->content);
+  if (abuf_memcpy(&entry->content, content, len)) {
+    _remove_cache_entry(entry);
+  }
+}
+
+/**
+ * Remove an entry from the cache and free its memory
+ * @param entry cache entry
+ */
+static void
+_remove_cache_entry(struct _http_cache_entry *entry) {
+  avl_remove(&_cache_tree, &entry->_node);
+  list_remove(&entry->_lru);
+  abuf_free(&entry->content);
+  oonf_class_free(&_cache_class, entry);
+}
+
+/**
+ * Remove the least recently used cache entries
+ * @param count maximum number of cache entries to keep
+ */
+static void
+_trim_cache(size_t count) {
+  struct _http_cache_entry *entry;
+
+  while (_cache_tree.count > count) {
+    entry = list_first_element(&_cache_lru, entry, _lru);
+    _remove_cache_entry(entry);
+  }
+}
+
+/**
+ * AVL comparator for telnet commands, which are case sensitive
+ * @param k1 first command string
+ * @param k2 second command string
+ * @return result of strcmp()
+ */
+static int
+_avl_comp_commands(const void *k1, const void *k2) {
+  return strcmp(k1, k2);
 }
 
 /**
@@ -984,6 +1691,7 @@ _cb_config_changed(void) {
   }
 
   oonf_stream_apply_managed(&_http_managed_socket, &_config.smc);
+  _trim_cache(_config.cache_entries);
 
   if (_config.www_dir_fd != -1) {
     close(_config.www_dir_fd);
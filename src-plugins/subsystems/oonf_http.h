@@ -83,6 +83,7 @@ enum
 enum oonf_http_result
 {
   HTTP_200_OK = 200,
+  HTTP_304_NOT_MODIFIED = 304,
   HTTP_400_BAD_REQ = 400,
   HTTP_401_UNAUTHORIZED = 401,
   HTTP_403_FORBIDDEN = STREAM_REQUEST_FORBIDDEN,
@@ -92,6 +93,9 @@ enum oonf_http_result
   HTTP_501_NOT_IMPLEMENTED = 501,
   HTTP_503_SERVICE_UNAVAILABLE = STREAM_SERVICE_UNAVAILABLE,
 
+  /*! special result to signal start of a chunked transfer */
+  HTTP_START_CHUNKED_TRANSFER = 99998,
+
   /*! special result to signal start of file transfer */
   HTTP_START_FILE_TRANSFER = 99999,
 };
@@ -137,11 +141,34 @@ struct oonf_http_session {
   /*! content type for answer, NULL means plain/html */
   const char *content_type;
 
+  /*! entity tag of the answer, NULL if the answer cannot be validated */
+  const char *etag;
+
   /*! file descriptor to file that is being downloaded in this session */
   int transfer_fd;
 
   /*! number of bytes already being downloaded */
   size_t transfer_length;
+
+  /**
+   * Callback to generate the next part of a response, set together
+   * with the HTTP_START_CHUNKED_TRANSFER result. Each part is sent
+   * as a chunk when the output buffer of the connection runs empty.
+   * @param out output buffer for content
+   * @param data custom data of chunked transfer
+   * @return true if the response is complete, false if more parts follow
+   */
+  bool (*chunk_handler)(struct autobuf *out, void *data);
+
+  /**
+   * Callback to free the custom data of a chunked transfer, called
+   * when the response is complete or the connection is closed
+   * @param data custom data of chunked transfer
+   */
+  void (*chunk_cleanup)(void *data);
+
+  /*! custom data of chunked transfer */
+  void *chunk_data;
 };
 
 /**
@@ -43,14 +43,19 @@
  * @file
  */
 
+#include <stdlib.h>
+
 #include "common/avl.h"
 #include "common/avl_comp.h"
 #include "common/common_types.h"
 #include "common/json.h"
 #include "common/netaddr.h"
 #include "config/cfg_schema.h"
+#include "core/oonf_logging.h"
 #include "core/oonf_subsystem.h"
 #include "subsystems/oonf_class.h"
+#include "subsystems/oonf_clock.h"
+#include "subsystems/oonf_timer.h"
 #include "subsystems/os_interface.h"
 
 #include "subsystems/oonf_layer2.h"
@@ -64,10 +69,19 @@ static void _cleanup(void);
 
 static void _net_remove(struct oonf_layer2_net *l2net);
 static void _neigh_remove(struct oonf_layer2_neigh *l2neigh);
+static void _add_history_sample(struct oonf_layer2_data *l2data, size_t size, int64_t value);
+static void _free_history(struct oonf_layer2_data *l2data, size_t count);
+static void _net_changed(struct oonf_layer2_net *l2net);
+static void _neigh_changed(struct oonf_layer2_neigh *l2neigh);
+static uint64_t _collect_changes(struct oonf_layer2_data *l2data, size_t count);
+static void _cb_report_changes(struct oonf_timer_instance *);
+static struct avl_tree *_get_lpm_tree(const struct netaddr *addr, int prefix_len);
 
 /* subsystem definition */
 static const char *_dependencies[] = {
   OONF_CLASS_SUBSYSTEM,
+  OONF_CLOCK_SUBSYSTEM,
+  OONF_TIMER_SUBSYSTEM,
   OONF_OS_INTERFACE_SUBSYSTEM,
 };
 
@@ -179,12 +193,37 @@ static struct avl_tree _oonf_originator_tree;
 
 static struct avl_tree _local_peer_ips_tree;
 
+/* listeners for coalesced changes */
+static struct list_entity _listener_list;
+
+/* the change bitmaps have one bit per data index */
+_Static_assert(OONF_LAYER2_NET_COUNT <= 64, "layer2 network data does not fit into change bitmap");
+_Static_assert(OONF_LAYER2_NEIGH_COUNT <= 64, "layer2 neighbor data does not fit into change bitmap");
+
+/* networks and neighbors with changes not yet reported to the listeners */
+static struct list_entity _changed_net_list;
+static struct list_entity _changed_neigh_list;
+
+static struct oonf_timer_class _report_timer_class = {
+  .name = "layer2 change report",
+  .callback = _cb_report_changes,
+};
+static struct oonf_timer_instance _report_timer = {
+  .class = &_report_timer_class,
+};
+
+/* longest prefix match index of neighbor addresses, one tree per prefix length */
+static struct avl_tree _neigh_ipv4_lpm[33];
+static struct avl_tree _neigh_ipv6_lpm[129];
+
 /**
  * Subsystem constructor
  * @return always returns 0
  */
 static int
 _init(void) {
+  size_t i;
+
   oonf_class_add(&_l2network_class);
   oonf_class_add(&_l2neighbor_class);
   oonf_class_add(&_l2dst_class);
@@ -194,6 +233,18 @@ _init(void) {
   avl_init(&_oonf_layer2_net_tree, avl_comp_strcasecmp, false);
   avl_init(&_oonf_originator_tree, avl_comp_strcasecmp, false);
   avl_init(&_local_peer_ips_tree, avl_comp_netaddr, true);
+
+  list_init_head(&_listener_list);
+  list_init_head(&_changed_net_list);
+  list_init_head(&_changed_neigh_list);
+  oonf_timer_add(&_report_timer_class);
+
+  for (i = 0; i < ARRAYSIZE(_neigh_ipv4_lpm); i++) {
+    avl_init(&_neigh_ipv4_lpm[i], avl_comp_netaddr, true);
+  }
+  for (i = 0; i < ARRAYSIZE(_neigh_ipv6_lpm); i++) {
+    avl_init(&_neigh_ipv6_lpm[i], avl_comp_netaddr, true);
+  }
   return 0;
 }
 
@@ -208,6 +259,7 @@ _cleanup(void) {
     _net_remove(l2net);
   }
 
+  oonf_timer_remove(&_report_timer_class);
   oonf_class_remove(&_l2neigh_addr_class);
   oonf_class_remove(&_l2net_addr_class);
   oonf_class_remove(&_l2dst_class);
@@ -244,6 +296,26 @@ oonf_layer2_origin_remove(struct oonf_layer2_origin *origin) {
   avl_remove(&_oonf_originator_tree, &origin->_node);
 }
 
+/**
+ * Register a listener for coalesced changes of layer2 networks and neighbors
+ * @param listener layer2 listener
+ */
+void
+oonf_layer2_listener_add(struct oonf_layer2_listener *listener) {
+  list_add_tail(&_listener_list, &listener->_node);
+}
+
+/**
+ * Unregister a listener for coalesced layer2 changes
+ * @param listener layer2 listener
+ */
+void
+oonf_layer2_listener_remove(struct oonf_layer2_listener *listener) {
+  if (list_is_node_added(&listener->_node)) {
+    list_remove(&listener->_node);
+  }
+}
+
 /**
  * Parse a string into a layer2 data object
  * @param value target buffer for layer2 data
@@ -317,13 +389,90 @@ oonf_layer2_data_set(struct oonf_layer2_data *l2data, const struct oonf_layer2_o
   if (l2data->_type == OONF_LAYER2_NO_DATA || l2data->_origin == NULL || l2data->_origin == origin ||
       l2data->_origin->priority < origin->priority) {
     changed = l2data->_type != type || memcmp(&l2data->_value, input, sizeof(*input)) != 0;
+    l2data->_changed |= changed;
     memcpy(&l2data->_value, input, sizeof(*input));
     l2data->_type = type;
     l2data->_origin = origin;
+
+    if (type == OONF_LAYER2_INTEGER_DATA && origin->history_size > 0) {
+      _add_history_sample(l2data, origin->history_size, input->integer);
+    }
   }
   return changed;
 }
 
+/**
+ * Get a sample from the history of a layer2 data object
+ * @param l2data layer2 data object
+ * @param idx index of the sample, 0 is the newest one
+ * @return pointer to sample, NULL if index is not in history
+ */
+const struct oonf_layer2_sample *
+oonf_layer2_data_get_sample(const struct oonf_layer2_data *l2data, size_t idx) {
+  const struct oonf_layer2_history *history = l2data->_history;
+
+  if (history == NULL || idx >= history->count) {
+    return NULL;
+  }
+  return &history->samples[(history->next + history->size - 1 - idx) % history->size];
+}
+
+/**
+ * Calculate minimum, maximum, average and rate of change of the
+ * samples of a layer2 data object inside a time window
+ * @param stats pointer to buffer for statistics
+ * @param l2data layer2 data object
+ * @param window size of time window in milliseconds ending now,
+ *   0 to use all samples in the history
+ * @return -1 if no sample was inside the window, 0 otherwise
+ */
+int
+oonf_layer2_data_get_history_stats(
+  struct oonf_layer2_history_stats *stats, const struct oonf_layer2_data *l2data, uint64_t window) {
+  const struct oonf_layer2_sample *newest, *oldest, *sample;
+  uint64_t now;
+  int64_t sum;
+  size_t i;
+
+  memset(stats, 0, sizeof(*stats));
+
+  newest = oonf_layer2_data_get_sample(l2data, 0);
+  if (newest == NULL) {
+    return -1;
+  }
+
+  now = oonf_clock_getNow();
+  oldest = NULL;
+  sum = 0;
+  for (i = 0; (sample = oonf_layer2_data_get_sample(l2data, i)) != NULL; i++) {
+    if (window > 0 && sample->time + window < now) {
+      /* all further samples are older */
+      break;
+    }
+
+    if (oldest == NULL || sample->value < stats->min) {
+      stats->min = sample->value;
+    }
+    if (oldest == NULL || sample->value > stats->max) {
+      stats->max = sample->value;
+    }
+    sum += sample->value;
+    oldest = sample;
+  }
+
+  if (oldest == NULL) {
+    return -1;
+  }
+
+  stats->count = i;
+  stats->avg = sum / (int64_t)i;
+  stats->span = newest->time - oldest->time;
+  if (stats->span > 0) {
+    stats->rate = (newest->value - oldest->value) * 1000 / (int64_t)stats->span;
+  }
+  return 0;
+}
+
 /**
  * Compare two layer2 data objects
  * @param left left parameter for comparator
@@ -535,20 +684,20 @@ oonf_layer2_net_commit(struct oonf_layer2_net *l2net) {
   size_t i;
 
   if (l2net->neighbors.count > 0) {
-    oonf_class_event(&_l2network_class, l2net, OONF_OBJECT_CHANGED);
+    _net_changed(l2net);
     return false;
   }
 
   for (i = 0; i < OONF_LAYER2_NET_COUNT; i++) {
     if (oonf_layer2_data_has_value(&l2net->data[i])) {
-      oonf_class_event(&_l2network_class, l2net, OONF_OBJECT_CHANGED);
+      _net_changed(l2net);
       return false;
     }
   }
 
   for (i = 0; i < OONF_LAYER2_NEIGH_COUNT; i++) {
     if (oonf_layer2_data_has_value(&l2net->neighdata[i])) {
-      oonf_class_event(&_l2network_class, l2net, OONF_OBJECT_CHANGED);
+      _net_changed(l2net);
       return false;
     }
   }
@@ -654,32 +803,39 @@ oonf_layer2_net_remove_ip(struct oonf_layer2_peer_address *ip, const struct oonf
 }
 
 /**
- * Look for the best matching prefix in all layer2 neighbor addresses
+ * Look for the longest matching prefix in all layer2 neighbor addresses
  * that contains a specific address
  * @param addr ip address to look for
  * @return layer2 neighbor address object, NULL if no match was found
  */
 struct oonf_layer2_neighbor_address *
 oonf_layer2_net_get_best_neighbor_match(const struct netaddr *addr) {
-  struct oonf_layer2_neighbor_address *best_match, *l2addr;
-  struct oonf_layer2_neigh *l2neigh;
-  struct oonf_layer2_net *l2net;
-  int prefix_length;
+  struct oonf_layer2_neighbor_address *l2addr;
+  struct avl_tree *tree;
+  struct netaddr key;
+  int len;
 
-  prefix_length = 256;
-  best_match = NULL;
+  memcpy(&key, addr, sizeof(key));
 
-  avl_for_each_element(&_oonf_layer2_net_tree, l2net, _node) {
-    avl_for_each_element(&l2net->neighbors, l2neigh, _node) {
-      avl_for_each_element(&l2neigh->remote_neighbor_ips, l2addr, _neigh_node) {
-        if (netaddr_is_in_subnet(&l2addr->ip, addr) && netaddr_get_prefix_length(&l2addr->ip) < prefix_length) {
-          best_match = l2addr;
-          prefix_length = netaddr_get_prefix_length(&l2addr->ip);
-        }
-      }
+  for (len = netaddr_get_maxprefix(addr); len >= 0; len--) {
+    tree = _get_lpm_tree(addr, len);
+    if (tree == NULL) {
+      /* address family is not indexed */
+      return NULL;
+    }
+    if (tree->count == 0) {
+      continue;
+    }
+
+    key._prefix_len = len;
+    netaddr_truncate(&key, &key);
+
+    l2addr = avl_find_element(tree, &key, l2addr, _lpm_node);
+    if (l2addr) {
+      return l2addr;
     }
   }
-  return best_match;
+  return NULL;
 }
 
 /**
@@ -793,13 +949,13 @@ oonf_layer2_neigh_commit(struct oonf_layer2_neigh *l2neigh) {
   size_t i;
 
   if (l2neigh->destinations.count > 0 || l2neigh->remote_neighbor_ips.count > 0) {
-    oonf_class_event(&_l2neighbor_class, l2neigh, OONF_OBJECT_CHANGED);
+    _neigh_changed(l2neigh);
     return false;
   }
 
   for (i = 0; i < OONF_LAYER2_NEIGH_COUNT; i++) {
     if (oonf_layer2_data_has_value(&l2neigh->data[i])) {
-      oonf_class_event(&_l2neighbor_class, l2neigh, OONF_OBJECT_CHANGED);
+      _neigh_changed(l2neigh);
       return false;
     }
   }
@@ -851,6 +1007,7 @@ struct oonf_layer2_neighbor_address *
 oonf_layer2_neigh_add_ip(
   struct oonf_layer2_neigh *l2neigh, const struct oonf_layer2_origin *origin, const struct netaddr *ip) {
   struct oonf_layer2_neighbor_address *l2addr;
+  struct avl_tree *tree;
 
   l2addr = oonf_layer2_neigh_get_remote_ip(l2neigh, ip);
   if (!l2addr) {
@@ -871,6 +1028,13 @@ oonf_layer2_neigh_add_ip(
     l2addr->_net_node.key = &l2addr->ip;
     avl_insert(&l2neigh->network->remote_neighbor_ips, &l2addr->_net_node);
 
+    tree = _get_lpm_tree(ip, netaddr_get_prefix_length(ip));
+    if (tree) {
+      netaddr_truncate(&l2addr->_lpm_key, ip);
+      l2addr->_lpm_node.key = &l2addr->_lpm_key;
+      avl_insert(tree, &l2addr->_lpm_node);
+    }
+
     oonf_class_event(&_l2neigh_addr_class, l2addr, OONF_OBJECT_ADDED);
   }
 
@@ -894,6 +1058,9 @@ oonf_layer2_neigh_remove_ip(struct oonf_layer2_neighbor_address *ip, const struc
 
   avl_remove(&ip->l2neigh->remote_neighbor_ips, &ip->_neigh_node);
   avl_remove(&ip->l2neigh->network->remote_neighbor_ips, &ip->_net_node);
+  if (avl_is_node_added(&ip->_lpm_node)) {
+    avl_remove(_get_lpm_tree(&ip->ip, netaddr_get_prefix_length(&ip->ip)), &ip->_lpm_node);
+  }
   oonf_class_free(&_l2neigh_addr_class, ip);
   return 0;
 }
@@ -1116,7 +1283,12 @@ _net_remove(struct oonf_layer2_net *l2net) {
   os_interface_remove(&l2net->if_listener);
 
   /* free addr */
+  if (list_is_node_added(&l2net->_changed_node)) {
+    list_remove(&l2net->_changed_node);
+  }
   avl_remove(&_oonf_layer2_net_tree, &l2net->_node);
+  _free_history(l2net->data, OONF_LAYER2_NET_COUNT);
+  _free_history(l2net->neighdata, OONF_LAYER2_NEIGH_COUNT);
   oonf_class_free(&_l2network_class, l2net);
 }
 
@@ -1143,6 +1315,189 @@ _neigh_remove(struct oonf_layer2_neigh *l2neigh) {
   oonf_class_event(&_l2neighbor_class, l2neigh, OONF_OBJECT_REMOVED);
 
   /* free resources for mac entry */
+  if (list_is_node_added(&l2neigh->_changed_node)) {
+    list_remove(&l2neigh->_changed_node);
+  }
   avl_remove(&l2neigh->network->neighbors, &l2neigh->_node);
+  _free_history(l2neigh->data, OONF_LAYER2_NEIGH_COUNT);
   oonf_class_free(&_l2neighbor_class, l2neigh);
 }
+
+/**
+ * Inform class listeners about a committed network and queue it
+ * for the next coalesced layer2 listener callback
+ * @param l2net layer2 network
+ */
+static void
+_net_changed(struct oonf_layer2_net *l2net) {
+  l2net->_changed_data |= _collect_changes(l2net->data, OONF_LAYER2_NET_COUNT);
+  l2net->_changed_neighdata |= _collect_changes(l2net->neighdata, OONF_LAYER2_NEIGH_COUNT);
+
+  if (!list_is_node_added(&l2net->_changed_node)) {
+    list_add_tail(&_changed_net_list, &l2net->_changed_node);
+  }
+  if (!oonf_timer_is_active(&_report_timer)) {
+    oonf_timer_set(&_report_timer, 1);
+  }
+
+  oonf_class_event(&_l2network_class, l2net, OONF_OBJECT_CHANGED);
+}
+
+/**
+ * Inform class listeners about a committed neighbor and queue it
+ * for the next coalesced layer2 listener callback
+ * @param l2neigh layer2 neighbor
+ */
+static void
+_neigh_changed(struct oonf_layer2_neigh *l2neigh) {
+  l2neigh->_changed_data |= _collect_changes(l2neigh->data, OONF_LAYER2_NEIGH_COUNT);
+
+  if (!list_is_node_added(&l2neigh->_changed_node)) {
+    list_add_tail(&_changed_neigh_list, &l2neigh->_changed_node);
+  }
+  if (!oonf_timer_is_active(&_report_timer)) {
+    oonf_timer_set(&_report_timer, 1);
+  }
+
+  oonf_class_event(&_l2neighbor_class, l2neigh, OONF_OBJECT_CHANGED);
+}
+
+/**
+ * Collect and clear the change flags of an array of layer2 data objects
+ * @param l2data array of layer2 data objects
+ * @param count number of data objects
+ * @return bitmap of changed indices
+ */
+static uint64_t
+_collect_changes(struct oonf_layer2_data *l2data, size_t count) {
+  uint64_t changed = 0;
+  size_t i;
+
+  for (i = 0; i < count; i++) {
+    if (l2data[i]._changed) {
+      changed |= 1ull << i;
+      l2data[i]._changed = false;
+    }
+  }
+  return changed;
+}
+
+/**
+ * Timer callback to report all changes of the last scheduler
+ * iteration to the layer2 listeners
+ * @param ptr timer instance that fired
+ */
+static void
+_cb_report_changes(struct oonf_timer_instance *ptr __attribute__((unused))) {
+  struct oonf_layer2_listener *listener;
+  struct oonf_layer2_neigh *l2neigh;
+  struct oonf_layer2_net *l2net;
+  struct list_entity nets, neighs;
+  uint64_t changed_data, changed_neighdata;
+
+  /* changes triggered by the listeners are reported in the next round */
+  list_init_head(&nets);
+  list_init_head(&neighs);
+  list_merge(&nets, &_changed_net_list);
+  list_merge(&neighs, &_changed_neigh_list);
+
+  while (!list_is_empty(&nets)) {
+    l2net = list_first_element(&nets, l2net, _changed_node);
+    list_remove(&l2net->_changed_node);
+
+    changed_data = l2net->_changed_data;
+    changed_neighdata = l2net->_changed_neighdata;
+    l2net->_changed_data = 0;
+    l2net->_changed_neighdata = 0;
+
+    list_for_each_element(&_listener_list, listener, _node) {
+      if (listener->cb_net_changed) {
+        listener->cb_net_changed(l2net, changed_data, changed_neighdata);
+      }
+    }
+  }
+
+  while (!list_is_empty(&neighs)) {
+    l2neigh = list_first_element(&neighs, l2neigh, _changed_node);
+    list_remove(&l2neigh->_changed_node);
+
+    changed_data = l2neigh->_changed_data;
+    l2neigh->_changed_data = 0;
+
+    list_for_each_element(&_listener_list, listener, _node) {
+      if (listener->cb_neigh_changed) {
+        listener->cb_neigh_changed(l2neigh, changed_data);
+      }
+    }
+  }
+}
+
+/**
+ * Add a sample to the history of a layer2 data object
+ * @param l2data layer2 data object
+ * @param size number of samples the history should store
+ * @param value new value
+ */
+static void
+_add_history_sample(struct oonf_layer2_data *l2data, size_t size, int64_t value) {
+  struct oonf_layer2_history *history;
+
+  if (size > OONF_LAYER2_HISTORY_MAX) {
+    size = OONF_LAYER2_HISTORY_MAX;
+  }
+
+  history = l2data->_history;
+  if (history == NULL || history->size != size) {
+    /* history size of origin changed, drop the old samples */
+    free(history);
+
+    history = calloc(1, sizeof(*history) + size * sizeof(struct oonf_layer2_sample));
+    l2data->_history = history;
+    if (history == NULL) {
+      OONF_WARN(LOG_LAYER2, "Not enough memory for layer2 history");
+      return;
+    }
+    history->size = size;
+  }
+
+  history->samples[history->next].time = oonf_clock_getNow();
+  history->samples[history->next].value = value;
+  history->next = (history->next + 1) % history->size;
+  if (history->count < history->size) {
+    history->count++;
+  }
+}
+
+/**
+ * Free the histories of an array of layer2 data objects
+ * @param l2data array of layer2 data objects
+ * @param count number of data objects
+ */
+static void
+_free_history(struct oonf_layer2_data *l2data, size_t count) {
+  size_t i;
+
+  for (i = 0; i < count; i++) {
+    free(l2data[i]._history);
+    l2data[i]._history = NULL;
+  }
+}
+
+/**
+ * Get the tree of the longest prefix match index for neighbor addresses
+ * of an address family and prefix length
+ * @param addr address with address family of the tree
+ * @param prefix_len prefix length of the tree
+ * @return pointer to tree, NULL if address family is not indexed
+ */
+static struct avl_tree *
+_get_lpm_tree(const struct netaddr *addr, int prefix_len) {
+  switch (netaddr_get_address_family(addr)) {
+    case AF_INET:
+      return &_neigh_ipv4_lpm[prefix_len];
+    case AF_INET6:
+      return &_neigh_ipv6_lpm[prefix_len];
+    default:
+      return NULL;
+  }
+}
@@ -69,6 +69,12 @@
 /*! memory class for layer2 neighbor address */
 #define LAYER2_CLASS_NEIGHBOR_ADDRESS "layer2_neighbor_address"
 
+/*! maximum number of samples in the history of a layer2 data object */
+#define OONF_LAYER2_HISTORY_MAX 256
+
+/*! maximum length of the key of a layer2 metadata entry */
+#define OONF_LAYER2_METADATA_KEY_LEN 16
+
 /* configuration Macros for Layer2 keys */
 
 /**
@@ -165,6 +171,12 @@ struct oonf_layer2_origin {
   /*! priority of this originator */
   enum oonf_layer2_origin_priority priority;
 
+  /**
+   * number of (timestamp, value) samples stored for each integer
+   * value set by this originator, 0 to disable the history
+   */
+  size_t history_size;
+
   /*! node for tree of originators */
   struct avl_node _node;
 };
@@ -185,6 +197,57 @@ union oonf_layer2_value {
   struct netaddr addr;
 };
 
+/**
+ * Timestamped integer value of a layer2 data object
+ */
+struct oonf_layer2_sample {
+  /*! absolute timestamp of the sample */
+  uint64_t time;
+
+  /*! integer value of the sample */
+  int64_t value;
+};
+
+/**
+ * Ring buffer of the last values of a layer2 data object
+ */
+struct oonf_layer2_history {
+  /*! number of samples the ring can store */
+  size_t size;
+
+  /*! number of valid samples in the ring */
+  size_t count;
+
+  /*! index of the next sample to overwrite */
+  size_t next;
+
+  /*! ring of samples */
+  struct oonf_layer2_sample samples[];
+};
+
+/**
+ * Statistics of the samples of a layer2 data object inside a time window
+ */
+struct oonf_layer2_history_stats {
+  /*! number of samples inside the window */
+  size_t count;
+
+  /*! minimal value */
+  int64_t min;
+
+  /*! maximal value */
+  int64_t max;
+
+  /*! average value */
+  int64_t avg;
+
+  /*! change of the value per second between the oldest and newest sample, 0 if not available */
+  int64_t rate;
+
+  /*! time between the oldest and newest sample in milliseconds */
+  uint64_t span;
+};
+
 /**
  * Single data entry of layer2 network or neighbor
  */
@@ -197,14 +260,20 @@ struct oonf_layer2_data {
 
   /*! layer2 originator id */
   const struct oonf_layer2_origin *_origin;
+
+  /*! history of integer values, NULL if not recorded */
+  struct oonf_layer2_history *_history;
+
+  /*! true if value changed since the last commit of its network/neighbor */
+  bool _changed;
 };
 
 /**
  * Metadata of layer2 data entry for automatic processing
  */
 struct oonf_layer2_metadata {
-  /*! type of data */
-  const char key[16];
+  /*! type of data, not null terminated if it uses the whole array */
+  const char key[OONF_LAYER2_METADATA_KEY_LEN];
 
   /*! data type */
   enum oonf_layer2_data_type type;
@@ -394,6 +463,15 @@ struct oonf_layer2_net {
   /*! default values of neighbor layer2 data */
   struct oonf_layer2_data neighdata[OONF_LAYER2_NEIGH_COUNT];
 
+  /*! bitmap of data indices changed since the last layer2 listener callback */
+  uint64_t _changed_data;
+
+  /*! bitmap of neighbor default indices changed since the last layer2 listener callback */
+  uint64_t _changed_neighdata;
+
+  /*! node for list of networks waiting for a layer2 listener callback */
+  struct list_entity _changed_node;
+
   /*! node to hook into global l2network tree */
   struct avl_node _node;
 };
@@ -440,6 +518,12 @@ struct oonf_layer2_neigh {
   /*! neigbor layer 2 data */
   struct oonf_layer2_data data[OONF_LAYER2_NEIGH_COUNT];
 
+  /*! bitmap of data indices changed since the last layer2 listener callback */
+  uint64_t _changed_data;
+
+  /*! node for list of neighbors waiting for a layer2 listener callback */
+  struct list_entity _changed_node;
+
   /*! node to hook into tree of layer2 network */
   struct avl_node _node;
 };
@@ -462,6 +546,43 @@ struct oonf_layer2_neighbor_address {
 
   /*! node for tree of ip addresses */
   struct avl_node _neigh_node;
+
+  /*! truncated copy of ip, key for longest prefix match index */
+  struct netaddr _lpm_key;
+
+  /*! node for longest prefix match index of neighbor addresses */
+  struct avl_node _lpm_node;
+};
+
+/**
+ * Listener for coalesced changes of the layer2 database.
+ *
+ * All commits of a network or neighbor during one scheduler
+ * iteration are reported with a single callback, together with
+ * a bitmap of the data indices that changed in between. The bitmap
+ * can be zero if only addresses, destinations or timestamps changed.
+ */
+struct oonf_layer2_listener {
+  /*! name of the listener */
+  const char *name;
+
+  /**
+   * Callback for changed layer2 networks
+   * @param l2net layer2 network
+   * @param changed_data bitmap of changed network data indices
+   * @param changed_neighdata bitmap of changed neighbor default indices
+   */
+  void (*cb_net_changed)(struct oonf_layer2_net *l2net, uint64_t changed_data, uint64_t changed_neighdata);
+
+  /**
+   * Callback for changed layer2 neighbors
+   * @param l2neigh layer2 neighbor
+   * @param changed_data bitmap of changed neighbor data indices
+   */
+  void (*cb_neigh_changed)(struct oonf_layer2_neigh *l2neigh, uint64_t changed_data);
+
+  /*! node for list of listeners */
+  struct list_entity _node;
 };
 
 /**
@@ -484,6 +605,9 @@ struct oonf_layer2_destination {
 EXPORT void oonf_layer2_origin_add(struct oonf_layer2_origin *origin);
 EXPORT void oonf_layer2_origin_remove(struct oonf_layer2_origin *origin);
 
+EXPORT void oonf_layer2_listener_add(struct oonf_layer2_listener *listener);
+EXPORT void oonf_layer2_listener_remove(struct oonf_layer2_listener *listener);
+
 EXPORT int oonf_layer2_data_parse_string(
   union oonf_layer2_value *value, const struct oonf_layer2_metadata *meta, const char *input);
 EXPORT const char *oonf_layer2_data_to_string(
@@ -495,6 +619,9 @@ EXPORT bool oonf_layer2_data_compare(const union oonf_layer2_value *left, const
 EXPORT enum oonf_layer2_data_comparator_type oonf_layer2_data_get_comparator(const char *);
 EXPORT const char *oonf_layer2_data_get_comparator_string(enum oonf_layer2_data_comparator_type type);
 EXPORT const char *oonf_layer2_data_get_type_string(enum oonf_layer2_data_type type);
+EXPORT const struct oonf_layer2_sample *oonf_layer2_data_get_sample(const struct oonf_layer2_data *l2data, size_t idx);
+EXPORT int oonf_layer2_data_get_history_stats(
+  struct oonf_layer2_history_stats *stats, const struct oonf_layer2_data *l2data, uint64_t window);
 
 EXPORT struct oonf_layer2_net *oonf_layer2_net_add(const char *ifname);
 EXPORT bool oonf_layer2_net_remove(struct oonf_layer2_net *, const struct oonf_layer2_origin *origin);
@@ -621,6 +748,16 @@ oonf_layer2_destination_get(const struct oonf_layer2_neigh *l2neigh, const struc
   return avl_find_element(&l2neigh->destinations, destination, l2dst, _node);
 }
 
+/**
+ * @param changed bitmap of changed layer2 data indices
+ * @param idx index of layer2 data
+ * @return true if the bitmap contains the index, false otherwise
+ */
+static INLINE bool
+oonf_layer2_is_index_changed(uint64_t changed, unsigned idx) {
+  return (changed & (1ull << idx)) != 0;
+}
+
 /**
  * @param l2data layer-2 data object
  * @return true if object contains a value, false otherwise
@@ -630,6 +767,15 @@ oonf_layer2_data_has_value(const struct oonf_layer2_data *l2data) {
   return l2data->_type != OONF_LAYER2_NO_DATA;
 }
 
+/**
+ * @param l2data layer-2 data object
+ * @return number of samples in the history of the data object
+ */
+static INLINE size_t
+oonf_layer2_data_get_sample_count(const struct oonf_layer2_data *l2data) {
+  return l2data->_history ? l2data->_history->count : 0;
+}
+
 /**
  * @param l2data layer-2 data object
  * @return type of data in object
@@ -782,6 +928,9 @@ oonf_layer2_neigh_data_from_string(struct oonf_layer2_data *data, enum oonf_laye
  */
 static INLINE void
 oonf_layer2_data_reset(struct oonf_layer2_data *l2data) {
+  if (l2data->_type != OONF_LAYER2_NO_DATA) {
+    l2data->_changed = true;
+  }
   l2data->_type = OONF_LAYER2_NO_DATA;
   l2data->_origin = NULL;
 }
@@ -75,6 +75,8 @@ static int _apply_managed_socket(struct oonf_packet_managed *managed, struct oon
 static void _cb_packet_event_unicast(struct oonf_socket_entry *);
 static void _cb_packet_event_multicast(struct oonf_socket_entry *);
 static void _cb_packet_event(struct oonf_socket_entry *, bool mc);
+static bool _receive_packet(struct oonf_packet_socket *pktsocket, bool multicast);
+static bool _send_packet(struct oonf_packet_socket *pktsocket);
 static int _cb_interface_listener(struct os_interface_listener *l);
 
 /* subsystem definition */
@@ -169,6 +171,7 @@ _packet_add(struct oonf_packet_socket *pktsocket, union netaddr_socket *local, s
   pktsocket->os_if = interf;
   pktsocket->scheduler_entry.name = pktsocket->socket_name;
   pktsocket->scheduler_entry.process = _cb_packet_event_unicast;
+  pktsocket->scheduler_entry.drains_socket = true;
 
   abuf_init(&pktsocket->out);
   list_add_tail(&_packet_sockets, &pktsocket->node);
@@ -735,98 +738,144 @@ _cb_packet_event_multicast(struct oonf_socket_entry *entry) {
  *   false otherwise
  */
 static void
-_cb_packet_event(struct oonf_socket_entry *entry, bool multicast __attribute__((unused))) {
+_cb_packet_event(struct oonf_socket_entry *entry, bool multicast) {
   struct oonf_packet_socket *pktsocket;
+
+  pktsocket = container_of(entry, typeof(*pktsocket), scheduler_entry);
+
+  if (oonf_socket_is_read(entry)) {
+    /* an edge triggered socket must be read until the kernel has no data left */
+    while (_receive_packet(pktsocket, multicast) && oonf_socket_is_edge_triggered(entry))
+      ;
+  }
+
+  if (oonf_socket_is_write(entry)) {
+    /* same for sending, write until buffer is empty or socket would block */
+    while (abuf_getlen(&pktsocket->out) > 0 && _send_packet(pktsocket) && oonf_socket_is_edge_triggered(entry))
+      ;
+  }
+
+  if (abuf_getlen(&pktsocket->out) == 0) {
+    /* nothing left to send, disable outgoing events */
+    oonf_socket_set_write(&pktsocket->scheduler_entry, false);
+  }
+}
+
+/**
+ * Read a single packet from a socket and hand it to the
+ * receive callback
+ * @param pktsocket packet socket
+ * @param multicast true if the multicast socket fired the event,
+ *   false otherwise
+ * @return true if the socket should be read again, false if it had
+ *   no data or an error happened
+ */
+static bool
+_receive_packet(struct oonf_packet_socket *pktsocket, bool multicast __attribute__((unused))) {
   union netaddr_socket sock;
-  uint16_t length;
-  char *pkt;
   ssize_t result;
+  uint8_t *buf;
   struct netaddr_str netbuf;
 
 #ifdef OONF_LOG_DEBUG_INFO
   const char *interf = "";
-#endif
-
-  pktsocket = container_of(entry, typeof(*pktsocket), scheduler_entry);
 
-#ifdef OONF_LOG_DEBUG_INFO
   if (pktsocket->os_if) {
     interf = pktsocket->os_if->name;
   }
 #endif
 
-  if (oonf_socket_is_read(entry)) {
-    uint8_t *buf;
-
-    /* clear recvfrom memory */
-    memset(&sock, 0, sizeof(sock));
-
-    /* handle incoming data */
-    buf = pktsocket->config.input_buffer;
-
-    result = os_fd_recvfrom(&entry->fd, buf, pktsocket->config.input_buffer_length - 1, &sock, pktsocket->os_if);
-    if (result > 0 && pktsocket->config.receive_data != NULL) {
-      /* handle raw socket */
-      if (pktsocket->protocol) {
-        buf = os_fd_skip_rawsocket_prefix(buf, &result, pktsocket->local_socket.std.sa_family);
-        if (!buf) {
-          OONF_WARN(LOG_PACKET, "Error while skipping IP header for socket %s:",
-            netaddr_socket_to_string(&netbuf, &pktsocket->local_socket));
-          return;
-        }
+  /* clear recvfrom memory */
+  memset(&sock, 0, sizeof(sock));
+
+  /* handle incoming data */
+  buf = pktsocket->config.input_buffer;
+
+  result = os_fd_recvfrom(
+    &pktsocket->scheduler_entry.fd, buf, pktsocket->config.input_buffer_length - 1, &sock, pktsocket->os_if);
+  if (result > 0 && pktsocket->config.receive_data != NULL) {
+    /* handle raw socket */
+    if (pktsocket->protocol) {
+      buf = os_fd_skip_rawsocket_prefix(buf, &result, pktsocket->local_socket.std.sa_family);
+      if (!buf) {
+        OONF_WARN(LOG_PACKET, "Error while skipping IP header for socket %s:",
+          netaddr_socket_to_string(&netbuf, &pktsocket->local_socket));
+        return true;
       }
-      /* null terminate it */
-      buf[result] = 0;
-
-      /* received valid packet */
-      OONF_DEBUG(LOG_PACKET, "Received %" PRINTF_SSIZE_T_SPECIFIER " bytes from %s %s (%s)", result,
-        netaddr_socket_to_string(&netbuf, &sock), interf, multicast ? "multicast" : "unicast");
-      pktsocket->config.receive_data(pktsocket, &sock, buf, result);
-    }
-    else if (result < 0 && (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)) {
-      OONF_WARN(LOG_PACKET, "Cannot read packet from socket %s: %s (%d)",
-        netaddr_socket_to_string(&netbuf, &pktsocket->local_socket), strerror(errno), errno);
     }
+    /* null terminate it */
+    buf[result] = 0;
+
+    /* received valid packet */
+    OONF_DEBUG(LOG_PACKET, "Received %" PRINTF_SSIZE_T_SPECIFIER " bytes from %s %s (%s)", result,
+      netaddr_socket_to_string(&netbuf, &sock), interf, multicast ? "multicast" : "unicast");
+    pktsocket->config.receive_data(pktsocket, &sock, buf, result);
+  }
+  else if (result < 0 && (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)) {
+    OONF_WARN(LOG_PACKET, "Cannot read packet from socket %s: %s (%d)",
+      netaddr_socket_to_string(&netbuf, &pktsocket->local_socket), strerror(errno), errno);
   }
+  return result > 0 || (result < 0 && errno == EINTR);
+}
+
+/**
+ * Send the first packet of the output buffer of a socket
+ * @param pktsocket packet socket
+ * @return true if the output buffer should be sent again,
+ *   false if the socket would block
+ */
+static bool
+_send_packet(struct oonf_packet_socket *pktsocket) {
+  union netaddr_socket sock;
+  uint16_t length;
+  ssize_t result;
+  char *pkt;
+  struct netaddr_str netbuf;
 
-  if (oonf_socket_is_write(entry) && abuf_getlen(&pktsocket->out) > 0) {
-    /* handle outgoing data */
-    pkt = abuf_getptr(&pktsocket->out);
+#ifdef OONF_LOG_DEBUG_INFO
+  const char *interf = "";
+
+  if (pktsocket->os_if) {
+    interf = pktsocket->os_if->name;
+  }
+#endif
 
-    /* copy remote socket */
-    memcpy(&sock, pkt, sizeof(sock));
-    pkt += sizeof(sock);
+  /* handle outgoing data */
+  pkt = abuf_getptr(&pktsocket->out);
 
-    /* copy length */
-    memcpy(&length, pkt, 2);
-    pkt += 2;
+  /* copy remote socket */
+  memcpy(&sock, pkt, sizeof(sock));
+  pkt += sizeof(sock);
 
-    /* try to send packet */
-    result = os_fd_sendto(&entry->fd, pkt, length, &sock, pktsocket->config.dont_route);
-    if (result < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
-      /* try again later */
-      OONF_DEBUG(
-        LOG_PACKET, "Sending to %s %s could block, try again later", netaddr_socket_to_string(&netbuf, &sock), interf);
-      return;
-    }
+  /* copy length */
+  memcpy(&length, pkt, 2);
+  pkt += 2;
 
-    if (result < 0) {
-      /* display error message */
-      OONF_WARN(LOG_PACKET, "Cannot send UDP packet to %s: %s (%d)", netaddr_socket_to_string(&netbuf, &sock),
-        strerror(errno), errno);
-    }
-    else {
-      OONF_DEBUG(LOG_PACKET, "Sent %" PRINTF_SSIZE_T_SPECIFIER " bytes to %s %s", result,
-        netaddr_socket_to_string(&netbuf, &sock), interf);
-    }
-    /* remove data from outgoing buffer (both for success and for final error */
-    abuf_pull(&pktsocket->out, sizeof(sock) + 2 + length);
+  /* try to send packet */
+  result = os_fd_sendto(&pktsocket->scheduler_entry.fd, pkt, length, &sock, pktsocket->config.dont_route);
+  if (result < 0 && errno == EINTR) {
+    /* interrupted, packet is still in buffer */
+    return true;
+  }
+  if (result < 0 && errno == EAGAIN) {
+    /* try again later */
+    OONF_DEBUG(
+      LOG_PACKET, "Sending to %s %s could block, try again later", netaddr_socket_to_string(&netbuf, &sock), interf);
+    return false;
   }
 
-  if (abuf_getlen(&pktsocket->out) == 0) {
-    /* nothing left to send, disable outgoing events */
-    oonf_socket_set_write(&pktsocket->scheduler_entry, false);
+  if (result < 0) {
+    /* display error message */
+    OONF_WARN(LOG_PACKET, "Cannot send UDP packet to %s: %s (%d)", netaddr_socket_to_string(&netbuf, &sock),
+      strerror(errno), errno);
+  }
+  else {
+    OONF_DEBUG(LOG_PACKET, "Sent %" PRINTF_SSIZE_T_SPECIFIER " bytes to %s %s", result,
+      netaddr_socket_to_string(&netbuf, &sock), interf);
   }
+  /* remove data from outgoing buffer (both for success and for final error */
+  abuf_pull(&pktsocket->out, sizeof(sock) + 2 + length);
+  return true;
 }
 
 /**
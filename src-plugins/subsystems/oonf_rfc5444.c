@@ -87,6 +87,25 @@ struct _rfc5444_if_config {
   uint64_t aggregation_interval;
 };
 
+/* RFC5444 interface configuration entry index */
+enum
+{
+  /* socket settings */
+  IDX_IF_ACL,
+  IDX_IF_BINDTO,
+  IDX_IF_MULTICAST_V4,
+  IDX_IF_MULTICAST_V6,
+  IDX_IF_DSCP,
+  IDX_IF_RAWIP,
+  IDX_IF_MULTICAST_TTL,
+
+  /* number of socket settings at the start of the interface entries */
+  IDX_IF_SOCKET_COUNT,
+
+  /* settings which do not need a new socket */
+  IDX_IF_AGGREGATION_INTERVAL = IDX_IF_SOCKET_COUNT,
+};
+
 /* prototypes */
 static int _init(void);
 static void _cleanup(void);
@@ -185,25 +204,26 @@ static struct cfg_schema_section _rfc5444_section = {
 };
 
 static struct cfg_schema_entry _interface_entries[] = {
-  CFG_MAP_ACL_V46(_rfc5444_if_config, sock.acl, "acl", ACL_DEFAULT_ACCEPT, "Access control list for RFC5444 interface"),
-  CFG_MAP_ACL_V46(_rfc5444_if_config, sock.bindto, "bindto",
+  [IDX_IF_ACL] = CFG_MAP_ACL_V46(
+    _rfc5444_if_config, sock.acl, "acl", ACL_DEFAULT_ACCEPT, "Access control list for RFC5444 interface"),
+  [IDX_IF_BINDTO] = CFG_MAP_ACL_V46(_rfc5444_if_config, sock.bindto, "bindto",
     "-127.0.0.0/8\0"
     "fe80::/10\0"
     "-::/0\0" ACL_FIRST_ACCEPT "\0" ACL_DEFAULT_ACCEPT,
     "Bind RFC5444 socket to an address matching this filter (both IPv4 and IPv6)"),
-  CFG_MAP_NETADDR_V4(_rfc5444_if_config, sock.multicast_v4, "multicast_v4", RFC5444_MANET_MULTICAST_V4_TXT,
-    "ipv4 multicast address of this socket", false, true),
-  CFG_MAP_NETADDR_V6(_rfc5444_if_config, sock.multicast_v6, "multicast_v6", RFC5444_MANET_MULTICAST_V6_TXT,
-    "ipv6 multicast address of this socket", false, true),
-  CFG_MAP_INT32_MINMAX(
+  [IDX_IF_MULTICAST_V4] = CFG_MAP_NETADDR_V4(_rfc5444_if_config, sock.multicast_v4, "multicast_v4",
+    RFC5444_MANET_MULTICAST_V4_TXT, "ipv4 multicast address of this socket", false, true),
+  [IDX_IF_MULTICAST_V6] = CFG_MAP_NETADDR_V6(_rfc5444_if_config, sock.multicast_v6, "multicast_v6",
+    RFC5444_MANET_MULTICAST_V6_TXT, "ipv6 multicast address of this socket", false, true),
+  [IDX_IF_DSCP] = CFG_MAP_INT32_MINMAX(
     _rfc5444_if_config, sock.dscp, "dscp", "192", "DSCP field for outgoing UDP protocol traffic", 0, 0, 255),
-  CFG_MAP_BOOL(
+  [IDX_IF_RAWIP] = CFG_MAP_BOOL(
     _rfc5444_if_config, sock.rawip, "rawip", "false", "True if a raw IP socket should be used, false to use UDP"),
-  CFG_MAP_INT32_MINMAX(
+  [IDX_IF_MULTICAST_TTL] = CFG_MAP_INT32_MINMAX(
     _rfc5444_if_config, sock.ttl_multicast, "multicast_ttl", "1", "TTL value of outgoing multicast traffic", 0, 1, 255),
-  CFG_MAP_CLOCK(_rfc5444_if_config, aggregation_interval, "aggregation_interval", "0.100",
-    "Interval in seconds for message aggregation"),
 
+  [IDX_IF_AGGREGATION_INTERVAL] = CFG_MAP_CLOCK(_rfc5444_if_config, aggregation_interval, "aggregation_interval",
+    "0.100", "Interval in seconds for message aggregation"),
 };
 
 static struct cfg_schema_section _interface_section = {
@@ -1394,8 +1414,11 @@ _cb_cfg_interface_changed(void) {
   struct oonf_rfc5444_interface *interf;
   const char *ifname;
   char ifbuf[IF_NAMESIZE];
+  bool socket_changed;
   int result;
 
+  memset(&config, 0, sizeof(config));
+
   ifname = cfg_get_phy_if(ifbuf, _interface_section.section_name);
 
   interf = avl_find_element(&_rfc5444_protocol->_interface_tree, ifname, interf, _node);
@@ -1408,22 +1431,27 @@ _cb_cfg_interface_changed(void) {
     goto interface_changed_cleanup;
   }
 
-  memset(&config, 0, sizeof(config));
+  /* convert the whole section first, so a bad value leaves the running interface untouched */
   result = cfg_schema_tobin(&config, _interface_section.post, _interface_entries, ARRAYSIZE(_interface_entries));
   if (result) {
     OONF_WARN(LOG_RFC5444, "Could not convert %s '%s' to binary (%d)", _interface_section.type, ifname, -(result + 1));
     goto interface_changed_cleanup;
   }
 
+  socket_changed = cfg_schema_entries_changed(&_interface_entries[IDX_IF_ACL], IDX_IF_SOCKET_COUNT);
+
   if (_interface_section.pre == NULL) {
     interf = oonf_rfc5444_add_interface(_rfc5444_protocol, NULL, ifname);
-    if (interf == NULL) {
-      OONF_WARN(LOG_RFC5444, "Could not generate interface '%s' for protocol '%s'", ifname, _rfc5444_protocol->name);
-      goto interface_changed_cleanup;
-    }
+    socket_changed = true;
+  }
+  if (interf == NULL) {
+    OONF_WARN(LOG_RFC5444, "Could not generate interface '%s' for protocol '%s'", ifname, _rfc5444_protocol->name);
+    goto interface_changed_cleanup;
   }
 
-  oonf_rfc5444_reconfigure_interface(interf, &config.sock);
+  if (socket_changed) {
+    oonf_rfc5444_reconfigure_interface(interf, &config.sock);
+  }
   interf->aggregation_interval = config.aggregation_interval;
 
   /* fall through */
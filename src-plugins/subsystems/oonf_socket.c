@@ -50,6 +50,7 @@
 
 #include "common/avl.h"
 #include "common/avl_comp.h"
+#include "config/cfg_schema.h"
 #include "core/oonf_logging.h"
 #include "core/oonf_main.h"
 #include "core/oonf_subsystem.h"
@@ -62,10 +63,19 @@
 /* Definitions */
 #define LOG_SOCKET _oonf_socket_subsystem.logging
 
+/**
+ * Configuration of socket scheduler
+ */
+struct _socket_config {
+  /*! true if sockets that support it should use edge triggered events */
+  bool edge_triggered;
+};
+
 /* prototypes */
 static int _init(void);
 static void _cleanup(void);
 static void _initiate_shutdown(void);
+static void _cb_config_changed(void);
 
 static bool _shall_end_scheduler(void);
 static int _handle_scheduling(void);
@@ -79,6 +89,25 @@ static struct list_entity _socket_head;
 /* socket event scheduler */
 struct os_fd_select _socket_events;
 
+/* current configuration */
+static struct _socket_config _config;
+
+/* configuration of socket scheduler */
+static struct cfg_schema_entry _socket_entries[] = {
+  CFG_MAP_BOOL(_socket_config, edge_triggered, "edge_triggered", "false",
+    "Use edge triggered events for sockets that read and write until the kernel reports EAGAIN."
+    " This saves scheduler iterations and epoll calls under load."),
+};
+
+static struct cfg_schema_section _socket_section = {
+  .type = OONF_SOCKET_SUBSYSTEM,
+  .mode = CFG_SSMODE_UNNAMED,
+  .help = "Settings for the socket scheduler",
+  .cb_delta_handler = _cb_config_changed,
+  .entries = _socket_entries,
+  .entry_count = ARRAYSIZE(_socket_entries),
+};
+
 /* subsystem definition */
 static const char *_dependencies[] = {
   OONF_TIMER_SUBSYSTEM,
@@ -92,6 +121,7 @@ static struct oonf_subsystem _oonf_socket_subsystem = {
   .init = _init,
   .cleanup = _cleanup,
   .initiate_shutdown = _initiate_shutdown,
+  .cfg_section = &_socket_section,
 };
 DECLARE_OONF_PLUGIN(_oonf_socket_subsystem);
 
@@ -105,8 +135,11 @@ _init(void) {
     return -1;
   }
 
+  if (os_fd_event_add(&_socket_events)) {
+    OONF_WARN(LOG_SOCKET, "Cannot initialize socket event handler: %s (%d)", strerror(errno), errno);
+    return -1;
+  }
   list_init_head(&_socket_head);
-  os_fd_event_add(&_socket_events);
 
   _scheduler_time_limit = ~0ull;
   return 0;
@@ -146,6 +179,10 @@ oonf_socket_add(struct oonf_socket_entry *entry) {
 
   list_add_before(&_socket_head, &entry->_node);
   os_fd_event_socket_add(&_socket_events, &entry->fd);
+
+  if (entry->drains_socket && _config.edge_triggered) {
+    os_fd_event_socket_edge_triggered(&_socket_events, &entry->fd, true);
+  }
 }
 
 /**
@@ -170,6 +207,14 @@ oonf_socket_get_list(void) {
   return &_socket_head;
 }
 
+/**
+ * @return statistics of the socket event handler
+ */
+const struct os_fd_select_stats *
+oonf_socket_get_event_stats(void) {
+  return os_fd_event_get_stats(&_socket_events);
+}
+
 /**
  * @param entry socket entry
  * @param event_read true to enable read events, false to disable
@@ -188,6 +233,41 @@ oonf_socket_set_write(struct oonf_socket_entry *entry, bool event_write) {
   os_fd_event_socket_write(&_socket_events, &entry->fd, event_write);
 }
 
+/**
+ * Make the scheduler report an edge triggered socket again if it is
+ * still readable/writable. Must be called by a process callback that
+ * stops before the socket reported EAGAIN.
+ * @param entry socket entry
+ */
+void
+oonf_socket_rearm(struct oonf_socket_entry *entry) {
+  if (os_fd_event_is_edge_triggered(&entry->fd)) {
+    os_fd_event_socket_rearm(&_socket_events, &entry->fd);
+  }
+}
+
+/**
+ * Handle changes of the socket scheduler configuration
+ */
+static void
+_cb_config_changed(void) {
+  struct oonf_socket_entry *entry;
+
+  if (cfg_schema_tobin(&_config, _socket_section.post, _socket_entries, ARRAYSIZE(_socket_entries))) {
+    OONF_WARN(LOG_SOCKET, "Cannot map socket config to binary data");
+    return;
+  }
+
+  /* switch all sockets that support it to the new event mode */
+  list_for_each_element(&_socket_head, entry, _node) {
+    if (entry->drains_socket && oonf_socket_is_edge_triggered(entry) != _config.edge_triggered) {
+      OONF_DEBUG(LOG_SOCKET, "Switch socket %s (%d) to %s triggered events", entry->name, os_fd_get_fd(&entry->fd),
+        _config.edge_triggered ? "edge" : "level");
+      os_fd_event_socket_edge_triggered(&_socket_events, &entry->fd, _config.edge_triggered);
+    }
+  }
+}
+
 /**
  * @return true if scheduler should stop
  */
@@ -205,7 +285,7 @@ _handle_scheduling(void) {
   struct oonf_socket_entry *sock_entry = NULL;
   struct os_fd *sock;
   uint64_t next_event;
-  uint64_t start_time, end_time;
+  uint64_t start_time, end_time, duration;
   int i, n;
 
   while (true) {
@@ -276,13 +356,16 @@ _handle_scheduling(void) {
         if (os_fd_event_is_write(sock)) {
           sock_entry->_stat_send++;
         }
-        os_clock_gettime64(&start_time);
+        os_clock_gettime64_ns(&start_time);
         sock_entry->process(sock_entry);
-        os_clock_gettime64(&end_time);
+        os_clock_gettime64_ns(&end_time);
+
+        duration = (end_time - start_time) / 1000ull;
+        histogram_add(&sock_entry->_stat_duration, duration);
 
-        if (end_time - start_time > OONF_TIMER_SLICE) {
+        if (duration > OONF_TIMER_SLICE * 1000ull) {
           OONF_WARN(LOG_SOCKET, "Socket '%s' (%d) scheduling took %" PRIu64 " ms", sock_entry->name,
-            os_fd_get_fd(&sock_entry->fd), end_time - start_time);
+            os_fd_get_fd(&sock_entry->fd), duration / 1000);
           sock_entry->_stat_long++;
         }
       }
@@ -48,6 +48,7 @@
 
 #include "common/avl.h"
 #include "common/common_types.h"
+#include "common/histogram.h"
 #include "common/list.h"
 #include "common/netaddr_acl.h"
 #include "subsystems/os_fd.h"
@@ -71,6 +72,13 @@ struct oonf_socket_entry {
    */
   void (*process)(struct oonf_socket_entry *entry);
 
+  /**
+   * true if the process callback reads and writes until the socket
+   * reports EAGAIN, which allows the scheduler to register the socket
+   * for edge triggered events.
+   */
+  bool drains_socket;
+
   /*! usage counter, will be increased every times the socket receives data */
   uint32_t _stat_recv;
 
@@ -83,6 +91,15 @@ struct oonf_socket_entry {
    */
   uint32_t _stat_long;
 
+  /*! number of payload bytes sent through the socket */
+  uint64_t _stat_bytes_sent;
+
+  /*! number of payload bytes copied between buffers before they could be sent */
+  uint64_t _stat_bytes_copied;
+
+  /*! duration of process callbacks in microseconds */
+  struct histogram _stat_duration;
+
   /*! list of socket handlers */
   struct list_entity _node;
 };
@@ -91,7 +108,9 @@ EXPORT void oonf_socket_add(struct oonf_socket_entry *);
 EXPORT void oonf_socket_remove(struct oonf_socket_entry *);
 EXPORT void oonf_socket_set_read(struct oonf_socket_entry *entry, bool event_read);
 EXPORT void oonf_socket_set_write(struct oonf_socket_entry *entry, bool event_write);
+EXPORT void oonf_socket_rearm(struct oonf_socket_entry *entry);
 EXPORT struct list_entity *oonf_socket_get_list(void);
+EXPORT const struct os_fd_select_stats *oonf_socket_get_event_stats(void);
 
 /**
  * @param entry socket entry
@@ -111,6 +130,16 @@ oonf_socket_is_write(struct oonf_socket_entry *entry) {
   return os_fd_event_is_write(&entry->fd);
 }
 
+/**
+ * @param entry socket entry
+ * @return true if socket is registered for edge triggered events,
+ *   its process callback must read/write until EAGAIN
+ */
+static INLINE bool
+oonf_socket_is_edge_triggered(struct oonf_socket_entry *entry) {
+  return os_fd_event_is_edge_triggered(&entry->fd);
+}
+
 /**
  * Registers a direct send (without select) to a socket
  * @param entry socket entry
@@ -120,6 +149,26 @@ oonf_socket_register_direct_send(struct oonf_socket_entry *entry) {
   entry->_stat_send++;
 }
 
+/**
+ * Account payload bytes sent through a socket
+ * @param entry socket entry
+ * @param bytes number of bytes sent
+ */
+static INLINE void
+oonf_socket_register_bytes_sent(struct oonf_socket_entry *entry, size_t bytes) {
+  entry->_stat_bytes_sent += bytes;
+}
+
+/**
+ * Account payload bytes copied between buffers for a socket
+ * @param entry socket entry
+ * @param bytes number of bytes copied
+ */
+static INLINE void
+oonf_socket_register_bytes_copied(struct oonf_socket_entry *entry, size_t bytes) {
+  entry->_stat_bytes_copied += bytes;
+}
+
 /**
  * @param sock pointer to socket entry
  * @return number of recv events of socket
@@ -147,4 +196,31 @@ oonf_socket_get_long(struct oonf_socket_entry *sock) {
   return sock->_stat_long;
 }
 
+/**
+ * @param sock pointer to socket entry
+ * @return number of payload bytes sent through socket
+ */
+static INLINE uint64_t
+oonf_socket_get_bytes_sent(struct oonf_socket_entry *sock) {
+  return sock->_stat_bytes_sent;
+}
+
+/**
+ * @param sock pointer to socket entry
+ * @return number of payload bytes copied between buffers for socket
+ */
+static INLINE uint64_t
+oonf_socket_get_bytes_copied(struct oonf_socket_entry *sock) {
+  return sock->_stat_bytes_copied;
+}
+
+/**
+ * @param sock pointer to socket entry
+ * @return histogram of process callback durations in microseconds
+ */
+static INLINE const struct histogram *
+oonf_socket_get_duration(struct oonf_socket_entry *sock) {
+  return &sock->_stat_duration;
+}
+
 #endif /* OONF_SOCKET_H_ */
@@ -48,6 +48,7 @@
 #include <string.h>
 
 #include "common/autobuf.h"
+#include "common/autobuf_chain.h"
 #include "common/avl.h"
 #include "common/list.h"
 #include "core/oonf_logging.h"
@@ -71,8 +72,13 @@ int _apply_managed(struct oonf_stream_managed *managed);
 static int _apply_managed_socket(
   int af_type, struct oonf_stream_managed *managed, struct oonf_stream_socket *stream, struct os_interface *os_if);
 static void _cb_parse_request(struct oonf_socket_entry *);
+static bool _accept_session(struct oonf_stream_socket *stream);
 static struct oonf_stream_session *_create_session(struct oonf_stream_socket *stream_socket, struct os_fd *sock,
   const struct netaddr *remote_addr, const union netaddr_socket *remote_socket);
+static char *_get_input_space(struct oonf_stream_session *session);
+static void _update_read_size(struct oonf_stream_session *session, size_t len);
+static ssize_t _send_output(struct oonf_stream_session *session);
+static bool _receive_input(struct oonf_stream_session *session);
 static void _cb_parse_connection(struct oonf_socket_entry *entry);
 
 static void _cb_timeout_handler(struct oonf_timer_instance *);
@@ -147,6 +153,69 @@ oonf_stream_flush(struct oonf_stream_session *con) {
   oonf_socket_set_write(&con->scheduler_entry, true);
 }
 
+/**
+ * Mark bytes at the start of the input buffer as processed.
+ * The remaining input is not moved until the next read needs
+ * the space, so a parser can consume one message after another
+ * without copying the rest of the buffer each time.
+ * @param con pointer to stream session
+ * @param len number of bytes processed
+ */
+void
+oonf_stream_consume_input(struct oonf_stream_session *con, size_t len) {
+  if (len >= oonf_stream_get_input_length(con)) {
+    /* everything consumed, start again at the beginning of the buffer */
+    abuf_setlen(&con->in, 0);
+    con->_in_offset = 0;
+    return;
+  }
+  con->_in_offset += len;
+}
+
+/**
+ * Move the content of the output buffer of a session behind the data
+ * already waiting for the kernel. Large output buffers are moved without
+ * copying them. Anything written into the output buffer afterwards
+ * will be sent behind the queued data.
+ * @param con pointer to stream session
+ * @return -1 if an out-of-memory error happened, 0 otherwise
+ */
+int
+oonf_stream_queue_output(struct oonf_stream_session *con) {
+  size_t len;
+
+  len = abuf_getlen(&con->out);
+  if (len >= ABUF_CHAIN_CHUNK_SIZE) {
+    return abuf_chain_adopt(&con->_out_chain, &con->out);
+  }
+  if (len > 0) {
+    if (abuf_chain_memcpy(&con->_out_chain, abuf_getptr(&con->out), len)) {
+      return -1;
+    }
+    abuf_clear(&con->out);
+    oonf_socket_register_bytes_copied(&con->scheduler_entry, len);
+  }
+  return 0;
+}
+
+/**
+ * Copy a memory block behind the data already waiting for the kernel,
+ * but in front of the current content of the output buffer. This allows
+ * to put a header in front of generated content without moving it.
+ * @param con pointer to stream session
+ * @param p pointer to memory block
+ * @param len length of memory block
+ * @return -1 if an out-of-memory error happened, 0 otherwise
+ */
+int
+oonf_stream_queue_memcpy(struct oonf_stream_session *con, const void *p, size_t len) {
+  if (abuf_chain_memcpy(&con->_out_chain, p, len)) {
+    return -1;
+  }
+  oonf_socket_register_bytes_copied(&con->scheduler_entry, len);
+  return 0;
+}
+
 /**
  * Add a new stream socket to the scheduler
  * @param stream_socket pointer to stream socket struct with
@@ -174,6 +243,7 @@ oonf_stream_add(struct oonf_stream_socket *stream_socket, const union netaddr_so
     }
     stream_socket->scheduler_entry.name = stream_socket->socket_name;
     stream_socket->scheduler_entry.process = _cb_parse_request;
+    stream_socket->scheduler_entry.drains_socket = true;
 
     snprintf(stream_socket->socket_name, sizeof(stream_socket->socket_name), "tcp-server: %s",
       netaddr_socket_to_string(&buf, local));
@@ -245,7 +315,7 @@ oonf_stream_close_all_sessions(struct oonf_stream_socket *stream_socket) {
   }
 
   list_for_each_element_safe(&stream_socket->session, session, node, ptr) {
-    if (abuf_getlen(&session->out) == 0 && !session->busy) {
+    if (oonf_stream_get_output_length(session) == 0 && !session->busy) {
       /* close everything that doesn't need to send data anymore */
       oonf_stream_close(session);
     }
@@ -462,6 +532,7 @@ _stream_close(struct oonf_stream_session *session) {
 
   abuf_free(&session->in);
   abuf_free(&session->out);
+  abuf_chain_free(&session->_out_chain);
 
   oonf_class_free(session->stream_socket->config.memcookie, session);
 }
@@ -560,12 +631,6 @@ _apply_managed_socket(
 static void
 _cb_parse_request(struct oonf_socket_entry *entry) {
   struct oonf_stream_socket *stream;
-  union netaddr_socket remote_socket;
-  struct netaddr remote_addr;
-  struct os_fd sock;
-#ifdef OONF_LOG_DEBUG_INFO
-  struct netaddr_str buf1, buf2;
-#endif
 
   if (!oonf_socket_is_read(entry)) {
     return;
@@ -573,9 +638,34 @@ _cb_parse_request(struct oonf_socket_entry *entry) {
 
   stream = container_of(entry, typeof(*stream), scheduler_entry);
 
-  if (os_fd_accept(&sock, &entry->fd, &remote_socket)) {
-    OONF_WARN(LOG_STREAM, "accept() call returned error: %s (%d)", strerror(errno), errno);
-    return;
+  /* an edge triggered socket must be accepted from until no connection is left */
+  while (_accept_session(stream) && oonf_socket_is_edge_triggered(entry))
+    ;
+}
+
+/**
+ * Accept a single incoming connection of a server socket
+ * @param stream stream server socket
+ * @return true if the socket should be accepted from again,
+ *   false if no connection was waiting or an error happened
+ */
+static bool
+_accept_session(struct oonf_stream_socket *stream) {
+  union netaddr_socket remote_socket;
+  struct netaddr remote_addr;
+  struct os_fd sock;
+#ifdef OONF_LOG_DEBUG_INFO
+  struct netaddr_str buf1, buf2;
+#endif
+
+  if (os_fd_accept(&sock, &stream->scheduler_entry.fd, &remote_socket)) {
+    if (errno == EINTR) {
+      return true;
+    }
+    if (errno != EAGAIN) {
+      OONF_WARN(LOG_STREAM, "accept() call returned error: %s (%d)", strerror(errno), errno);
+    }
+    return false;
   }
 
   netaddr_from_socket(&remote_addr, &remote_socket);
@@ -584,10 +674,11 @@ _cb_parse_request(struct oonf_socket_entry *entry) {
       OONF_DEBUG(LOG_STREAM, "Access from %s to socket %s blocked because of ACL",
         netaddr_to_string(&buf1, &remote_addr), netaddr_socket_to_string(&buf2, &stream->local_socket));
       os_fd_close(&sock);
-      return;
+      return true;
     }
   }
   _create_session(stream, &sock, &remote_addr, &remote_socket);
+  return true;
 }
 
 /**
@@ -615,6 +706,7 @@ _create_session(struct oonf_stream_socket *stream_socket, struct os_fd *sock, co
     return NULL;
   }
 
+  abuf_chain_init(&session->_out_chain);
   if (abuf_init(&session->in)) {
     OONF_WARN(LOG_STREAM, "Cannot allocate memory for comport session");
     goto parse_request_error;
@@ -629,6 +721,7 @@ _create_session(struct oonf_stream_socket *stream_socket, struct os_fd *sock, co
   session->scheduler_entry.process = _cb_parse_connection;
   session->send_first = stream_socket->config.send_first;
   session->stream_socket = stream_socket;
+  session->_read_size = OONF_STREAM_MIN_READ_SIZE;
 
   session->remote_address = *remote_addr;
   session->remote_socket = *remote_socket;
@@ -675,6 +768,7 @@ _create_session(struct oonf_stream_socket *stream_socket, struct os_fd *sock, co
 parse_request_error:
   abuf_free(&session->in);
   abuf_free(&session->out);
+  abuf_chain_free(&session->_out_chain);
   oonf_class_free(stream_socket->config.memcookie, session);
 
   return NULL;
@@ -700,8 +794,9 @@ static void
 _cb_parse_connection(struct oonf_socket_entry *entry) {
   struct oonf_stream_session *session;
   struct oonf_stream_socket *s_sock;
+  enum oonf_stream_session_state state;
+  bool would_block;
   int len;
-  char buffer[1024];
   struct netaddr_str buf;
 
   session = container_of(entry, typeof(*session), scheduler_entry);
@@ -738,60 +833,31 @@ _cb_parse_connection(struct oonf_socket_entry *entry) {
     return;
   }
 
-  /* read data if necessary */
+  /* read data if necessary, an edge triggered socket must be read until the kernel has no data left */
   if (session->state == STREAM_SESSION_ACTIVE && oonf_socket_is_read(entry)) {
-    len = os_fd_recvfrom(&entry->fd, buffer, sizeof(buffer), NULL, 0);
-    if (len > 0) {
-      OONF_DEBUG(LOG_STREAM, "  recv returned %d\n", len);
-      if (abuf_memcpy(&session->in, buffer, len)) {
-        /* out of memory */
-        OONF_WARN(LOG_STREAM, "Out of memory for comport session input buffer");
-        session->state = STREAM_SESSION_CLEANUP;
-      }
-      else if (abuf_getlen(&session->in) > s_sock->config.maximum_input_buffer) {
-        /* input buffer overflow */
-        if (s_sock->config.create_error) {
-          s_sock->config.create_error(session, STREAM_REQUEST_TOO_LARGE);
-        }
-        session->state = STREAM_SESSION_SEND_AND_QUIT;
-      }
-      else {
-        /* got new input block, reset timeout */
-        oonf_stream_set_timeout(session, s_sock->config.session_timeout);
-      }
-    }
-    else if (len < 0 && errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK) {
-      /* error during read */
-      OONF_WARN(LOG_STREAM, "Error while reading from communication stream with %s: %s (%d)\n",
-        netaddr_to_string(&buf, &session->remote_address), strerror(errno), errno);
-      session->state = STREAM_SESSION_CLEANUP;
-    }
-    else if (len == 0) {
-      /* external s_sock closed */
-      session->state = STREAM_SESSION_SEND_AND_QUIT;
-
-      /* still call callback once more */
-      session->state = s_sock->config.receive_data(session);
-
-      /* switch off read events */
-      oonf_socket_set_read(entry, false);
-    }
+    while (_receive_input(session) && oonf_socket_is_edge_triggered(entry))
+      ;
   }
 
   if (session->state == STREAM_SESSION_ACTIVE && s_sock->config.receive_data != NULL &&
-      (abuf_getlen(&session->in) > 0 || session->send_first)) {
+      (oonf_stream_get_input_length(session) > 0 || session->send_first)) {
     session->state = s_sock->config.receive_data(session);
     session->send_first = false;
   }
 
   /* send data if necessary */
-  if (session->state != STREAM_SESSION_CLEANUP && abuf_getlen(&session->out) > 0) {
+  would_block = false;
+  if (session->state != STREAM_SESSION_CLEANUP && oonf_stream_get_output_length(session) > 0) {
     if (oonf_socket_is_write(entry)) {
-      len = os_fd_sendto(&entry->fd, abuf_getptr(&session->out), abuf_getlen(&session->out), NULL, false);
+      do {
+        len = _send_output(session);
+      } while (len > 0 && oonf_stream_get_output_length(session) > 0 && oonf_socket_is_edge_triggered(entry));
 
-      if (len > 0) {
-        OONF_DEBUG(LOG_STREAM, "  send returned %d\n", len);
-        abuf_pull(&session->out, len);
+      if (len < 0 && errno == EAGAIN) {
+        would_block = true;
+      }
+      else if (len > 0) {
+        OONF_DEBUG(LOG_STREAM, "  writev returned %d\n", len);
         oonf_stream_set_timeout(session, s_sock->config.session_timeout);
       }
       else if (len < 0 && errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK) {
@@ -807,29 +873,38 @@ _cb_parse_connection(struct oonf_socket_entry *entry) {
   }
 
   /* send file if necessary */
-  if (session->state == STREAM_SESSION_SEND_AND_QUIT && abuf_getlen(&session->out) == 0 &&
+  if (session->state == STREAM_SESSION_SEND_AND_QUIT && oonf_stream_get_output_length(session) == 0 &&
       os_fd_is_initialized(&session->copy_fd)) {
     if (oonf_socket_is_write(entry)) {
-      len = os_fd_sendfile(
-        &entry->fd, &session->copy_fd, session->copy_bytes_sent, session->copy_total_size - session->copy_bytes_sent);
-      if (len <= 0) {
+      do {
+        len = os_fd_sendfile(&entry->fd, &session->copy_fd, session->copy_bytes_sent,
+          session->copy_total_size - session->copy_bytes_sent);
+        if (len > 0) {
+          session->copy_bytes_sent += len;
+        }
+      } while (len > 0 && session->copy_bytes_sent < session->copy_total_size && oonf_socket_is_edge_triggered(entry));
+
+      if (len < 0 && errno == EAGAIN) {
+        would_block = true;
+      }
+      else if (len <= 0) {
         OONF_WARN(LOG_STREAM, "Error while copying file to output stream (%d/%d): %s (%d)", os_fd_get_fd(&entry->fd),
           os_fd_get_fd(&session->copy_fd), strerror(errno), errno);
         session->state = STREAM_SESSION_CLEANUP;
       }
-      else {
-        session->copy_bytes_sent += len;
-      }
     }
   }
 
-  /* check for buffer underrun */
-  if (session->state == STREAM_SESSION_ACTIVE && abuf_getlen(&session->out) == 0 &&
-      s_sock->config.buffer_underrun != NULL) {
-    session->state = s_sock->config.buffer_underrun(session);
+  /* check for buffer underrun, a session about to quit might still have output to generate */
+  if ((session->state == STREAM_SESSION_ACTIVE || session->state == STREAM_SESSION_SEND_AND_QUIT) &&
+      oonf_stream_get_output_length(session) == 0 && s_sock->config.buffer_underrun != NULL) {
+    state = s_sock->config.buffer_underrun(session);
+    if (session->state == STREAM_SESSION_ACTIVE || state == STREAM_SESSION_CLEANUP) {
+      session->state = state;
+    }
   }
 
-  if (abuf_getlen(&session->out) == 0 && session->copy_bytes_sent == session->copy_total_size) {
+  if (oonf_stream_get_output_length(session) == 0 && session->copy_bytes_sent == session->copy_total_size) {
     /* nothing to send anymore */
     OONF_DEBUG(LOG_STREAM, "  deactivating output in scheduler\n");
     oonf_socket_set_write(&session->scheduler_entry, false);
@@ -837,6 +912,10 @@ _cb_parse_connection(struct oonf_socket_entry *entry) {
       session->state = STREAM_SESSION_CLEANUP;
     }
   }
+  else if (!would_block && session->state != STREAM_SESSION_CLEANUP) {
+    /* new output without a full kernel buffer, an edge triggered socket will not report again by itself */
+    oonf_socket_rearm(entry);
+  }
 
   session->busy = false;
   s_sock->busy = false;
@@ -858,6 +937,133 @@ _cb_parse_connection(struct oonf_socket_entry *entry) {
   return;
 }
 
+/**
+ * Read a single block of data from a stream session into its input buffer
+ * @param session stream session
+ * @return true if the session should be read again,
+ *   false if the socket had no data, was closed or an error happened
+ */
+static bool
+_receive_input(struct oonf_stream_session *session) {
+  struct oonf_stream_socket *s_sock;
+  struct netaddr_str buf;
+  char *buffer;
+  int len;
+
+  s_sock = session->stream_socket;
+
+  /* receive directly into the free space of the input buffer */
+  buffer = _get_input_space(session);
+  if (!buffer) {
+    /* out of memory */
+    OONF_WARN(LOG_STREAM, "Out of memory for comport session input buffer");
+    session->state = STREAM_SESSION_CLEANUP;
+  }
+  else if ((len = os_fd_recvfrom(&session->scheduler_entry.fd, buffer, session->_read_size, NULL, 0)) > 0) {
+    OONF_DEBUG(LOG_STREAM, "  recv returned %d\n", len);
+    abuf_setlen(&session->in, abuf_getlen(&session->in) + len);
+    _update_read_size(session, len);
+
+    if (oonf_stream_get_input_length(session) > s_sock->config.maximum_input_buffer) {
+      /* input buffer overflow */
+      if (s_sock->config.create_error) {
+        s_sock->config.create_error(session, STREAM_REQUEST_TOO_LARGE);
+      }
+      session->state = STREAM_SESSION_SEND_AND_QUIT;
+    }
+    else {
+      /* got new input block, reset timeout */
+      oonf_stream_set_timeout(session, s_sock->config.session_timeout);
+      return true;
+    }
+  }
+  else if (len < 0 && errno == EINTR) {
+    return true;
+  }
+  else if (len < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+    /* error during read */
+    OONF_WARN(LOG_STREAM, "Error while reading from communication stream with %s: %s (%d)\n",
+      netaddr_to_string(&buf, &session->remote_address), strerror(errno), errno);
+    session->state = STREAM_SESSION_CLEANUP;
+  }
+  else if (len == 0) {
+    /* external s_sock closed */
+    session->state = STREAM_SESSION_SEND_AND_QUIT;
+
+    /* still call callback once more */
+    session->state = s_sock->config.receive_data(session);
+
+    /* switch off read events */
+    oonf_socket_set_read(&session->scheduler_entry, false);
+  }
+  return false;
+}
+
+/**
+ * Get free space behind the content of the input buffer of a session
+ * for the next read. Unconsumed input is moved to the start of the
+ * buffer first if the space behind it is too small.
+ * @param session stream session
+ * @return pointer to at least _read_size bytes of writable memory,
+ *   NULL if out of memory
+ */
+static char *
+_get_input_space(struct oonf_stream_session *session) {
+  size_t remaining;
+
+  if (session->_in_offset > 0 && abuf_getmax(&session->in) - abuf_getlen(&session->in) <= session->_read_size) {
+    remaining = oonf_stream_get_input_length(session);
+    memmove(abuf_getptr(&session->in), oonf_stream_get_input(session), remaining);
+    abuf_setlen(&session->in, remaining);
+    session->_in_offset = 0;
+  }
+  return abuf_reserve(&session->in, session->_read_size);
+}
+
+/**
+ * Adapt the read size of a session to the amount of data
+ * the last read returned
+ * @param session stream session
+ * @param len number of bytes returned by the last read
+ */
+static void
+_update_read_size(struct oonf_stream_session *session, size_t len) {
+  if (len == session->_read_size && session->_read_size < OONF_STREAM_MAX_READ_SIZE) {
+    /* kernel had more data for us */
+    session->_read_size *= 2;
+  }
+  else if (len < session->_read_size / 4 && session->_read_size > OONF_STREAM_MIN_READ_SIZE) {
+    session->_read_size /= 2;
+  }
+}
+
+/**
+ * Move the output buffer of a session into its output chain and
+ * hand as much of the chain to the kernel as possible.
+ * Large output buffers are moved without copying them.
+ * @param session stream session
+ * @return number of bytes sent, -1 if an error happened
+ */
+static ssize_t
+_send_output(struct oonf_stream_session *session) {
+  struct iovec iov[OONF_STREAM_MAX_WRITE_CHUNKS];
+  ssize_t result;
+  int count;
+
+  if (oonf_stream_queue_output(session)) {
+    errno = ENOMEM;
+    return -1;
+  }
+
+  count = abuf_chain_get_iovec(&session->_out_chain, iov, OONF_STREAM_MAX_WRITE_CHUNKS);
+  result = os_fd_writev(&session->scheduler_entry.fd, iov, count);
+  if (result > 0) {
+    abuf_chain_pull(&session->_out_chain, (size_t)result);
+    oonf_socket_register_bytes_sent(&session->scheduler_entry, (size_t)result);
+  }
+  return result;
+}
+
 /**
  * Callbacks for events on the interface
  * @param interf os interface listener that fired
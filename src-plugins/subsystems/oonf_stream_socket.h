@@ -47,6 +47,7 @@
 #define OONF_STREAM_SOCKET_H_
 
 #include "common/autobuf.h"
+#include "common/autobuf_chain.h"
 #include "common/common_types.h"
 #include "common/list.h"
 #include "common/netaddr.h"
@@ -60,6 +61,15 @@
 /*! subsystem identifier */
 #define OONF_STREAM_SUBSYSTEM "stream_socket"
 
+/*! initial number of bytes requested from the kernel by a single read */
+#define OONF_STREAM_MIN_READ_SIZE 4096
+
+/*! maximum number of bytes requested from the kernel by a single read */
+#define OONF_STREAM_MAX_READ_SIZE 65536
+
+/*! maximum number of output buffer chunks handed to the kernel by a single write */
+#define OONF_STREAM_MAX_WRITE_CHUNKS 16
+
 /**
  * TCP session states
  */
@@ -109,6 +119,12 @@ struct oonf_stream_session {
    */
   struct autobuf out;
 
+  /**
+   * data already taken from the output buffer but not yet
+   * accepted by the kernel, always sent before the output buffer
+   */
+  struct abuf_chain _out_chain;
+
   /**
    * file input descriptor for file upload
    *
@@ -137,9 +153,18 @@ struct oonf_stream_session {
   /*! timer for handling session timeout */
   struct oonf_timer_instance timeout;
 
-  /*! input buffer for session */
+  /**
+   * input buffer for session, use oonf_stream_get_input() and
+   * oonf_stream_consume_input() to parse it in place
+   */
   struct autobuf in;
 
+  /*! number of bytes at the start of the input buffer already consumed */
+  size_t _in_offset;
+
+  /*! number of bytes requested from the kernel by the next read */
+  size_t _read_size;
+
   /**
    * true if session user want to send before receiving anything. Will trigger
    * an empty read even as soon as session is connected
@@ -230,7 +255,8 @@ struct oonf_stream_config {
    */
   /**
    * Callback to notify that the user asked scheduler to write
-   * data, but outgoing buffer is empty
+   * data, but outgoing buffer is empty. It is also called for sessions
+   * in SEND_AND_QUIT state, which can only be switched to CLEANUP.
    * @param session stream session
    * @return stream session status code
    */
@@ -319,6 +345,9 @@ EXPORT void oonf_stream_close_all_sessions(struct oonf_stream_socket *stream_soc
 EXPORT struct oonf_stream_session *oonf_stream_connect_to(
   struct oonf_stream_socket *, const union netaddr_socket *remote);
 EXPORT void oonf_stream_flush(struct oonf_stream_session *con);
+EXPORT void oonf_stream_consume_input(struct oonf_stream_session *con, size_t len);
+EXPORT int oonf_stream_queue_output(struct oonf_stream_session *con);
+EXPORT int oonf_stream_queue_memcpy(struct oonf_stream_session *con, const void *p, size_t len);
 
 EXPORT void oonf_stream_set_timeout(struct oonf_stream_session *con, uint64_t timeout);
 EXPORT void oonf_stream_close(struct oonf_stream_session *con);
@@ -331,4 +360,46 @@ EXPORT void oonf_stream_copy_managed_config(
   struct oonf_stream_managed_config *dst, struct oonf_stream_managed_config *src);
 EXPORT void oonf_stream_free_managed_config(struct oonf_stream_managed_config *config);
 
+/**
+ * @param con stream session
+ * @return pointer to first unconsumed byte of the input buffer,
+ *   the input is always zero terminated
+ */
+static INLINE char *
+oonf_stream_get_input(struct oonf_stream_session *con) {
+  return abuf_getptr(&con->in) + con->_in_offset;
+}
+
+/**
+ * @param con stream session
+ * @return number of unconsumed bytes in the input buffer
+ */
+static INLINE size_t
+oonf_stream_get_input_length(struct oonf_stream_session *con) {
+  return abuf_getlen(&con->in) - con->_in_offset;
+}
+
+/**
+ * @param con stream session
+ * @return number of bytes waiting to be sent to the peer
+ */
+static INLINE size_t
+oonf_stream_get_output_length(struct oonf_stream_session *con) {
+  return abuf_chain_getlen(&con->_out_chain) + abuf_getlen(&con->out);
+}
+
+/**
+ * Move the output buffer of a session behind the data already waiting
+ * for the kernel, so further output can be appended to the chained
+ * output buffer directly. Data written into the output buffer later
+ * will be sent behind the content of the chain.
+ * @param con stream session
+ * @return chained output buffer of the session,
+ *   NULL if an out-of-memory error happened
+ */
+static INLINE struct abuf_chain *
+oonf_stream_get_output_chain(struct oonf_stream_session *con) {
+  return oonf_stream_queue_output(con) ? NULL : &con->_out_chain;
+}
+
 #endif /* OONF_STREAM_SOCKET_H_ */
@@ -80,7 +80,9 @@ static int _cb_telnet_init(struct oonf_stream_session *);
 static void _cb_telnet_cleanup(struct oonf_stream_session *);
 static void _cb_telnet_create_error(struct oonf_stream_session *, enum oonf_stream_errors);
 static enum oonf_stream_session_state _cb_telnet_receive_data(struct oonf_stream_session *);
+static enum oonf_stream_session_state _cb_telnet_buffer_underrun(struct oonf_stream_session *);
 static enum oonf_telnet_result _telnet_handle_command(struct oonf_telnet_data *);
+static void _reset_output(struct oonf_telnet_data *data, size_t len, size_t chain_len);
 static struct oonf_telnet_command *_check_telnet_command_acl(
   struct oonf_telnet_data *data, struct oonf_telnet_command *cmd);
 
@@ -161,6 +163,7 @@ static struct oonf_stream_managed _telnet_managed = {
       .cleanup_session = _cb_telnet_cleanup,
       .receive_data = _cb_telnet_receive_data,
       .create_error = _cb_telnet_create_error,
+      .buffer_underrun = _cb_telnet_buffer_underrun,
     },
 };
 
@@ -245,31 +248,114 @@ oonf_telnet_stop(struct oonf_telnet_data *data, bool print_prompt) {
 enum oonf_telnet_result
 oonf_telnet_execute(const char *cmd, const char *para, struct autobuf *out, struct netaddr *remote)
 {
-  struct oonf_telnet_cleanup *handler, *it;
   struct oonf_telnet_session session;
   enum oonf_telnet_result result;
 
-  memset(&session, 0, sizeof(session));
-  session.data.command = cmd;
-  session.data.parameter = para;
-  session.data.out = out;
-  session.data.remote = remote;
+  result = oonf_telnet_execute_start(&session, cmd, para, out, remote);
+  while (result == TELNET_RESULT_CONTINOUS && session.data.underrun_handler) {
+    /* there is no socket to wait for, generate all chunks of the output now */
+    result = oonf_telnet_execute_continue(&session);
+  }
+  oonf_telnet_execute_stop(&session);
+  return result;
+}
 
-  list_init_head(&session.data.cleanup_list);
+/**
+ * Start the execution of a telnet command without a telnet socket.
+ * A command with an underrun handler can be continued step by step
+ * with oonf_telnet_execute_continue(), oonf_telnet_execute_stop()
+ * must always be called afterwards.
+ * @param session telnet session object, will be initialized by this function
+ *   and must not be moved until the execution has been stopped
+ * @param cmd pointer to name of command
+ * @param para pointer to parameter string
+ * @param out buffer for output of command
+ * @param remote pointer to address which triggers the execution
+ * @return result of telnet command
+ */
+enum oonf_telnet_result
+oonf_telnet_execute_start(struct oonf_telnet_session *session, const char *cmd, const char *para,
+  struct autobuf *out, struct netaddr *remote) {
+  enum oonf_telnet_result result;
+
+  memset(session, 0, sizeof(*session));
+  session->data.command = cmd;
+  session->data.parameter = para;
+  session->data.out = out;
+  session->data.remote = remote;
 
-  result = _telnet_handle_command(&session.data);
-  _call_stop_handler(&session.data);
+  list_init_head(&session->data.cleanup_list);
+
+  result = _telnet_handle_command(&session->data);
+  return abuf_has_failed(session->data.out) ? TELNET_RESULT_INTERNAL_ERROR : result;
+}
+
+/**
+ * Generate the next part of the output of a continuous telnet command
+ * started with oonf_telnet_execute_start()
+ * @param session telnet session object
+ * @return TELNET_RESULT_CONTINOUS if more output will follow,
+ *   any other value if the output is complete
+ */
+enum oonf_telnet_result
+oonf_telnet_execute_continue(struct oonf_telnet_session *session) {
+  enum oonf_telnet_result result;
+
+  if (!session->data.underrun_handler) {
+    return TELNET_RESULT_ACTIVE;
+  }
+
+  result = session->data.underrun_handler(&session->data);
+  return abuf_has_failed(session->data.out) ? TELNET_RESULT_INTERNAL_ERROR : result;
+}
+
+/**
+ * Stop a telnet command started with oonf_telnet_execute_start()
+ * and call all its cleanup handlers
+ * @param session telnet session object
+ */
+void
+oonf_telnet_execute_stop(struct oonf_telnet_session *session) {
+  struct oonf_telnet_cleanup *handler, *it;
+
+  _call_stop_handler(&session->data);
 
   /* call all cleanup handlers */
-  list_for_each_element_safe(&session.data.cleanup_list, handler, node, it) {
+  list_for_each_element_safe(&session->data.cleanup_list, handler, node, it) {
     /* remove from list first */
     oonf_telnet_remove_cleanup(handler);
 
     /* after this command the handler pointer might not be valid anymore */
     handler->cleanup_handler(handler);
   }
+}
 
-  return abuf_has_failed(session.data.out) ? TELNET_RESULT_INTERNAL_ERROR : result;
+/**
+ * Get the generation number of the output of a telnet command
+ * @param cmd pointer to command
+ * @param para pointer to parameter string
+ * @param remote address of remote client
+ * @return generation number, 0 if the command is unknown, forbidden
+ *   or its output cannot be cached
+ */
+uint64_t
+oonf_telnet_get_generation(const char *cmd, const char *para, struct netaddr *remote) {
+  struct oonf_telnet_command *command;
+  struct oonf_telnet_data data;
+
+  memset(&data, 0, sizeof(data));
+  data.command = cmd;
+  data.parameter = para;
+  data.remote = remote;
+
+  command = avl_find_element(&_telnet_cmd_tree, cmd, command, _node);
+  if (command) {
+    command = _check_telnet_command_acl(&data, command);
+  }
+  if (command == NULL || command->generation_handler == NULL) {
+    return 0;
+  }
+  return command->generation_handler(&data);
 }
 
 /**
@@ -311,6 +397,7 @@ _cb_telnet_init(struct oonf_stream_session *session) {
 
   telnet_session->data.show_echo = true;
   telnet_session->data.stop_handler = NULL;
+  telnet_session->data.underrun_handler = NULL;
   telnet_session->data.timeout_value = 120000;
   telnet_session->data.out = &telnet_session->session.out;
   telnet_session->data.remote = &telnet_session->session.remote_address;
@@ -381,6 +468,7 @@ _call_stop_handler(struct oonf_telnet_data *data) {
      */
     stop_handler = data->stop_handler;
     data->stop_handler = NULL;
+    data->underrun_handler = NULL;
 
     /* call stop handler */
     stop_handler(data);
@@ -398,21 +486,23 @@ _cb_telnet_receive_data(struct oonf_stream_session *session) {
   enum oonf_telnet_result cmd_result;
   bool processedCommand = false;
   bool chainCommands = false;
-  char *eol;
+  char *line, *eol;
+  size_t chain_len;
   int len;
 
   /* get telnet session pointer */
   telnet_session = (struct oonf_telnet_session *)session;
 
   /* loop over input */
-  while (abuf_getlen(&session->in) > 0) {
+  while (oonf_stream_get_input_length(session) > 0) {
     char *para = NULL, *cmd = NULL, *next = NULL;
 
     /* search for end of line */
-    eol = memchr(abuf_getptr(&session->in), '\n', abuf_getlen(&session->in));
+    line = oonf_stream_get_input(session);
+    eol = memchr(line, '\n', oonf_stream_get_input_length(session));
     if (eol) {
       /* terminate line with a 0 */
-      if (eol != abuf_getptr(&session->in) && eol[-1] == '\r') {
+      if (eol != line && eol[-1] == '\r') {
         eol[-1] = 0;
       }
       *eol++ = 0;
@@ -423,8 +513,8 @@ _cb_telnet_receive_data(struct oonf_stream_session *session) {
     }
 
     /* handle line */
-    OONF_DEBUG(LOG_TELNET, "Interactive console: %s\n", abuf_getptr(&session->in));
-    cmd = abuf_getptr(&session->in);
+    OONF_DEBUG(LOG_TELNET, "Interactive console: %s\n", line);
+    cmd = line;
     processedCommand = true;
 
     if (cmd[0] == '/') {
@@ -432,6 +522,9 @@ _cb_telnet_receive_data(struct oonf_stream_session *session) {
       chainCommands = true;
     }
     while (cmd) {
+      /* let commands append to the output chain of the session directly */
+      telnet_session->data.out_chain = oonf_stream_get_output_chain(session);
+      chain_len = telnet_session->data.out_chain ? abuf_chain_getlen(telnet_session->data.out_chain) : 0;
       len = abuf_getlen(&session->out);
 
       /* handle difference between multicommand and singlecommand mode */
@@ -463,7 +556,8 @@ _cb_telnet_receive_data(struct oonf_stream_session *session) {
         }
 
         cmd_result = _telnet_handle_command(&telnet_session->data);
-        if (abuf_has_failed(telnet_session->data.out)) {
+        if (abuf_has_failed(telnet_session->data.out) ||
+            (telnet_session->data.out_chain && abuf_chain_has_failed(telnet_session->data.out_chain))) {
           cmd_result = TELNET_RESULT_INTERNAL_ERROR;
         }
 
@@ -474,15 +568,16 @@ _cb_telnet_receive_data(struct oonf_stream_session *session) {
             telnet_session->data.show_echo = false;
             break;
           case _TELNET_RESULT_UNKNOWN_COMMAND:
-            abuf_setlen(&session->out, len);
+            _reset_output(&telnet_session->data, len, chain_len);
             abuf_appendf(&session->out, "Error, unknown command '%s'\n", cmd);
             break;
           case TELNET_RESULT_QUIT:
+            telnet_session->data.out_chain = NULL;
             return STREAM_SESSION_SEND_AND_QUIT;
           case TELNET_RESULT_INTERNAL_ERROR:
           default:
             /* reset stream */
-            abuf_setlen(&session->out, len);
+            _reset_output(&telnet_session->data, len, chain_len);
             abuf_appendf(&session->out, "Error in autobuffer during command '%s'.\n", cmd);
             break;
         }
@@ -491,13 +586,12 @@ _cb_telnet_receive_data(struct oonf_stream_session *session) {
           abuf_puts(&session->out, "\n");
         }
       }
+      telnet_session->data.out_chain = NULL;
       cmd = next;
     }
 
-    /* remove line from input buffer */
-    if (eol) {
-      abuf_pull(&session->in, eol - abuf_getptr(&session->in));
-    }
+    /* remove line from input buffer, a last line without newline is consumed completely */
+    oonf_stream_consume_input(session, eol ? (size_t)(eol - line) : oonf_stream_get_input_length(session));
 
     if (chainCommands) {
       /* end of multiple command line */
@@ -516,6 +610,41 @@ _cb_telnet_receive_data(struct oonf_stream_session *session) {
   return STREAM_SESSION_ACTIVE;
 }
 
+/**
+ * Handler for an empty output buffer of a telnet session,
+ * asks a continuous command for the next part of its output
+ * @param session pointer to TCP session
+ * @return TCP session state
+ */
+static enum oonf_stream_session_state
+_cb_telnet_buffer_underrun(struct oonf_stream_session *session) {
+  struct oonf_telnet_session *telnet_session;
+  enum oonf_telnet_result result;
+
+  /* get telnet session pointer */
+  telnet_session = (struct oonf_telnet_session *)session;
+
+  if (telnet_session->data.underrun_handler == NULL) {
+    return session->state;
+  }
+
+  telnet_session->data.out_chain = oonf_stream_get_output_chain(session);
+  result = telnet_session->data.underrun_handler(&telnet_session->data);
+  telnet_session->data.out_chain = NULL;
+  if (result == TELNET_RESULT_CONTINOUS) {
+    return session->state;
+  }
+
+  /* output of continuous command is complete */
+  _call_stop_handler(&telnet_session->data);
+  telnet_session->data.show_echo = true;
+
+  if (session->state == STREAM_SESSION_ACTIVE) {
+    abuf_puts(&session->out, "\n> ");
+  }
+  return session->state;
+}
+
 /**
  * Helper function to call telnet command handler
  * @param data pointer to telnet data
@@ -540,6 +669,20 @@ _telnet_handle_command(struct oonf_telnet_data *data) {
   return cmd->handler(data);
 }
 
+/**
+ * Remove the output of a failed telnet command
+ * @param data pointer to telnet data
+ * @param len length of output buffer before the command
+ * @param chain_len length of chained output buffer before the command
+ */
+static void
+_reset_output(struct oonf_telnet_data *data, size_t len, size_t chain_len) {
+  abuf_setlen(data->out, len);
+  if (data->out_chain) {
+    abuf_chain_setlen(data->out_chain, chain_len);
+  }
+}
+
 /**
  * Checks for existing (and allowed) telnet command.
  * Either name or cmd should be NULL, but not both.
@@ -46,6 +46,7 @@
 #ifndef OONF_TELNET_H_
 #define OONF_TELNET_H_
 
+#include "common/autobuf_chain.h"
 #include "common/avl.h"
 #include "common/common_types.h"
 #include "common/list.h"
@@ -111,6 +112,13 @@ struct oonf_telnet_data {
   /*! output buffer for telnet commands */
   struct autobuf *out;
 
+  /**
+   * chained output buffer of the telnet session, NULL if not available.
+   * Only valid during the call of a command or underrun handler, everything
+   * written into it is sent before the content of the output buffer.
+   */
+  struct abuf_chain *out_chain;
+
   /*! current telnet command */
   const char *command;
 
@@ -129,6 +137,15 @@ struct oonf_telnet_data {
    */
   void (*stop_handler)(struct oonf_telnet_data *data);
 
+  /**
+   * Callback triggered when the output buffer ran empty while a
+   * continuous command still generates its output step by step
+   * @param data this telnet data object
+   * @return TELNET_RESULT_CONTINOUS if more output will follow,
+   *   any other value if the output is complete
+   */
+  enum oonf_telnet_result (*underrun_handler)(struct oonf_telnet_data *data);
+
   /*! custom data for stop handler */
   void *stop_data[4];
 
@@ -192,6 +209,15 @@ struct oonf_telnet_command {
    */
   enum oonf_telnet_result (*help_handler)(struct oonf_telnet_data *con);
 
+  /**
+   * callback to get the generation number of the data the command would
+   * output for its parameters. The output of the command does not change
+   * as long as the generation number stays the same.
+   * @param con telnet data
+   * @return generation number, 0 if the output cannot be cached
+   */
+  uint64_t (*generation_handler)(struct oonf_telnet_data *con);
+
   /*! node for tree of telnet commands */
   struct avl_node _node;
 };
@@ -203,6 +229,11 @@ EXPORT void oonf_telnet_stop(struct oonf_telnet_data *data, bool print_prompt);
 
 EXPORT enum oonf_telnet_result oonf_telnet_execute(
   const char *cmd, const char *para, struct autobuf *out, struct netaddr *remote);
+EXPORT enum oonf_telnet_result oonf_telnet_execute_start(struct oonf_telnet_session *session, const char *cmd,
+  const char *para, struct autobuf *out, struct netaddr *remote);
+EXPORT enum oonf_telnet_result oonf_telnet_execute_continue(struct oonf_telnet_session *session);
+EXPORT void oonf_telnet_execute_stop(struct oonf_telnet_session *session);
+EXPORT uint64_t oonf_telnet_get_generation(const char *cmd, const char *para, struct netaddr *remote);
 
 /**
  * Add a cleanup handler to a telnet session
@@ -239,4 +270,16 @@ oonf_telnet_flush_session(struct oonf_telnet_data *data) {
   }
 }
 
+/**
+ * @param data pointer to telnet data
+ * @return number of bytes of the telnet session waiting to be sent
+ */
+static INLINE size_t
+oonf_telnet_get_output_length(struct oonf_telnet_data *data) {
+  struct oonf_telnet_session *session;
+
+  session = container_of(data, struct oonf_telnet_session, data);
+  return oonf_stream_get_output_length(&session->session);
+}
+
 #endif /* OONF_TELNET_H_ */
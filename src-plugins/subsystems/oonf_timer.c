@@ -65,6 +65,7 @@ static int _init(void);
 static void _cleanup(void);
 
 static void _calc_clock(struct oonf_timer_instance *timer, uint64_t rel_time);
+static uint64_t _coalesce_clock(uint64_t clock, uint64_t slack);
 static int _avlcomp_timer(const void *p1, const void *p2);
 
 /* tree of all timers */
@@ -73,6 +74,9 @@ static struct avl_tree _timer_tree;
 /* true if scheduler is active */
 static bool _scheduling_now;
 
+/* number of scheduler runs that fired at least one timer */
+static uint64_t _wakeups;
+
 /* List of timer classes */
 static struct list_entity _timer_info_list;
 
@@ -246,9 +250,11 @@ void
 oonf_timer_walk(void) {
   struct oonf_timer_instance *timer;
   struct oonf_timer_class *info;
-  uint64_t start_time, end_time;
+  uint64_t start_time, end_time, duration;
+  bool fired;
 
   _scheduling_now = true;
+  fired = false;
 
   while (!avl_is_empty(&_timer_tree)) {
     timer = avl_first_element(&_timer_tree, timer, _node);
@@ -258,6 +264,7 @@ oonf_timer_walk(void) {
     }
 
     OONF_DEBUG(LOG_TIMER, "TIMER: fire '%s' at clocktick %" PRIu64 "\n", timer->class->name, timer->_clock);
+    fired = true;
 
     /*
      * The timer->info pointer is invalidated by oonf_timer_stop()
@@ -268,6 +275,7 @@ oonf_timer_walk(void) {
 
     /* update statistics */
     info->_stat_fired++;
+    histogram_add(&info->_stat_lateness, (oonf_clock_getNow() - timer->_clock) * 1000ull);
 
     if (timer->_period == 0) {
       /* stop now, the data structure might not be available anymore later */
@@ -275,12 +283,15 @@ oonf_timer_walk(void) {
     }
 
     /* This timer is expired, call into the provided callback function */
-    os_clock_gettime64(&start_time);
+    os_clock_gettime64_ns(&start_time);
     timer->class->callback(timer);
-    os_clock_gettime64(&end_time);
+    os_clock_gettime64_ns(&end_time);
+
+    duration = (end_time - start_time) / 1000ull;
+    histogram_add(&info->_stat_duration, duration);
 
-    if (end_time - start_time > OONF_TIMER_SLICE) {
-      OONF_WARN(LOG_TIMER, "Timer %s scheduling took %" PRIu64 " ms", timer->class->name, end_time - start_time);
+    if (duration > OONF_TIMER_SLICE * 1000ull) {
+      OONF_WARN(LOG_TIMER, "Timer %s scheduling took %" PRIu64 " ms", info->name, duration / 1000);
       info->_stat_long++;
     }
 
@@ -301,6 +312,9 @@ oonf_timer_walk(void) {
     }
   }
 
+  if (fired) {
+    _wakeups++;
+  }
   _scheduling_now = false;
 }
 
@@ -319,6 +333,14 @@ oonf_timer_getNextEvent(void) {
   return first->_clock;
 }
 
+/**
+ * @return number of times the scheduler fired at least one timer
+ */
+uint64_t
+oonf_timer_get_wakeups(void) {
+  return _wakeups;
+}
+
 /**
  * get list of active timer classes
  * @return timer class list
@@ -356,6 +378,33 @@ _calc_clock(struct oonf_timer_instance *timer, uint64_t rel_time) {
   /* round up to next timeslice */
   timer->_clock += OONF_TIMER_SLICE;
   timer->_clock -= (timer->_clock % OONF_TIMER_SLICE);
+
+  if (timer->class->slack >= OONF_TIMER_SLICE) {
+    timer->_clock = _coalesce_clock(timer->_clock, timer->class->slack);
+  }
+}
+
+/**
+ * Move the expiration of a timer to a deadline shared with other timers
+ * @param clock absolute time when the timer should fire, aligned to a timeslice
+ * @param slack maximum time the timer might be delayed
+ * @return absolute time when the timer will fire
+ */
+static uint64_t
+_coalesce_clock(uint64_t clock, uint64_t slack) {
+  struct oonf_timer_instance key, *next;
+  uint64_t granularity;
+
+  /* join the next scheduled timer if it fires within the slack */
+  key._clock = clock;
+  next = avl_find_ge_element(&_timer_tree, &key, next, _node);
+  if (next != NULL && next->_clock <= clock + slack) {
+    return next->_clock;
+  }
+
+  /* align to a multiple of the slack so that later timers can join this one */
+  granularity = slack - (slack % OONF_TIMER_SLICE);
+  return ((clock + granularity - 1) / granularity) * granularity;
 }
 
 /**
@@ -48,6 +48,7 @@
 
 #include "common/avl.h"
 #include "common/common_types.h"
+#include "common/histogram.h"
 #include "common/list.h"
 
 #include "subsystems/oonf_clock.h"
@@ -80,6 +81,14 @@ struct oonf_timer_class {
   /*! true if this is a class of periodic timers */
   bool periodic;
 
+  /**
+   * time in milliseconds a timer of this class might fire later than
+   * requested, allows the scheduler to merge its expiration with other
+   * timers. Should not be used for timers that rely on jitter.
+   * 0 (or anything smaller than a timeslice) disables coalescing.
+   */
+  uint64_t slack;
+
   /*! Number of times the timer is currently running */
   uint32_t _stat_usage;
 
@@ -92,6 +101,12 @@ struct oonf_timer_class {
   /*! number of times the timer took more than a timeslice */
   uint32_t _stat_long;
 
+  /*! duration of timer callbacks in microseconds */
+  struct histogram _stat_duration;
+
+  /*! time between scheduled and real firing of timers in microseconds */
+  struct histogram _stat_lateness;
+
   /*! pointer to timer currently in callback */
   struct oonf_timer_instance *_timer_in_callback;
 
@@ -133,6 +148,7 @@ EXPORT void oonf_timer_start_ext(struct oonf_timer_instance *timer, uint64_t fir
 EXPORT void oonf_timer_stop(struct oonf_timer_instance *);
 
 EXPORT uint64_t oonf_timer_getNextEvent(void);
+EXPORT uint64_t oonf_timer_get_wakeups(void);
 
 EXPORT struct list_entity *oonf_timer_get_list(void);
 
@@ -222,4 +238,22 @@ oonf_timer_get_long(struct oonf_timer_class *tc) {
   return tc->_stat_long;
 }
 
+/**
+ * @param tc timer class
+ * @return histogram of callback durations in microseconds
+ */
+static INLINE const struct histogram *
+oonf_timer_get_duration(struct oonf_timer_class *tc) {
+  return &tc->_stat_duration;
+}
+
+/**
+ * @param tc timer class
+ * @return histogram of firing lateness in microseconds
+ */
+static INLINE const struct histogram *
+oonf_timer_get_lateness(struct oonf_timer_class *tc) {
+  return &tc->_stat_lateness;
+}
+
 #endif /* OONF_TIMER_H_ */
@@ -45,6 +45,7 @@
 
 #include "subsystems/oonf_viewer.h"
 #include "common/autobuf.h"
+#include "common/autobuf_chain.h"
 #include "common/common_types.h"
 #include "common/json.h"
 #include "common/template.h"
@@ -65,6 +66,9 @@ static const char _telnet_help[] = "\n"
                                    "Use '" OONF_VIEWER_JSON_RAW_FORMAT "' as the first parameter"
                                    " to generate JSON output of all keys/value pairs"
                                    "  without isoprefixes for numbers.\n"
+                                   "Use '" OONF_VIEWER_CBOR_FORMAT "' as the first parameter"
+                                   " to generate the JSON data as binary CBOR (RFC 7049)"
+                                   " with raw numbers.\n"
                                    "Use '" OONF_VIEWER_HEAD_FORMAT "' as the first parameter to"
                                    " generate a headline for the table.\n"
                                    "Use '" OONF_VIEWER_RAW_FORMAT "' as the first parameter to"
@@ -72,6 +76,17 @@ static const char _telnet_help[] = "\n"
                                    "You can also add a custom template (text with keys inside)"
                                    " as the last parameter instead.\n";
 
+/* output formats that can be put in front of the template name */
+static const char *_formats[] = {
+  OONF_VIEWER_HEAD_FORMAT,
+  OONF_VIEWER_JSON_FORMAT,
+  OONF_VIEWER_RAW_FORMAT,
+  OONF_VIEWER_JSON_RAW_FORMAT,
+  OONF_VIEWER_DATA_FORMAT,
+  OONF_VIEWER_DATA_RAW_FORMAT,
+  OONF_VIEWER_CBOR_FORMAT,
+};
+
 /* subsystem definition */
 static struct oonf_subsystem _oonf_viewer_subsystem = {
   .name = OONF_VIEWER_SUBSYSTEM,
@@ -108,12 +123,39 @@ _cleanup(void) {}
 void
 oonf_viewer_output_prepare(struct oonf_viewer_template *template, struct abuf_template_storage *storage,
   struct autobuf *out, const char *format) {
+  oonf_viewer_output_prepare_chain(template, storage, out, NULL, format);
+}
+
+/**
+ * Prepare a viewer template for output into a chained output buffer.
+ * Binary CBOR output is still written to the normal output buffer.
+ * The create_json and create_raw variable should be initialized
+ * before calling this function.
+ * @param template pointer to viewer template
+ * @param storage pointer to autobuffer template storage that should
+ *     be printed
+ * @param out pointer to output buffer
+ * @param out_chain pointer to chained output buffer, NULL to use out
+ * @param format pointer to template for output, not used for JSON output
+ */
+void
+oonf_viewer_output_prepare_chain(struct oonf_viewer_template *template, struct abuf_template_storage *storage,
+  struct autobuf *out, struct abuf_chain *out_chain, const char *format) {
   template->out = out;
+  template->out_chain = template->create_cbor ? NULL : out_chain;
 
   if (template->create_json) {
     /* JSON format */
     template->_storage = NULL;
-    json_init_session(&template->_json, out);
+    if (template->create_cbor) {
+      json_init_cbor_session(&template->_json, out);
+    }
+    else if (template->out_chain) {
+      json_init_chain_session(&template->_json, template->out_chain);
+    }
+    else {
+      json_init_session(&template->_json, out);
+    }
 
     /* start wrapper object */
     if (!template->create_only_data) {
@@ -142,7 +184,11 @@ oonf_viewer_output_prepare(struct oonf_viewer_template *template, struct abuf_te
  */
 void
 oonf_viewer_output_print_line(struct oonf_viewer_template *template) {
-  if (!template->create_json) {
+  if (!template->create_json && template->out_chain) {
+    abuf_chain_add_template(template->out_chain, template->_storage, false);
+    abuf_chain_puts(template->out_chain, "\n");
+  }
+  else if (!template->create_json) {
     abuf_add_template(template->out, template->_storage, false);
     abuf_puts(template->out, "\n");
   }
@@ -222,6 +268,7 @@ oonf_viewer_print_help(
  * corresponding template command. This function both prepares and
  * finishes a viewer template.
  * @param out pointer to output buffer
+ * @param out_chain pointer to chained output buffer, NULL to use out
  * @param storage pointer to autobuffer template storage
  * @param param parameter of telnet call
  * @param templates pointer to array of viewer templates
@@ -229,8 +276,8 @@ oonf_viewer_print_help(
  * @return -1 if an error happened, 0 otherwise
  */
 int
-oonf_viewer_call_subcommands(struct autobuf *out, struct abuf_template_storage *storage, const char *param,
-  struct oonf_viewer_template *templates, size_t count) {
+oonf_viewer_call_subcommands(struct autobuf *out, struct abuf_chain *out_chain,
+  struct abuf_template_storage *storage, const char *param, struct oonf_viewer_template *templates, size_t count) {
   const char *next = NULL, *ptr = NULL;
   int result = 0;
   size_t i;
@@ -238,6 +285,7 @@ oonf_viewer_call_subcommands(struct autobuf *out, struct abuf_template_storage *
   bool json = false;
   bool raw = false;
   bool data = false;
+  bool cbor = false;
 
   if ((next = str_hasnextword(param, OONF_VIEWER_HEAD_FORMAT))) {
     head = true;
@@ -261,6 +309,11 @@ oonf_viewer_call_subcommands(struct autobuf *out, struct abuf_template_storage *
     raw = true;
     data = true;
   }
+  else if ((next = str_hasnextword(param, OONF_VIEWER_CBOR_FORMAT))) {
+    json = true;
+    raw = true;
+    cbor = true;
+  }
   else {
     next = param;
   }
@@ -270,10 +323,15 @@ oonf_viewer_call_subcommands(struct autobuf *out, struct abuf_template_storage *
       templates[i].create_json = json;
       templates[i].create_raw = raw;
       templates[i].create_only_data = data;
+      templates[i].create_cbor = cbor;
 
-      oonf_viewer_output_prepare(&templates[i], storage, out, ptr);
+      oonf_viewer_output_prepare_chain(&templates[i], storage, out, out_chain, ptr);
 
-      if (head) {
+      if (head && templates[i].out_chain) {
+        abuf_chain_add_template(templates[i].out_chain, templates[i]._storage, true);
+        abuf_chain_puts(templates[i].out_chain, "\n");
+      }
+      else if (head) {
         abuf_add_template(out, templates[i]._storage, true);
         abuf_puts(out, "\n");
       }
@@ -290,28 +348,65 @@ oonf_viewer_call_subcommands(struct autobuf *out, struct abuf_template_storage *
 }
 
 /**
- * Handles a telnet command for a viewer including error handling
- * @param out output buffer
+ * Get the generation number of the data a viewer template call
+ * would print.
+ * @param param parameter of telnet call
+ * @param templates pointer to array of viewer templates
+ * @param count number of elements in viewer template array
+ * @return generation number, 0 if the output cannot be cached
+ */
+uint64_t
+oonf_viewer_get_generation(const char *param, struct oonf_viewer_template *templates, size_t count) {
+  const char *next;
+  size_t i;
+
+  if (param == NULL) {
+    return 0;
+  }
+
+  /* skip output format */
+  next = param;
+  for (i = 0; i < ARRAYSIZE(_formats); i++) {
+    if ((next = str_hasnextword(param, _formats[i]))) {
+      break;
+    }
+  }
+  if (next == NULL) {
+    next = param;
+  }
+
+  for (i = 0; i < count; i++) {
+    if (str_hasnextword(next, templates[i].json_name)) {
+      return templates[i].cb_generation ? templates[i].cb_generation() : 0;
+    }
+  }
+  return 0;
+}
+
+/**
+ * Handles a telnet command for a viewer including error handling.
+ * The output is written into the chained output buffer of the
+ * telnet session if it has one.
+ * @param con telnet session data
  * @param storage template storage object
  * @param cmd telnet command
- * @param param telnet parameter(s)
  * @param templates template viewer array
  * @param count number of template viewer entries
  * @return telnet return code
  */
 enum oonf_telnet_result
-oonf_viewer_telnet_handler(struct autobuf *out, struct abuf_template_storage *storage, const char *cmd,
-  const char *param, struct oonf_viewer_template *templates, size_t count)
+oonf_viewer_telnet_handler(struct oonf_telnet_data *con, struct abuf_template_storage *storage, const char *cmd,
+  struct oonf_viewer_template *templates, size_t count)
 {
   int result;
 
   /* sanity check */
-  if (param == NULL || *param == 0) {
-    abuf_appendf(out, "Error, '%s' command needs a parameter\n", cmd);
+  if (con->parameter == NULL || *con->parameter == 0) {
+    abuf_appendf(con->out, "Error, '%s' command needs a parameter\n", cmd);
   }
 
   /* call template based subcommands */
-  result = oonf_viewer_call_subcommands(out, storage, param, templates, count);
+  result = oonf_viewer_call_subcommands(con->out, con->out_chain, storage, con->parameter, templates, count);
   if (result == 0) {
     return TELNET_RESULT_ACTIVE;
   }
@@ -319,7 +414,7 @@ oonf_viewer_telnet_handler(struct autobuf *out, struct abuf_template_storage *st
     return TELNET_RESULT_INTERNAL_ERROR;
   }
 
-  abuf_appendf(out, "Unknown parameter for command '%s': %s\n", cmd, param);
+  abuf_appendf(con->out, "Unknown parameter for command '%s': %s\n", cmd, con->parameter);
   return TELNET_RESULT_ACTIVE;
 }
 
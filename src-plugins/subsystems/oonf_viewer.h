@@ -47,6 +47,7 @@
 #define OONF_VIEWER_H_
 
 #include "common/autobuf.h"
+#include "common/autobuf_chain.h"
 #include "common/common_types.h"
 #include "common/json.h"
 #include "common/template.h"
@@ -78,6 +79,9 @@
  */
 #define OONF_VIEWER_DATA_RAW_FORMAT "dataraw"
 
+/*! viewer should output the JSON data structure with raw numbers as binary CBOR */
+#define OONF_VIEWER_CBOR_FORMAT "cbor"
+
 /**
  * This struct defines a template engine command that can output both
  * table and JSON.
@@ -86,6 +90,9 @@ struct oonf_viewer_template {
   /*! output buffer */
   struct autobuf *out;
 
+  /*! chained output buffer, used instead of out for text and JSON output if not NULL */
+  struct abuf_chain *out_chain;
+
   /*! true if output should be in JSON format */
   bool create_json;
 
@@ -95,6 +102,9 @@ struct oonf_viewer_template {
   /*! true if skips the enclosing JSON brackets */
   bool create_only_data;
 
+  /*! true if JSON output should be encoded as binary CBOR */
+  bool create_cbor;
+
   /*! pointer to template data array to get key/value pairs */
   struct abuf_template_data *data;
 
@@ -117,6 +127,14 @@ struct oonf_viewer_template {
    */
   int (*cb_function)(struct oonf_viewer_template *);
 
+  /**
+   * Callback to get the generation number of the data printed by
+   * the template. NULL if the output cannot be cached, e.g. because
+   * it contains the remaining time of timers.
+   * @return generation number, 0 if not available
+   */
+  uint64_t (*cb_generation)(void);
+
   /*! internal variable for template engine storage array */
   struct abuf_template_storage *_storage;
 
@@ -126,15 +144,19 @@ struct oonf_viewer_template {
 
 EXPORT void oonf_viewer_output_prepare(struct oonf_viewer_template *template, struct abuf_template_storage *storage,
   struct autobuf *out, const char *format);
+EXPORT void oonf_viewer_output_prepare_chain(struct oonf_viewer_template *template,
+  struct abuf_template_storage *storage, struct autobuf *out, struct abuf_chain *out_chain, const char *format);
 EXPORT void oonf_viewer_output_print_line(struct oonf_viewer_template *template);
 EXPORT void oonf_viewer_output_finish(struct oonf_viewer_template *template);
 
 EXPORT void oonf_viewer_print_help(
   struct autobuf *out, const char *parameter, struct oonf_viewer_template *template, size_t count);
-EXPORT int oonf_viewer_call_subcommands(struct autobuf *out, struct abuf_template_storage *storage, const char *param,
-  struct oonf_viewer_template *templates, size_t count);
-EXPORT enum oonf_telnet_result oonf_viewer_telnet_handler(struct autobuf *out, struct abuf_template_storage *storage,
-  const char *cmd, const char *param, struct oonf_viewer_template *templates, size_t count);
+EXPORT int oonf_viewer_call_subcommands(struct autobuf *out, struct abuf_chain *out_chain,
+  struct abuf_template_storage *storage, const char *param, struct oonf_viewer_template *templates, size_t count);
+EXPORT enum oonf_telnet_result oonf_viewer_telnet_handler(struct oonf_telnet_data *con,
+  struct abuf_template_storage *storage, const char *cmd, struct oonf_viewer_template *templates, size_t count);
+EXPORT uint64_t oonf_viewer_get_generation(
+  const char *param, struct oonf_viewer_template *templates, size_t count);
 EXPORT enum oonf_telnet_result oonf_viewer_telnet_help(
   struct autobuf *out, const char *cmd, const char *parameter, struct oonf_viewer_template *template, size_t count);
 
@@ -63,6 +63,30 @@
 /* pre-definition of structs */
 struct os_fd;
 struct os_fd_select;
+struct iovec;
+
+/**
+ * Statistics of a socket event handler
+ */
+struct os_fd_select_stats {
+  /*! number of calls to wait for socket events */
+  uint64_t wait_calls;
+
+  /*! number of socket events delivered by wait calls */
+  uint64_t events;
+
+  /*! number of wait calls that filled the whole event array */
+  uint64_t full_batches;
+
+  /*! number of calls to change the registered events of a socket */
+  uint64_t ctl_calls;
+
+  /*! number of event changes skipped because nothing changed */
+  uint64_t ctl_skipped;
+
+  /*! current number of events a single wait call can return */
+  uint32_t batch_size;
+};
 
 /* pre-declare inlines */
 static INLINE int os_fd_init(struct os_fd *, int fd);
@@ -81,12 +105,16 @@ static INLINE int os_fd_event_socket_read(struct os_fd_select *, struct os_fd *,
 static INLINE int os_fd_event_is_read(struct os_fd *);
 static INLINE int os_fd_event_socket_write(struct os_fd_select *, struct os_fd *, bool want_write);
 static INLINE int os_fd_event_is_write(struct os_fd *);
+static INLINE int os_fd_event_socket_edge_triggered(struct os_fd_select *, struct os_fd *, bool edge_triggered);
+static INLINE bool os_fd_event_is_edge_triggered(struct os_fd *);
+static INLINE int os_fd_event_socket_rearm(struct os_fd_select *, struct os_fd *);
 static INLINE int os_fd_event_socket_remove(struct os_fd_select *, struct os_fd *);
 static INLINE int os_fd_event_set_deadline(struct os_fd_select *, uint64_t deadline);
 static INLINE uint64_t os_fd_event_get_deadline(struct os_fd_select *);
 static INLINE int os_fd_event_wait(struct os_fd_select *);
 static INLINE struct os_fd *os_fd_event_get(struct os_fd_select *, int idx);
 static INLINE int os_fd_event_remove(struct os_fd_select *);
+static INLINE const struct os_fd_select_stats *os_fd_event_get_stats(struct os_fd_select *);
 
 static INLINE int os_fd_connect(struct os_fd *, const union netaddr_socket *remote);
 static INLINE int os_fd_accept(struct os_fd *client, struct os_fd *server, union netaddr_socket *incoming);
@@ -95,6 +123,7 @@ static INLINE ssize_t os_fd_sendto(
   struct os_fd *, const void *buf, size_t length, const union netaddr_socket *dst, bool dont_route);
 static INLINE ssize_t os_fd_recvfrom(
   struct os_fd *, void *buf, size_t length, union netaddr_socket *source, const struct os_interface *);
+static INLINE ssize_t os_fd_writev(struct os_fd *, const struct iovec *iov, int iov_count);
 static INLINE const char *os_fd_get_loopback_name(void);
 static INLINE ssize_t os_fd_sendfile(struct os_fd *, struct os_fd *, size_t offset, size_t count);
 
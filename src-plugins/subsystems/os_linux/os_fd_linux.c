@@ -46,6 +46,7 @@
 #include <errno.h>
 #include <net/if.h>
 #include <netinet/in.h>
+#include <stdlib.h>
 #include <sys/ioctl.h>
 
 #include "common/common_types.h"
@@ -62,6 +63,8 @@
 static int _init(void);
 static void _cleanup(void);
 
+static void _grow_event_array(struct os_fd_select *sel);
+
 /* subsystem definition */
 static const char *_dependencies[] = {
   OONF_CLOCK_SUBSYSTEM,
@@ -91,6 +94,46 @@ _init(void) {
 static void
 _cleanup(void) {}
 
+/**
+ * Initialize a socket selector set
+ * @param sel socket selector set
+ * @return -1 if an error happened, 0 otherwise
+ */
+int
+os_fd_linux_event_add(struct os_fd_select *sel) {
+  memset(sel, 0, sizeof(*sel));
+
+  sel->_events = calloc(OS_FD_MIN_EVENTS, sizeof(*sel->_events));
+  if (!sel->_events) {
+    return -1;
+  }
+  sel->_event_size = OS_FD_MIN_EVENTS;
+  sel->_stats.batch_size = OS_FD_MIN_EVENTS;
+
+  sel->_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (sel->_epoll_fd < 0) {
+    free(sel->_events);
+    sel->_events = NULL;
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * Cleanup a socket selector set
+ * @param sel socket selector set
+ * @return -1 if an error happened, 0 otherwise
+ */
+int
+os_fd_linux_event_remove(struct os_fd_select *sel) {
+  free(sel->_events);
+  sel->_events = NULL;
+  sel->_event_size = 0;
+  sel->_event_count = 0;
+
+  return close(sel->_epoll_fd);
+}
+
 /**
  * wait for a network event on multiple sockets
  * @param sel socket selector set
@@ -102,15 +145,28 @@ os_fd_linux_event_wait(struct os_fd_select *sel) {
   uint64_t maxdelay;
   int i;
 
+  if (sel->_event_count == sel->_event_size) {
+    /* last call filled the whole array, there might be more events waiting */
+    _grow_event_array(sel);
+  }
+
   maxdelay = oonf_clock_get_relative(sel->deadline);
   if (maxdelay > INT32_MAX) {
     maxdelay = INT32_MAX;
   }
 
-  sel->_event_count = epoll_wait(sel->_epoll_fd, sel->_events, ARRAYSIZE(sel->_events), maxdelay);
+  sel->_event_count = epoll_wait(sel->_epoll_fd, sel->_events, sel->_event_size, maxdelay);
+  sel->_stats.wait_calls++;
 
   OONF_DEBUG(LOG_OS_SOCKET, "epoll_wait(maxdelay = %" PRIu64 "): %d", maxdelay, sel->_event_count);
 
+  if (sel->_event_count > 0) {
+    sel->_stats.events += sel->_event_count;
+    if (sel->_event_count == sel->_event_size) {
+      sel->_stats.full_batches++;
+    }
+  }
+
   for (i = 0; i < sel->_event_count; i++) {
     sock = os_fd_event_get(sel, i);
     sock->received_events = sel->_events[i].events;
@@ -133,10 +189,57 @@ os_fd_linux_event_socket_modify(struct os_fd_select *sel, struct os_fd *sock) {
   memset(&event, 0, sizeof(event));
 
   event.events = sock->wanted_events;
+  if (sock->_flags & OS_FD_EDGE_TRIGGERED) {
+    event.events |= EPOLLET;
+  }
   event.data.ptr = sock;
 
-  OONF_DEBUG(LOG_OS_SOCKET, "Modify socket %d to events 0x%x", sock->fd, sock->wanted_events);
-  return epoll_ctl(sel->_epoll_fd, EPOLL_CTL_MOD, sock->fd, &event);
+  if (event.events == sock->_registered_events) {
+    /* kernel already has this state */
+    sel->_stats.ctl_skipped++;
+    return 0;
+  }
+
+  OONF_DEBUG(LOG_OS_SOCKET, "Modify socket %d to events 0x%x", sock->fd, event.events);
+
+  sel->_stats.ctl_calls++;
+  if (epoll_ctl(sel->_epoll_fd, EPOLL_CTL_MOD, sock->fd, &event)) {
+    return -1;
+  }
+  sock->_registered_events = event.events;
+  return 0;
+}
+
+/**
+ * Double the size of the event array of a selector set
+ * (up to OS_FD_MAX_EVENTS) so a single epoll_wait() call can
+ * return more events. Keeps the old array if allocation fails.
+ * @param sel socket selector set
+ */
+static void
+_grow_event_array(struct os_fd_select *sel) {
+  struct epoll_event *events;
+  int size;
+
+  if (sel->_event_size >= OS_FD_MAX_EVENTS) {
+    return;
+  }
+
+  size = sel->_event_size * 2;
+  if (size > OS_FD_MAX_EVENTS) {
+    size = OS_FD_MAX_EVENTS;
+  }
+
+  events = realloc(sel->_events, size * sizeof(*events));
+  if (!events) {
+    OONF_WARN(LOG_OS_SOCKET, "Cannot grow epoll event array to %d events", size);
+    return;
+  }
+
+  OONF_DEBUG(LOG_OS_SOCKET, "Grow epoll event array to %d events", size);
+  sel->_events = events;
+  sel->_event_size = size;
+  sel->_stats.batch_size = size;
 }
 
 /**
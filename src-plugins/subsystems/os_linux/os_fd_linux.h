@@ -50,6 +50,7 @@
 #include <sys/sendfile.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include "subsystems/os_fd.h"
@@ -63,9 +64,19 @@
 /*! name of the loopback interface */
 #define IF_LOOPBACK_NAME "lo"
 
+/*! initial number of events a single epoll_wait() call can return */
+#define OS_FD_MIN_EVENTS 16
+
+/*! maximum number of events a single epoll_wait() call can return */
+#define OS_FD_MAX_EVENTS 1024
+
 enum os_fd_flags
 {
+  /*! socket representation contains a valid file descriptor */
   OS_FD_ACTIVE = 1,
+
+  /*! socket is registered as edge triggered */
+  OS_FD_EDGE_TRIGGERED = 2,
 };
 
 /*! linux specific socket definition */
@@ -79,21 +90,35 @@ struct os_fd {
   /*! flags which were triggered in last epoll */
   uint32_t received_events;
 
+  /*! flags currently registered with epoll */
+  uint32_t _registered_events;
+
   /*! flags for socket */
   enum os_fd_flags _flags;
 };
 
 /*! linux specific socket select definition */
 struct os_fd_select {
-  struct epoll_event _events[16];
+  /*! array for events returned by epoll_wait(), grows if it is filled */
+  struct epoll_event *_events;
+
+  /*! number of elements in event array */
+  int _event_size;
+
+  /*! number of events returned by last epoll_wait() */
   int _event_count;
 
   int _epoll_fd;
 
   uint64_t deadline;
+
+  /*! statistics of socket event handler */
+  struct os_fd_select_stats _stats;
 };
 
 /** declare non-inline linux-specific functions */
+EXPORT int os_fd_linux_event_add(struct os_fd_select *);
+EXPORT int os_fd_linux_event_remove(struct os_fd_select *);
 EXPORT int os_fd_linux_event_wait(struct os_fd_select *);
 EXPORT int os_fd_linux_event_socket_modify(struct os_fd_select *sel, struct os_fd *sock);
 EXPORT uint8_t *os_fd_linux_skip_rawsocket_prefix(uint8_t *ptr, ssize_t *len, int af_type);
@@ -314,9 +339,7 @@ os_fd_listen(struct os_fd *fd, int n) {
  */
 static INLINE int
 os_fd_event_add(struct os_fd_select *sel) {
-  memset(sel, 0, sizeof(*sel));
-  sel->_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
-  return sel->_epoll_fd < 0 ? -1 : 0;
+  return os_fd_linux_event_add(sel);
 }
 
 /**
@@ -344,6 +367,9 @@ os_fd_event_socket_add(struct os_fd_select *sel, struct os_fd *sock) {
 
   event.events = 0;
   event.data.ptr = sock;
+
+  sock->_registered_events = 0;
+  sel->_stats.ctl_calls++;
   return epoll_ctl(sel->_epoll_fd, EPOLL_CTL_ADD, sock->fd, &event);
 }
 
@@ -405,6 +431,51 @@ os_fd_event_is_write(struct os_fd *sock) {
   return (sock->received_events & EPOLLOUT) != 0;
 }
 
+/**
+ * Switch a socket in a socket event handler between level and
+ * edge triggered events. An edge triggered socket only reports
+ * new events, so its user must read/write until the socket
+ * returns EAGAIN.
+ * @param sel socket event handler
+ * @param sock socket representation
+ * @param edge_triggered true to switch socket to edge triggered events,
+ *   false for level triggered events
+ * @return -1 if an error happened, 0 otherwise
+ */
+static INLINE int
+os_fd_event_socket_edge_triggered(struct os_fd_select *sel, struct os_fd *sock, bool edge_triggered) {
+  if (edge_triggered) {
+    sock->_flags |= OS_FD_EDGE_TRIGGERED;
+  }
+  else {
+    sock->_flags &= ~OS_FD_EDGE_TRIGGERED;
+  }
+  return os_fd_linux_event_socket_modify(sel, sock);
+}
+
+/**
+ * @param sock socket representation
+ * @return true if socket is registered for edge triggered events
+ */
+static INLINE bool
+os_fd_event_is_edge_triggered(struct os_fd *sock) {
+  return (sock->_flags & OS_FD_EDGE_TRIGGERED) != 0;
+}
+
+/**
+ * Register the wanted events of a socket again, even if they did
+ * not change. This makes the kernel report an edge triggered socket
+ * again if it is still readable/writable.
+ * @param sel socket event handler
+ * @param sock socket representation
+ * @return -1 if an error happened, 0 otherwise
+ */
+static INLINE int
+os_fd_event_socket_rearm(struct os_fd_select *sel, struct os_fd *sock) {
+  sock->_registered_events = 0;
+  return os_fd_linux_event_socket_modify(sel, sock);
+}
+
 /**
  * Remove a socket fromo a socket event handler
  * @param sel socket event handler
@@ -413,6 +484,7 @@ os_fd_event_is_write(struct os_fd *sock) {
  */
 static INLINE int
 os_fd_event_socket_remove(struct os_fd_select *sel, struct os_fd *sock) {
+  sel->_stats.ctl_calls++;
   return epoll_ctl(sel->_epoll_fd, EPOLL_CTL_DEL, sock->fd, NULL);
 }
 
@@ -444,7 +516,16 @@ os_fd_event_get_deadline(struct os_fd_select *sel) {
  */
 static INLINE int
 os_fd_event_remove(struct os_fd_select *sel) {
-  return close(sel->_epoll_fd);
+  return os_fd_linux_event_remove(sel);
+}
+
+/**
+ * @param sel socket event handler
+ * @return statistics of socket event handler
+ */
+static INLINE const struct os_fd_select_stats *
+os_fd_event_get_stats(struct os_fd_select *sel) {
+  return &sel->_stats;
 }
 
 /**
@@ -548,6 +629,18 @@ os_fd_get_loopback_name(void) {
   return "lo";
 }
 
+/**
+ * Sends a list of memory blocks to a connected socket
+ * @param sock filedescriptor of socket
+ * @param iov array of memory blocks
+ * @param iov_count number of memory blocks
+ * @return same as writev()
+ */
+static INLINE ssize_t
+os_fd_writev(struct os_fd *sock, const struct iovec *iov, int iov_count) {
+  return writev(sock->fd, iov, iov_count);
+}
+
 /**
  * send data from one filedescriptor to another one. Linux compatible API
  * structure, might need a bit of work for other OS.
@@ -0,0 +1,97 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include "common/common_types.h"
+#include "core/oonf_subsystem.h"
+#include "subsystems/os_clock.h"
+
+#include "bench_stubs.h"
+
+/* first timestamp of the virtual clock, keep it away from zero */
+enum
+{
+  BENCH_CLOCK_START = 1000000,
+};
+
+/* subsystem definition */
+static struct oonf_subsystem _bench_os_clock_subsystem = {
+  .name = OONF_OS_CLOCK_SUBSYSTEM,
+  .no_logging = true,
+};
+DECLARE_OONF_PLUGIN(_bench_os_clock_subsystem);
+
+/* current time of the virtual clock in milliseconds */
+static uint64_t _now = BENCH_CLOCK_START;
+
+/**
+ * Move the virtual clock forward
+ * @param interval time in milliseconds
+ */
+void
+bench_os_clock_advance(uint64_t interval) {
+  _now += interval;
+}
+
+/**
+ * Reads the virtual time in nanoseconds
+ * @param t64 pointer to timestamp
+ * @return always 0
+ */
+int
+os_clock_linux_gettime64_ns(uint64_t *t64) {
+  *t64 = _now * 1000000ull;
+  return 0;
+}
+
+/**
+ * Reads the virtual time in milliseconds
+ * @param t64 pointer to timestamp
+ * @return always 0
+ */
+int
+os_clock_linux_gettime64(uint64_t *t64) {
+  *t64 = _now;
+  return 0;
+}
@@ -0,0 +1,421 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include "common/avl.h"
+#include "common/avl_comp.h"
+#include "common/common_types.h"
+#include "common/list.h"
+#include "common/netaddr.h"
+#include "common/string.h"
+#include "core/oonf_subsystem.h"
+#include "subsystems/oonf_class.h"
+#include "subsystems/oonf_timer.h"
+#include "subsystems/os_interface.h"
+
+#include "bench_stubs.h"
+
+/* Definitions */
+#define LOG_OS_INTERFACE _bench_os_interface_subsystem.logging
+
+/* prototypes */
+static int _init(void);
+static void _cleanup(void);
+
+static struct os_interface *_add_interface(const char *name);
+static void _remove_interface(struct os_interface *data);
+static void _cb_delayed_interface_changed(struct oonf_timer_instance *);
+
+/* subsystem definition */
+static const char *_dependencies[] = {
+  OONF_CLASS_SUBSYSTEM,
+  OONF_TIMER_SUBSYSTEM,
+};
+
+static struct oonf_subsystem _bench_os_interface_subsystem = {
+  .name = OONF_OS_INTERFACE_SUBSYSTEM,
+  .dependencies = _dependencies,
+  .dependencies_count = ARRAYSIZE(_dependencies),
+  .init = _init,
+  .cleanup = _cleanup,
+};
+DECLARE_OONF_PLUGIN(_bench_os_interface_subsystem);
+
+/* memory classes for interface data */
+static struct oonf_class _interface_data_class = {
+  .name = "network interface data",
+  .size = sizeof(struct os_interface),
+};
+
+static struct oonf_class _interface_ip_class = {
+  .name = "network interface ip",
+  .size = sizeof(struct os_interface_ip),
+};
+
+/* timer for delayed interface change handling */
+static struct oonf_timer_class _interface_change_timer = {
+  .name = "interface change",
+  .callback = _cb_delayed_interface_changed,
+};
+
+static struct avl_tree _interface_data_tree;
+static const char _ANY_INTERFACE[] = OS_INTERFACE_ANY;
+
+/* next interface index */
+static unsigned _next_index = 1;
+
+/**
+ * Initialize in-memory interface handler
+ * @return always 0
+ */
+static int
+_init(void) {
+  oonf_class_add(&_interface_data_class);
+  oonf_class_add(&_interface_ip_class);
+  oonf_timer_add(&_interface_change_timer);
+
+  avl_init(&_interface_data_tree, avl_comp_strcasecmp, false);
+  return 0;
+}
+
+/**
+ * Cleanup in-memory interface handler
+ */
+static void
+_cleanup(void) {
+  struct os_interface *data, *data_it;
+
+  avl_for_each_element_safe(&_interface_data_tree, data, _node, data_it) {
+    data->_internal.configured = false;
+    list_init_head(&data->_listeners);
+    _remove_interface(data);
+  }
+
+  oonf_timer_remove(&_interface_change_timer);
+  oonf_class_remove(&_interface_ip_class);
+  oonf_class_remove(&_interface_data_class);
+}
+
+/**
+ * Set the (single) address of an in-memory interface and
+ * trigger all its listeners.
+ * @param name interface name
+ * @param prefix address with prefix length of the interface
+ * @return interface data, NULL if out of memory
+ */
+struct os_interface *
+bench_os_interface_set_address(const char *name, const struct netaddr *prefix) {
+  struct os_interface *data, *any;
+  struct os_interface_ip *ip, *ip_it;
+  struct os_interface_listener *listener;
+
+  data = _add_interface(name);
+  if (!data) {
+    return NULL;
+  }
+
+  avl_for_each_element_safe(&data->addresses, ip, _node, ip_it) {
+    avl_remove(&data->addresses, &ip->_node);
+    oonf_class_free(&_interface_ip_class, ip);
+  }
+
+  ip = oonf_class_malloc(&_interface_ip_class);
+  if (!ip) {
+    return NULL;
+  }
+
+  memcpy(&ip->prefixed_addr, prefix, sizeof(*prefix));
+  netaddr_truncate(&ip->prefix, prefix);
+  memcpy(&ip->address, prefix, sizeof(*prefix));
+  netaddr_set_prefix_length(&ip->address, netaddr_get_maxprefix(prefix));
+  ip->interf = data;
+
+  ip->_node.key = &ip->prefixed_addr;
+  avl_insert(&data->addresses, &ip->_node);
+
+  data->_internal.configured = true;
+  data->flags.up = true;
+  data->_link_initialized = true;
+  data->_addr_initialized = true;
+
+  if (netaddr_get_address_family(prefix) == AF_INET) {
+    data->if_v4 = &ip->address;
+  }
+  else {
+    data->if_v6 = &ip->address;
+  }
+
+  list_for_each_element(&data->_listeners, listener, _node) {
+    listener->_dirty = true;
+  }
+  oonf_timer_start(&data->_change_timer, OS_INTERFACE_CHANGE_TRIGGER_INTERVAL);
+
+  /* wildcard listeners are interested in all interfaces */
+  any = avl_find_element(&_interface_data_tree, _ANY_INTERFACE, any, _node);
+  if (any) {
+    list_for_each_element(&any->_listeners, listener, _node) {
+      listener->_dirty = true;
+    }
+    oonf_timer_start(&any->_change_timer, OS_INTERFACE_CHANGE_TRIGGER_INTERVAL);
+  }
+  return data;
+}
+
+/**
+ * Add an interface event listener
+ * @param if_listener network interface listener
+ * @return interface data object, NULL if out of memory
+ */
+struct os_interface *
+os_interface_linux_add(struct os_interface_listener *if_listener) {
+  struct os_interface *data;
+
+  if (if_listener->data) {
+    return if_listener->data;
+  }
+
+  if (!if_listener->name || !if_listener->name[0]) {
+    if_listener->name = _ANY_INTERFACE;
+  }
+
+  data = _add_interface(if_listener->name);
+  if (!data) {
+    return NULL;
+  }
+
+  if_listener->data = data;
+  list_add_tail(&data->_listeners, &if_listener->_node);
+
+  if_listener->_dirty = true;
+  oonf_timer_start(&data->_change_timer, OS_INTERFACE_CHANGE_TRIGGER_INTERVAL);
+  return data;
+}
+
+/**
+ * Remove an interface event listener
+ * @param if_listener network interface listener
+ */
+void
+os_interface_linux_remove(struct os_interface_listener *if_listener) {
+  struct os_interface *data;
+
+  if (!if_listener->data) {
+    return;
+  }
+
+  data = if_listener->data;
+  if_listener->data = NULL;
+  list_remove(&if_listener->_node);
+
+  _remove_interface(data);
+}
+
+/**
+ * @return tree of in-memory interfaces
+ */
+struct avl_tree *
+os_interface_linux_get_tree(void) {
+  return &_interface_data_tree;
+}
+
+/**
+ * Trigger the event handler of an interface listener
+ * @param if_listener network interface listener
+ */
+void
+os_interface_linux_trigger_handler(struct os_interface_listener *if_listener) {
+  if_listener->_dirty = true;
+  if (!oonf_timer_is_active(&if_listener->data->_change_timer)) {
+    oonf_timer_start(&if_listener->data->_change_timer, OS_INTERFACE_CHANGE_TRIGGER_INTERVAL);
+  }
+}
+
+/**
+ * Set interface up or down
+ * @param os_if network interface
+ * @param up true if interface should be up, false if down
+ * @return always 0
+ */
+int
+os_interface_linux_state_set(struct os_interface *os_if, bool up) {
+  os_if->flags.up = up;
+  return 0;
+}
+
+/**
+ * Set mac address of interface
+ * @param os_if network interface
+ * @param mac mac address
+ * @return always 0
+ */
+int
+os_interface_linux_mac_set(struct os_interface *os_if, struct netaddr *mac) {
+  memcpy(&os_if->mac, mac, sizeof(*mac));
+  return 0;
+}
+
+/**
+ * Address changes are not supported by the in-memory interfaces
+ * @param addr interface address change request
+ * @return always -1
+ */
+int
+os_interface_linux_address_set(struct os_interface_ip_change *addr __attribute__((unused))) {
+  return -1;
+}
+
+/**
+ * Stop processing an interface address change
+ * @param addr interface address change request
+ */
+void
+os_interface_linux_address_interrupt(struct os_interface_ip_change *addr __attribute__((unused))) {}
+
+/**
+ * Add an interface to the database if not already there
+ * @param name interface name
+ * @return interface representation, NULL if out of memory
+ */
+static struct os_interface *
+_add_interface(const char *name) {
+  uint8_t mac[6] = { 0x02, 0, 0, 0, 0, 0 };
+  struct os_interface *data;
+
+  data = avl_find_element(&_interface_data_tree, name, data, _node);
+  if (data) {
+    return data;
+  }
+
+  data = oonf_class_malloc(&_interface_data_class);
+  if (!data) {
+    return NULL;
+  }
+
+  OONF_INFO(LOG_OS_INTERFACE, "Add in-memory interface: %s", name);
+
+  strscpy(data->name, name, IF_NAMESIZE);
+  data->_node.key = data->name;
+  avl_insert(&_interface_data_tree, &data->_node);
+
+  avl_init(&data->addresses, avl_comp_netaddr, false);
+  avl_init(&data->peers, avl_comp_netaddr, false);
+  list_init_head(&data->_listeners);
+
+  data->_change_timer.class = &_interface_change_timer;
+
+  if (strcmp(data->name, _ANY_INTERFACE) == 0) {
+    data->flags.any = true;
+    data->flags.up = true;
+  }
+  else {
+    data->index = _next_index++;
+    data->base_index = data->index;
+    data->flags.mesh = true;
+
+    /* locally administered MAC, NHDP treats identical MACs as a collision */
+    mac[5] = data->index & 0xff;
+    mac[4] = (data->index >> 8) & 0xff;
+    netaddr_from_binary(&data->mac, mac, sizeof(mac), AF_MAC48);
+  }
+
+  data->if_linklocal_v4 = &NETADDR_UNSPEC;
+  data->if_linklocal_v6 = &NETADDR_UNSPEC;
+  data->if_v4 = &NETADDR_UNSPEC;
+  data->if_v6 = &NETADDR_UNSPEC;
+  return data;
+}
+
+/**
+ * Remove an interface from the database if not used anymore
+ * @param data interface representation
+ */
+static void
+_remove_interface(struct os_interface *data) {
+  struct os_interface_ip *ip, *ip_it;
+
+  if (!list_is_empty(&data->_listeners) || data->_internal.configured) {
+    return;
+  }
+
+  avl_for_each_element_safe(&data->addresses, ip, _node, ip_it) {
+    avl_remove(&data->addresses, &ip->_node);
+    oonf_class_free(&_interface_ip_class, ip);
+  }
+
+  oonf_timer_stop(&data->_change_timer);
+
+  avl_remove(&_interface_data_tree, &data->_node);
+  oonf_class_free(&_interface_data_class, data);
+}
+
+/**
+ * Timer callback to deliver delayed interface change events
+ * @param timer timer instance of the interface
+ */
+static void
+_cb_delayed_interface_changed(struct oonf_timer_instance *timer) {
+  struct os_interface *data;
+  struct os_interface_listener *interf, *interf_it;
+  bool error;
+
+  data = container_of(timer, struct os_interface, _change_timer);
+
+  error = false;
+  list_for_each_element_safe(&data->_listeners, interf, _node, interf_it) {
+    if (!interf->_dirty) {
+      continue;
+    }
+
+    if (interf->if_changed && interf->if_changed(interf)) {
+      error = true;
+    }
+    else {
+      interf->_dirty = false;
+    }
+  }
+
+  if (error) {
+    oonf_timer_start(timer, OS_INTERFACE_CHANGE_TRIGGER_INTERVAL);
+  }
+}
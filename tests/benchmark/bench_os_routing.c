@@ -0,0 +1,239 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include "common/avl.h"
+#include "common/avl_comp.h"
+#include "common/common_types.h"
+#include "common/list.h"
+#include "core/oonf_subsystem.h"
+#include "subsystems/os_routing.h"
+
+#include "bench_stubs.h"
+
+/* prototypes */
+static int _init(void);
+static void _cleanup(void);
+
+static void _routing_finished(struct os_route *route, int error);
+
+/* subsystem definition */
+static struct oonf_subsystem _bench_os_routing_subsystem = {
+  .name = OONF_OS_ROUTING_SUBSYSTEM,
+  .init = _init,
+  .cleanup = _cleanup,
+};
+DECLARE_OONF_PLUGIN(_bench_os_routing_subsystem);
+
+/* default wildcard route */
+static const struct os_route_parameter OS_ROUTE_WILDCARD = { .family = AF_UNSPEC,
+  .src_ip = { ._type = AF_UNSPEC },
+  .gw = { ._type = AF_UNSPEC },
+  .type = OS_ROUTE_UNDEFINED,
+  .key =
+    {
+      .dst = { ._type = AF_UNSPEC },
+      .src = { ._type = AF_UNSPEC },
+    },
+  .table = RT_TABLE_UNSPEC,
+  .metric = -1,
+  .protocol = RTPROT_UNSPEC,
+  .if_index = 0 };
+
+/* routes waiting for their (simulated) kernel feedback */
+static struct avl_tree _route_feedback;
+static struct list_entity _route_listener;
+static uint32_t _route_seq;
+
+static struct bench_routing_stats _stats;
+
+/**
+ * Initialize in-memory routing table
+ * @return always 0
+ */
+static int
+_init(void) {
+  avl_init(&_route_feedback, avl_comp_uint32, false);
+  list_init_head(&_route_listener);
+  return 0;
+}
+
+/**
+ * Cleanup in-memory routing table
+ */
+static void
+_cleanup(void) {
+  struct os_route *rt, *rt_it;
+
+  avl_for_each_element_safe(&_route_feedback, rt, _internal._node, rt_it) {
+    _routing_finished(rt, 1);
+  }
+}
+
+/**
+ * Deliver feedback for all pending route changes
+ */
+void
+bench_os_routing_flush(void) {
+  struct os_route *rt, *rt_it;
+
+  avl_for_each_element_safe(&_route_feedback, rt, _internal._node, rt_it) {
+    _routing_finished(rt, 0);
+  }
+}
+
+/**
+ * @return counters of in-memory routing table
+ */
+const struct bench_routing_stats *
+bench_os_routing_get_stats(void) {
+  return &_stats;
+}
+
+/**
+ * Source specific routes are not simulated
+ * @param af_family address family
+ * @return always false
+ */
+bool
+os_routing_linux_supports_source_specific(int af_family __attribute__((unused))) {
+  return false;
+}
+
+/**
+ * Record a change of the in-memory routing table. Feedback is
+ * delivered by bench_os_routing_flush().
+ * @param route data of route to be set/removed
+ * @param set true if route should be set, false if it should be removed
+ * @param del_similar ignored
+ * @return always 0
+ */
+int
+os_routing_linux_set(struct os_route *route, bool set, bool del_similar __attribute__((unused))) {
+  if (set) {
+    _stats.set++;
+  }
+  else {
+    _stats.removed++;
+  }
+
+  if (route->cb_finished) {
+    route->_internal.nl_seq = ++_route_seq;
+    route->_internal._node.key = &route->_internal.nl_seq;
+    avl_insert(&_route_feedback, &route->_internal._node);
+  }
+  return 0;
+}
+
+/**
+ * Routing table queries are not simulated
+ * @param route pointer to routing filter
+ * @return always -1
+ */
+int
+os_routing_linux_query(struct os_route *route __attribute__((unused))) {
+  return -1;
+}
+
+/**
+ * Stop processing of a routing command
+ * @param route pointer to os_route
+ */
+void
+os_routing_linux_interrupt(struct os_route *route) {
+  if (os_routing_linux_is_in_progress(route)) {
+    _routing_finished(route, -1);
+  }
+}
+
+/**
+ * @param route os route
+ * @return true if route feedback is still pending
+ */
+bool
+os_routing_linux_is_in_progress(struct os_route *route) {
+  return avl_is_node_added(&route->_internal._node);
+}
+
+/**
+ * Add routing change listener
+ * @param listener routing change listener
+ */
+void
+os_routing_linux_listener_add(struct os_route_listener *listener) {
+  list_add_tail(&_route_listener, &listener->_internal._node);
+}
+
+/**
+ * Remove routing change listener
+ * @param listener routing change listener
+ */
+void
+os_routing_linux_listener_remove(struct os_route_listener *listener) {
+  list_remove(&listener->_internal._node);
+}
+
+/**
+ * Initializes a route with default values
+ * @param route route to be initialized
+ */
+void
+os_routing_linux_init_wildcard_route(struct os_route *route) {
+  memset(route, 0, sizeof(*route));
+  memcpy(&route->p, &OS_ROUTE_WILDCARD, sizeof(route->p));
+}
+
+/**
+ * Remove a route from the feedback tree and call its callback
+ * @param route pointer to os_route
+ * @param error error code, 0 if no error
+ */
+static void
+_routing_finished(struct os_route *route, int error) {
+  avl_remove(&_route_feedback, &route->_internal._node);
+
+  if (route->cb_finished) {
+    route->cb_finished(route, error);
+  }
+}
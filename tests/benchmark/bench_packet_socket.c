@@ -0,0 +1,487 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include "common/autobuf.h"
+#include "common/common_types.h"
+#include "common/list.h"
+#include "common/netaddr.h"
+#include "common/netaddr_acl.h"
+#include "core/oonf_subsystem.h"
+#include "subsystems/oonf_packet_socket.h"
+#include "subsystems/os_interface.h"
+
+#include "bench_stubs.h"
+
+/* Definitions */
+#define LOG_PACKET _bench_packet_subsystem.logging
+
+/* prototypes */
+static int _init(void);
+static void _cleanup(void);
+
+static void _activate_socket(struct oonf_packet_socket *sock, union netaddr_socket *local, struct os_interface *os_if,
+  struct oonf_packet_config *config);
+static void _apply_managed_socketpair(int af_type, struct oonf_packet_managed *managed, struct os_interface *os_if,
+  bool *changed, struct oonf_packet_socket *sock, struct oonf_packet_socket *mc_sock, struct netaddr *mc_ip);
+static int _apply_managed(struct oonf_packet_managed *managed);
+static int _cb_interface_listener(struct os_interface_listener *l);
+
+/* subsystem definition */
+static const char *_dependencies[] = {
+  OONF_OS_INTERFACE_SUBSYSTEM,
+};
+
+static struct oonf_subsystem _bench_packet_subsystem = {
+  .name = OONF_PACKET_SUBSYSTEM,
+  .dependencies = _dependencies,
+  .dependencies_count = ARRAYSIZE(_dependencies),
+  .init = _init,
+  .cleanup = _cleanup,
+};
+DECLARE_OONF_PLUGIN(_bench_packet_subsystem);
+
+/* list of active in-memory sockets */
+static struct list_entity _packet_sockets;
+
+/* traffic counters */
+static struct bench_packet_stats _stats;
+
+/**
+ * Initialize in-memory packet sockets
+ * @return always 0
+ */
+static int
+_init(void) {
+  list_init_head(&_packet_sockets);
+  return 0;
+}
+
+/**
+ * Cleanup all in-memory packet sockets
+ */
+static void
+_cleanup(void) {
+  struct oonf_packet_socket *sock, *iterator;
+
+  list_for_each_element_safe(&_packet_sockets, sock, node, iterator) {
+    oonf_packet_remove(sock, true);
+  }
+}
+
+/**
+ * Inject a packet into the multicast socket of an interface
+ * as if it had been received from the network.
+ * @param ifname name of the receiving interface
+ * @param src IP source address of the packet
+ * @param data pointer to packet data
+ * @param length length of packet data
+ * @return -1 if no socket is listening on the interface, 0 otherwise
+ */
+int
+bench_packet_inject(const char *ifname, const struct netaddr *src, void *data, size_t length) {
+  struct oonf_packet_socket *sock;
+  union netaddr_socket from;
+  struct netaddr local;
+  const struct netaddr *mc_prefix;
+
+  mc_prefix = netaddr_get_address_family(src) == AF_INET ? &NETADDR_IPV4_MULTICAST : &NETADDR_IPV6_MULTICAST;
+
+  list_for_each_element(&_packet_sockets, sock, node) {
+    if (sock->os_if == NULL || strcmp(sock->os_if->name, ifname) != 0 || sock->config.receive_data == NULL) {
+      continue;
+    }
+    if (netaddr_from_socket(&local, &sock->local_socket) || !netaddr_is_in_subnet(mc_prefix, &local)) {
+      continue;
+    }
+
+    netaddr_socket_init(&from, src, netaddr_socket_get_port(&sock->local_socket), sock->os_if->index);
+
+    _stats.rx_packets++;
+    _stats.rx_bytes += length;
+
+    sock->config.receive_data(sock, &from, data, length);
+    return 0;
+  }
+  return -1;
+}
+
+/**
+ * @return traffic counters of the in-memory sockets
+ */
+const struct bench_packet_stats *
+bench_packet_get_stats(void) {
+  return &_stats;
+}
+
+/**
+ * Add an in-memory packet socket
+ * @param pktsocket pointer to an uninitialized packet socket
+ * @param local local IP address of socket
+ * @param os_if interface to bind the socket to, NULL if not bound
+ * @return always 0
+ */
+int
+oonf_packet_add(struct oonf_packet_socket *pktsocket, union netaddr_socket *local, struct os_interface *os_if) {
+  _activate_socket(pktsocket, local, os_if, &pktsocket->config);
+  return 0;
+}
+
+/**
+ * Add an in-memory raw packet socket
+ * @param pktsocket pointer to an uninitialized packet socket
+ * @param protocol IP protocol number
+ * @param local local IP address of socket
+ * @param os_if interface to bind the socket to, NULL if not bound
+ * @return always 0
+ */
+int
+oonf_packet_raw_add(
+  struct oonf_packet_socket *pktsocket, int protocol, union netaddr_socket *local, struct os_interface *os_if) {
+  pktsocket->protocol = protocol;
+  return oonf_packet_add(pktsocket, local, os_if);
+}
+
+/**
+ * Remove an in-memory packet socket
+ * @param pktsocket pointer to packet socket
+ * @param force ignored
+ */
+void
+oonf_packet_remove(struct oonf_packet_socket *pktsocket, bool force __attribute__((unused))) {
+  if (list_is_node_added(&pktsocket->node)) {
+    list_remove(&pktsocket->node);
+  }
+}
+
+/**
+ * Account an outgoing packet
+ * @param pktsocket pointer to packet socket
+ * @param remote ignored
+ * @param data ignored
+ * @param length length of packet
+ * @return -1 if socket is not active, 0 otherwise
+ */
+int
+oonf_packet_send(struct oonf_packet_socket *pktsocket, union netaddr_socket *remote __attribute__((unused)),
+  const void *data __attribute__((unused)), size_t length) {
+  if (!oonf_packet_is_active(pktsocket)) {
+    return -1;
+  }
+
+  _stats.tx_packets++;
+  _stats.tx_bytes += length;
+  return 0;
+}
+
+/**
+ * Account an outgoing packet of a managed socket
+ * @param managed pointer to managed packet socket
+ * @param remote pointer to remote socket
+ * @param data pointer to data to send
+ * @param length length of data
+ * @return -1 if an error happened, 0 otherwise
+ */
+int
+oonf_packet_send_managed(
+  struct oonf_packet_managed *managed, union netaddr_socket *remote, const void *data, size_t length) {
+  switch (netaddr_socket_get_addressfamily(remote)) {
+    case AF_INET:
+      if (oonf_packet_is_active(&managed->socket_v4)) {
+        return oonf_packet_send(&managed->socket_v4, remote, data, length);
+      }
+      break;
+    case AF_INET6:
+      if (oonf_packet_is_active(&managed->socket_v6)) {
+        return oonf_packet_send(&managed->socket_v6, remote, data, length);
+      }
+      break;
+    default:
+      break;
+  }
+  return 0;
+}
+
+/**
+ * Account an outgoing multicast packet of a managed socket
+ * @param managed pointer to managed packet socket
+ * @param data pointer to data to send
+ * @param length length of data
+ * @param af_type address family to send multicast
+ * @return -1 if an error happened, 0 if packet was sent, 1 if this
+ *    type of address was switched off
+ */
+int
+oonf_packet_send_managed_multicast(struct oonf_packet_managed *managed, const void *data, size_t length, int af_type) {
+  if (af_type == AF_INET) {
+    return oonf_packet_send_managed(managed, &managed->multicast_v4.local_socket, data, length);
+  }
+  else if (af_type == AF_INET6) {
+    return oonf_packet_send_managed(managed, &managed->multicast_v6.local_socket, data, length);
+  }
+  return 1;
+}
+
+/**
+ * Initialize a new managed packet socket
+ * @param managed pointer to managed packet socket
+ */
+void
+oonf_packet_add_managed(struct oonf_packet_managed *managed) {
+  managed->_if_listener.if_changed = _cb_interface_listener;
+  managed->_if_listener.name = managed->_managed_config.interface;
+  managed->_if_listener.mesh = managed->_managed_config.mesh;
+}
+
+/**
+ * Apply a new configuration to a managed socket
+ * @param managed pointer to managed packet socket
+ * @param config pointer to new configuration
+ * @return -1 if an error happened, 0 otherwise
+ */
+int
+oonf_packet_apply_managed(struct oonf_packet_managed *managed, const struct oonf_packet_managed_config *config) {
+  bool if_changed;
+
+  _stats.reconfigured++;
+
+  if_changed = strcmp(config->interface, managed->_managed_config.interface) != 0 ||
+               !list_is_node_added(&managed->_if_listener._node);
+
+  oonf_packet_copy_managed_config(&managed->_managed_config, config);
+
+  if (if_changed) {
+    os_interface_remove(&managed->_if_listener);
+
+    managed->_if_listener.mesh = managed->_managed_config.mesh;
+    os_interface_add(&managed->_if_listener);
+  }
+
+  return _apply_managed(managed);
+}
+
+/**
+ * Cleanup a managed packet socket
+ * @param managed pointer to packet socket
+ * @param forced ignored
+ */
+void
+oonf_packet_remove_managed(struct oonf_packet_managed *managed, bool forced) {
+  oonf_packet_remove(&managed->socket_v4, forced);
+  oonf_packet_remove(&managed->socket_v6, forced);
+  oonf_packet_remove(&managed->multicast_v4, forced);
+  oonf_packet_remove(&managed->multicast_v6, forced);
+
+  os_interface_remove(&managed->_if_listener);
+  oonf_packet_free_managed_config(&managed->_managed_config);
+}
+
+/**
+ * @param managed pointer to managed UDP socket
+ * @param af_type address familty
+ * @return true if the selected socket is active.
+ */
+bool
+oonf_packet_managed_is_active(struct oonf_packet_managed *managed, int af_type) {
+  switch (af_type) {
+    case AF_INET:
+      return oonf_packet_is_active(&managed->socket_v4);
+    case AF_INET6:
+      return oonf_packet_is_active(&managed->socket_v6);
+    default:
+      return false;
+  }
+}
+
+/**
+ * copies a packet managed configuration object
+ * @param dst Destination
+ * @param src Source
+ */
+void
+oonf_packet_copy_managed_config(struct oonf_packet_managed_config *dst, const struct oonf_packet_managed_config *src) {
+  oonf_packet_free_managed_config(dst);
+
+  memcpy(dst, src, sizeof(*dst));
+
+  memset(&dst->acl, 0, sizeof(dst->acl));
+  memset(&dst->bindto, 0, sizeof(dst->bindto));
+
+  netaddr_acl_copy(&dst->acl, &src->acl);
+  netaddr_acl_copy(&dst->bindto, &src->bindto);
+}
+
+/**
+ * Free dynamically allocated parts of managed packet configuration
+ * @param config packet configuration
+ */
+void
+oonf_packet_free_managed_config(struct oonf_packet_managed_config *config) {
+  netaddr_acl_remove(&config->acl);
+  netaddr_acl_remove(&config->bindto);
+}
+
+/**
+ * Hook a packet socket into the list of active sockets
+ * @param sock packet socket
+ * @param local local socket address
+ * @param os_if interface the socket is bound to, NULL if none
+ * @param config socket configuration
+ */
+static void
+_activate_socket(struct oonf_packet_socket *sock, union netaddr_socket *local, struct os_interface *os_if,
+  struct oonf_packet_config *config) {
+  struct netaddr_str buf;
+
+  if (&sock->config != config) {
+    memcpy(&sock->config, config, sizeof(*config));
+  }
+  memcpy(&sock->local_socket, local, sizeof(*local));
+  sock->os_if = os_if;
+
+  netaddr_socket_to_string(&buf, local);
+  snprintf(sock->socket_name, sizeof(sock->socket_name), "%s", buf.buf);
+
+  if (!list_is_node_added(&sock->node)) {
+    list_add_tail(&_packet_sockets, &sock->node);
+  }
+}
+
+/**
+ * Apply the configuration of a managed socket to an unicast/multicast
+ * socket pair of one address family
+ * @param af_type address family
+ * @param managed managed socket
+ * @param os_if OS interface to bind sockets, NULL if unbound socket
+ * @param changed buffer for boolean, will be set to true if sockets changed
+ * @param sock unicast packet socket
+ * @param mc_sock multicast packet socket
+ * @param mc_ip multicast address
+ */
+static void
+_apply_managed_socketpair(int af_type, struct oonf_packet_managed *managed, struct os_interface *os_if,
+  bool *changed, struct oonf_packet_socket *sock, struct oonf_packet_socket *mc_sock, struct netaddr *mc_ip) {
+  const struct netaddr *bind_ip;
+  union netaddr_socket local;
+  uint16_t mc_port;
+  unsigned if_index;
+
+  mc_port = managed->_managed_config.multicast_port;
+  if (mc_port == 0) {
+    mc_port = managed->_managed_config.port;
+  }
+
+  if (os_if != NULL && !os_if->flags.up) {
+    bind_ip = NULL;
+  }
+  else {
+    bind_ip = os_interface_get_bindaddress(af_type, &managed->_managed_config.bindto, os_if);
+  }
+  if (!bind_ip) {
+    oonf_packet_remove(sock, false);
+    oonf_packet_remove(mc_sock, false);
+    return;
+  }
+
+  if_index = os_if == NULL ? 0 : os_if->index;
+
+  netaddr_socket_init(&local, bind_ip, managed->_managed_config.port, if_index);
+  if (!oonf_packet_is_active(sock) || memcmp(&local, &sock->local_socket, sizeof(local)) != 0) {
+    *changed = true;
+  }
+  _activate_socket(sock, &local, os_if, &managed->config);
+
+  if (netaddr_get_address_family(mc_ip) == af_type) {
+    netaddr_socket_init(&local, mc_ip, mc_port, if_index);
+    if (!oonf_packet_is_active(mc_sock) || memcmp(&local, &mc_sock->local_socket, sizeof(local)) != 0) {
+      *changed = true;
+    }
+    _activate_socket(mc_sock, &local, os_if, &managed->config);
+  }
+  else {
+    oonf_packet_remove(mc_sock, true);
+  }
+}
+
+/**
+ * Apply the current configuration to all sockets of a managed socket
+ * @param managed pointer to managed packet socket
+ * @return always 0
+ */
+static int
+_apply_managed(struct oonf_packet_managed *managed) {
+  struct os_interface *os_if = NULL;
+  bool changed = false;
+
+  if (managed->_if_listener.name) {
+    os_if = managed->_if_listener.data;
+  }
+
+  _apply_managed_socketpair(AF_INET, managed, os_if, &changed, &managed->socket_v4, &managed->multicast_v4,
+    &managed->_managed_config.multicast_v4);
+  _apply_managed_socketpair(AF_INET6, managed, os_if, &changed, &managed->socket_v6, &managed->multicast_v6,
+    &managed->_managed_config.multicast_v6);
+
+  OONF_DEBUG(LOG_PACKET, "Applied in-memory socket configuration (if %s), changed=%s",
+    managed->_managed_config.interface[0] == 0 ? "any" : managed->_managed_config.interface,
+    changed ? "true" : "false");
+
+  if (managed->cb_settings_change) {
+    managed->cb_settings_change(managed, changed);
+  }
+  return 0;
+}
+
+/**
+ * Callback for interface changes of a managed socket
+ * @param l interface listener
+ * @return always 0
+ */
+static int
+_cb_interface_listener(struct os_interface_listener *l) {
+  struct oonf_packet_managed *managed;
+
+  managed = container_of(l, struct oonf_packet_managed, _if_listener);
+  return _apply_managed(managed);
+}
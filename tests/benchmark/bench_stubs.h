@@ -0,0 +1,94 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#ifndef BENCH_STUBS_H_
+#define BENCH_STUBS_H_
+
+#include "common/common_types.h"
+#include "common/netaddr.h"
+#include "subsystems/os_interface.h"
+
+/**
+ * Traffic counters of the in-memory packet socket
+ */
+struct bench_packet_stats {
+  /*! number of packets injected into the RFC5444 reader */
+  uint64_t rx_packets;
+
+  /*! number of bytes injected into the RFC5444 reader */
+  uint64_t rx_bytes;
+
+  /*! number of packets generated by the local node */
+  uint64_t tx_packets;
+
+  /*! number of bytes generated by the local node */
+  uint64_t tx_bytes;
+
+  /*! number of configuration changes of managed sockets */
+  uint64_t reconfigured;
+};
+
+/**
+ * Counters of the in-memory routing table
+ */
+struct bench_routing_stats {
+  /*! number of route set commands */
+  uint64_t set;
+
+  /*! number of route remove commands */
+  uint64_t removed;
+};
+
+EXPORT void bench_os_clock_advance(uint64_t interval);
+
+EXPORT struct os_interface *bench_os_interface_set_address(const char *name, const struct netaddr *prefix);
+
+EXPORT int bench_packet_inject(const char *ifname, const struct netaddr *src, void *data, size_t length);
+EXPORT const struct bench_packet_stats *bench_packet_get_stats(void);
+
+EXPORT void bench_os_routing_flush(void);
+EXPORT const struct bench_routing_stats *bench_os_routing_get_stats(void);
+
+#endif /* BENCH_STUBS_H_ */
@@ -0,0 +1,429 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/common_types.h"
+#include "common/netaddr.h"
+
+#include "cunit/cunit_random.h"
+
+#include "bench_topology.h"
+
+/*! largest clique the generator accepts, the adjacency list grows quadratic */
+#define BENCH_MAX_CLIQUE 2000
+
+/*! number of attempts to find an edge that can be toggled */
+#define BENCH_TOGGLE_ATTEMPTS 64
+
+/**
+ * Temporary list of undirected edges
+ */
+struct _edge_list {
+  /*! array of node pairs */
+  uint32_t *pairs;
+
+  /*! number of edges */
+  uint32_t count;
+
+  /*! number of allocated edges */
+  uint32_t size;
+};
+
+static int _add_edge(struct _edge_list *list, uint32_t node1, uint32_t node2);
+static int _generate_grid(struct _edge_list *list, uint32_t nodes, uint32_t *observer);
+static int _generate_geometric(
+  struct _edge_list *list, uint32_t nodes, uint32_t degree, uint32_t *seed, uint32_t *observer);
+static int _generate_clique(struct _edge_list *list, uint32_t nodes);
+static int _build_adjacency(struct bench_topology *topo, struct _edge_list *list);
+
+/**
+ * Generate a network topology
+ * @param topo uninitialized topology
+ * @param type shape of network
+ * @param nodes number of nodes
+ * @param degree average number of neighbors (geometric topology only)
+ * @param seed pointer to random generator state
+ * @return -1 if an error happened, 0 otherwise
+ */
+int
+bench_topology_generate(
+  struct bench_topology *topo, enum bench_topology_type type, uint32_t nodes, uint32_t degree, uint32_t *seed) {
+  struct _edge_list list;
+  int result;
+
+  memset(topo, 0, sizeof(*topo));
+  memset(&list, 0, sizeof(list));
+
+  topo->node_count = nodes;
+  switch (type) {
+    case BENCH_TOPOLOGY_GRID:
+      result = _generate_grid(&list, nodes, &topo->observer);
+      break;
+    case BENCH_TOPOLOGY_GEOMETRIC:
+      result = _generate_geometric(&list, nodes, degree, seed, &topo->observer);
+      break;
+    case BENCH_TOPOLOGY_CLIQUE:
+      topo->observer = 0;
+      result = nodes > BENCH_MAX_CLIQUE ? -1 : _generate_clique(&list, nodes);
+      break;
+    default:
+      result = -1;
+      break;
+  }
+
+  if (!result) {
+    result = _build_adjacency(topo, &list);
+  }
+  free(list.pairs);
+
+  if (result) {
+    bench_topology_free(topo);
+    return -1;
+  }
+
+  bench_topology_update_paths(topo);
+  return 0;
+}
+
+/**
+ * Free all memory allocated for a topology
+ * @param topo network topology
+ */
+void
+bench_topology_free(struct bench_topology *topo) {
+  free(topo->adj_index);
+  free(topo->adj);
+  free(topo->adj_down);
+  free(topo->hops);
+  free(topo->via);
+  memset(topo, 0, sizeof(*topo));
+}
+
+/**
+ * Recalculate hopcount and first hop from the observer to all nodes,
+ * ignoring broken adjacencies.
+ * @param topo network topology
+ */
+void
+bench_topology_update_paths(struct bench_topology *topo) {
+  uint32_t *queue;
+  uint32_t head, tail, node, other, i;
+
+  for (i = 0; i < topo->node_count; i++) {
+    topo->hops[i] = BENCH_TOPOLOGY_UNREACHABLE;
+    topo->via[i] = BENCH_TOPOLOGY_UNREACHABLE;
+  }
+
+  queue = calloc(topo->node_count, sizeof(*queue));
+  if (!queue) {
+    return;
+  }
+
+  head = tail = 0;
+  topo->hops[topo->observer] = 0;
+  topo->via[topo->observer] = topo->observer;
+  queue[tail++] = topo->observer;
+
+  while (head < tail) {
+    node = queue[head++];
+
+    for (i = topo->adj_index[node]; i < topo->adj_index[node + 1]; i++) {
+      other = topo->adj[i];
+      if (topo->adj_down[i] || topo->hops[other] != BENCH_TOPOLOGY_UNREACHABLE) {
+        continue;
+      }
+
+      topo->hops[other] = topo->hops[node] + 1;
+      topo->via[other] = node == topo->observer ? other : topo->via[node];
+      queue[tail++] = other;
+    }
+  }
+  free(queue);
+}
+
+/**
+ * Break or repair a random adjacency that does not involve the observer
+ * @param topo network topology
+ * @param seed pointer to random generator state
+ * @param node1 pointer to first node of toggled edge
+ * @param node2 pointer to second node of toggled edge
+ * @return -1 if no edge could be toggled, 0 otherwise
+ */
+int
+bench_topology_toggle_edge(struct bench_topology *topo, uint32_t *seed, uint32_t *node1, uint32_t *node2) {
+  uint32_t attempt, entry, node, other, i;
+
+  if (topo->adj_count == 0) {
+    return -1;
+  }
+
+  for (attempt = 0; attempt < BENCH_TOGGLE_ATTEMPTS; attempt++) {
+    entry = cunit_random(seed) % topo->adj_count;
+    other = topo->adj[entry];
+
+    /* find owner of adjacency entry */
+    node = 0;
+    while (topo->adj_index[node + 1] <= entry) {
+      node++;
+    }
+
+    if (node == topo->observer || other == topo->observer) {
+      continue;
+    }
+
+    /* toggle both directions */
+    topo->adj_down[entry] = !topo->adj_down[entry];
+    for (i = topo->adj_index[other]; i < topo->adj_index[other + 1]; i++) {
+      if (topo->adj[i] == node) {
+        topo->adj_down[i] = topo->adj_down[entry];
+      }
+    }
+
+    *node1 = node;
+    *node2 = other;
+    return 0;
+  }
+  return -1;
+}
+
+/**
+ * Calculate the IPv4 address of a node
+ * @param addr buffer for address
+ * @param node node index
+ */
+void
+bench_topology_get_address(struct netaddr *addr, uint32_t node) {
+  uint8_t bin[4];
+
+  node++;
+  bin[0] = 10;
+  bin[1] = (node >> 16) & 0xff;
+  bin[2] = (node >> 8) & 0xff;
+  bin[3] = node & 0xff;
+
+  netaddr_from_binary(addr, bin, sizeof(bin), AF_INET);
+}
+
+/**
+ * Add an undirected edge to the temporary edge list
+ * @param list edge list
+ * @param node1 first node
+ * @param node2 second node
+ * @return -1 if out of memory, 0 otherwise
+ */
+static int
+_add_edge(struct _edge_list *list, uint32_t node1, uint32_t node2) {
+  uint32_t *pairs;
+
+  if (list->count == list->size) {
+    list->size = list->size == 0 ? 1024 : list->size * 2;
+    pairs = realloc(list->pairs, list->size * 2 * sizeof(*pairs));
+    if (!pairs) {
+      return -1;
+    }
+    list->pairs = pairs;
+  }
+
+  list->pairs[list->count * 2] = node1;
+  list->pairs[list->count * 2 + 1] = node2;
+  list->count++;
+  return 0;
+}
+
+/**
+ * Generate a square grid
+ * @param list edge list
+ * @param nodes number of nodes
+ * @param observer buffer for observer node, center of the grid
+ * @return -1 if out of memory, 0 otherwise
+ */
+static int
+_generate_grid(struct _edge_list *list, uint32_t nodes, uint32_t *observer) {
+  uint32_t side, i;
+  double root;
+
+  root = sqrt(nodes);
+  side = root;
+  while (side * side < nodes) {
+    side++;
+  }
+
+  for (i = 0; i < nodes; i++) {
+    if ((i % side) + 1 < side && i + 1 < nodes && _add_edge(list, i, i + 1)) {
+      return -1;
+    }
+    if (i + side < nodes && _add_edge(list, i, i + side)) {
+      return -1;
+    }
+  }
+
+  *observer = ((nodes / side) / 2) * side + side / 2;
+  if (*observer >= nodes) {
+    *observer = nodes / 2;
+  }
+  return 0;
+}
+
+/**
+ * Generate a random geometric graph in the unit square
+ * @param list edge list
+ * @param nodes number of nodes
+ * @param degree average number of neighbors
+ * @param seed pointer to random generator state
+ * @param observer buffer for observer node, closest node to the center
+ * @return -1 if out of memory, 0 otherwise
+ */
+static int
+_generate_geometric(struct _edge_list *list, uint32_t nodes, uint32_t degree, uint32_t *seed, uint32_t *observer) {
+  double *pos, radius2, dx, dy, best, dist;
+  uint32_t i, j, x, y;
+  int result = 0;
+
+  pos = calloc(nodes * 2, sizeof(*pos));
+  if (!pos) {
+    return -1;
+  }
+
+  /* expected degree of a node is N * pi * r^2 */
+  radius2 = (double)degree / (M_PI * nodes);
+
+  best = 2.0;
+  for (i = 0; i < nodes; i++) {
+    x = cunit_random(seed);
+    y = cunit_random(seed);
+    pos[i * 2] = x / (double)UINT32_MAX;
+    pos[i * 2 + 1] = y / (double)UINT32_MAX;
+
+    dx = pos[i * 2] - 0.5;
+    dy = pos[i * 2 + 1] - 0.5;
+    dist = dx * dx + dy * dy;
+    if (dist < best) {
+      best = dist;
+      *observer = i;
+    }
+  }
+
+  for (i = 0; i < nodes && !result; i++) {
+    for (j = i + 1; j < nodes && !result; j++) {
+      dx = pos[i * 2] - pos[j * 2];
+      dy = pos[i * 2 + 1] - pos[j * 2 + 1];
+      if (dx * dx + dy * dy <= radius2) {
+        result = _add_edge(list, i, j);
+      }
+    }
+  }
+
+  free(pos);
+  return result;
+}
+
+/**
+ * Generate a fully meshed network
+ * @param list edge list
+ * @param nodes number of nodes
+ * @return -1 if out of memory, 0 otherwise
+ */
+static int
+_generate_clique(struct _edge_list *list, uint32_t nodes) {
+  uint32_t i, j;
+
+  for (i = 0; i < nodes; i++) {
+    for (j = i + 1; j < nodes; j++) {
+      if (_add_edge(list, i, j)) {
+        return -1;
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ * Convert the temporary edge list into per-node adjacency arrays
+ * @param topo network topology
+ * @param list edge list
+ * @return -1 if out of memory, 0 otherwise
+ */
+static int
+_build_adjacency(struct bench_topology *topo, struct _edge_list *list) {
+  uint32_t *fill;
+  uint32_t i, n1, n2;
+
+  topo->adj_count = list->count * 2;
+  topo->adj_index = calloc(topo->node_count + 1, sizeof(*topo->adj_index));
+  topo->adj = calloc(topo->adj_count + 1, sizeof(*topo->adj));
+  topo->adj_down = calloc(topo->adj_count + 1, sizeof(*topo->adj_down));
+  topo->hops = calloc(topo->node_count, sizeof(*topo->hops));
+  topo->via = calloc(topo->node_count, sizeof(*topo->via));
+  fill = calloc(topo->node_count, sizeof(*fill));
+
+  if (!topo->adj_index || !topo->adj || !topo->adj_down || !topo->hops || !topo->via || !fill) {
+    free(fill);
+    return -1;
+  }
+
+  /* count degree of each node */
+  for (i = 0; i < list->count; i++) {
+    topo->adj_index[list->pairs[i * 2] + 1]++;
+    topo->adj_index[list->pairs[i * 2 + 1] + 1]++;
+  }
+  for (i = 0; i < topo->node_count; i++) {
+    topo->adj_index[i + 1] += topo->adj_index[i];
+  }
+
+  /* fill in both directions of each edge */
+  for (i = 0; i < list->count; i++) {
+    n1 = list->pairs[i * 2];
+    n2 = list->pairs[i * 2 + 1];
+
+    topo->adj[topo->adj_index[n1] + fill[n1]++] = n2;
+    topo->adj[topo->adj_index[n2] + fill[n2]++] = n1;
+  }
+
+  free(fill);
+  return 0;
+}
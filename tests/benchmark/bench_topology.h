@@ -0,0 +1,116 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#ifndef BENCH_TOPOLOGY_H_
+#define BENCH_TOPOLOGY_H_
+
+#include "common/common_types.h"
+#include "common/netaddr.h"
+
+/*! hopcount of nodes that cannot be reached from the observer */
+#define BENCH_TOPOLOGY_UNREACHABLE UINT32_MAX
+
+/**
+ * Shape of the generated network
+ */
+enum bench_topology_type
+{
+  /*! square grid, each node connected to its four neighbors */
+  BENCH_TOPOLOGY_GRID,
+
+  /*! random geometric graph in the unit square */
+  BENCH_TOPOLOGY_GEOMETRIC,
+
+  /*! every node connected to every other node */
+  BENCH_TOPOLOGY_CLIQUE,
+};
+
+/**
+ * Generated network graph with paths from the observer node
+ */
+struct bench_topology {
+  /*! number of nodes */
+  uint32_t node_count;
+
+  /*! node running the real NHDP/OLSRv2 instance */
+  uint32_t observer;
+
+  /*! index of the first adjacency of each node, node_count+1 entries */
+  uint32_t *adj_index;
+
+  /*! adjacency list of all nodes (both directions of each edge) */
+  uint32_t *adj;
+
+  /*! true if the adjacency is currently broken */
+  bool *adj_down;
+
+  /*! number of entries in adjacency list */
+  uint32_t adj_count;
+
+  /*! hopcount from the observer to each node */
+  uint32_t *hops;
+
+  /*! neighbor of the observer on the shortest path to each node */
+  uint32_t *via;
+};
+
+EXPORT int bench_topology_generate(
+  struct bench_topology *topo, enum bench_topology_type type, uint32_t nodes, uint32_t degree, uint32_t *seed);
+EXPORT void bench_topology_free(struct bench_topology *topo);
+EXPORT void bench_topology_update_paths(struct bench_topology *topo);
+EXPORT int bench_topology_toggle_edge(struct bench_topology *topo, uint32_t *seed, uint32_t *node1, uint32_t *node2);
+EXPORT void bench_topology_get_address(struct netaddr *addr, uint32_t node);
+
+/**
+ * @param topo network topology
+ * @param node node index
+ * @return number of adjacencies of a node
+ */
+static INLINE uint32_t
+bench_topology_get_degree(const struct bench_topology *topo, uint32_t node) {
+  return topo->adj_index[node + 1] - topo->adj_index[node];
+}
+
+#endif /* BENCH_TOPOLOGY_H_ */
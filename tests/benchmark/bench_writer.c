@@ -0,0 +1,380 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include "common/autobuf.h"
+#include "common/common_types.h"
+#include "common/netaddr.h"
+
+#include "subsystems/rfc5444/rfc5444.h"
+#include "subsystems/rfc5444/rfc5444_context.h"
+#include "subsystems/rfc5444/rfc5444_iana.h"
+
+#include "bench_topology.h"
+#include "bench_writer.h"
+
+/*! maximum number of addresses in a RFC5444 address block */
+#define BENCH_MAX_ADDRBLOCK 255
+
+/*! length of a synthetic IPv4 address */
+#define BENCH_ADDRLEN 4
+
+/**
+ * Address TLV attached to all addresses of an address block
+ */
+struct _addrblock_tlv {
+  /*! TLV type */
+  uint8_t type;
+
+  /*! TLV value */
+  const uint8_t *value;
+
+  /*! length of value */
+  uint8_t length;
+};
+
+static size_t _begin_message(struct autobuf *out, uint8_t type, uint32_t node, uint8_t hoplimit, uint8_t hopcount,
+  uint16_t seqno);
+static void _end_message(struct autobuf *out, size_t start);
+static size_t _begin_tlvblock(struct autobuf *out);
+static void _end_tlvblock(struct autobuf *out, size_t start);
+static void _add_tlv(struct autobuf *out, uint8_t type, const void *value, uint8_t length);
+static void _add_neighbor_blocks(struct autobuf *out, const struct bench_topology *topo, uint32_t node,
+  const struct _addrblock_tlv *tlvs, size_t tlv_count);
+static void _end_addrblock(
+  struct autobuf *out, size_t start, uint32_t count, const struct _addrblock_tlv *tlvs, size_t tlv_count);
+static void _set_uint16(struct autobuf *out, size_t offset, uint16_t value);
+
+/**
+ * Generate a packet with a HELLO message of a node that advertises
+ * all working adjacencies as symmetric links.
+ * @param out output buffer, will be cleared first
+ * @param topo network topology
+ * @param node index of originating node
+ * @param seqno message sequence number
+ * @param itime interval time of message
+ * @param vtime validity time of message
+ * @return -1 if an error happened, 0 otherwise
+ */
+int
+bench_writer_hello(struct autobuf *out, const struct bench_topology *topo, uint32_t node, uint16_t seqno,
+  uint64_t itime, uint64_t vtime) {
+  struct rfc7181_metric_field metric;
+  struct _addrblock_tlv tlvs[2];
+  struct netaddr addr;
+  size_t msg, block;
+  uint8_t value;
+
+  static const uint8_t linkstatus = RFC6130_LINKSTATUS_SYMMETRIC;
+  static const uint8_t localif = RFC6130_LOCALIF_THIS_IF;
+
+  abuf_clear(out);
+  abuf_append_uint8(out, 0);
+
+  msg = _begin_message(out, RFC6130_MSGTYPE_HELLO, node, 1, 0, seqno);
+
+  /* message TLVs */
+  block = _begin_tlvblock(out);
+  value = rfc5497_timetlv_encode(vtime);
+  _add_tlv(out, RFC5497_MSGTLV_VALIDITY_TIME, &value, 1);
+  value = rfc5497_timetlv_encode(itime);
+  _add_tlv(out, RFC5497_MSGTLV_INTERVAL_TIME, &value, 1);
+  value = (RFC7181_WILLINGNESS_DEFAULT << RFC7181_WILLINGNESS_SHIFT) | RFC7181_WILLINGNESS_DEFAULT;
+  _add_tlv(out, RFC7181_MSGTLV_MPR_WILLING, &value, 1);
+  _end_tlvblock(out, block);
+
+  /* local interface address */
+  bench_topology_get_address(&addr, node);
+  abuf_append_uint8(out, 1);
+  abuf_append_uint8(out, 0);
+  abuf_memcpy(out, netaddr_get_binptr(&addr), BENCH_ADDRLEN);
+
+  block = _begin_tlvblock(out);
+  _add_tlv(out, RFC6130_ADDRTLV_LOCAL_IF, &localif, 1);
+  _end_tlvblock(out, block);
+
+  /* symmetric link neighbors */
+  memset(&metric, 0, sizeof(metric));
+  rfc7181_metric_encode(&metric, BENCH_LINK_COST);
+  rfc7181_metric_set_flag(&metric, RFC7181_LINKMETRIC_INCOMING_LINK);
+  rfc7181_metric_set_flag(&metric, RFC7181_LINKMETRIC_OUTGOING_LINK);
+  rfc7181_metric_set_flag(&metric, RFC7181_LINKMETRIC_INCOMING_NEIGH);
+  rfc7181_metric_set_flag(&metric, RFC7181_LINKMETRIC_OUTGOING_NEIGH);
+
+  tlvs[0].type = RFC6130_ADDRTLV_LINK_STATUS;
+  tlvs[0].value = &linkstatus;
+  tlvs[0].length = 1;
+  tlvs[1].type = RFC7181_ADDRTLV_LINK_METRIC;
+  tlvs[1].value = metric.b;
+  tlvs[1].length = sizeof(metric.b);
+
+  _add_neighbor_blocks(out, topo, node, tlvs, ARRAYSIZE(tlvs));
+
+  _end_message(out, msg);
+  return abuf_has_failed(out) ? -1 : 0;
+}
+
+/**
+ * Generate a packet with a TC message of a node that advertises
+ * all working adjacencies as routable originators.
+ * @param out output buffer, will be cleared first
+ * @param topo network topology
+ * @param node index of originating node
+ * @param seqno message sequence number
+ * @param ansn advertised neighbor sequence number
+ * @param hopcount hopcount of the message when it reaches the observer
+ * @param itime interval time of message
+ * @param vtime validity time of message
+ * @return -1 if an error happened, 0 otherwise
+ */
+int
+bench_writer_tc(struct autobuf *out, const struct bench_topology *topo, uint32_t node, uint16_t seqno,
+  uint16_t ansn, uint8_t hopcount, uint64_t itime, uint64_t vtime) {
+  struct rfc7181_metric_field metric;
+  struct _addrblock_tlv tlvs[2];
+  size_t msg, block;
+  uint8_t value, ansn_value[2];
+
+  static const uint8_t addrtype = RFC7181_NBR_ADDR_TYPE_ORIGINATOR | RFC7181_NBR_ADDR_TYPE_ROUTABLE;
+
+  abuf_clear(out);
+  abuf_append_uint8(out, 0);
+
+  msg = _begin_message(out, RFC7181_MSGTYPE_TC, node, 255 - hopcount, hopcount, seqno);
+
+  /* message TLVs */
+  block = _begin_tlvblock(out);
+  value = rfc5497_timetlv_encode(vtime);
+  _add_tlv(out, RFC5497_MSGTLV_VALIDITY_TIME, &value, 1);
+  value = rfc5497_timetlv_encode(itime);
+  _add_tlv(out, RFC5497_MSGTLV_INTERVAL_TIME, &value, 1);
+
+  ansn_value[0] = ansn >> 8;
+  ansn_value[1] = ansn & 0xff;
+  _add_tlv(out, RFC7181_MSGTLV_CONT_SEQ_NUM, ansn_value, sizeof(ansn_value));
+  _end_tlvblock(out, block);
+
+  /* advertised neighbors */
+  memset(&metric, 0, sizeof(metric));
+  rfc7181_metric_encode(&metric, BENCH_LINK_COST);
+  rfc7181_metric_set_flag(&metric, RFC7181_LINKMETRIC_INCOMING_NEIGH);
+  rfc7181_metric_set_flag(&metric, RFC7181_LINKMETRIC_OUTGOING_NEIGH);
+
+  tlvs[0].type = RFC7181_ADDRTLV_NBR_ADDR_TYPE;
+  tlvs[0].value = &addrtype;
+  tlvs[0].length = 1;
+  tlvs[1].type = RFC7181_ADDRTLV_LINK_METRIC;
+  tlvs[1].value = metric.b;
+  tlvs[1].length = sizeof(metric.b);
+
+  _add_neighbor_blocks(out, topo, node, tlvs, ARRAYSIZE(tlvs));
+
+  _end_message(out, msg);
+  return abuf_has_failed(out) ? -1 : 0;
+}
+
+/**
+ * Append a message header with all optional fields
+ * @param out output buffer
+ * @param type message type
+ * @param node index of originating node
+ * @param hoplimit message hoplimit
+ * @param hopcount message hopcount
+ * @param seqno message sequence number
+ * @return offset of message header in buffer
+ */
+static size_t
+_begin_message(struct autobuf *out, uint8_t type, uint32_t node, uint8_t hoplimit, uint8_t hopcount,
+  uint16_t seqno) {
+  struct netaddr originator;
+  size_t start;
+
+  start = abuf_getlen(out);
+  bench_topology_get_address(&originator, node);
+
+  abuf_append_uint8(out, type);
+  abuf_append_uint8(out, RFC5444_MSG_FLAG_ORIGINATOR | RFC5444_MSG_FLAG_HOPLIMIT | RFC5444_MSG_FLAG_HOPCOUNT |
+                           RFC5444_MSG_FLAG_SEQNO | (BENCH_ADDRLEN - 1));
+  abuf_append_uint16(out, 0);
+  abuf_memcpy(out, netaddr_get_binptr(&originator), BENCH_ADDRLEN);
+  abuf_append_uint8(out, hoplimit);
+  abuf_append_uint8(out, hopcount);
+  abuf_append_uint8(out, seqno >> 8);
+  abuf_append_uint8(out, seqno & 0xff);
+  return start;
+}
+
+/**
+ * Fill in the size field of a message header
+ * @param out output buffer
+ * @param start offset of message header
+ */
+static void
+_end_message(struct autobuf *out, size_t start) {
+  _set_uint16(out, start + 2, abuf_getlen(out) - start);
+}
+
+/**
+ * Append an empty TLV block header
+ * @param out output buffer
+ * @return offset of TLV block header
+ */
+static size_t
+_begin_tlvblock(struct autobuf *out) {
+  size_t start;
+
+  start = abuf_getlen(out);
+  abuf_append_uint16(out, 0);
+  return start;
+}
+
+/**
+ * Fill in the length field of a TLV block
+ * @param out output buffer
+ * @param start offset of TLV block header
+ */
+static void
+_end_tlvblock(struct autobuf *out, size_t start) {
+  _set_uint16(out, start, abuf_getlen(out) - start - 2);
+}
+
+/**
+ * Append a TLV without index fields, which applies to the whole
+ * message or to all addresses of the current address block.
+ * @param out output buffer
+ * @param type TLV type
+ * @param value TLV value
+ * @param length length of value
+ */
+static void
+_add_tlv(struct autobuf *out, uint8_t type, const void *value, uint8_t length) {
+  abuf_append_uint8(out, type);
+  abuf_append_uint8(out, RFC5444_TLV_FLAG_VALUE);
+  abuf_append_uint8(out, length);
+  abuf_memcpy(out, value, length);
+}
+
+/**
+ * Append the working adjacencies of a node as address blocks,
+ * each one with the same set of address TLVs.
+ * @param out output buffer
+ * @param topo network topology
+ * @param node node index
+ * @param tlvs array of address TLVs
+ * @param tlv_count number of address TLVs
+ */
+static void
+_add_neighbor_blocks(struct autobuf *out, const struct bench_topology *topo, uint32_t node,
+  const struct _addrblock_tlv *tlvs, size_t tlv_count) {
+  struct netaddr addr;
+  size_t count_offset;
+  uint32_t i, count;
+
+  count = 0;
+  count_offset = 0;
+  for (i = topo->adj_index[node]; i < topo->adj_index[node + 1]; i++) {
+    if (topo->adj_down[i]) {
+      continue;
+    }
+
+    if (count == 0) {
+      /* start new address block without head/tail compression */
+      count_offset = abuf_getlen(out);
+      abuf_append_uint8(out, 0);
+      abuf_append_uint8(out, 0);
+    }
+
+    bench_topology_get_address(&addr, topo->adj[i]);
+    abuf_memcpy(out, netaddr_get_binptr(&addr), BENCH_ADDRLEN);
+    count++;
+
+    if (count == BENCH_MAX_ADDRBLOCK) {
+      _end_addrblock(out, count_offset, count, tlvs, tlv_count);
+      count = 0;
+    }
+  }
+
+  if (count > 0) {
+    _end_addrblock(out, count_offset, count, tlvs, tlv_count);
+  }
+}
+
+/**
+ * Fill in the address count of an address block and append its TLV block
+ * @param out output buffer
+ * @param start offset of address block
+ * @param count number of addresses in block
+ * @param tlvs array of address TLVs
+ * @param tlv_count number of address TLVs
+ */
+static void
+_end_addrblock(
+  struct autobuf *out, size_t start, uint32_t count, const struct _addrblock_tlv *tlvs, size_t tlv_count) {
+  size_t block, i;
+
+  if (!abuf_has_failed(out)) {
+    abuf_getptr(out)[start] = count;
+  }
+
+  block = _begin_tlvblock(out);
+  for (i = 0; i < tlv_count; i++) {
+    _add_tlv(out, tlvs[i].type, tlvs[i].value, tlvs[i].length);
+  }
+  _end_tlvblock(out, block);
+}
+
+/**
+ * Overwrite a 16 bit field in network byte order
+ * @param out output buffer
+ * @param offset offset of field
+ * @param value new value
+ */
+static void
+_set_uint16(struct autobuf *out, size_t offset, uint16_t value) {
+  if (abuf_has_failed(out)) {
+    return;
+  }
+  abuf_getptr(out)[offset] = value >> 8;
+  abuf_getptr(out)[offset + 1] = value & 0xff;
+}
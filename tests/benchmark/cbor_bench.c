@@ -0,0 +1,190 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ *
+ * Microbenchmark of the JSON and CBOR output of a json_session,
+ * filled with route-like template data similar to the output of
+ * the viewer based info plugins.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "common/autobuf.h"
+#include "common/cbor.h"
+#include "common/common_types.h"
+#include "common/json.h"
+#include "common/template.h"
+
+/*! default number of table lines per run */
+#define BENCH_LINE_COUNT 200000
+
+/* prototypes */
+static uint64_t _get_ns(void);
+static void _generate(struct json_session *session, struct abuf_template_data *data, uint32_t lines);
+
+/* sink for results, keeps the compiler from removing the loops */
+static volatile size_t _sink;
+
+/* template data of one table line */
+static char _value_dst[64], _value_gw[64], _value_metric[16], _value_hops[8];
+
+static struct abuf_template_data_entry _entries[] = {
+  { .key = "route_destination", .value = _value_dst, .string = true },
+  { .key = "route_gateway", .value = _value_gw, .string = true },
+  { .key = "route_metric", .value = _value_metric, .string = false },
+  { .key = "route_hops", .value = _value_hops, .string = false },
+  { .key = "route_local", .value = "false", .string = false },
+};
+
+/**
+ * @return monotonic time in nanoseconds
+ */
+static uint64_t
+_get_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Generate a table with route-like lines into a json session
+ * @param session json session
+ * @param data template data of a line
+ * @param lines number of lines
+ */
+static void
+_generate(struct json_session *session, struct abuf_template_data *data, uint32_t lines) {
+  uint32_t i;
+
+  json_start_object(session, NULL);
+  json_start_array(session, "route");
+  for (i = 0; i < lines; i++) {
+    snprintf(_value_dst, sizeof(_value_dst), "fd00:%x:%x::/64", (i >> 8) & 0xff, i & 0xff);
+    snprintf(_value_gw, sizeof(_value_gw), "fe80::%x", (i * 7) & 0xffff);
+    snprintf(_value_metric, sizeof(_value_metric), "%u", 1024 + (i * 13) % 65536);
+    snprintf(_value_hops, sizeof(_value_hops), "%u", 1 + i % 8);
+
+    json_start_object(session, NULL);
+    json_print_templates(session, data, 1);
+    json_end_object(session);
+  }
+  json_end_array(session);
+  json_end_object(session);
+}
+
+/**
+ * Print the result of one benchmark line
+ * @param name name of output format
+ * @param ns time to generate the output
+ * @param len length of the output
+ * @param lines number of lines
+ */
+static void
+_print(const char *name, uint64_t ns, size_t len, uint32_t lines) {
+  printf("%-12s %12" PRINTF_SIZE_T_SPECIFIER " %10.2f %10.2f\n", name, len, (double)len / lines, (double)ns / lines);
+}
+
+/**
+ * Main function of JSON/CBOR microbenchmark
+ * @param argc number of arguments
+ * @param argv argument array, optional number of lines
+ * @return 0 if the CBOR output could be parsed, 1 otherwise
+ */
+int
+main(int argc, char **argv) {
+  struct abuf_template_data data = { _entries, ARRAYSIZE(_entries) };
+  struct json_session session;
+  struct cbor_reader reader;
+  struct autobuf out;
+  uint64_t start, ns;
+  uint32_t lines;
+  int result;
+
+  lines = BENCH_LINE_COUNT;
+  if (argc > 1) {
+    lines = (uint32_t)strtoul(argv[1], NULL, 10);
+  }
+  if (lines == 0) {
+    fprintf(stderr, "Usage: %s [lines]\n", argv[0]);
+    return 1;
+  }
+
+  if (abuf_init(&out)) {
+    return 1;
+  }
+
+  printf("%-12s %12s %10s %10s\n", "format", "bytes", "bytes/line", "ns/line");
+
+  json_init_session(&session, &out);
+  start = _get_ns();
+  _generate(&session, &data, lines);
+  ns = _get_ns() - start;
+  _print("json", ns, abuf_getlen(&out), lines);
+
+  abuf_clear(&out);
+  json_init_cbor_session(&session, &out);
+  start = _get_ns();
+  _generate(&session, &data, lines);
+  ns = _get_ns() - start;
+  _print("cbor", ns, abuf_getlen(&out), lines);
+
+  /* parse the binary output again */
+  cbor_reader_init(&reader, abuf_getptr(&out), abuf_getlen(&out));
+  start = _get_ns();
+  result = cbor_skip(&reader);
+  ns = _get_ns() - start;
+  _print("cbor_parse", ns, abuf_getlen(&out), lines);
+
+  _sink = abuf_getlen(&out);
+  abuf_free(&out);
+
+  if (result || !cbor_reader_is_done(&reader)) {
+    printf("Could not parse CBOR output\n");
+    return 1;
+  }
+  return 0;
+}
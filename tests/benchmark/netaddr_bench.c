@@ -0,0 +1,232 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ *
+ * Microbenchmark of the word-wide netaddr comparison and subnet
+ * primitives compared to the bytewise memcmp() versions they replaced.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "common/common_types.h"
+#include "common/netaddr.h"
+
+#include "cunit/cunit_random.h"
+
+/*! number of addresses in the test set */
+#define BENCH_ADDRESS_COUNT 4096
+
+/*! default number of operations per run */
+#define BENCH_OPERATION_COUNT 20000000
+
+/* prototypes */
+static uint64_t _get_ns(void);
+static int _memcmp_cmp(const struct netaddr *a1, const struct netaddr *a2);
+static bool _bytewise_is_in_subnet(const struct netaddr *subnet, const struct netaddr *addr);
+
+/* sink for results, keeps the compiler from removing the loops */
+static volatile int _sink;
+
+/**
+ * @return monotonic time in nanoseconds
+ */
+static uint64_t
+_get_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Previous implementation of netaddr_cmp()
+ * @param a1 address 1
+ * @param a2 address 2
+ * @return >0 if a1>a2, <0 if a1<a2, 0 otherwise
+ */
+static int
+_memcmp_cmp(const struct netaddr *a1, const struct netaddr *a2) {
+  return memcmp(a1, a2, sizeof(*a1));
+}
+
+/**
+ * Previous implementation of netaddr_is_in_subnet(), not inlined
+ * like the library function
+ * @param subnet netaddr prefix
+ * @param addr netaddr object that might be inside the prefix
+ * @return true if addr is part of subnet, false otherwise
+ */
+static bool __attribute__((noinline))
+_bytewise_is_in_subnet(const struct netaddr *subnet, const struct netaddr *addr) {
+  const uint8_t *sbin, *bin;
+  size_t byte_length, bit_length;
+
+  if (netaddr_get_address_family(subnet) != netaddr_get_address_family(addr)) {
+    return false;
+  }
+
+  sbin = netaddr_get_binptr(subnet);
+  bin = netaddr_get_binptr(addr);
+  byte_length = netaddr_get_prefix_length(subnet) / 8;
+  bit_length = netaddr_get_prefix_length(subnet) % 8;
+
+  if (memcmp(sbin, bin, byte_length) != 0) {
+    return false;
+  }
+  if (bit_length != 0) {
+    return (sbin[byte_length] >> (8 - bit_length)) == (bin[byte_length] >> (8 - bit_length));
+  }
+  return true;
+}
+
+/**
+ * Print the result of one benchmark line
+ * @param name name of primitive
+ * @param old_ns time of the previous implementation
+ * @param new_ns time of the current implementation
+ * @param ops number of operations
+ */
+static void
+_print(const char *name, uint64_t old_ns, uint64_t new_ns, uint32_t ops) {
+  printf("%-16s %10.2f %10.2f %8.2f\n", name, (double)old_ns / ops, (double)new_ns / ops,
+    (double)old_ns / (double)(new_ns ? new_ns : 1));
+}
+
+/**
+ * Main function of netaddr microbenchmark
+ * @param argc number of arguments
+ * @param argv argument array, optional number of operations
+ * @return 0 if both implementations agree, 1 otherwise
+ */
+int
+main(int argc, char **argv) {
+  struct netaddr *addrs, *subnets;
+  uint64_t start, old_ns, new_ns;
+  uint32_t i, ops, state, mismatch;
+  uint8_t bin[16];
+  int af_type, sum;
+  size_t j, len;
+
+  ops = BENCH_OPERATION_COUNT;
+  if (argc > 1) {
+    ops = (uint32_t)strtoul(argv[1], NULL, 10);
+  }
+  if (ops == 0) {
+    fprintf(stderr, "Usage: %s [operations]\n", argv[0]);
+    return 1;
+  }
+
+  addrs = calloc(BENCH_ADDRESS_COUNT, sizeof(*addrs));
+  subnets = calloc(BENCH_ADDRESS_COUNT, sizeof(*subnets));
+  if (!addrs || !subnets) {
+    free(addrs);
+    free(subnets);
+    return 1;
+  }
+
+  /* mixed IPv4/IPv6 set of hosts inside a few shared prefixes */
+  state = 0x2468ace;
+  for (i = 0; i < BENCH_ADDRESS_COUNT; i++) {
+    af_type = (i & 1) ? AF_INET6 : AF_INET;
+    len = af_type == AF_INET ? 4 : 16;
+
+    memset(bin, 0, sizeof(bin));
+    bin[0] = af_type == AF_INET ? 10 : 0xfd;
+    for (j = 1; j < len; j++) {
+      bin[j] = (uint8_t)(j < len / 2 ? cunit_random(&state) & 3 : cunit_random(&state));
+    }
+    netaddr_from_binary(&addrs[i], bin, len, af_type);
+    netaddr_from_binary_prefix(&subnets[i], bin, len, af_type, (uint8_t)(cunit_random(&state) % (len * 8 + 1)));
+  }
+
+  printf("%-16s %10s %10s %8s\n", "primitive", "old_ns", "new_ns", "speedup");
+
+  mismatch = 0;
+  for (i = 0; i < BENCH_ADDRESS_COUNT; i++) {
+    j = (i * 7 + 1) % BENCH_ADDRESS_COUNT;
+    if ((_memcmp_cmp(&addrs[i], &addrs[j]) > 0) != (netaddr_cmp(&addrs[i], &addrs[j]) > 0)) {
+      mismatch++;
+    }
+    if (_bytewise_is_in_subnet(&subnets[j], &addrs[i]) != netaddr_is_in_subnet(&subnets[j], &addrs[i])) {
+      mismatch++;
+    }
+  }
+
+  sum = 0;
+  start = _get_ns();
+  for (i = 0; i < ops; i++) {
+    sum += _memcmp_cmp(&addrs[i % BENCH_ADDRESS_COUNT], &addrs[(i * 7 + 1) % BENCH_ADDRESS_COUNT]) > 0;
+  }
+  old_ns = _get_ns() - start;
+  start = _get_ns();
+  for (i = 0; i < ops; i++) {
+    sum += netaddr_cmp(&addrs[i % BENCH_ADDRESS_COUNT], &addrs[(i * 7 + 1) % BENCH_ADDRESS_COUNT]) > 0;
+  }
+  new_ns = _get_ns() - start;
+  _print("netaddr_cmp", old_ns, new_ns, ops);
+
+  start = _get_ns();
+  for (i = 0; i < ops; i++) {
+    sum += _bytewise_is_in_subnet(&subnets[(i * 7 + 1) % BENCH_ADDRESS_COUNT], &addrs[i % BENCH_ADDRESS_COUNT]);
+  }
+  old_ns = _get_ns() - start;
+  start = _get_ns();
+  for (i = 0; i < ops; i++) {
+    sum += netaddr_is_in_subnet(&subnets[(i * 7 + 1) % BENCH_ADDRESS_COUNT], &addrs[i % BENCH_ADDRESS_COUNT]);
+  }
+  new_ns = _get_ns() - start;
+  _print("is_in_subnet", old_ns, new_ns, ops);
+
+  _sink = sum;
+  free(addrs);
+  free(subnets);
+
+  if (mismatch) {
+    printf("%u mismatches between old and new implementation\n", mismatch);
+    return 1;
+  }
+  return 0;
+}
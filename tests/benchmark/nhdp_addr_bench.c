@@ -0,0 +1,239 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ *
+ * Lookup rate benchmark of the NHDP address hash compared to the
+ * avl_tree it replaces for exact address lookups.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "common/avl.h"
+#include "common/avl_comp.h"
+#include "common/common_types.h"
+#include "common/netaddr.h"
+
+#include "cunit/cunit_random.h"
+
+#include "nhdp/nhdp_addr_hash.h"
+
+/*! default number of addresses in the database */
+#define BENCH_ADDRESS_COUNT 5000
+
+/*! default number of lookups per run */
+#define BENCH_LOOKUP_COUNT 2000000
+
+/**
+ * Database object with both index types
+ */
+struct _bench_addr {
+  /*! address of object */
+  struct netaddr addr;
+
+  /*! member of avl tree */
+  struct avl_node _tree_node;
+
+  /*! member of hash table */
+  struct nhdp_addr_hash_node _hash_node;
+};
+
+/* prototypes */
+static void _generate(struct netaddr *addr, int af_type, uint32_t *state);
+static uint64_t _get_ns(void);
+static int _run(int af_type, uint32_t count, uint32_t lookups);
+
+/**
+ * Generate a random host address
+ * @param addr pointer to output address
+ * @param af_type address family
+ * @param state pointer to random generator state
+ */
+static void
+_generate(struct netaddr *addr, int af_type, uint32_t *state) {
+  uint8_t bin[16];
+  size_t i;
+
+  /* keep a common prefix like addresses of a single mesh */
+  memset(bin, 0, sizeof(bin));
+  bin[0] = af_type == AF_INET ? 10 : 0xfd;
+  for (i = af_type == AF_INET ? 1 : 8; i < (af_type == AF_INET ? 4u : 16u); i++) {
+    bin[i] = (uint8_t)cunit_random(state);
+  }
+  netaddr_from_binary(addr, bin, af_type == AF_INET ? 4 : 16, af_type);
+}
+
+/**
+ * @return monotonic time in nanoseconds
+ */
+static uint64_t
+_get_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Fill both indices with random addresses and compare their lookup rate.
+ * Half of the lookups hit an address in the database.
+ * @param af_type address family
+ * @param count number of addresses in database
+ * @param lookups number of lookups
+ * @return -1 if both indices disagree, 0 otherwise
+ */
+static int
+_run(int af_type, uint32_t count, uint32_t lookups) {
+  struct _bench_addr *objects, *obj;
+  struct netaddr *keys;
+  struct avl_tree tree;
+  struct nhdp_addr_hash hash;
+  uint64_t start, tree_ns, hash_ns;
+  uint32_t i, state, tree_hits, hash_hits;
+  int result;
+
+  objects = calloc(count, sizeof(*objects));
+  keys = calloc(count * 2, sizeof(*keys));
+  if (!objects || !keys) {
+    free(objects);
+    free(keys);
+    return -1;
+  }
+
+  avl_init(&tree, avl_comp_netaddr, false);
+  nhdp_addr_hash_init(&hash);
+
+  state = 0x12345678;
+  for (i = 0; i < count; i++) {
+    obj = &objects[i];
+    do {
+      _generate(&obj->addr, af_type, &state);
+    } while (avl_find(&tree, &obj->addr));
+
+    obj->_tree_node.key = &obj->addr;
+    obj->_hash_node.key = &obj->addr;
+    avl_insert(&tree, &obj->_tree_node);
+    nhdp_addr_hash_add(&hash, &obj->_hash_node);
+
+    /* every second key hits, the others (most likely) miss */
+    memcpy(&keys[i * 2], &obj->addr, sizeof(obj->addr));
+    _generate(&keys[i * 2 + 1], af_type, &state);
+  }
+
+  /* make sure both indices give the same answers */
+  result = 0;
+  for (i = 0; i < count * 2; i++) {
+    if (avl_find_element(&tree, &keys[i], obj, _tree_node) !=
+        nhdp_addr_hash_find_element(&hash, &keys[i], obj, _hash_node)) {
+      result = -1;
+    }
+  }
+
+  tree_hits = 0;
+  start = _get_ns();
+  for (i = 0; i < lookups; i++) {
+    if (avl_find(&tree, &keys[i % (count * 2)])) {
+      tree_hits++;
+    }
+  }
+  tree_ns = _get_ns() - start;
+
+  hash_hits = 0;
+  start = _get_ns();
+  for (i = 0; i < lookups; i++) {
+    if (nhdp_addr_hash_find(&hash, &keys[i % (count * 2)])) {
+      hash_hits++;
+    }
+  }
+  hash_ns = _get_ns() - start;
+
+  if (tree_hits != hash_hits) {
+    result = -1;
+  }
+
+  printf("%-5s %8u %9u %10.1f %10.1f %8.2f %s\n", af_type == AF_INET ? "ipv4" : "ipv6", count, lookups,
+    (double)tree_ns / lookups, (double)hash_ns / lookups, (double)tree_ns / (double)(hash_ns ? hash_ns : 1),
+    result ? "MISMATCH" : "ok");
+
+  for (i = 0; i < count; i++) {
+    avl_remove(&tree, &objects[i]._tree_node);
+    nhdp_addr_hash_remove(&hash, &objects[i]._hash_node);
+  }
+  nhdp_addr_hash_free(&hash);
+  free(objects);
+  free(keys);
+  return result;
+}
+
+/**
+ * Main function of address lookup benchmark
+ * @param argc number of arguments
+ * @param argv argument array, optional address count and lookup count
+ * @return 0 if both indices agree, 1 otherwise
+ */
+int
+main(int argc, char **argv) {
+  uint32_t count, lookups;
+  int result;
+
+  count = BENCH_ADDRESS_COUNT;
+  lookups = BENCH_LOOKUP_COUNT;
+  if (argc > 1) {
+    count = (uint32_t)strtoul(argv[1], NULL, 10);
+  }
+  if (argc > 2) {
+    lookups = (uint32_t)strtoul(argv[2], NULL, 10);
+  }
+  if (count == 0 || lookups == 0) {
+    fprintf(stderr, "Usage: %s [addresses] [lookups]\n", argv[0]);
+    return 1;
+  }
+
+  printf("%-5s %8s %9s %10s %10s %8s\n", "af", "addrs", "lookups", "avl_ns", "hash_ns", "speedup");
+
+  result = _run(AF_INET, count, lookups);
+  result |= _run(AF_INET6, count, lookups);
+  return result ? 1 : 0;
+}
@@ -0,0 +1,779 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <time.h>
+
+#include "common/autobuf.h"
+#include "common/avl.h"
+#include "common/common_types.h"
+#include "common/list.h"
+#include "common/netaddr.h"
+
+#include "config/cfg_db.h"
+#include "config/cfg_schema.h"
+#include "core/oonf_cfg.h"
+#include "core/oonf_logging.h"
+#include "core/oonf_main.h"
+#include "core/oonf_subsystem.h"
+#include "subsystems/oonf_class.h"
+#include "subsystems/oonf_clock.h"
+#include "subsystems/oonf_rfc5444.h"
+#include "subsystems/oonf_timer.h"
+
+#include "constant_metric/constant_metric.h"
+#include "nhdp/nhdp.h"
+#include "nhdp/nhdp_db.h"
+#include "nhdp/nhdp_domain.h"
+
+#include "olsrv2/olsrv2.h"
+#include "olsrv2/olsrv2_routing.h"
+#include "olsrv2/olsrv2_tc.h"
+
+#include "bench_stubs.h"
+#include "bench_topology.h"
+#include "bench_writer.h"
+
+/* definitions */
+#define LOG_BENCH _bench_subsystem.logging
+
+/*! subsystem identifier */
+#define OONF_BENCH_SUBSYSTEM "benchmark"
+
+/*! name of the in-memory interface of the observer node */
+#define BENCH_INTERFACE "bench0"
+
+/*! virtual time for processing after injecting a burst of messages */
+#define BENCH_PROCESSING_TIME 100
+
+/*! virtual time for the interface and socket setup */
+#define BENCH_SETUP_TIME 1000
+
+/*! virtual time for route calculation after the initial flooding */
+#define BENCH_ROUTING_TIME 1000
+
+/*! virtual time for cleanup during shutdown */
+#define BENCH_SHUTDOWN_TIME 500
+
+/**
+ * benchmark configuration
+ */
+struct _bench_config {
+  /*! shape of the network */
+  int32_t topology;
+
+  /*! number of nodes including the observer */
+  int32_t nodes;
+
+  /*! average number of neighbors in geometric topology */
+  int32_t degree;
+
+  /*! random generator seed */
+  int32_t seed;
+
+  /*! HELLO interval of the synthetic nodes */
+  uint64_t hello_interval;
+
+  /*! TC interval of the synthetic nodes */
+  uint64_t tc_interval;
+
+  /*! virtual duration of the steady state phase */
+  uint64_t steady_time;
+
+  /*! percentage of links toggled in each churn round */
+  int32_t churn_percent;
+
+  /*! number of churn rounds */
+  int32_t churn_rounds;
+
+  /*! fail if the observer did not calculate a route to every reachable node */
+  bool check_routes;
+};
+
+/**
+ * Protocol state of a synthetic node
+ */
+struct _bench_node {
+  /*! next message sequence number */
+  uint16_t seqno;
+
+  /*! current advertised neighbor sequence number */
+  uint16_t ansn;
+};
+
+/**
+ * Resource usage and counters at the start of a phase
+ */
+struct _bench_sample {
+  /*! user and system CPU time in microseconds */
+  uint64_t cpu_us;
+
+  /*! monotonic wall clock in nanoseconds */
+  uint64_t wall_ns;
+
+  /*! number of oonf_class_malloc() calls, including objects reused from free lists */
+  uint64_t class_allocs;
+
+  /*! packet counters */
+  struct bench_packet_stats packets;
+
+  /*! routing counters */
+  struct bench_routing_stats routes;
+};
+
+/* prototypes */
+static int _init(void);
+static void _cleanup(void);
+
+static int _bench_scheduling(void);
+static int _run_benchmark(void);
+static void _advance(uint64_t interval);
+static void _run_interval(uint64_t *since_tc);
+static int _inject_hello(uint32_t node);
+static void _inject_tc(uint32_t node);
+static int _inject_all_hellos(void);
+static void _inject_all_tcs(void);
+static void _run_churn_round(void);
+static int _check_routes(const char *phase);
+static int _check_reload(void);
+static int _apply_interface_entry(const char *key, const char *value);
+static uint32_t _count_reachable(void);
+static size_t _count_routes(void);
+static void _sample(struct _bench_sample *sample);
+static void _report(const char *phase, const struct _bench_sample *start);
+
+static void _cb_cfg_changed(void);
+
+/* configuration */
+static const char *_TOPOLOGY_NAMES[] = {
+  [BENCH_TOPOLOGY_GRID] = "grid",
+  [BENCH_TOPOLOGY_GEOMETRIC] = "geometric",
+  [BENCH_TOPOLOGY_CLIQUE] = "clique",
+};
+
+static struct cfg_schema_entry _bench_entries[] = {
+  CFG_MAP_CHOICE(_bench_config, topology, "topology", "grid", "Shape of the synthetic network", _TOPOLOGY_NAMES),
+  CFG_MAP_INT32_MINMAX(_bench_config, nodes, "nodes", "100", "Number of nodes including the observer", 0, 2, 100000),
+  CFG_MAP_INT32_MINMAX(
+    _bench_config, degree, "degree", "8", "Average number of neighbors in geometric topology", 0, 1, 1000),
+  CFG_MAP_INT32_MINMAX(_bench_config, seed, "seed", "1", "Seed for the topology random generator", 0, 1, INT32_MAX),
+  CFG_MAP_CLOCK_MIN(_bench_config, hello_interval, "hello_interval", "2.0", "HELLO interval of synthetic nodes", 100),
+  CFG_MAP_CLOCK_MIN(_bench_config, tc_interval, "tc_interval", "5.0", "TC interval of synthetic nodes", 100),
+  CFG_MAP_CLOCK(_bench_config, steady_time, "steady_time", "30.0", "Virtual duration of the steady state phase"),
+  CFG_MAP_INT32_MINMAX(
+    _bench_config, churn_percent, "churn_percent", "1", "Percentage of links toggled per churn round", 0, 0, 100),
+  CFG_MAP_INT32_MINMAX(_bench_config, churn_rounds, "churn_rounds", "10", "Number of churn rounds", 0, 0, 100000),
+  CFG_MAP_BOOL(_bench_config, check_routes, "check_routes", "true",
+    "Fail if the observer has no route to a reachable node after the initial flooding"),
+};
+
+static struct cfg_schema_section _bench_section = {
+  .type = OONF_BENCH_SUBSYSTEM,
+  .cb_delta_handler = _cb_cfg_changed,
+  .entries = _bench_entries,
+  .entry_count = ARRAYSIZE(_bench_entries),
+};
+
+static struct _bench_config _config;
+
+/* plugin declaration */
+static const char *_dependencies[] = {
+  OONF_CLASS_SUBSYSTEM,
+  OONF_CLOCK_SUBSYSTEM,
+  OONF_RFC5444_SUBSYSTEM,
+  OONF_TIMER_SUBSYSTEM,
+  OONF_NHDP_SUBSYSTEM,
+  OONF_OLSRV2_SUBSYSTEM,
+  OONF_CONSTANT_METRIC_SUBSYSTEM,
+};
+static struct oonf_subsystem _bench_subsystem = {
+  .name = OONF_BENCH_SUBSYSTEM,
+  .dependencies = _dependencies,
+  .dependencies_count = ARRAYSIZE(_dependencies),
+  .descr = "NHDP/OLSRv2 scaling benchmark",
+
+  .cfg_section = &_bench_section,
+
+  .init = _init,
+  .cleanup = _cleanup,
+};
+DECLARE_OONF_PLUGIN(_bench_subsystem);
+
+/* synthetic network */
+static struct bench_topology _topology;
+static struct _bench_node *_nodes;
+static uint32_t _random;
+
+/* buffer for generated packets */
+static struct autobuf _packet;
+
+/* true after the benchmark has been run */
+static bool _finished;
+
+/**
+ * Initialize benchmark subsystem
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_init(void) {
+  char cost[16];
+
+  if (abuf_init(&_packet)) {
+    return -1;
+  }
+
+  /* the benchmark replaces the socket scheduler */
+  if (oonf_main_set_scheduler(_bench_scheduling)) {
+    abuf_free(&_packet);
+    return -1;
+  }
+
+  /* the observer runs NHDP on a single in-memory interface */
+  if (cfg_db_add_namedsection(oonf_cfg_get_rawdb(), "interface", BENCH_INTERFACE) == NULL) {
+    abuf_free(&_packet);
+    return -1;
+  }
+
+  /* same constant cost for all links the synthetic neighbors advertise */
+  snprintf(cost, sizeof(cost), "- %u", BENCH_LINK_COST);
+  if (cfg_db_overwrite_entry(oonf_cfg_get_rawdb(), "interface", BENCH_INTERFACE, "constant_metric", cost) == NULL) {
+    abuf_free(&_packet);
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * Cleanup benchmark subsystem
+ */
+static void
+_cleanup(void) {
+  bench_topology_free(&_topology);
+  free(_nodes);
+  _nodes = NULL;
+  abuf_free(&_packet);
+}
+
+/**
+ * Scheduler of the benchmark. The first call runs the whole
+ * benchmark in virtual time and stops the application, the
+ * following calls let the subsystems finish their shutdown.
+ * @return -1 if the scheduler should stop, 0 otherwise
+ */
+static int
+_bench_scheduling(void) {
+  int result;
+
+  if (_finished) {
+    _advance(BENCH_SHUTDOWN_TIME);
+    return -1;
+  }
+
+  _finished = true;
+  result = _run_benchmark();
+  oonf_cfg_exit();
+  return result;
+}
+
+/**
+ * Run all benchmark phases and print a report for each phase
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_run_benchmark(void) {
+  struct _bench_sample start;
+  struct netaddr prefix;
+  uint64_t elapsed, since_tc;
+  int32_t round;
+
+  printf("topology=%s nodes=%d degree=%d seed=%d hello=%" PRIu64 "ms tc=%" PRIu64 "ms\n",
+    _TOPOLOGY_NAMES[_config.topology], _config.nodes, _config.degree, _config.seed, _config.hello_interval,
+    _config.tc_interval);
+  printf("%-8s %9s %9s %12s %8s %8s %7s %7s %6s %6s %8s %8s %7s %9s\n", "phase", "cpu_ms", "wall_ms", "class_allocs",
+    "rx_pkt", "tx_pkt", "rt_set", "rt_del", "neigh", "links", "tc_nodes", "tc_edges", "routes", "maxrss_kb");
+
+  /* generate network and bring up the observer interface */
+  _sample(&start);
+
+  _random = (uint32_t)_config.seed;
+  if (bench_topology_generate(
+        &_topology, _config.topology, (uint32_t)_config.nodes, (uint32_t)_config.degree, &_random)) {
+    OONF_WARN(LOG_BENCH, "Could not generate %s topology with %d nodes", _TOPOLOGY_NAMES[_config.topology],
+      _config.nodes);
+    return -1;
+  }
+
+  _nodes = calloc(_topology.node_count, sizeof(*_nodes));
+  if (!_nodes) {
+    return -1;
+  }
+
+  bench_topology_get_address(&prefix, _topology.observer);
+  netaddr_set_prefix_length(&prefix, 8);
+  if (bench_os_interface_set_address(BENCH_INTERFACE, &prefix) == NULL) {
+    return -1;
+  }
+  _advance(BENCH_SETUP_TIME);
+  _report("setup", &start);
+
+  /* discovery of all neighbors, the second HELLO completes the link handshake */
+  _sample(&start);
+  if (_inject_all_hellos()) {
+    OONF_WARN(LOG_BENCH, "Interface %s has no active RFC5444 socket", BENCH_INTERFACE);
+    return -1;
+  }
+  _advance(BENCH_PROCESSING_TIME);
+  _inject_all_hellos();
+  _advance(BENCH_PROCESSING_TIME);
+  _report("hello", &start);
+
+  /* flooding of the whole topology */
+  _sample(&start);
+  _inject_all_tcs();
+  _advance(BENCH_PROCESSING_TIME);
+  _report("tc", &start);
+
+  /* pending route calculation */
+  _sample(&start);
+  _advance(BENCH_ROUTING_TIME);
+  _report("routing", &start);
+
+  if (_check_routes("routing")) {
+    return -1;
+  }
+
+  /* refresh all messages with their intervals */
+  _sample(&start);
+  since_tc = 0;
+  for (elapsed = 0; elapsed < _config.steady_time; elapsed += _config.hello_interval) {
+    _run_interval(&since_tc);
+  }
+  _report("steady", &start);
+
+  /* random link breaks and repairs, one round per HELLO interval */
+  _sample(&start);
+  for (round = 0; round < _config.churn_rounds; round++) {
+    _run_churn_round();
+    _run_interval(&since_tc);
+  }
+  _report("churn", &start);
+
+  if (_check_routes("churn")) {
+    return -1;
+  }
+
+  /* configuration changes of the observer interface */
+  if (_check_reload()) {
+    return -1;
+  }
+
+  /* let everything time out */
+  _sample(&start);
+  _advance(3 * (_config.hello_interval + _config.tc_interval) + BENCH_ROUTING_TIME);
+  _report("expire", &start);
+
+  return 0;
+}
+
+/**
+ * Advance the virtual clock and fire all timers on the way
+ * @param interval virtual time in milliseconds
+ */
+static void
+_advance(uint64_t interval) {
+  uint64_t now, next, end;
+
+  end = oonf_clock_getNow() + interval;
+  do {
+    now = oonf_clock_getNow();
+    next = oonf_timer_getNextEvent();
+    if (next > end) {
+      next = end;
+    }
+    if (next > now) {
+      bench_os_clock_advance(next - now);
+    }
+
+    if (oonf_clock_update()) {
+      return;
+    }
+    oonf_timer_walk();
+    bench_os_routing_flush();
+  } while (oonf_clock_getNow() < end);
+}
+
+/**
+ * Advance the virtual clock by one HELLO interval and refresh
+ * all HELLOs (and all TCs if the TC interval is over)
+ * @param since_tc time since the last TCs were injected
+ */
+static void
+_run_interval(uint64_t *since_tc) {
+  _advance(_config.hello_interval);
+  _inject_all_hellos();
+
+  *since_tc += _config.hello_interval;
+  if (*since_tc >= _config.tc_interval) {
+    _inject_all_tcs();
+    *since_tc = 0;
+  }
+}
+
+/**
+ * Inject a HELLO of a neighbor of the observer
+ * @param node index of neighbor
+ * @return -1 if the HELLO could not be injected, 0 otherwise
+ */
+static int
+_inject_hello(uint32_t node) {
+  struct netaddr src;
+
+  if (bench_writer_hello(&_packet, &_topology, node, _nodes[node].seqno++, _config.hello_interval,
+        3 * _config.hello_interval)) {
+    OONF_WARN(LOG_BENCH, "Could not generate HELLO for node %u", node);
+    return -1;
+  }
+
+  bench_topology_get_address(&src, node);
+  return bench_packet_inject(BENCH_INTERFACE, &src, abuf_getptr(&_packet), abuf_getlen(&_packet));
+}
+
+/**
+ * Inject a TC of a node through the first hop of its
+ * shortest path to the observer
+ * @param node index of originator
+ */
+static void
+_inject_tc(uint32_t node) {
+  struct netaddr src;
+  uint32_t hopcount;
+
+  if (node == _topology.observer || _topology.hops[node] == BENCH_TOPOLOGY_UNREACHABLE) {
+    return;
+  }
+
+  hopcount = _topology.hops[node] - 1;
+  if (hopcount > 254) {
+    return;
+  }
+
+  if (bench_writer_tc(&_packet, &_topology, node, _nodes[node].seqno++, _nodes[node].ansn, hopcount,
+        _config.tc_interval, 3 * _config.tc_interval)) {
+    OONF_WARN(LOG_BENCH, "Could not generate TC for node %u", node);
+    return;
+  }
+
+  bench_topology_get_address(&src, _topology.via[node]);
+  bench_packet_inject(BENCH_INTERFACE, &src, abuf_getptr(&_packet), abuf_getlen(&_packet));
+}
+
+/**
+ * Inject HELLOs of all working neighbors of the observer
+ * @return -1 if a HELLO could not be injected, 0 otherwise
+ */
+static int
+_inject_all_hellos(void) {
+  uint32_t i;
+  int result = 0;
+
+  for (i = _topology.adj_index[_topology.observer]; i < _topology.adj_index[_topology.observer + 1]; i++) {
+    if (!_topology.adj_down[i] && _inject_hello(_topology.adj[i])) {
+      result = -1;
+    }
+  }
+  return result;
+}
+
+/**
+ * Inject TCs of all nodes reachable from the observer
+ */
+static void
+_inject_all_tcs(void) {
+  uint32_t i;
+
+  for (i = 0; i < _topology.node_count; i++) {
+    _inject_tc(i);
+  }
+}
+
+/**
+ * Toggle a percentage of all links and inject the HELLOs and TCs
+ * of the nodes whose neighborhood changed.
+ */
+static void
+_run_churn_round(void) {
+  uint32_t count, i, j, n1, n2;
+  uint32_t *changed;
+
+  count = (_topology.adj_count / 2) * (uint32_t)_config.churn_percent / 100;
+  if (count == 0) {
+    count = 1;
+  }
+
+  changed = calloc(count * 2, sizeof(*changed));
+  if (!changed) {
+    return;
+  }
+
+  for (i = 0; i < count; i++) {
+    if (bench_topology_toggle_edge(&_topology, &_random, &n1, &n2)) {
+      break;
+    }
+    _nodes[n1].ansn++;
+    _nodes[n2].ansn++;
+    changed[i * 2] = n1;
+    changed[i * 2 + 1] = n2;
+  }
+  count = i;
+
+  bench_topology_update_paths(&_topology);
+
+  for (i = 0; i < count * 2; i++) {
+    if (_topology.hops[changed[i]] == 1) {
+      _inject_hello(changed[i]);
+    }
+  }
+  for (i = 0; i < count * 2; i++) {
+    /* each node only sends one TC per round */
+    for (j = 0; j < i && changed[j] != changed[i]; j++)
+      ;
+    if (j == i) {
+      _inject_tc(changed[i]);
+    }
+  }
+
+  free(changed);
+}
+
+/**
+ * Compare the routes of the observer with the synthetic network
+ * @param phase name of the benchmark phase for the warning
+ * @return -1 if routes are missing, 0 otherwise
+ */
+static int
+_check_routes(const char *phase) {
+  uint32_t reachable;
+  size_t routes;
+
+  if (!_config.check_routes) {
+    return 0;
+  }
+
+  reachable = _count_reachable();
+  routes = _count_routes();
+  if (routes < reachable) {
+    OONF_WARN(LOG_BENCH, "Observer has only %" PRINTF_SIZE_T_SPECIFIER " routes for %u reachable nodes after %s",
+      routes, reachable, phase);
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @return number of nodes reachable by the observer (excluding itself)
+ */
+static uint32_t
+_count_reachable(void) {
+  uint32_t i, count;
+
+  count = 0;
+  for (i = 0; i < _topology.node_count; i++) {
+    if (i != _topology.observer && _topology.hops[i] != BENCH_TOPOLOGY_UNREACHABLE) {
+      count++;
+    }
+  }
+  return count;
+}
+
+/**
+ * @return number of routing entries of the default domain
+ */
+static size_t
+_count_routes(void) {
+  struct nhdp_domain *domain;
+
+  domain = nhdp_domain_get_by_ext(0);
+  if (!domain) {
+    return 0;
+  }
+  return olsrv2_routing_get_tree(domain)->count;
+}
+
+/**
+ * Change the RFC5444 settings of the observer interface and check
+ * that only a changed socket setting reconfigures its socket
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_check_reload(void) {
+  struct oonf_rfc5444_interface *interf;
+  uint64_t reconfigured;
+
+  interf = oonf_rfc5444_get_interface(oonf_rfc5444_get_default_protocol(), BENCH_INTERFACE);
+  if (!interf) {
+    OONF_WARN(LOG_BENCH, "RFC5444 interface %s does not exist", BENCH_INTERFACE);
+    return -1;
+  }
+
+  /* the aggregation interval is applied without touching the socket */
+  reconfigured = bench_packet_get_stats()->reconfigured;
+  if (_apply_interface_entry("aggregation_interval", "0.050")) {
+    return -1;
+  }
+  if (interf->aggregation_interval != 50 || bench_packet_get_stats()->reconfigured != reconfigured) {
+    OONF_WARN(LOG_BENCH, "New aggregation interval %" PRIu64 " reconfigured the socket %" PRIu64 " times",
+      interf->aggregation_interval, bench_packet_get_stats()->reconfigured - reconfigured);
+    return -1;
+  }
+
+  /* a socket setting reconfigures the socket once */
+  if (_apply_interface_entry("dscp", "0")) {
+    return -1;
+  }
+  if (bench_packet_get_stats()->reconfigured != reconfigured + 1) {
+    OONF_WARN(LOG_BENCH, "New dscp reconfigured the socket %" PRIu64 " times",
+      bench_packet_get_stats()->reconfigured - reconfigured);
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * Change one entry of the observer interface section and apply
+ * the configuration like a reload
+ * @param key name of configuration entry
+ * @param value new value of configuration entry
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_apply_interface_entry(const char *key, const char *value) {
+  if (cfg_db_overwrite_entry(oonf_cfg_get_rawdb(), "interface", BENCH_INTERFACE, key, value) == NULL ||
+      oonf_cfg_apply()) {
+    OONF_WARN(LOG_BENCH, "Could not set %s of interface %s to %s", key, BENCH_INTERFACE, value);
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * Take a snapshot of resource usage and counters
+ * @param sample buffer for snapshot
+ */
+static void
+_sample(struct _bench_sample *sample) {
+  struct oonf_class *c;
+  struct rusage usage;
+  struct timespec ts;
+
+  getrusage(RUSAGE_SELF, &usage);
+  sample->cpu_us = (uint64_t)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000ull +
+                   (uint64_t)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  sample->wall_ns = (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+
+  /* heap allocations by other code (e.g. autobufs) are not counted */
+  sample->class_allocs = 0;
+  avl_for_each_element(oonf_class_get_tree(), c, _node) {
+    sample->class_allocs += (uint64_t)oonf_class_get_allocations(c) + oonf_class_get_recycled(c);
+  }
+
+  memcpy(&sample->packets, bench_packet_get_stats(), sizeof(sample->packets));
+  memcpy(&sample->routes, bench_os_routing_get_stats(), sizeof(sample->routes));
+}
+
+/**
+ * Print the resource usage of a phase and the state of the observer
+ * @param phase name of phase
+ * @param start snapshot taken at the start of the phase
+ */
+static void
+_report(const char *phase, const struct _bench_sample *start) {
+  struct _bench_sample end;
+  struct olsrv2_tc_node *tc_node;
+  struct nhdp_neighbor *neigh;
+  struct nhdp_link *lnk;
+  struct rusage usage;
+  size_t neighbors, links, edges;
+
+  _sample(&end);
+  getrusage(RUSAGE_SELF, &usage);
+
+  neighbors = 0;
+  list_for_each_element(nhdp_db_get_neigh_list(), neigh, _global_node) {
+    neighbors++;
+  }
+
+  links = 0;
+  list_for_each_element(nhdp_db_get_link_list(), lnk, _global_node) {
+    links++;
+  }
+
+  edges = 0;
+  avl_for_each_element(olsrv2_tc_get_tree(), tc_node, _originator_node) {
+    edges += tc_node->_edges.count;
+  }
+
+  printf("%-8s %9.1f %9.1f %12" PRIu64 " %8" PRIu64 " %8" PRIu64 " %7" PRIu64 " %7" PRIu64
+         " %6zu %6zu %8u %8zu %7zu %9ld\n",
+    phase, (end.cpu_us - start->cpu_us) / 1000.0, (end.wall_ns - start->wall_ns) / 1000000.0,
+    end.class_allocs - start->class_allocs, end.packets.rx_packets - start->packets.rx_packets,
+    end.packets.tx_packets - start->packets.tx_packets, end.routes.set - start->routes.set,
+    end.routes.removed - start->routes.removed, neighbors, links, olsrv2_tc_get_tree()->count, edges,
+    _count_routes(), usage.ru_maxrss);
+  fflush(stdout);
+}
+
+/**
+ * Configuration of benchmark changed
+ */
+static void
+_cb_cfg_changed(void) {
+  if (cfg_schema_tobin(&_config, _bench_section.post, _bench_entries, ARRAYSIZE(_bench_entries))) {
+    OONF_WARN(LOG_BENCH, "Could not convert " OONF_BENCH_SUBSYSTEM " configuration");
+  }
+}
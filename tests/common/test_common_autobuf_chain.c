@@ -0,0 +1,259 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/uio.h>
+
+#include "common/autobuf.h"
+#include "common/autobuf_chain.h"
+#include "common/common_types.h"
+
+#include "cunit/cunit.h"
+
+static char _data[ABUF_CHAIN_CHUNK_SIZE * 3];
+static char _flat[ABUF_CHAIN_CHUNK_SIZE * 3];
+
+static struct abuf_chain _chain;
+
+static void
+clear_elements(void) {
+  size_t i;
+
+  for (i = 0; i < sizeof(_data); i++) {
+    _data[i] = (char)('a' + i % 26);
+  }
+  memset(_flat, 0, sizeof(_flat));
+}
+
+/* copy the content of the chain into _flat */
+static size_t
+_flatten(void) {
+  struct iovec iov[8];
+  size_t len;
+  int count, i;
+
+  count = abuf_chain_get_iovec(&_chain, iov, 8);
+
+  len = 0;
+  for (i = 0; i < count; i++) {
+    memcpy(&_flat[len], iov[i].iov_base, iov[i].iov_len);
+    len += iov[i].iov_len;
+  }
+  return len;
+}
+
+static void
+test_chain_memcpy(void) {
+  struct iovec iov[8];
+  size_t len;
+
+  START_TEST();
+
+  abuf_chain_init(&_chain);
+
+  CHECK_TRUE(abuf_chain_memcpy(&_chain, _data, 100) == 0, "memcpy of 100 bytes failed");
+  CHECK_TRUE(abuf_chain_memcpy(&_chain, &_data[100], ABUF_CHAIN_CHUNK_SIZE) == 0, "memcpy of a full chunk failed");
+  CHECK_TRUE(abuf_chain_getlen(&_chain) == ABUF_CHAIN_CHUNK_SIZE + 100,
+    "chain length is not %d but %" PRINTF_SIZE_T_SPECIFIER, ABUF_CHAIN_CHUNK_SIZE + 100,
+    abuf_chain_getlen(&_chain));
+
+  CHECK_TRUE(abuf_chain_get_iovec(&_chain, iov, 8) == 2, "data should be stored in two chunks");
+  CHECK_TRUE(abuf_chain_get_iovec(&_chain, iov, 1) == 1, "iovec array size is not honored");
+
+  len = _flatten();
+  CHECK_TRUE(len == ABUF_CHAIN_CHUNK_SIZE + 100, "iovec length is %" PRINTF_SIZE_T_SPECIFIER, len);
+  CHECK_TRUE(memcmp(_flat, _data, len) == 0, "chain content differs from input");
+
+  CHECK_TRUE(!abuf_chain_has_failed(&_chain), "chain reported an error");
+  abuf_chain_free(&_chain);
+  CHECK_TRUE(abuf_chain_getlen(&_chain) == 0, "chain is not empty after free");
+
+  END_TEST();
+}
+
+static void
+test_chain_appendf(void) {
+  size_t len;
+
+  START_TEST();
+
+  abuf_chain_init(&_chain);
+
+  CHECK_TRUE(abuf_chain_puts(&_chain, "abc") == 0, "puts failed");
+  CHECK_TRUE(abuf_chain_appendf(&_chain, "%d-%s", 42, "x") == 4, "appendf did not report 4 characters");
+
+  /* larger than the remaining space of the first chunk */
+  _data[ABUF_CHAIN_CHUNK_SIZE + 10] = 0;
+  CHECK_TRUE(abuf_chain_appendf(&_chain, "%s", _data) == ABUF_CHAIN_CHUNK_SIZE + 10,
+    "appendf of a string larger than a chunk failed");
+
+  len = _flatten();
+  CHECK_TRUE(len == ABUF_CHAIN_CHUNK_SIZE + 17, "iovec length is %" PRINTF_SIZE_T_SPECIFIER, len);
+  CHECK_TRUE(memcmp(_flat, "abc42-x", 7) == 0, "chain does not start with 'abc42-x'");
+  CHECK_TRUE(memcmp(&_flat[7], _data, ABUF_CHAIN_CHUNK_SIZE + 10) == 0, "appended string differs from input");
+
+  abuf_chain_free(&_chain);
+
+  END_TEST();
+}
+
+static void
+test_chain_adopt(void) {
+  struct autobuf abuf;
+  size_t len;
+
+  START_TEST();
+
+  abuf_chain_init(&_chain);
+  CHECK_TRUE(abuf_init(&abuf) == 0, "Could not initialize autobuf");
+
+  abuf_puts(&abuf, "first ");
+  abuf_memcpy(&abuf, _data, ABUF_CHAIN_CHUNK_SIZE);
+
+  CHECK_TRUE(abuf_chain_puts(&_chain, "head ") == 0, "puts failed");
+  CHECK_TRUE(abuf_chain_adopt(&_chain, &abuf) == 0, "adopt failed");
+  CHECK_TRUE(abuf_getlen(&abuf) == 0, "autobuf is not empty after adopt");
+
+  /* autobuf must still be usable */
+  abuf_puts(&abuf, "second");
+  CHECK_TRUE(abuf_getlen(&abuf) == 6, "autobuf not usable after adopt");
+
+  CHECK_TRUE(abuf_chain_puts(&_chain, " tail") == 0, "puts failed");
+
+  len = _flatten();
+  CHECK_TRUE(len == ABUF_CHAIN_CHUNK_SIZE + 16, "iovec length is %" PRINTF_SIZE_T_SPECIFIER, len);
+  CHECK_TRUE(memcmp(_flat, "head first ", 11) == 0, "chain does not start with 'head first '");
+  CHECK_TRUE(memcmp(&_flat[11], _data, ABUF_CHAIN_CHUNK_SIZE) == 0, "adopted data differs from input");
+  CHECK_TRUE(memcmp(&_flat[11 + ABUF_CHAIN_CHUNK_SIZE], " tail", 5) == 0, "chain does not end with ' tail'");
+
+  abuf_chain_free(&_chain);
+  abuf_free(&abuf);
+
+  END_TEST();
+}
+
+static void
+test_chain_pull(void) {
+  size_t len;
+
+  START_TEST();
+
+  abuf_chain_init(&_chain);
+  CHECK_TRUE(abuf_chain_memcpy(&_chain, _data, ABUF_CHAIN_CHUNK_SIZE * 2 + 50) == 0, "memcpy failed");
+
+  /* pull across a chunk border */
+  abuf_chain_pull(&_chain, ABUF_CHAIN_CHUNK_SIZE + 20);
+  CHECK_TRUE(abuf_chain_getlen(&_chain) == ABUF_CHAIN_CHUNK_SIZE + 30,
+    "chain length is %" PRINTF_SIZE_T_SPECIFIER, abuf_chain_getlen(&_chain));
+
+  len = _flatten();
+  CHECK_TRUE(len == ABUF_CHAIN_CHUNK_SIZE + 30, "iovec length is %" PRINTF_SIZE_T_SPECIFIER, len);
+  CHECK_TRUE(memcmp(_flat, &_data[ABUF_CHAIN_CHUNK_SIZE + 20], len) == 0, "chain content wrong after pull");
+
+  /* data appended after a pull must end up behind the remaining data */
+  CHECK_TRUE(abuf_chain_puts(&_chain, "end") == 0, "puts failed");
+  abuf_chain_pull(&_chain, ABUF_CHAIN_CHUNK_SIZE + 30);
+
+  len = _flatten();
+  CHECK_TRUE(len == 3 && memcmp(_flat, "end", 3) == 0, "chain content is not 'end' after second pull");
+
+  abuf_chain_pull(&_chain, 3);
+  CHECK_TRUE(abuf_chain_getlen(&_chain) == 0, "chain is not empty");
+  CHECK_TRUE(abuf_chain_get_iovec(&_chain, NULL, 0) == 0, "empty chain returned iovec elements");
+
+  abuf_chain_free(&_chain);
+
+  END_TEST();
+}
+
+static void
+test_chain_setlen(void) {
+  struct iovec iov[8];
+  size_t len;
+
+  START_TEST();
+
+  abuf_chain_init(&_chain);
+  CHECK_TRUE(abuf_chain_memcpy(&_chain, _data, ABUF_CHAIN_CHUNK_SIZE + 50) == 0, "memcpy failed");
+
+  /* cut back across a chunk border */
+  abuf_chain_setlen(&_chain, ABUF_CHAIN_CHUNK_SIZE - 10);
+  CHECK_TRUE(abuf_chain_getlen(&_chain) == ABUF_CHAIN_CHUNK_SIZE - 10,
+    "chain length is %" PRINTF_SIZE_T_SPECIFIER, abuf_chain_getlen(&_chain));
+  CHECK_TRUE(abuf_chain_get_iovec(&_chain, iov, 8) == 1, "emptied chunk was not freed");
+
+  /* data appended after setlen must follow the remaining data */
+  CHECK_TRUE(abuf_chain_puts(&_chain, "end") == 0, "puts failed");
+
+  len = _flatten();
+  CHECK_TRUE(len == ABUF_CHAIN_CHUNK_SIZE - 7, "iovec length is %" PRINTF_SIZE_T_SPECIFIER, len);
+  CHECK_TRUE(memcmp(_flat, _data, ABUF_CHAIN_CHUNK_SIZE - 10) == 0, "chain content wrong after setlen");
+  CHECK_TRUE(memcmp(&_flat[ABUF_CHAIN_CHUNK_SIZE - 10], "end", 3) == 0, "chain does not end with 'end'");
+
+  /* a larger length does not change the chain */
+  abuf_chain_setlen(&_chain, ABUF_CHAIN_CHUNK_SIZE * 2);
+  CHECK_TRUE(abuf_chain_getlen(&_chain) == ABUF_CHAIN_CHUNK_SIZE - 7, "setlen increased chain length");
+
+  abuf_chain_setlen(&_chain, 0);
+  CHECK_TRUE(abuf_chain_getlen(&_chain) == 0, "chain is not empty");
+
+  abuf_chain_free(&_chain);
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__((unused)), char **argv __attribute__((unused))) {
+  BEGIN_TESTING(clear_elements);
+
+  test_chain_memcpy();
+  test_chain_appendf();
+  test_chain_adopt();
+  test_chain_pull();
+  test_chain_setlen();
+
+  return FINISH_TESTING();
+}
@@ -0,0 +1,241 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "common/autobuf.h"
+#include "common/cbor.h"
+#include "common/common_types.h"
+#include "common/json.h"
+#include "common/template.h"
+
+#include "cunit/cunit.h"
+
+static struct autobuf _out;
+
+static void
+clear_elements(void) {
+  abuf_clear(&_out);
+}
+
+static void
+_check_bytes(const char *name, const uint8_t *expected, size_t len) {
+  CHECK_TRUE(abuf_getlen(&_out) == len, "%s: encoded length is %" PRINTF_SIZE_T_SPECIFIER " instead of %"
+    PRINTF_SIZE_T_SPECIFIER, name, abuf_getlen(&_out), len);
+  CHECK_TRUE(memcmp(abuf_getptr(&_out), expected, len) == 0, "%s: wrong encoding", name);
+}
+
+static void
+test_cbor_encode_int(void) {
+  static const uint8_t enc_0[] = { 0x00 };
+  static const uint8_t enc_23[] = { 0x17 };
+  static const uint8_t enc_24[] = { 0x18, 0x18 };
+  static const uint8_t enc_1000[] = { 0x19, 0x03, 0xe8 };
+  static const uint8_t enc_1000000[] = { 0x1a, 0x00, 0x0f, 0x42, 0x40 };
+  static const uint8_t enc_2_40[] = { 0x1b, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00 };
+  static const uint8_t enc_minus_1[] = { 0x20 };
+  static const uint8_t enc_minus_1000[] = { 0x39, 0x03, 0xe7 };
+
+  START_TEST();
+
+  /* examples from RFC 7049 appendix A */
+  clear_elements();
+  cbor_add_uint(&_out, 0);
+  _check_bytes("0", enc_0, sizeof(enc_0));
+
+  clear_elements();
+  cbor_add_uint(&_out, 23);
+  _check_bytes("23", enc_23, sizeof(enc_23));
+
+  clear_elements();
+  cbor_add_uint(&_out, 24);
+  _check_bytes("24", enc_24, sizeof(enc_24));
+
+  clear_elements();
+  cbor_add_int(&_out, 1000);
+  _check_bytes("1000", enc_1000, sizeof(enc_1000));
+
+  clear_elements();
+  cbor_add_uint(&_out, 1000000);
+  _check_bytes("1000000", enc_1000000, sizeof(enc_1000000));
+
+  clear_elements();
+  cbor_add_uint(&_out, 1ull << 40);
+  _check_bytes("2^40", enc_2_40, sizeof(enc_2_40));
+
+  clear_elements();
+  cbor_add_int(&_out, -1);
+  _check_bytes("-1", enc_minus_1, sizeof(enc_minus_1));
+
+  clear_elements();
+  cbor_add_int(&_out, -1000);
+  _check_bytes("-1000", enc_minus_1000, sizeof(enc_minus_1000));
+
+  END_TEST();
+}
+
+static void
+test_cbor_number_string(void) {
+  struct cbor_reader reader;
+  struct cbor_item item;
+
+  START_TEST();
+
+  clear_elements();
+  cbor_add_number_string(&_out, "42");
+  cbor_add_number_string(&_out, "-7");
+  cbor_add_number_string(&_out, "1.5");
+  cbor_add_number_string(&_out, "1.5k");
+  cbor_add_number_string(&_out, "true");
+  cbor_add_number_string(&_out, "");
+
+  cbor_reader_init(&reader, abuf_getptr(&_out), abuf_getlen(&_out));
+
+  CHECK_TRUE(cbor_read(&reader, &item) == 0, "could not read 42");
+  CHECK_TRUE(item.type == CBOR_TYPE_UINT && item.value == 42, "42 was decoded as %d/%" PRIu64, item.type,
+    item.value);
+
+  CHECK_TRUE(cbor_read(&reader, &item) == 0, "could not read -7");
+  CHECK_TRUE(item.type == CBOR_TYPE_NEGINT && item.value == 6, "-7 was decoded as %d/%" PRIu64, item.type,
+    item.value);
+
+  CHECK_TRUE(cbor_read(&reader, &item) == 0, "could not read 1.5");
+  CHECK_TRUE(item.type == CBOR_TYPE_SIMPLE && item.value == CBOR_SIMPLE_DOUBLE && item.number == 1.5,
+    "1.5 was decoded as %d/%f", item.type, item.number);
+
+  CHECK_TRUE(cbor_read(&reader, &item) == 0, "could not read 1.5k");
+  CHECK_TRUE(item.type == CBOR_TYPE_TEXT && item.value == 4 && memcmp(item.data, "1.5k", 4) == 0,
+    "1.5k was not decoded as text");
+
+  CHECK_TRUE(cbor_read(&reader, &item) == 0, "could not read true");
+  CHECK_TRUE(item.type == CBOR_TYPE_SIMPLE && item.value == CBOR_SIMPLE_TRUE, "true was not decoded as simple");
+
+  CHECK_TRUE(cbor_read(&reader, &item) == 0, "could not read empty number");
+  CHECK_TRUE(item.type == CBOR_TYPE_UINT && item.value == 0, "empty number was not decoded as 0");
+
+  CHECK_TRUE(cbor_reader_is_done(&reader), "reader has data left");
+  CHECK_TRUE(cbor_read(&reader, &item) != 0, "reader did not report end of data");
+
+  END_TEST();
+}
+
+static void
+test_cbor_json_session(void) {
+  struct abuf_template_data_entry entries[] = {
+    { .key = "name", .value = "eth0", .string = true },
+    { .key = "mtu", .value = "1500", .string = false },
+    { .key = "unset", .value = NULL, .string = false },
+  };
+  struct abuf_template_data data = { entries, ARRAYSIZE(entries) };
+  struct json_session session;
+  struct cbor_reader reader;
+  struct cbor_item item;
+
+  START_TEST();
+
+  clear_elements();
+  json_init_cbor_session(&session, &_out);
+  json_start_object(&session, NULL);
+  json_start_array(&session, "interface");
+  json_start_object(&session, NULL);
+  json_print_templates(&session, &data, 1);
+  json_end_object(&session);
+  json_end_array(&session);
+  json_end_object(&session);
+
+  cbor_reader_init(&reader, abuf_getptr(&_out), abuf_getlen(&_out));
+
+  CHECK_TRUE(cbor_read(&reader, &item) == 0 && item.type == CBOR_TYPE_MAP && item.indefinite,
+    "output does not start with a map");
+  CHECK_TRUE(cbor_read(&reader, &item) == 0 && item.type == CBOR_TYPE_TEXT && item.value == 9 &&
+               memcmp(item.data, "interface", 9) == 0,
+    "key of array is not 'interface'");
+  CHECK_TRUE(cbor_read(&reader, &item) == 0 && item.type == CBOR_TYPE_ARRAY && item.indefinite,
+    "value of 'interface' is not an array");
+  CHECK_TRUE(cbor_read(&reader, &item) == 0 && item.type == CBOR_TYPE_MAP, "array does not contain a map");
+  CHECK_TRUE(cbor_read(&reader, &item) == 0 && item.type == CBOR_TYPE_TEXT && memcmp(item.data, "name", 4) == 0,
+    "first key is not 'name'");
+  CHECK_TRUE(cbor_read(&reader, &item) == 0 && item.type == CBOR_TYPE_TEXT && memcmp(item.data, "eth0", 4) == 0,
+    "value of 'name' is not 'eth0'");
+  CHECK_TRUE(cbor_read(&reader, &item) == 0 && item.type == CBOR_TYPE_TEXT && memcmp(item.data, "mtu", 3) == 0,
+    "second key is not 'mtu'");
+  CHECK_TRUE(cbor_read(&reader, &item) == 0 && item.type == CBOR_TYPE_UINT && item.value == 1500,
+    "value of 'mtu' is not 1500");
+  CHECK_TRUE(cbor_read(&reader, &item) == 0 && cbor_is_break(&item), "inner map is not closed");
+  CHECK_TRUE(cbor_read(&reader, &item) == 0 && cbor_is_break(&item), "array is not closed");
+  CHECK_TRUE(cbor_read(&reader, &item) == 0 && cbor_is_break(&item), "outer map is not closed");
+  CHECK_TRUE(cbor_reader_is_done(&reader), "reader has data left");
+
+  /* the whole document is a single data item */
+  cbor_reader_init(&reader, abuf_getptr(&_out), abuf_getlen(&_out));
+  CHECK_TRUE(cbor_skip(&reader) == 0, "could not skip document");
+  CHECK_TRUE(cbor_reader_is_done(&reader), "skip did not consume the whole document");
+
+  /* truncated document */
+  cbor_reader_init(&reader, abuf_getptr(&_out), abuf_getlen(&_out) - 1);
+  CHECK_TRUE(cbor_skip(&reader) != 0, "skip did not detect truncated document");
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__((unused)), char **argv __attribute__((unused))) {
+  int result;
+
+  if (abuf_init(&_out)) {
+    return 1;
+  }
+
+  BEGIN_TESTING(clear_elements);
+
+  test_cbor_encode_int();
+  test_cbor_number_string();
+  test_cbor_json_session();
+
+  result = FINISH_TESTING();
+  abuf_free(&_out);
+  return result;
+}
@@ -0,0 +1,163 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "common/common_types.h"
+#include "common/histogram.h"
+
+#include "cunit/cunit.h"
+
+static struct histogram _hist;
+
+static void
+clear_elements(void) {
+  memset(&_hist, 0, sizeof(_hist));
+}
+
+static void
+test_bucket_bounds(void) {
+  uint64_t value;
+  size_t i, idx;
+  bool ok;
+
+  START_TEST();
+
+  /* small values are exact */
+  for (i = 0; i < 8; i++) {
+    CHECK_TRUE(histogram_get_bucket(i) == i, "value %" PRINTF_SIZE_T_SPECIFIER " is not in its own bucket", i);
+  }
+
+  /* buckets must be continuous */
+  ok = true;
+  for (i = 0; i < HISTOGRAM_BUCKETS - 1; i++) {
+    if (histogram_get_bucket_max(i) + 1 != histogram_get_bucket_min(i + 1)) {
+      ok = false;
+    }
+  }
+  CHECK_TRUE(ok, "bucket borders are not continuous");
+
+  /* every bucket border maps back to its bucket */
+  ok = true;
+  for (i = 0; i < HISTOGRAM_BUCKETS - 1; i++) {
+    if (histogram_get_bucket(histogram_get_bucket_min(i)) != i
+        || histogram_get_bucket(histogram_get_bucket_max(i)) != i) {
+      ok = false;
+    }
+  }
+  CHECK_TRUE(ok, "bucket borders are not inside their own bucket");
+
+  /* relative width of a bucket */
+  value = 1000000;
+  idx = histogram_get_bucket(value);
+  CHECK_TRUE(histogram_get_bucket_max(idx) - histogram_get_bucket_min(idx) < value / HISTOGRAM_SUB_BUCKETS,
+    "bucket of %" PRIu64 " is too wide: %" PRIu64 "-%" PRIu64, value, histogram_get_bucket_min(idx),
+    histogram_get_bucket_max(idx));
+
+  /* overflow */
+  CHECK_TRUE(histogram_get_bucket(1ull << HISTOGRAM_MAX_BITS) == HISTOGRAM_BUCKETS - 1,
+    "large value not in last bucket");
+  CHECK_TRUE(histogram_get_bucket(UINT64_MAX) == HISTOGRAM_BUCKETS - 1, "UINT64_MAX not in last bucket");
+  CHECK_TRUE(histogram_get_bucket_max(HISTOGRAM_BUCKETS - 1) == UINT64_MAX, "last bucket is limited");
+
+  END_TEST();
+}
+
+static void
+test_percentile(void) {
+  uint64_t p50, p99;
+  int i;
+
+  START_TEST();
+
+  CHECK_TRUE(histogram_get_percentile(&_hist, 50) == 0, "empty histogram has a median");
+
+  /* 1..1000 */
+  for (i = 1; i <= 1000; i++) {
+    histogram_add(&_hist, i);
+  }
+
+  CHECK_TRUE(_hist.count == 1000, "count is %" PRIu64, _hist.count);
+  CHECK_TRUE(_hist.sum == 500500, "sum is %" PRIu64, _hist.sum);
+  CHECK_TRUE(_hist.max == 1000, "max is %" PRIu64, _hist.max);
+
+  p50 = histogram_get_percentile(&_hist, 50);
+  p99 = histogram_get_percentile(&_hist, 99);
+  CHECK_TRUE(p50 >= 500 && p50 < 500 + 500 / HISTOGRAM_SUB_BUCKETS, "median is %" PRIu64, p50);
+  CHECK_TRUE(p99 >= 990 && p99 <= 1000, "99th percentile is %" PRIu64, p99);
+  CHECK_TRUE(histogram_get_percentile(&_hist, 100) == 1000, "100th percentile is not max");
+  CHECK_TRUE(histogram_get_percentile(&_hist, 0) == 1, "0th percentile is not min");
+
+  END_TEST();
+}
+
+static void
+test_percentile_outlier(void) {
+  int i;
+
+  START_TEST();
+
+  for (i = 0; i < 99; i++) {
+    histogram_add(&_hist, 3);
+  }
+  histogram_add(&_hist, 100000000);
+
+  CHECK_TRUE(histogram_get_percentile(&_hist, 99) == 3, "99th percentile is not 3");
+  CHECK_TRUE(histogram_get_percentile(&_hist, 100) == 100000000, "outlier not reported as maximum");
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__((unused)), char **argv __attribute__((unused))) {
+  BEGIN_TESTING(clear_elements);
+
+  test_bucket_bounds();
+  test_percentile();
+  test_percentile_outlier();
+
+  return FINISH_TESTING();
+}
@@ -0,0 +1,217 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/uio.h>
+
+#include "common/autobuf.h"
+#include "common/autobuf_chain.h"
+#include "common/common_types.h"
+#include "common/json.h"
+#include "common/template.h"
+
+#include "cunit/cunit.h"
+
+/* number of JSON objects the test generator creates */
+#define TEST_OBJECT_COUNT 100
+
+/* number of JSON objects needed to fill more than one chunk of a chained buffer */
+#define TEST_CHAIN_OBJECT_COUNT 1000
+
+static struct autobuf _out;
+static int _object_count;
+
+static void
+clear_elements(void) {
+  _object_count = 0;
+}
+
+static bool
+_cb_generate(struct json_generator *generator) {
+  char buffer[16];
+
+  if (_object_count == 0) {
+    json_start_array(&generator->session, "list");
+  }
+  if (_object_count == TEST_OBJECT_COUNT) {
+    json_end_array(&generator->session);
+    return true;
+  }
+
+  snprintf(buffer, sizeof(buffer), "%d", _object_count++);
+
+  json_start_object(&generator->session, NULL);
+  json_print(&generator->session, "index", false, buffer);
+  json_end_object(&generator->session);
+  return false;
+}
+
+static void
+test_generator_chunks(void) {
+  struct json_generator generator;
+  struct autobuf complete;
+  size_t len;
+  int runs;
+
+  START_TEST();
+
+  CHECK_TRUE(abuf_init(&_out) == 0, "Could not initialize output buffer");
+  CHECK_TRUE(abuf_init(&complete) == 0, "Could not initialize output buffer");
+
+  /* generate whole document in one run */
+  json_init_generator(&generator, &complete, SIZE_MAX, _cb_generate);
+  CHECK_TRUE(json_generator_run(&generator), "generator did not finish in one run");
+
+  /* generate document in chunks of 100 bytes */
+  _object_count = 0;
+  json_init_generator(&generator, &_out, 100, _cb_generate);
+
+  runs = 1;
+  len = 0;
+  while (!json_generator_run(&generator)) {
+    CHECK_TRUE(abuf_getlen(&_out) - len >= 100, "chunk %d was only %" PRINTF_SIZE_T_SPECIFIER " bytes long", runs,
+      abuf_getlen(&_out) - len);
+    CHECK_TRUE(runs < TEST_OBJECT_COUNT, "generator did not finish");
+    if (runs >= TEST_OBJECT_COUNT) {
+      break;
+    }
+
+    len = abuf_getlen(&_out);
+    runs++;
+  }
+
+  CHECK_TRUE(runs > 1, "generator finished in a single run");
+  CHECK_TRUE(abuf_getlen(&_out) == abuf_getlen(&complete),
+    "chunked output has %" PRINTF_SIZE_T_SPECIFIER " bytes instead of %" PRINTF_SIZE_T_SPECIFIER,
+    abuf_getlen(&_out), abuf_getlen(&complete));
+  CHECK_TRUE(strcmp(abuf_getptr(&_out), abuf_getptr(&complete)) == 0, "chunked output differs");
+
+  /* a finished generator must not produce more output */
+  len = abuf_getlen(&_out);
+  CHECK_TRUE(json_generator_run(&generator), "finished generator is running again");
+  CHECK_TRUE(abuf_getlen(&_out) == len, "finished generator produced more output");
+
+  abuf_free(&complete);
+  abuf_free(&_out);
+
+  END_TEST();
+}
+
+static void
+_generate_document(struct json_session *session) {
+  struct abuf_template_data_entry entries[] = {
+    { "name", "quoted \"text\"\n", true },
+    { "value", "42", false },
+  };
+  struct abuf_template_data data[] = {
+    { entries, ARRAYSIZE(entries) },
+  };
+  int i;
+
+  json_start_object(session, NULL);
+  json_start_array(session, "list");
+  for (i = 0; i < TEST_CHAIN_OBJECT_COUNT; i++) {
+    json_start_object(session, NULL);
+    json_print_templates(session, data, ARRAYSIZE(data));
+    json_end_object(session);
+  }
+  json_end_array(session);
+  json_end_object(session);
+}
+
+static void
+test_chain_session(void) {
+  struct json_session session;
+  struct abuf_chain chain;
+  struct iovec iov[8];
+  size_t len;
+  int count, i;
+
+  START_TEST();
+
+  CHECK_TRUE(abuf_init(&_out) == 0, "Could not initialize output buffer");
+  abuf_chain_init(&chain);
+
+  json_init_session(&session, &_out);
+  _generate_document(&session);
+
+  json_init_chain_session(&session, &chain);
+  _generate_document(&session);
+
+  CHECK_TRUE(json_get_length(&session) == abuf_getlen(&_out),
+    "chained output has %" PRINTF_SIZE_T_SPECIFIER " bytes instead of %" PRINTF_SIZE_T_SPECIFIER,
+    json_get_length(&session), abuf_getlen(&_out));
+
+  count = abuf_chain_get_iovec(&chain, iov, ARRAYSIZE(iov));
+  len = 0;
+  for (i = 0; i < count; i++) {
+    CHECK_TRUE(len + iov[i].iov_len <= abuf_getlen(&_out), "chained output is too long");
+    if (len + iov[i].iov_len > abuf_getlen(&_out)) {
+      break;
+    }
+    CHECK_TRUE(memcmp(abuf_getptr(&_out) + len, iov[i].iov_base, iov[i].iov_len) == 0,
+      "chained output differs at chunk %d", i);
+    len += iov[i].iov_len;
+  }
+  CHECK_TRUE(count > 1, "chained output fits into a single chunk");
+  CHECK_TRUE(len == abuf_getlen(&_out), "chained output has only %" PRINTF_SIZE_T_SPECIFIER " bytes", len);
+  CHECK_TRUE(!abuf_chain_has_failed(&chain), "chained output reported an error");
+
+  abuf_chain_free(&chain);
+  abuf_free(&_out);
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__((unused)), char **argv __attribute__((unused))) {
+  BEGIN_TESTING(clear_elements);
+
+  test_generator_chunks();
+  test_chain_session();
+
+  return FINISH_TESTING();
+}
@@ -49,6 +49,7 @@
 
 #include "common/netaddr.h"
 #include "cunit/cunit.h"
+#include "cunit/cunit_random.h"
 
 struct netaddr_string_tests {
   const char *str;
@@ -368,6 +369,104 @@ test_netaddr_is_in_subnet(void) {
   END_TEST();
 }
 
+/* bytewise reference implementation of the subnet check */
+static bool
+_reference_is_in_subnet(const struct netaddr *subnet, const uint8_t *bin) {
+  size_t byte_length, bit_length;
+
+  byte_length = subnet->_prefix_len / 8;
+  bit_length = subnet->_prefix_len % 8;
+
+  if (memcmp(subnet->_addr, bin, byte_length) != 0) {
+    return false;
+  }
+  if (bit_length != 0) {
+    return (subnet->_addr[byte_length] >> (8 - bit_length)) == (bin[byte_length] >> (8 - bit_length));
+  }
+  return true;
+}
+
+static int
+_sign(int value) {
+  return value > 0 ? 1 : (value < 0 ? -1 : 0);
+}
+
+static void
+test_netaddr_cmp_equivalence(void) {
+  struct netaddr a1, a2;
+  struct netaddr_str str1, str2;
+  uint32_t state = 42;
+  size_t i, j;
+  START_TEST();
+
+  for (i = 0; i < 10000; i++) {
+    for (j = 0; j < sizeof(a1); j++) {
+      ((uint8_t *)&a1)[j] = (uint8_t)cunit_random(&state);
+    }
+    memcpy(&a2, &a1, sizeof(a2));
+
+    /* modify a single byte, so all positions decide the order once */
+    j = i % sizeof(a2);
+    ((uint8_t *)&a2)[j] = (uint8_t)cunit_random(&state);
+
+    CHECK_TRUE(_sign(netaddr_cmp(&a1, &a2)) == _sign(memcmp(&a1, &a2, sizeof(a1))),
+        "netaddr_cmp(%s, %s) does not match memcmp (byte %"PRINTF_SIZE_T_SPECIFIER")",
+        netaddr_to_string(&str1, &a1), netaddr_to_string(&str2, &a2), j);
+    CHECK_TRUE(_sign(netaddr_cmp(&a2, &a1)) == _sign(memcmp(&a2, &a1, sizeof(a1))),
+        "netaddr_cmp(%s, %s) does not match memcmp (byte %"PRINTF_SIZE_T_SPECIFIER")",
+        netaddr_to_string(&str1, &a2), netaddr_to_string(&str2, &a1), j);
+    CHECK_TRUE(netaddr_cmp(&a1, &a1) == 0,
+        "netaddr_cmp(%s, %s) is not zero", netaddr_to_string(&str1, &a1), netaddr_to_string(&str2, &a1));
+  }
+
+  END_TEST();
+}
+
+static void
+test_netaddr_is_in_subnet_equivalence(void) {
+  static const uint8_t af_types[] = { AF_INET, AF_INET6, AF_MAC48, AF_EUI64 };
+  struct netaddr subnet, addr;
+  struct netaddr_str str1, str2;
+  uint32_t state = 23;
+  size_t i, t, len;
+  int prefix_len, bit;
+  bool expected;
+  START_TEST();
+
+  for (t = 0; t < ARRAYSIZE(af_types); t++) {
+    len = netaddr_get_af_maxprefix(af_types[t]) / 8;
+
+    for (prefix_len = 0; prefix_len <= (int)len * 8; prefix_len++) {
+      for (i = 0; i < 20; i++) {
+        memset(&subnet, 0, sizeof(subnet));
+        for (bit = 0; bit < (int)len; bit++) {
+          subnet._addr[bit] = (uint8_t)cunit_random(&state);
+        }
+        subnet._type = af_types[t];
+        subnet._prefix_len = (uint8_t)prefix_len;
+
+        /* flip a single bit, sometimes inside and sometimes outside of the prefix */
+        memcpy(&addr, &subnet, sizeof(addr));
+        addr._prefix_len = (uint8_t)(len * 8);
+        bit = (int)(cunit_random(&state) % (len * 8));
+        addr._addr[bit / 8] ^= (uint8_t)(0x80 >> (bit % 8));
+
+        expected = _reference_is_in_subnet(&subnet, addr._addr);
+        CHECK_TRUE(expected == (bit >= prefix_len), "reference check failed for bit %d", bit);
+
+        CHECK_TRUE(expected == netaddr_is_in_subnet(&subnet, &addr),
+            "%s should %sbe in %s", netaddr_to_string(&str1, &addr), expected ? "" : "not ",
+            netaddr_to_string(&str2, &subnet));
+        CHECK_TRUE(expected == netaddr_binary_is_in_subnet(&subnet, addr._addr, len, af_types[t]),
+            "binary %s should %sbe in %s", netaddr_to_string(&str1, &addr), expected ? "" : "not ",
+            netaddr_to_string(&str2, &subnet));
+      }
+    }
+  }
+
+  END_TEST();
+}
+
 int main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
   BEGIN_TESTING(NULL);
 
@@ -375,6 +474,8 @@ int main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))
   test_netaddr_from_string();
 
   test_netaddr_is_in_subnet();
+  test_netaddr_is_in_subnet_equivalence();
+  test_netaddr_cmp_equivalence();
 
   test_netaddr_create_host();
 
@@ -0,0 +1,249 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "common/netaddr.h"
+#include "common/netaddr_acl.h"
+#include "common/string.h"
+#include "cunit/cunit.h"
+#include "cunit/cunit_random.h"
+
+#define ADDRESSES_PER_ACL 2000
+
+/* linear reference implementation of netaddr_acl_check_accept() */
+static bool
+_is_in_array(const struct netaddr *array, size_t length, const struct netaddr *addr) {
+  size_t i;
+
+  for (i = 0; i < length; i++) {
+    if (netaddr_is_in_subnet(&array[i], addr)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool
+_reference_check_accept(const struct netaddr_acl *acl, const struct netaddr *addr) {
+  if (acl->reject_first && _is_in_array(acl->reject, acl->reject_count, addr)) {
+    return false;
+  }
+  if (_is_in_array(acl->accept, acl->accept_count, addr)) {
+    return true;
+  }
+  if (!acl->reject_first && _is_in_array(acl->reject, acl->reject_count, addr)) {
+    return false;
+  }
+  return acl->accept_default;
+}
+
+static void
+_check_acl(uint32_t seed, size_t prefix_count, bool check_copy) {
+  struct strarray value;
+  struct netaddr_acl acl, copy;
+  struct netaddr prefix, addr;
+  struct netaddr_str nbuf;
+  char buffer[sizeof(nbuf) + 1];
+  uint32_t state;
+  size_t i, errors;
+  bool expected;
+
+  state = seed;
+  strarray_init(&value);
+
+  switch (cunit_random(&state) % 4) {
+    case 0:
+      strarray_append(&value, ACL_FIRST_REJECT);
+      break;
+    case 1:
+      strarray_append(&value, ACL_DEFAULT_ACCEPT);
+      break;
+    case 2:
+      strarray_append(&value, ACL_FIRST_REJECT);
+      strarray_append(&value, ACL_DEFAULT_ACCEPT);
+      break;
+    default:
+      break;
+  }
+
+  for (i = 0; i < prefix_count; i++) {
+    cunit_random_address(&prefix, &state, (uint8_t)(cunit_random(&state) % 129), true);
+    snprintf(buffer, sizeof(buffer), "%s%s", (cunit_random(&state) & 1) ? "-" : "", netaddr_to_string(&nbuf, &prefix));
+    strarray_append(&value, buffer);
+  }
+
+  netaddr_acl_add(&acl);
+  netaddr_acl_add(&copy);
+  CHECK_TRUE(netaddr_acl_from_strarray(&acl, (const struct const_strarray *)&value) == 0,
+    "Could not parse ACL (seed %u)", seed);
+
+  if (check_copy) {
+    CHECK_TRUE(netaddr_acl_copy(&copy, &acl) == 0, "Could not copy ACL (seed %u)", seed);
+  }
+
+  errors = 0;
+  for (i = 0; i < ADDRESSES_PER_ACL; i++) {
+    cunit_random_address(&addr, &state, 128, true);
+
+    expected = _reference_check_accept(&acl, &addr);
+    if (expected != netaddr_acl_check_accept(&acl, &addr)) {
+      errors++;
+    }
+    if (check_copy && expected != netaddr_acl_check_accept(&copy, &addr)) {
+      errors++;
+    }
+  }
+  CHECK_TRUE(errors == 0, "ACL with %" PRINTF_SIZE_T_SPECIFIER " prefixes (seed %u) has %" PRINTF_SIZE_T_SPECIFIER
+    " mismatches", prefix_count, seed, errors);
+
+  netaddr_acl_remove(&copy);
+  netaddr_acl_remove(&acl);
+  strarray_free(&value);
+}
+
+static void
+test_acl_small(void) {
+  uint32_t seed;
+  START_TEST();
+
+  for (seed = 1; seed < 50; seed++) {
+    _check_acl(seed, seed % NETADDR_ACL_TRIE_MIN_PREFIXES, false);
+  }
+
+  END_TEST();
+}
+
+static void
+test_acl_trie(void) {
+  uint32_t seed;
+  START_TEST();
+
+  for (seed = 1; seed < 50; seed++) {
+    _check_acl(seed, NETADDR_ACL_TRIE_MIN_PREFIXES + seed * 10, false);
+  }
+
+  END_TEST();
+}
+
+static void
+test_acl_copy(void) {
+  uint32_t seed;
+  START_TEST();
+
+  for (seed = 100; seed < 110; seed++) {
+    _check_acl(seed, 500, true);
+  }
+
+  END_TEST();
+}
+
+static void
+test_acl_keywords(void) {
+  static const char *prefixes[] = {
+    "10.0.0.0/8", "-10.1.0.0/16", "10.1.1.0/24", "-10.1.1.1", "fd00::/8", "-fd00:1::/32", "fd00:1:2::/48",
+    "-0.0.0.0/0",
+  };
+  struct strarray value;
+  struct netaddr_acl acl;
+  struct netaddr addr;
+  size_t i;
+  START_TEST();
+
+  strarray_init(&value);
+  for (i = 0; i < ARRAYSIZE(prefixes); i++) {
+    strarray_append(&value, prefixes[i]);
+  }
+
+  netaddr_acl_add(&acl);
+  CHECK_TRUE(netaddr_acl_from_strarray(&acl, (const struct const_strarray *)&value) == 0, "Could not parse ACL");
+
+  /* accept first: the accept array wins */
+  CHECK_TRUE(netaddr_from_string(&addr, "10.1.1.1") == 0, "Could not parse 10.1.1.1");
+  CHECK_TRUE(netaddr_acl_check_accept(&acl, &addr), "10.1.1.1 should be accepted (accept first)");
+  CHECK_TRUE(netaddr_from_string(&addr, "10.1.2.1") == 0, "Could not parse 10.1.2.1");
+  CHECK_TRUE(netaddr_acl_check_accept(&acl, &addr), "10.1.2.1 should be accepted (accept first)");
+  CHECK_TRUE(netaddr_from_string(&addr, "11.0.0.1") == 0, "Could not parse 11.0.0.1");
+  CHECK_TRUE(!netaddr_acl_check_accept(&acl, &addr), "11.0.0.1 should be rejected");
+  CHECK_TRUE(netaddr_from_string(&addr, "fd00:1:3::1") == 0, "Could not parse fd00:1:3::1");
+  CHECK_TRUE(netaddr_acl_check_accept(&acl, &addr), "fd00:1:3::1 should be accepted (accept first)");
+  CHECK_TRUE(netaddr_from_string(&addr, "fe80::1") == 0, "Could not parse fe80::1");
+  CHECK_TRUE(!netaddr_acl_check_accept(&acl, &addr), "fe80::1 should be rejected (default)");
+
+  /* reject first: the reject array wins */
+  strarray_prepend(&value, ACL_FIRST_REJECT);
+  strarray_prepend(&value, ACL_DEFAULT_ACCEPT);
+  CHECK_TRUE(netaddr_acl_from_strarray(&acl, (const struct const_strarray *)&value) == 0, "Could not parse ACL");
+
+  CHECK_TRUE(netaddr_from_string(&addr, "10.1.1.1") == 0, "Could not parse 10.1.1.1");
+  CHECK_TRUE(!netaddr_acl_check_accept(&acl, &addr), "10.1.1.1 should be rejected (reject first)");
+  CHECK_TRUE(netaddr_from_string(&addr, "10.2.0.1") == 0, "Could not parse 10.2.0.1");
+  CHECK_TRUE(!netaddr_acl_check_accept(&acl, &addr), "10.2.0.1 should be rejected by 0.0.0.0/0");
+  CHECK_TRUE(netaddr_from_string(&addr, "fd00:1:2::1") == 0, "Could not parse fd00:1:2::1");
+  CHECK_TRUE(!netaddr_acl_check_accept(&acl, &addr), "fd00:1:2::1 should be rejected (reject first)");
+  CHECK_TRUE(netaddr_from_string(&addr, "fd00:2::1") == 0, "Could not parse fd00:2::1");
+  CHECK_TRUE(netaddr_acl_check_accept(&acl, &addr), "fd00:2::1 should be accepted");
+  CHECK_TRUE(netaddr_from_string(&addr, "fe80::1") == 0, "Could not parse fe80::1");
+  CHECK_TRUE(netaddr_acl_check_accept(&acl, &addr), "fe80::1 should be accepted (default)");
+
+  netaddr_acl_remove(&acl);
+  strarray_free(&value);
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__((unused)), char **argv __attribute__((unused))) {
+  BEGIN_TESTING(NULL);
+
+  test_acl_small();
+  test_acl_trie();
+  test_acl_copy();
+  test_acl_keywords();
+
+  return FINISH_TESTING();
+}
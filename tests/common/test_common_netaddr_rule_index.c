@@ -0,0 +1,304 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "common/netaddr.h"
+#include "common/netaddr_acl.h"
+#include "common/netaddr_rule_index.h"
+#include "common/string.h"
+#include "cunit/cunit.h"
+#include "cunit/cunit_random.h"
+
+#define RULE_COUNT 200
+#define LOOKUP_COUNT 2000
+
+static const int32_t _keys[] = { NETADDR_RULE_ANY, 0, 1, 2 };
+static const int32_t _prefix_lengths[] = { NETADDR_RULE_ANY, 16, 24, 32, 64, 128 };
+
+static struct netaddr_acl _acls[RULE_COUNT];
+static struct netaddr_rule _rules[RULE_COUNT];
+
+/* linear reference implementation of a rule lookup */
+static struct netaddr_rule *
+_reference_next(struct netaddr_rule *rules[], size_t count, size_t *idx, int32_t key, const struct netaddr *dst) {
+  struct netaddr_rule *rule;
+
+  while (*idx < count) {
+    rule = rules[(*idx)++];
+    if (rule->key != NETADDR_RULE_ANY && rule->key != key) {
+      continue;
+    }
+    if (rule->prefix_length != NETADDR_RULE_ANY && rule->prefix_length != netaddr_get_prefix_length(dst)) {
+      continue;
+    }
+    if (netaddr_acl_check_accept(rule->acl, dst)) {
+      return rule;
+    }
+  }
+  return NULL;
+}
+
+static void
+_create_rules(uint32_t *state) {
+  struct strarray value;
+  struct netaddr prefix;
+  struct netaddr_str nbuf;
+  char buffer[sizeof(nbuf) + 1];
+  size_t i, j, count;
+
+  for (i = 0; i < RULE_COUNT; i++) {
+    strarray_init(&value);
+
+    switch (cunit_random(state) % 8) {
+      case 0:
+        strarray_append(&value, ACL_DEFAULT_ACCEPT);
+        break;
+      case 1:
+        strarray_append(&value, ACL_FIRST_REJECT);
+        break;
+      default:
+        break;
+    }
+
+    count = cunit_random(state) % 4;
+    for (j = 0; j < count; j++) {
+      cunit_random_address(&prefix, state, (uint8_t)(cunit_random(state) % 129), false);
+      snprintf(buffer, sizeof(buffer), "%s%s", (cunit_random(state) % 4) == 0 ? "-" : "",
+        netaddr_to_string(&nbuf, &prefix));
+      strarray_append(&value, buffer);
+    }
+
+    netaddr_acl_add(&_acls[i]);
+    CHECK_TRUE(netaddr_acl_from_strarray(&_acls[i], (const struct const_strarray *)&value) == 0, "Could not parse ACL");
+    strarray_free(&value);
+
+    _rules[i].acl = &_acls[i];
+    _rules[i].key = _keys[cunit_random(state) % ARRAYSIZE(_keys)];
+    _rules[i].prefix_length = _prefix_lengths[cunit_random(state) % ARRAYSIZE(_prefix_lengths)];
+  }
+}
+
+static void
+_free_rules(void) {
+  size_t i;
+
+  for (i = 0; i < RULE_COUNT; i++) {
+    netaddr_acl_remove(&_acls[i]);
+  }
+}
+
+static size_t
+_check_lookups(struct netaddr_rule_index *idx, struct netaddr_rule *order[], size_t count, uint32_t *state) {
+  struct netaddr_rule_iterator iter;
+  struct netaddr_rule *rule, *expected;
+  struct netaddr dst;
+  size_t i, ref_idx, errors;
+  uint8_t prefix_len;
+  int32_t key;
+
+  errors = 0;
+  for (i = 0; i < LOOKUP_COUNT; i++) {
+    prefix_len = (uint8_t)_prefix_lengths[1 + cunit_random(state) % (ARRAYSIZE(_prefix_lengths) - 1)];
+    cunit_random_address(&dst, state, prefix_len, false);
+    key = _keys[cunit_random(state) % ARRAYSIZE(_keys)];
+
+    ref_idx = 0;
+    netaddr_rule_index_for_each_match(idx, &iter, key, &dst, rule) {
+      expected = _reference_next(order, count, &ref_idx, key, &dst);
+      if (rule != expected) {
+        errors++;
+        break;
+      }
+    }
+    if (rule == NULL && _reference_next(order, count, &ref_idx, key, &dst) != NULL) {
+      errors++;
+    }
+  }
+  return errors;
+}
+
+static void
+test_rule_index_lookup(void) {
+  struct netaddr_rule_index idx;
+  struct netaddr_rule *order[RULE_COUNT];
+  uint32_t state, seed;
+  size_t i, errors;
+  START_TEST();
+
+  for (seed = 1; seed < 20; seed++) {
+    state = seed;
+    _create_rules(&state);
+
+    netaddr_rule_index_init(&idx);
+    for (i = 0; i < RULE_COUNT; i++) {
+      netaddr_rule_index_add(&idx, &_rules[i]);
+      order[i] = &_rules[i];
+    }
+
+    errors = _check_lookups(&idx, order, RULE_COUNT, &state);
+    CHECK_TRUE(errors == 0, "Seed %u has %" PRINTF_SIZE_T_SPECIFIER " mismatches", seed, errors);
+    CHECK_TRUE(!idx._linear, "Seed %u fell back to linear search", seed);
+
+    netaddr_rule_index_clear(&idx);
+    _free_rules();
+  }
+
+  END_TEST();
+}
+
+static void
+test_rule_index_modify(void) {
+  struct netaddr_rule_iterator iter;
+  struct netaddr_rule_index idx;
+  struct netaddr_rule *order[RULE_COUNT];
+  uint32_t state;
+  size_t i, count, errors;
+  START_TEST();
+
+  state = 4711;
+  _create_rules(&state);
+
+  /* add rules in reverse order */
+  netaddr_rule_index_init(&idx);
+  for (i = 0; i < RULE_COUNT; i++) {
+    netaddr_rule_index_add(&idx, &_rules[RULE_COUNT - 1 - i]);
+    order[i] = &_rules[RULE_COUNT - 1 - i];
+  }
+  errors = _check_lookups(&idx, order, RULE_COUNT, &state);
+  CHECK_TRUE(errors == 0, "Reverse order has %" PRINTF_SIZE_T_SPECIFIER " mismatches", errors);
+
+  /* remove every third rule */
+  count = 0;
+  for (i = 0; i < RULE_COUNT; i++) {
+    if (i % 3 == 0) {
+      netaddr_rule_index_remove(&idx, order[i]);
+    }
+    else {
+      order[count++] = order[i];
+    }
+  }
+  CHECK_TRUE(idx.rule_count == count, "Index has %u rules instead of %" PRINTF_SIZE_T_SPECIFIER, idx.rule_count, count);
+  errors = _check_lookups(&idx, order, count, &state);
+  CHECK_TRUE(errors == 0, "Reduced rules have %" PRINTF_SIZE_T_SPECIFIER " mismatches", errors);
+
+  /* change the key and prefix length of some rules */
+  for (i = 0; i < count; i += 5) {
+    order[i]->key = _keys[cunit_random(&state) % ARRAYSIZE(_keys)];
+    order[i]->prefix_length = _prefix_lengths[cunit_random(&state) % ARRAYSIZE(_prefix_lengths)];
+  }
+  netaddr_rule_index_changed(&idx);
+  errors = _check_lookups(&idx, order, count, &state);
+  CHECK_TRUE(errors == 0, "Changed rules have %" PRINTF_SIZE_T_SPECIFIER " mismatches", errors);
+
+  netaddr_rule_index_clear(&idx);
+  CHECK_TRUE(
+    netaddr_rule_index_get_first(&idx, &iter, 0, &NETADDR_IPV4_ANY) == NULL, "Empty index returned a rule");
+
+  _free_rules();
+  END_TEST();
+}
+
+static void
+test_rule_index_nested(void) {
+  struct netaddr_rule_iterator outer_iter, inner_iter;
+  struct netaddr_rule *order[RULE_COUNT];
+  struct netaddr_rule *outer, *inner;
+  struct netaddr_rule_index idx;
+  struct netaddr outer_dst, inner_dst;
+  size_t i, outer_ref, inner_ref, errors;
+  uint32_t state;
+  START_TEST();
+
+  state = 815;
+  _create_rules(&state);
+
+  netaddr_rule_index_init(&idx);
+  for (i = 0; i < RULE_COUNT; i++) {
+    netaddr_rule_index_add(&idx, &_rules[i]);
+    order[i] = &_rules[i];
+  }
+
+  /* a complete lookup inside of another one must not disturb it */
+  errors = 0;
+  for (i = 0; i < LOOKUP_COUNT / 10; i++) {
+    cunit_random_address(&outer_dst, &state, 128, false);
+    cunit_random_address(&inner_dst, &state, 128, false);
+
+    outer_ref = 0;
+    netaddr_rule_index_for_each_match(&idx, &outer_iter, 0, &outer_dst, outer) {
+      if (outer != _reference_next(order, RULE_COUNT, &outer_ref, 0, &outer_dst)) {
+        errors++;
+        break;
+      }
+
+      inner_ref = 0;
+      netaddr_rule_index_for_each_match(&idx, &inner_iter, 1, &inner_dst, inner) {
+        if (inner != _reference_next(order, RULE_COUNT, &inner_ref, 1, &inner_dst)) {
+          errors++;
+          break;
+        }
+      }
+    }
+  }
+  CHECK_TRUE(errors == 0, "Nested lookups have %" PRINTF_SIZE_T_SPECIFIER " mismatches", errors);
+
+  netaddr_rule_index_clear(&idx);
+  _free_rules();
+  END_TEST();
+}
+
+int
+main(int argc __attribute__((unused)), char **argv __attribute__((unused))) {
+  BEGIN_TESTING(NULL);
+
+  test_rule_index_lookup();
+  test_rule_index_modify();
+  test_rule_index_nested();
+
+  return FINISH_TESTING();
+}
@@ -0,0 +1,238 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdio.h>
+
+#include "common/common_types.h"
+#include "config/cfg_db.h"
+#include "config/cfg_schema.h"
+
+#include "cunit/cunit.h"
+
+#define SECTION_TYPE     "interface"
+#define INTERFACE_COUNT  200
+
+#define KEY_ACL          "acl"
+#define KEY_DSCP         "dscp"
+#define KEY_AGGREGATION  "aggregation_interval"
+#define KEY_HELLO        "hello_interval"
+
+static void handler_socket(void);
+static void handler_hello(void);
+
+static struct cfg_db *db_pre = NULL;
+static struct cfg_db *db_post = NULL;
+
+static struct cfg_schema schema;
+
+enum
+{
+  IDX_ACL,
+  IDX_DSCP,
+
+  /* number of entries checked with cfg_schema_entries_changed() */
+  IDX_SOCKET_COUNT,
+
+  IDX_AGGREGATION = IDX_SOCKET_COUNT,
+};
+
+static struct cfg_schema_entry entries_socket[] = {
+  [IDX_ACL] = CFG_VALIDATE_STRING(KEY_ACL, "default_accept", "help"),
+  [IDX_DSCP] = CFG_VALIDATE_STRING(KEY_DSCP, "192", "help"),
+  [IDX_AGGREGATION] = CFG_VALIDATE_STRING(KEY_AGGREGATION, "0.100", "help"),
+};
+
+static struct cfg_schema_entry entries_hello[] = {
+  CFG_VALIDATE_STRING(KEY_HELLO, "2.0", "help"),
+};
+
+static struct cfg_schema_section section_socket = {
+  .type = SECTION_TYPE, .mode = CFG_SSMODE_NAMED,
+  .cb_delta_handler = handler_socket,
+  .entries = entries_socket,
+  .entry_count = ARRAYSIZE(entries_socket),
+};
+
+static struct cfg_schema_section section_hello = {
+  .type = SECTION_TYPE, .mode = CFG_SSMODE_NAMED,
+  .cb_delta_handler = handler_hello,
+  .entries = entries_hello,
+  .entry_count = ARRAYSIZE(entries_hello),
+};
+
+static uint32_t socket_counter;
+static uint32_t socket_reconfigure_counter;
+static uint32_t hello_counter;
+
+static void
+fill_db(struct cfg_db *db) {
+  char name[16];
+  int i;
+
+  for (i = 0; i < INTERFACE_COUNT; i++) {
+    snprintf(name, sizeof(name), "if%d", i);
+    cfg_db_add_entry(db, SECTION_TYPE, name, KEY_ACL, "10.0.0.0/8");
+    cfg_db_add_entry(db, SECTION_TYPE, name, KEY_DSCP, "46");
+    cfg_db_add_entry(db, SECTION_TYPE, name, KEY_AGGREGATION, "0.200");
+    cfg_db_add_entry(db, SECTION_TYPE, name, KEY_HELLO, "1.0");
+  }
+}
+
+static void
+clear_elements(void) {
+  if (db_pre) {
+    cfg_db_remove(db_pre);
+  }
+  db_pre = cfg_db_add();
+  cfg_db_link_schema(db_pre, &schema);
+  fill_db(db_pre);
+
+  if (db_post) {
+    cfg_db_remove(db_post);
+  }
+  db_post = cfg_db_duplicate(db_pre);
+  cfg_db_link_schema(db_post, &schema);
+
+  socket_counter = 0;
+  socket_reconfigure_counter = 0;
+  hello_counter = 0;
+}
+
+static void
+handler_socket(void) {
+  socket_counter++;
+
+  if (section_socket.pre == NULL || cfg_schema_entries_changed(&entries_socket[IDX_ACL], IDX_SOCKET_COUNT)) {
+    socket_reconfigure_counter++;
+  }
+}
+
+static void
+handler_hello(void) {
+  hello_counter++;
+}
+
+static void
+test_reload_startup(void) {
+  struct cfg_db *db_empty;
+
+  START_TEST();
+
+  db_empty = cfg_db_add();
+  cfg_db_link_schema(db_empty, &schema);
+
+  CHECK_TRUE(cfg_schema_handle_db_changes(db_empty, db_pre) == 0, "delta calculation failed");
+
+  CHECK_TRUE(socket_counter == INTERFACE_COUNT, "Socket handler was called %u times", socket_counter);
+  CHECK_TRUE(socket_reconfigure_counter == INTERFACE_COUNT, "Sockets were reconfigured %u times",
+    socket_reconfigure_counter);
+  CHECK_TRUE(hello_counter == INTERFACE_COUNT, "Hello handler was called %u times", hello_counter);
+
+  cfg_db_remove(db_empty);
+  END_TEST();
+}
+
+static void
+test_reload_unchanged(void) {
+  START_TEST();
+
+  CHECK_TRUE(cfg_schema_handle_db_changes(db_pre, db_post) == 0, "delta calculation failed");
+
+  CHECK_TRUE(socket_counter == 0, "Socket handler was called %u times", socket_counter);
+  CHECK_TRUE(hello_counter == 0, "Hello handler was called %u times", hello_counter);
+  END_TEST();
+}
+
+static void
+test_reload_single_entry(void) {
+  START_TEST();
+
+  cfg_db_overwrite_entry(db_post, SECTION_TYPE, "if100", KEY_AGGREGATION, "0.050");
+
+  CHECK_TRUE(cfg_schema_handle_db_changes(db_pre, db_post) == 0, "delta calculation failed");
+
+  CHECK_TRUE(socket_counter == 1, "Socket handler was called %u times", socket_counter);
+  CHECK_TRUE(socket_reconfigure_counter == 0, "Sockets were reconfigured %u times", socket_reconfigure_counter);
+  CHECK_TRUE(hello_counter == 0, "Hello handler was called %u times", hello_counter);
+  END_TEST();
+}
+
+static void
+test_reload_socket_entry(void) {
+  START_TEST();
+
+  cfg_db_overwrite_entry(db_post, SECTION_TYPE, "if7", KEY_DSCP, "0");
+  cfg_db_overwrite_entry(db_post, SECTION_TYPE, "if8", KEY_HELLO, "3.0");
+
+  CHECK_TRUE(cfg_schema_handle_db_changes(db_pre, db_post) == 0, "delta calculation failed");
+
+  CHECK_TRUE(socket_counter == 1, "Socket handler was called %u times", socket_counter);
+  CHECK_TRUE(socket_reconfigure_counter == 1, "Sockets were reconfigured %u times", socket_reconfigure_counter);
+  CHECK_TRUE(hello_counter == 1, "Hello handler was called %u times", hello_counter);
+  END_TEST();
+}
+
+int
+main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  cfg_schema_add(&schema);
+  cfg_schema_add_section(&schema, &section_socket);
+  cfg_schema_add_section(&schema, &section_hello);
+
+  BEGIN_TESTING(clear_elements);
+
+  test_reload_startup();
+  test_reload_unchanged();
+  test_reload_single_entry();
+  test_reload_socket_entry();
+
+  if (db_post) {
+    cfg_db_remove(db_post);
+  }
+  if (db_pre) {
+    cfg_db_remove(db_pre);
+  }
+
+  return FINISH_TESTING();
+}
@@ -0,0 +1,109 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#ifndef CUNIT_RANDOM_H_
+#define CUNIT_RANDOM_H_
+
+#include <string.h>
+
+#include "common/common_types.h"
+#include "common/netaddr.h"
+
+/**
+ * Reproducible xorshift pseudo random number generator
+ * @param state pointer to generator state, must not be zero
+ * @return next random number
+ */
+static INLINE uint32_t
+cunit_random(uint32_t *state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 17;
+  *state ^= *state << 5;
+  return *state;
+}
+
+/**
+ * Generate a random address out of a few shared networks, so that
+ * prefixes generated with it are nested and overlap each other.
+ * @param addr pointer to output address
+ * @param state pointer to random generator state
+ * @param prefix_len prefix length, will be limited to the maximum
+ *   prefix length of the chosen address family
+ * @param with_mac true to generate MAC48 addresses too
+ */
+static INLINE void
+cunit_random_address(struct netaddr *addr, uint32_t *state, uint8_t prefix_len, bool with_mac) {
+  uint8_t bin[16];
+  size_t i, len;
+  uint32_t type;
+  int af_type;
+
+  type = cunit_random(state) % (with_mac ? 5 : 3);
+  if (type == 0) {
+    af_type = AF_INET6;
+    len = 16;
+  }
+  else if (type == 1 && with_mac) {
+    af_type = AF_MAC48;
+    len = 6;
+  }
+  else {
+    af_type = AF_INET;
+    len = 4;
+  }
+
+  memset(bin, 0, sizeof(bin));
+  for (i = 0; i < len; i++) {
+    /* few different values in the first bytes */
+    bin[i] = (uint8_t)(i < len / 2 ? cunit_random(state) % 3 : cunit_random(state));
+  }
+
+  if (prefix_len > len * 8) {
+    prefix_len = (uint8_t)(len * 8);
+  }
+  netaddr_from_binary_prefix(addr, bin, len, af_type, prefix_len);
+}
+
+#endif /* CUNIT_RANDOM_H_ */